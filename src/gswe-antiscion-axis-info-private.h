@@ -32,11 +32,15 @@ struct _GsweAntiscionAxisInfo {
     /* the name of the mirror */
     gchar *name;
 
+    /* the untranslated name of the built-in records, used while name is not
+     * set */
+    const gchar *msgid;
+
     /* if TRUE, the axis runs through the middle of its starting sign */
     gdouble sign_offset;
 
     /* Reference counter */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_ANTISCION_AXIS_INFO_PRIVATE_H__ */
@@ -80,7 +80,7 @@ gswe_antiscion_axis_info_new(void)
 GsweAntiscionAxisInfo *
 gswe_antiscion_axis_info_ref(GsweAntiscionAxisInfo *antiscion_axis_info)
 {
-    antiscion_axis_info->refcount++;
+    g_atomic_int_inc(&antiscion_axis_info->refcount);
 
     return antiscion_axis_info;
 }
@@ -95,7 +95,7 @@ gswe_antiscion_axis_info_ref(GsweAntiscionAxisInfo *antiscion_axis_info)
 void
 gswe_antiscion_axis_info_unref(GsweAntiscionAxisInfo *antiscion_axis_info)
 {
-    if (--antiscion_axis_info->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&antiscion_axis_info->refcount)) {
         gswe_antiscion_axis_info_free(antiscion_axis_info);
     }
 }
@@ -185,10 +185,7 @@ gswe_antiscion_axis_info_set_start_sign(
 {
     GsweSignInfo *sign_info;
 
-    if ((sign_info = g_hash_table_lookup(
-                    gswe_sign_info_table,
-                    GINT_TO_POINTER(sign)
-                )) == NULL) {
+    if ((sign_info = gswe_sign_info_lookup(sign)) == NULL) {
         g_warning("Trying to fetch an unregistered sign");
         g_set_error(
                 err,
@@ -248,13 +245,21 @@ gswe_antiscion_axis_info_set_name(
  * gswe_antiscion_axis_info_get_name:
  * @antiscion_axis_info: (in): a #GsweAntiscionAxisInfo
  *
- * Gets the name of the axis.
+ * Gets the name of the axis. If NLS is enabled, the names of the axes known by
+ * SWE-GLib are translated on every call, so they follow the current locale.
  *
  * Returns: (transfer none): the name of the axis
  */
 const gchar *
 gswe_antiscion_axis_info_get_name(GsweAntiscionAxisInfo *antiscion_axis_info)
 {
+    if (
+                (antiscion_axis_info->name == NULL)
+                && (antiscion_axis_info->msgid != NULL)
+            ) {
+        return gswe_translate(antiscion_axis_info->msgid);
+    }
+
     return antiscion_axis_info->name;
 }
 
@@ -38,9 +38,11 @@ struct _GsweAntiscionData {
     gdouble difference;
 
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
+void gswe_antiscion_data_clear(GsweAntiscionData *antiscion_data);
+
 #endif /* __SWE_GLIB_GSWE_ANTISCION_DATA_PRIVATE_H__ */
 #else /* not defined __SWE_GLIB_BUILDING__ */
 #error __FILE__ "Can not be included, unless building SWE-GLib"
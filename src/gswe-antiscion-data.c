@@ -80,7 +80,6 @@ gswe_antiscion_data_new(void)
 
 /*
  * find_antiscion:
- * @axis_p: a pointer made with GINT_TO_POINTER(), holding the antiscion axis ID
  * @antiscion_axis_info: a GsweAntiscionAxisInfo, which will be checked against
  *                       @antiscion_data
  * @antiscion_data: a GsweAntiscionData, whose planets' positions will be
@@ -92,16 +91,14 @@ gswe_antiscion_data_new(void)
  */
 static gboolean
 find_antiscion(
-        gpointer axis_p,
         GsweAntiscionAxisInfo *antiscion_axis_info,
         GsweAntiscionData *antiscion_data)
 {
-    GsweAntiscionAxis axis;
     gdouble start_point,
             axis_position,
             planet_orb;
 
-    if ((axis = GPOINTER_TO_INT(axis_p)) == GSWE_ANTISCION_AXIS_NONE) {
+    if (antiscion_axis_info->axis == GSWE_ANTISCION_AXIS_NONE) {
         return FALSE;
     }
 
@@ -154,20 +151,50 @@ find_antiscion(
 void
 gswe_antiscion_data_calculate(GsweAntiscionData *antiscion_data)
 {
-    if ((antiscion_data->antiscion_axis_info = g_hash_table_find(
-                    gswe_antiscion_axis_info_table,
-                    (GHRFunc)find_antiscion,
-                    antiscion_data
-                )) == NULL) {
-        antiscion_data->antiscion_axis_info = gswe_antiscion_axis_info_ref(
-                g_hash_table_lookup(
-                        gswe_antiscion_axis_info_table,
-                        GINT_TO_POINTER(GSWE_ANTISCION_AXIS_NONE)
-                    )
-            );
-    } else {
-        gswe_antiscion_axis_info_ref(antiscion_data->antiscion_axis_info);
+    GsweAntiscionAxis axis;
+
+    if (antiscion_data->antiscion_axis_info) {
+        gswe_antiscion_axis_info_unref(antiscion_data->antiscion_axis_info);
+    }
+
+    for (axis = 0; axis < GSWE_ANTISCION_AXIS_COUNT; axis++) {
+        GsweAntiscionAxisInfo *antiscion_axis_info;
+
+        if (((antiscion_axis_info = gswe_antiscion_axis_info_lookup(axis))
+                    != NULL)
+                && find_antiscion(antiscion_axis_info, antiscion_data)) {
+            antiscion_data->antiscion_axis_info = gswe_antiscion_axis_info_ref(
+                    antiscion_axis_info
+                );
+
+            return;
+        }
+    }
+
+    antiscion_data->antiscion_axis_info = gswe_antiscion_axis_info_ref(
+            gswe_antiscion_axis_info_lookup(GSWE_ANTISCION_AXIS_NONE)
+        );
+}
+
+/*
+ * gswe_antiscion_data_clear:
+ * @antiscion_data: a #GsweAntiscionData
+ *
+ * Marks the planets of @antiscion_data as not being antiscia of each other on
+ * any axis, without checking the axis table. This is used internally by
+ * #GsweMoment for planet pairs that are known to be out of any axis' orb.
+ */
+void
+gswe_antiscion_data_clear(GsweAntiscionData *antiscion_data)
+{
+    if (antiscion_data->antiscion_axis_info) {
+        gswe_antiscion_axis_info_unref(antiscion_data->antiscion_axis_info);
     }
+
+    antiscion_data->antiscion_axis_info = gswe_antiscion_axis_info_ref(
+            gswe_antiscion_axis_info_lookup(GSWE_ANTISCION_AXIS_NONE)
+        );
+    antiscion_data->difference = 0.0;
 }
 
 /**
@@ -207,7 +234,7 @@ gswe_antiscion_data_new_with_planets(
 GsweAntiscionData *
 gswe_antiscion_data_ref(GsweAntiscionData *antiscion_data)
 {
-    antiscion_data->refcount++;
+    g_atomic_int_inc(&antiscion_data->refcount);
 
     return antiscion_data;
 }
@@ -226,7 +253,7 @@ gswe_antiscion_data_unref(GsweAntiscionData *antiscion_data)
         return;
     }
 
-    if (--antiscion_data->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&antiscion_data->refcount)) {
         gswe_antiscion_data_free(antiscion_data);
     }
 }
@@ -317,10 +344,7 @@ gswe_antiscion_data_set_axis(
 {
     GsweAntiscionAxisInfo *antiscion_axis_info;
 
-    if ((antiscion_axis_info = g_hash_table_lookup(
-                    gswe_antiscion_axis_info_table,
-                    GINT_TO_POINTER(axis)
-                )) == NULL) {
+    if ((antiscion_axis_info = gswe_antiscion_axis_info_lookup(axis)) == NULL) {
         g_set_error(
                 err,
                 GSWE_ERROR, GSWE_ERROR_UNKNOWN_ANTISCION_AXIS,
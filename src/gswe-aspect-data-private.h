@@ -40,9 +40,15 @@ struct _GsweAspectData {
     gdouble difference;
 
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
+void gswe_aspect_classifier_init(void);
+
+void gswe_aspect_classifier_update(GsweAspectInfo *aspect_info);
+
+void gswe_aspect_data_clear(GsweAspectData *aspect_data);
+
 void gswe_aspect_data_calculate(GsweAspectData *aspect_data);
 
 #endif /* __SWE_GLIB_GSWE_ASPECT_DATA_PRIVATE_H__ */
@@ -63,51 +63,275 @@ gswe_aspect_data_free(GsweAspectData *aspect_data)
     g_free(aspect_data);
 }
 
+/* The number of classifier bins in one degree of planet distance */
+#define GSWE_ASPECT_CLASSIFIER_RESOLUTION 10
+
+/* The number of classifier bins covering the [0; 180] range */
+#define GSWE_ASPECT_CLASSIFIER_BINS (180 * GSWE_ASPECT_CLASSIFIER_RESOLUTION + 1)
+
+/* Classifier bin values that are not an index in classifier_aspects */
+#define GSWE_ASPECT_CLASSIFIER_NONE -1
+#define GSWE_ASPECT_CLASSIFIER_CHECK -2
+
+/* The number of distances gswe_classify_aspects() folds in one run */
+#define GSWE_ASPECT_CLASSIFIER_CHUNK 256
+
 /*
- * find_aspect:
- * @aspect_p: a pointer made with GINT_TO_POINTER(), holding the aspect ID
- * @aspect_info: a GsweAspectInfo, which will be checked against @aspect_data
- * @aspect_data: a GsweAspectData, whose planets' positions will be checked
- *               against @aspect_info
- *
- * This function is called internally by gswe_aspect_data_calculate() to check
- * if the two planets in @aspect_data are in aspect according to @aspect_info
+ * GsweAspectOrbClass:
+ * @orb: the orb of the planet pairs this class is for
+ * @bin: the aspect of each 1 / GSWE_ASPECT_CLASSIFIER_RESOLUTION
+ *       degree wide distance range. It is either an index in
+ *       classifier_aspects, if every distance in that range is in that
+ *       aspect, GSWE_ASPECT_CLASSIFIER_NONE if no distance in that range is
+ *       in any aspect, or GSWE_ASPECT_CLASSIFIER_CHECK if the range contains
+ *       an orb boundary
+ *
+ * The precalculated aspects of planet pairs with the same orb.
  */
-static gboolean
-find_aspect(
-        gpointer aspect_p,
-        GsweAspectInfo *aspect_info,
-        GsweAspectData *aspect_data)
+typedef struct {
+    gdouble orb;
+    gint8 bin[GSWE_ASPECT_CLASSIFIER_BINS];
+} GsweAspectOrbClass;
+
+/* The known aspects (except GSWE_ASPECT_NONE) in the order they are checked,
+ * which is the order of their IDs */
+static GsweAspectInfo **classifier_aspects = NULL;
+static guint classifier_aspect_count = 0;
+
+/* One orb class for each different orb in gswe_planet_infos */
+static GsweAspectOrbClass *classifier_orb_classes = NULL;
+static guint classifier_orb_class_count = 0;
+
+static GsweAspectInfo *classifier_no_aspect = NULL;
+
+static inline gdouble
+gswe_aspect_get_orb(GsweAspectInfo *aspect_info, gdouble planet_orb)
 {
-    gdouble diff,
-            planet_orb,
-            aspect_orb;
+    return fmax(1.0, planet_orb - aspect_info->orb_modifier);
+}
 
-    diff = fabs(aspect_info->size - aspect_data->distance);
-    planet_orb = fmin(
-            aspect_data->planet1->planet_info->orb,
-            aspect_data->planet2->planet_info->orb
-        );
-    aspect_orb = fmax(1.0, planet_orb - aspect_info->orb_modifier);
+static inline gdouble
+gswe_aspect_get_difference(GsweAspectInfo *aspect_info, gdouble distance)
+{
+    gdouble diff = fabs(aspect_info->size - distance);
+
+    if (aspect_info->size == 0) {
+        return (1 - ((360.0 - diff) / 360.0)) * 100.0;
+    }
+
+    return (1 - ((aspect_info->size - diff) / aspect_info->size)) * 100.0;
+}
+
+/*
+ * gswe_aspect_classifier_check:
+ * @distance: the distance of two planets, between 0 and 180 degrees
+ * @planet_orb: the orb of the two planets
+ *
+ * Checks @distance against every known aspect, the same way
+ * gswe_aspect_classifier_build_class() does. This is used for distances
+ * close to an orb boundary, and for orbs without an orb class.
+ *
+ * Returns: the index of the matching aspect in classifier_aspects, or
+ *          GSWE_ASPECT_CLASSIFIER_NONE
+ */
+static gint
+gswe_aspect_classifier_check(gdouble distance, gdouble planet_orb)
+{
+    guint i;
+
+    for (i = 0; i < classifier_aspect_count; i++) {
+        GsweAspectInfo *aspect_info = classifier_aspects[i];
+
+        if (
+                fabs(aspect_info->size - distance)
+                < gswe_aspect_get_orb(aspect_info, planet_orb)
+            ) {
+            return i;
+        }
+    }
 
-    if (diff < aspect_orb) {
-        aspect_data->aspect_info = gswe_aspect_info_ref(aspect_info);
+    return GSWE_ASPECT_CLASSIFIER_NONE;
+}
 
-        if (aspect_info->size == 0) {
-            aspect_data->difference = (1 - ((360.0 - diff) / 360.0)) * 100.0;
+static void
+gswe_aspect_classifier_build_class(GsweAspectOrbClass *orb_class)
+{
+    // Allow for rounding errors when mapping a distance to its bin
+    const gdouble epsilon = 1e-9;
+    guint bin;
+
+    for (bin = 0; bin < GSWE_ASPECT_CLASSIFIER_BINS; bin++) {
+        gdouble low = (gdouble)bin / GSWE_ASPECT_CLASSIFIER_RESOLUTION
+                    - epsilon,
+                high = (gdouble)(bin + 1) / GSWE_ASPECT_CLASSIFIER_RESOLUTION
+                    + epsilon;
+        guint i;
+
+        orb_class->bin[bin] = GSWE_ASPECT_CLASSIFIER_NONE;
+
+        // The first aspect whose orb overlaps with this bin decides. If it
+        // covers the whole bin, every distance in it is in that aspect
+        for (i = 0; i < classifier_aspect_count; i++) {
+            GsweAspectInfo *aspect_info = classifier_aspects[i];
+            gdouble orb = gswe_aspect_get_orb(aspect_info, orb_class->orb);
+
+            if (
+                    (high <= aspect_info->size - orb)
+                    || (low >= aspect_info->size + orb)
+                ) {
+                continue;
+            }
+
+            if (
+                    (low > aspect_info->size - orb)
+                    && (high < aspect_info->size + orb)
+                ) {
+                orb_class->bin[bin] = i;
+            } else {
+                orb_class->bin[bin] = GSWE_ASPECT_CLASSIFIER_CHECK;
+            }
+
+            break;
+        }
+    }
+}
+
+/*
+ * gswe_aspect_classifier_init:
+ *
+ * Builds the aspect classifier tables from gswe_aspect_infos and
+ * gswe_planet_infos. Called by gswe_init_with_dir().
+ */
+void
+gswe_aspect_classifier_init(void)
+{
+    GsweAspectInfo *aspect_info;
+    GswePlanetInfo *planet_info;
+    gint aspect,
+         slot;
+    guint i;
+
+    classifier_aspects = g_new(GsweAspectInfo *, GSWE_ASPECT_COUNT);
+
+    for (aspect = 0; aspect < GSWE_ASPECT_COUNT; aspect++) {
+        if ((aspect_info = gswe_aspect_info_lookup(aspect)) == NULL) {
+            continue;
+        }
+
+        if (aspect_info->aspect == GSWE_ASPECT_NONE) {
+            classifier_no_aspect = aspect_info;
         } else {
-            aspect_data->difference = (1
-                    - ((aspect_info->size - diff) / aspect_info->size)) * 100.0;
+            classifier_aspects[classifier_aspect_count++] = aspect_info;
+        }
+    }
+
+    classifier_orb_classes = g_new(GsweAspectOrbClass, GSWE_PLANET_SLOT_COUNT);
+
+    for (slot = 0; slot < GSWE_PLANET_SLOT_COUNT; slot++) {
+        planet_info = &gswe_planet_infos[slot];
+
+        if (planet_info->refcount == 0) {
+            continue;
+        }
+
+        for (i = 0; i < classifier_orb_class_count; i++) {
+            if (classifier_orb_classes[i].orb == planet_info->orb) {
+                break;
+            }
+        }
+
+        if (i == classifier_orb_class_count) {
+            classifier_orb_classes[classifier_orb_class_count].orb
+                = planet_info->orb;
+            gswe_aspect_classifier_build_class(
+                    &classifier_orb_classes[classifier_orb_class_count++]
+                );
+        }
+    }
+}
+
+/*
+ * gswe_aspect_classifier_update:
+ * @aspect_info: the #GsweAspectInfo that has changed
+ *
+ * Rebuilds the orb classes after the size or the orb modifier of
+ * @aspect_info has changed, if the classifier uses @aspect_info. Called by
+ * the setters of #GsweAspectInfo.
+ *
+ * The bins are rebuilt in place without a lock, so this must not run while
+ * other threads classify aspects. The setters are documented as
+ * initialization only for this reason.
+ */
+void
+gswe_aspect_classifier_update(GsweAspectInfo *aspect_info)
+{
+    guint i;
+
+    for (i = 0; i < classifier_aspect_count; i++) {
+        if (classifier_aspects[i] == aspect_info) {
+            break;
+        }
+    }
+
+    if (i == classifier_aspect_count) {
+        return;
+    }
+
+    for (i = 0; i < classifier_orb_class_count; i++) {
+        gswe_aspect_classifier_build_class(&classifier_orb_classes[i]);
+    }
+}
+
+static GsweAspectOrbClass *
+gswe_aspect_classifier_find_class(gdouble planet_orb)
+{
+    guint i;
+
+    for (i = 0; i < classifier_orb_class_count; i++) {
+        if (classifier_orb_classes[i].orb == planet_orb) {
+            return &classifier_orb_classes[i];
         }
+    }
+
+    return NULL;
+}
 
-        return TRUE;
+static inline gint
+gswe_aspect_classify(
+        GsweAspectOrbClass *orb_class,
+        gdouble distance,
+        gdouble planet_orb)
+{
+    gint aspect;
+
+    // A NaN or infinite distance has no bin; the exact check finds no aspect
+    // for it
+    if ((orb_class == NULL) || !isfinite(distance)) {
+        return gswe_aspect_classifier_check(distance, planet_orb);
+    }
+
+    aspect = orb_class->bin[
+            (guint)(distance * GSWE_ASPECT_CLASSIFIER_RESOLUTION)
+        ];
+
+    if (aspect == GSWE_ASPECT_CLASSIFIER_CHECK) {
+        return gswe_aspect_classifier_check(distance, planet_orb);
     }
 
-    return FALSE;
+    return aspect;
 }
 
+/*
+ * gswe_aspect_data_clear:
+ * @aspect_data: a #GsweAspectData
+ *
+ * Calculates the distance between the planets of @aspect_data, and marks the
+ * two planets as having no aspect, without checking the aspect table. This
+ * is used internally by #GsweMoment for planet pairs that are known to be out
+ * of any aspect's orb.
+ */
 void
-gswe_aspect_data_calculate(GsweAspectData *aspect_data)
+gswe_aspect_data_clear(GsweAspectData *aspect_data)
 {
     if ((aspect_data->distance = fabs(
                     aspect_data->planet1->position
@@ -116,18 +340,107 @@ gswe_aspect_data_calculate(GsweAspectData *aspect_data)
         aspect_data->distance = 360.0 - aspect_data->distance;
     }
 
-    if ((aspect_data->aspect_info = g_hash_table_find(
-                    gswe_aspect_info_table,
-                    (GHRFunc)find_aspect, aspect_data
-                )) == NULL) {
+    if (aspect_data->aspect_info) {
+        gswe_aspect_info_unref(aspect_data->aspect_info);
+    }
+
+    aspect_data->aspect_info = gswe_aspect_info_ref(classifier_no_aspect);
+    aspect_data->difference = 0.0;
+}
+
+void
+gswe_aspect_data_calculate(GsweAspectData *aspect_data)
+{
+    gdouble planet_orb;
+    gint aspect;
+
+    gswe_aspect_data_clear(aspect_data);
+
+    planet_orb = fmin(
+            aspect_data->planet1->planet_info->orb,
+            aspect_data->planet2->planet_info->orb
+        );
+
+    if ((aspect = gswe_aspect_classify(
+                    gswe_aspect_classifier_find_class(planet_orb),
+                    aspect_data->distance,
+                    planet_orb
+                )) != GSWE_ASPECT_CLASSIFIER_NONE) {
+        gswe_aspect_info_unref(aspect_data->aspect_info);
         aspect_data->aspect_info = gswe_aspect_info_ref(
-                g_hash_table_lookup(
-                        gswe_aspect_info_table,
-                        GINT_TO_POINTER(GSWE_ASPECT_NONE)
-                    )
+                classifier_aspects[aspect]
             );
-    } else {
-        gswe_aspect_info_ref(aspect_data->aspect_info);
+        aspect_data->difference = gswe_aspect_get_difference(
+                aspect_data->aspect_info,
+                aspect_data->distance
+            );
+    }
+}
+
+/**
+ * gswe_classify_aspects:
+ * @distances: (array length=count) (in): planet distances, in degrees
+ * @count: the number of elements in @distances
+ * @planet_orb: the orb of the planet pairs. This is the smaller orb of the two
+ *              planets, as returned by gswe_planet_info_get_orb()
+ * @aspects: (array length=count) (out caller-allocates): an array of @count
+ *           elements to store the aspect of each distance in
+ * @differences: (array length=count) (out caller-allocates) (allow-none): an
+ *               array of @count elements to store the difference of each
+ *               aspect from the exact aspect, in percent, or %NULL
+ *
+ * Classifies a series of planet distances, the same way #GsweAspectData does
+ * for a single pair of planets. Distances may be outside of the [0; 180]
+ * range; they are folded into it first.
+ *
+ * Since: 2.2
+ */
+void
+gswe_classify_aspects(
+        const gdouble *distances,
+        guint count,
+        gdouble planet_orb,
+        GsweAspect *aspects,
+        gdouble *differences)
+{
+    GsweAspectOrbClass *orb_class;
+    gdouble folded[GSWE_ASPECT_CLASSIFIER_CHUNK];
+    guint offset;
+
+    gswe_init();
+
+    orb_class = gswe_aspect_classifier_find_class(planet_orb);
+
+    for (offset = 0; offset < count; offset += GSWE_ASPECT_CLASSIFIER_CHUNK) {
+        guint chunk = MIN(count - offset, GSWE_ASPECT_CLASSIFIER_CHUNK),
+              i;
+
+        // Fold the distances first, in a branch-free loop the compiler can
+        // vectorize…
+        for (i = 0; i < chunk; i++) {
+            gdouble distance = fmod(fabs(distances[offset + i]), 360.0);
+
+            folded[i] = fmin(distance, 360.0 - distance);
+        }
+
+        // …then look them up
+        for (i = 0; i < chunk; i++) {
+            GsweAspectInfo *aspect_info;
+            gint aspect;
+
+            aspect = gswe_aspect_classify(orb_class, folded[i], planet_orb);
+            aspect_info = (aspect == GSWE_ASPECT_CLASSIFIER_NONE)
+                ? classifier_no_aspect
+                : classifier_aspects[aspect];
+            aspects[offset + i] = aspect_info->aspect;
+
+            if (differences) {
+                differences[offset + i]
+                    = (aspect == GSWE_ASPECT_CLASSIFIER_NONE)
+                        ? 0.0
+                        : gswe_aspect_get_difference(aspect_info, folded[i]);
+            }
+        }
     }
 }
 
@@ -188,7 +501,7 @@ gswe_aspect_data_new_with_planets(
 GsweAspectData *
 gswe_aspect_data_ref(GsweAspectData *aspect_data)
 {
-    aspect_data->refcount++;
+    g_atomic_int_inc(&aspect_data->refcount);
 
     return aspect_data;
 }
@@ -207,7 +520,7 @@ gswe_aspect_data_unref(GsweAspectData *aspect_data)
         return;
     }
 
-    if (--aspect_data->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&aspect_data->refcount)) {
         gswe_aspect_data_free(aspect_data);
     }
 }
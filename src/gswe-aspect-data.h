@@ -70,6 +70,13 @@ GsweAspectInfo *gswe_aspect_data_get_aspect_info(GsweAspectData *aspect_data);
 
 gdouble gswe_aspect_data_get_difference(GsweAspectData *aspect_data);
 
+void gswe_classify_aspects(
+        const gdouble *distances,
+        guint count,
+        gdouble planet_orb,
+        GsweAspect *aspects,
+        gdouble *differences);
+
 G_END_DECLS
 
 #endif /* __SWE_GLIB_GSWE_ASPECT_DATA_H__ */
@@ -29,6 +29,10 @@ struct _GsweAspectInfo {
     /* the name of the aspect */
     gchar *name;
 
+    /* the untranslated name of the built-in records, used while name is not
+     * set */
+    const gchar *msgid;
+
     /* the size of the aspect, in degrees */
     guint size;
 
@@ -43,7 +47,7 @@ struct _GsweAspectInfo {
     gboolean major;
 
     /** reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_ASPECT_INFO_PRIVATE_H__ */
@@ -18,6 +18,7 @@
 #include <glib-object.h>
 
 #include "gswe-types.h"
+#include "swe-glib-private.h"
 #include "gswe-aspect-info.h"
 #include "gswe-aspect-info-private.h"
 
@@ -83,7 +84,7 @@ gswe_aspect_info_new(void)
 GsweAspectInfo *
 gswe_aspect_info_ref(GsweAspectInfo *aspect_info)
 {
-    aspect_info->refcount++;
+    g_atomic_int_inc(&aspect_info->refcount);
 
     return aspect_info;
 }
@@ -98,7 +99,7 @@ gswe_aspect_info_ref(GsweAspectInfo *aspect_info)
 void
 gswe_aspect_info_unref(GsweAspectInfo *aspect_info)
 {
-    if (--aspect_info->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&aspect_info->refcount)) {
         gswe_aspect_info_free(aspect_info);
     }
 }
@@ -149,16 +150,20 @@ gswe_aspect_info_set_name(GsweAspectInfo *aspect_info, const gchar *name)
  * gswe_aspect_info_get_name:
  * @aspect_info: (in): a #GsweAspectInfo
  *
- * Gets the name of this aspect. If NLS is enabled, name is translated in
- * gswe_init(), so if you switch locale in your program, it will remain in the
- * old locale. The returned string should not be freed or modified. It remains
- * valid until @aspect_info exists.
+ * Gets the name of this aspect. If NLS is enabled, the names of the aspects
+ * known by SWE-GLib are translated on every call, so they follow the locale
+ * your program uses at the time of the call. The returned string should not
+ * be freed or modified. It remains valid until @aspect_info exists.
  *
  * Returns: (transfer none): the name of the aspect
  */
 const gchar *
 gswe_aspect_info_get_name(GsweAspectInfo *aspect_info)
 {
+    if ((aspect_info->name == NULL) && (aspect_info->msgid != NULL)) {
+        return gswe_translate(aspect_info->msgid);
+    }
+
     return aspect_info->name;
 }
 
@@ -168,11 +173,17 @@ gswe_aspect_info_get_name(GsweAspectInfo *aspect_info)
  * @size: the new size for @aspect_info, in degrees
  *
  * Sets the size of @aspect info.
+ *
+ * If @aspect_info is one of the aspects known by SWE-GLib, this also rebuilds
+ * the tables shared by all aspect calculations, without any locking. It is
+ * not thread safe: call it only during initialization, before any thread
+ * starts calculating aspects.
  */
 void
 gswe_aspect_info_set_size(GsweAspectInfo *aspect_info, gdouble size)
 {
     aspect_info->size = size;
+    gswe_aspect_classifier_update(aspect_info);
 }
 
 /**
@@ -197,6 +208,9 @@ gswe_aspect_info_get_size(GsweAspectInfo *aspect_info)
  * Sets the orb modifier for @aspect_info. The orb modifier is used in aspect
  * calculation; if the difference between an exact aspect and the distance
  * between two positions exceeds this limit, the aspect is not considered.
+ *
+ * Like gswe_aspect_info_set_size(), this is not thread safe for the aspects
+ * known by SWE-GLib, and should only be called during initialization.
  */
 void
 gswe_aspect_info_set_orb_modifier(
@@ -204,6 +218,7 @@ gswe_aspect_info_set_orb_modifier(
         gdouble orb_modifier)
 {
     aspect_info->orb_modifier = orb_modifier;
+    gswe_aspect_classifier_update(aspect_info);
 }
 
 /**
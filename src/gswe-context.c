@@ -0,0 +1,181 @@
+/* gswe-context.c: Calculation context GObject for SWE-GLib
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#include "swe-glib.h"
+#include "swe-glib-private.h"
+#include "gswe-context.h"
+#include "gswe-context-private.h"
+
+#include "../swe/src/swephexp.h"
+
+/**
+ * SECTION:gswe-context
+ * @short_description: an independent set of Swiss Ephemeris state
+ * @title: GsweContext
+ * @stability: Stable
+ * @include: swe-glib/swe-glib.h
+ *
+ * The Swiss Ephemeris keeps all its state (open ephemeris files, saved
+ * planet positions, the observer's position, and so on) per thread. When
+ * one thread alternates between moments observed from different places,
+ * every switch throws away the saved positions.
+ *
+ * A #GsweContext is a separate copy of that state. Moments that have a
+ * context set with gswe_moment_set_context() do their calculations with
+ * it, so every context keeps its own warm caches, and switching between
+ * contexts costs nothing. A context can be shared by moments and threads;
+ * calculations with the same context are serialized.
+ */
+
+#define GSWE_CONTEXT_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE( \
+            (obj), \
+            GSWE_TYPE_CONTEXT, \
+            GsweContextPrivate \
+        ))
+
+/**
+ * GsweContextPrivate:
+ * @swe_context: the Swiss Ephemeris calculation context
+ * @previous: the calculation context that was active in the thread before
+ *            gswe_context_enter()
+ * @depth: the number of gswe_context_enter() calls not yet left
+ * @path_is_set: %TRUE if the ephemeris path has been set in @swe_context
+ * @lock: a lock held between gswe_context_enter() and gswe_context_leave()
+ *
+ * The private parts of #GsweContext
+ */
+struct _GsweContextPrivate {
+    struct swe_context *swe_context;
+    struct swe_context *previous;
+    guint depth;
+    gboolean path_is_set;
+    GRecMutex lock;
+};
+
+static void gswe_context_finalize(GObject *gobject);
+
+G_DEFINE_TYPE(GsweContext, gswe_context, G_TYPE_OBJECT);
+
+static void
+gswe_context_class_init(GsweContextClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+
+    g_type_class_add_private(klass, sizeof(GsweContextPrivate));
+
+    gobject_class->finalize = gswe_context_finalize;
+}
+
+static void
+gswe_context_init(GsweContext *context)
+{
+    context->priv = GSWE_CONTEXT_GET_PRIVATE(context);
+
+    if ((context->priv->swe_context = swe_context_new()) == NULL) {
+        g_error("Could not allocate a Swiss Ephemeris context");
+    }
+
+    context->priv->previous = NULL;
+    context->priv->depth = 0;
+    context->priv->path_is_set = FALSE;
+    g_rec_mutex_init(&context->priv->lock);
+}
+
+static void
+gswe_context_finalize(GObject *gobject)
+{
+    GsweContext *context = GSWE_CONTEXT(gobject);
+
+    swe_context_free(context->priv->swe_context);
+    g_rec_mutex_clear(&context->priv->lock);
+
+    G_OBJECT_CLASS(gswe_context_parent_class)->finalize(gobject);
+}
+
+/*
+ * gswe_context_enter:
+ * @context: (allow-none): a #GsweContext, or %NULL
+ *
+ * Makes @context the Swiss Ephemeris state of the calling thread, until
+ * gswe_context_leave() is called. With %NULL, the thread's own state is used,
+ * just like before #GsweContext existed. Calls may be nested.
+ */
+void
+gswe_context_enter(GsweContext *context)
+{
+    gswe_thread_init();
+
+    if (context == NULL) {
+        return;
+    }
+
+    g_rec_mutex_lock(&context->priv->lock);
+
+    if (context->priv->depth++ > 0) {
+        return;
+    }
+
+    context->priv->previous = swe_context_get_current();
+    swe_context_switch(context->priv->swe_context, NULL);
+
+    if (!context->priv->path_is_set) {
+        swe_set_ephe_path(gswe_ephe_path);
+        context->priv->path_is_set = TRUE;
+    }
+
+    swe_set_interpolate_nut(gswe_get_interpolate_nutation());
+}
+
+/*
+ * gswe_context_leave:
+ * @context: (allow-none): the #GsweContext passed to gswe_context_enter()
+ *
+ * Gives back the Swiss Ephemeris state the calling thread had before the
+ * matching gswe_context_enter() call.
+ */
+void
+gswe_context_leave(GsweContext *context)
+{
+    if (context == NULL) {
+        return;
+    }
+
+    if (--context->priv->depth == 0) {
+        swe_context_switch(context->priv->previous, NULL);
+        context->priv->previous = NULL;
+    }
+
+    g_rec_mutex_unlock(&context->priv->lock);
+}
+
+/**
+ * gswe_context_new:
+ *
+ * Creates a new calculation context, with an empty set of Swiss Ephemeris
+ * state. It uses the ephemeris directory SWE-GLib was initialized with.
+ *
+ * Returns: (transfer full): a new #GsweContext
+ *
+ * Since: 2.2
+ */
+GsweContext *
+gswe_context_new(void)
+{
+    gswe_init();
+
+    return GSWE_CONTEXT(g_object_new(GSWE_TYPE_CONTEXT, NULL));
+}
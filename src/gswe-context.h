@@ -0,0 +1,90 @@
+/* gswe-context.h - Calculation context GObject for SWE-GLib
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SWE_GLIB_GSWE_CONTEXT_H__
+#define __SWE_GLIB_GSWE_CONTEXT_H__
+
+#include <glib-object.h>
+
+#define GSWE_TYPE_CONTEXT             (gswe_context_get_type())
+#define GSWE_CONTEXT(obj)             (G_TYPE_CHECK_INSTANCE_CAST( \
+            (obj), \
+            GSWE_TYPE_CONTEXT, \
+            GsweContext))
+#define GSWE_IS_CONTEXT(obj)          (G_TYPE_CHECK_INSTANCE_TYPE( \
+            (obj), \
+            GSWE_TYPE_CONTEXT))
+#define GSWE_CONTEXT_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST( \
+            (klass), \
+            GSWE_TYPE_CONTEXT, \
+            GsweContextClass))
+#define GSWE_IS_CONTEXT_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE( \
+            (klass), \
+            GSWE_TYPE_CONTEXT))
+#define GSWE_CONTEXT_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS((obj), \
+            GSWE_TYPE_CONTEXT, \
+            GsweContextClass))
+
+typedef struct _GsweContext GsweContext;
+typedef struct _GsweContextClass GsweContextClass;
+typedef struct _GsweContextPrivate GsweContextPrivate;
+
+/**
+ * GsweContext:
+ *
+ * The GsweContext object's instance definition.
+ */
+struct _GsweContext {
+    /* Parent instance structure */
+    GObject parent_instance;
+
+    /* Instance members */
+
+    /*< private >*/
+    GsweContextPrivate *priv;
+};
+
+/**
+ * GsweContextClass:
+ * @parent_class: the parent class structure (#GObjectClass)
+ *
+ * The GsweContext object's class definition.
+ */
+struct _GsweContextClass {
+    /* Parent class */
+    GObjectClass parent_class;
+
+    /*< private >*/
+    /* Padding for future expansion */
+    void (*_swe_glib_reserved1)(void);
+    void (*_swe_glib_reserved2)(void);
+    void (*_swe_glib_reserved3)(void);
+    void (*_swe_glib_reserved4)(void);
+    void (*_swe_glib_reserved5)(void);
+    void (*_swe_glib_reserved6)(void);
+    void (*_swe_glib_reserved7)(void);
+    void (*_swe_glib_reserved8)(void);
+    void (*_swe_glib_reserved9)(void);
+    void (*_swe_glib_reserved10)(void);
+};
+
+GType gswe_context_get_type(void);
+
+/* Method definitions */
+GsweContext *gswe_context_new(void);
+
+#endif /* __SWE_GLIB_GSWE_CONTEXT_H__ */
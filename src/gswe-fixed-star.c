@@ -0,0 +1,383 @@
+/* gswe-fixed-star.c: Fixed star catalogue
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+
+#include "swe-glib-private.h"
+#include "swe-glib.h"
+#include "gswe-fixed-star.h"
+#include "gswe-fixed-star-private.h"
+
+#include "../swe/src/swephexp.h"
+
+/**
+ * SECTION:gswe-fixed-star
+ * @short_description: a structure representing a fixed star
+ * @title: GsweFixedStar
+ * @stability: Stable
+ * @include: swe-glib.h
+ *
+ * #GsweFixedStar represents a star of the Swiss Ephemeris star catalogue
+ * (<filename>sefstars.txt</filename>, or the older
+ * <filename>fixstars.cat</filename>).
+ *
+ * The catalogue is read from the ephemeris directory only once, by
+ * gswe_fixed_star_catalogue_load() or by the first star lookup. It is then
+ * kept in memory, indexed by the traditional names, the Bayer/Flamsteed
+ * designations and the sequence numbers of the stars, and shared by all
+ * threads. Later lookups, and the position calculations of the Swiss
+ * Ephemeris, don't read the file again.
+ */
+
+G_DEFINE_BOXED_TYPE(
+        GsweFixedStar,
+        gswe_fixed_star,
+        (GBoxedCopyFunc)gswe_fixed_star_ref,
+        (GBoxedFreeFunc)gswe_fixed_star_unref);
+
+static volatile gint gswe_fixed_star_count = 0;
+
+/**
+ * gswe_fixed_star_ref:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Increases reference count on @fixed_star by one.
+ *
+ * Returns: (transfer none): the same #GsweFixedStar
+ *
+ * Since: 2.2
+ */
+GsweFixedStar *
+gswe_fixed_star_ref(GsweFixedStar *fixed_star)
+{
+    g_atomic_int_inc(&fixed_star->refcount);
+
+    return fixed_star;
+}
+
+/**
+ * gswe_fixed_star_unref:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Decreases reference count on @fixed_star by one. If reference count drops
+ * to zero, @fixed_star is freed.
+ *
+ * Since: 2.2
+ */
+void
+gswe_fixed_star_unref(GsweFixedStar *fixed_star)
+{
+    if (fixed_star == NULL) {
+        return;
+    }
+
+    if (g_atomic_int_dec_and_test(&fixed_star->refcount)) {
+        g_free(fixed_star->name);
+        g_free(fixed_star->nomenclature);
+        g_free(fixed_star);
+    }
+}
+
+/**
+ * gswe_fixed_star_get_number:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Gets the sequence number of @fixed_star in the star catalogue. The first
+ * star has number 1.
+ *
+ * Returns: the sequence number of the star
+ *
+ * Since: 2.2
+ */
+guint
+gswe_fixed_star_get_number(GsweFixedStar *fixed_star)
+{
+    return fixed_star->number;
+}
+
+/**
+ * gswe_fixed_star_get_name:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Gets the traditional name of @fixed_star.
+ *
+ * Returns: (transfer none): the name of the star
+ *
+ * Since: 2.2
+ */
+const gchar *
+gswe_fixed_star_get_name(GsweFixedStar *fixed_star)
+{
+    return fixed_star->name;
+}
+
+/**
+ * gswe_fixed_star_get_nomenclature:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Gets the Bayer or Flamsteed designation of @fixed_star, like
+ * <literal>alTau</literal> for Aldebaran.
+ *
+ * Returns: (transfer none): the nomenclature name of the star
+ *
+ * Since: 2.2
+ */
+const gchar *
+gswe_fixed_star_get_nomenclature(GsweFixedStar *fixed_star)
+{
+    return fixed_star->nomenclature;
+}
+
+/**
+ * gswe_fixed_star_get_magnitude:
+ * @fixed_star: (in): a #GsweFixedStar
+ *
+ * Gets the visual magnitude of @fixed_star.
+ *
+ * Returns: the magnitude of the star
+ *
+ * Since: 2.2
+ */
+gdouble
+gswe_fixed_star_get_magnitude(GsweFixedStar *fixed_star)
+{
+    return fixed_star->magnitude;
+}
+
+/**
+ * gswe_fixed_star_catalogue_load:
+ * @err: a #GError
+ *
+ * Loads the star catalogue from the ephemeris directory into memory. It is
+ * not necessary to call this function, as the catalogue is loaded upon the
+ * first lookup, but it may be used to do it at a convenient time. Once the
+ * catalogue is loaded, this function returns immediately.
+ *
+ * Returns: TRUE if the catalogue is loaded, FALSE otherwise
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_fixed_star_catalogue_load(GError **err)
+{
+    gint32 count;
+    gchar serr[AS_MAXCH];
+
+    gswe_init();
+
+    // The catalogue is shared by all threads, and never unloaded
+    if (g_atomic_int_get(&gswe_fixed_star_count) > 0) {
+        return TRUE;
+    }
+
+    if ((count = swe_fixstar_load(serr)) == ERR) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
+                "Swiss Ephemeris fatal error: %s",
+                serr
+            );
+
+        return FALSE;
+    }
+
+    g_atomic_int_set(&gswe_fixed_star_count, count);
+
+    return TRUE;
+}
+
+/**
+ * gswe_fixed_star_catalogue_get_count:
+ *
+ * Gets the number of stars in the star catalogue.
+ *
+ * Returns: the number of stars, or 0 if the catalogue is not loaded yet
+ *
+ * Since: 2.2
+ */
+guint
+gswe_fixed_star_catalogue_get_count(void)
+{
+    return g_atomic_int_get(&gswe_fixed_star_count);
+}
+
+/**
+ * gswe_fixed_star_lookup:
+ * @name: the name of a star
+ * @err: a #GError
+ *
+ * Looks up a star in the star catalogue, loading the catalogue first if
+ * needed. @name may be the traditional name of the star (like
+ * <literal>Aldebaran</literal>; case insensitive, and the first star whose
+ * name begins with @name is returned), its nomenclature name prefixed with
+ * a comma (like <literal>,alTau</literal>), or its sequence number.
+ *
+ * Returns: (transfer full): a new #GsweFixedStar, or NULL if the star can
+ *          not be found
+ *
+ * Since: 2.2
+ */
+GsweFixedStar *
+gswe_fixed_star_lookup(const gchar *name, GError **err)
+{
+    gchar star[2 * SE_MAX_STNAME + 1],
+          serr[AS_MAXCH],
+          *comma;
+    gint32 number;
+    gdouble magnitude;
+    GsweFixedStar *ret;
+
+    if (!gswe_fixed_star_catalogue_load(err)) {
+        return NULL;
+    }
+
+    g_strlcpy(star, name, SE_MAX_STNAME + 1);
+
+    if ((number = swe_fixstar_index(star, serr)) == ERR) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_UNKNOWN_STAR,
+                "%s",
+                serr
+            );
+
+        return NULL;
+    }
+
+    ret = g_new0(GsweFixedStar, 1);
+    ret->refcount = 1;
+    ret->number = number;
+
+    if ((comma = strchr(star, ',')) != NULL) {
+        ret->name = g_strndup(star, comma - star);
+        ret->nomenclature = g_strdup(comma + 1);
+    } else {
+        ret->name = g_strdup(star);
+    }
+
+    /* The catalogue is in memory, so this does not read the file */
+    g_snprintf(star, sizeof(star), "%d", number);
+
+    if (swe_fixstar_mag(star, &magnitude, serr) != ERR) {
+        ret->magnitude = magnitude;
+    }
+
+    return ret;
+}
+
+/**
+ * gswe_fixed_star_lookup_by_number:
+ * @number: the sequence number of a star
+ * @err: a #GError
+ *
+ * Looks up a star in the star catalogue by its sequence number, loading the
+ * catalogue first if needed. The first star has number 1.
+ *
+ * Returns: (transfer full): a new #GsweFixedStar, or NULL if there is no star
+ *          with this number
+ *
+ * Since: 2.2
+ */
+GsweFixedStar *
+gswe_fixed_star_lookup_by_number(guint number, GError **err)
+{
+    gchar name[16];
+
+    if (number == 0) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_UNKNOWN_STAR,
+                "Star numbers start from 1"
+            );
+
+        return NULL;
+    }
+
+    g_snprintf(name, sizeof(name), "%u", number);
+
+    return gswe_fixed_star_lookup(name, err);
+}
+
+/**
+ * gswe_fixed_star_catalogue_calculate:
+ * @timestamp: a #GsweTimestamp
+ * @longitude: (out caller-allocates) (array) (allow-none): an array to hold
+ *             the ecliptic longitudes of the stars
+ * @latitude: (out caller-allocates) (array) (allow-none): an array to hold
+ *            the ecliptic latitudes of the stars
+ * @right_ascension: (out caller-allocates) (array) (allow-none): an array to
+ *                   hold the right ascensions of the stars
+ * @declination: (out caller-allocates) (array) (allow-none): an array to
+ *               hold the declinations of the stars
+ * @err: a #GError
+ *
+ * Calculates the apparent geocentric positions of every star in the star
+ * catalogue at @timestamp, all in degrees. The catalogue must be loaded
+ * with gswe_fixed_star_catalogue_load(), and each array must have room for
+ * gswe_fixed_star_catalogue_get_count() values; the value for a star is
+ * stored at the index gswe_fixed_star_get_number() - 1. Any of the arrays
+ * may be %NULL if the corresponding coordinate is not needed.
+ *
+ * This is much faster than calculating the stars one by one, as proper
+ * motion, light deflection, aberration, precession and nutation are
+ * applied to the whole catalogue at once.
+ *
+ * Returns: TRUE if the positions are calculated, FALSE otherwise
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_fixed_star_catalogue_calculate(
+        GsweTimestamp *timestamp,
+        gdouble *longitude,
+        gdouble *latitude,
+        gdouble *right_ascension,
+        gdouble *declination,
+        GError **err)
+{
+    gdouble jd;
+    gchar serr[AS_MAXCH];
+    GError *calc_err = NULL;
+
+    jd = gswe_timestamp_get_julian_day_et(timestamp, &calc_err);
+
+    if (calc_err) {
+        g_propagate_error(err, calc_err);
+
+        return FALSE;
+    }
+
+    gswe_init();
+
+    if (swe_fixstar_all(
+                jd, SEFLG_SWIEPH,
+                longitude, latitude,
+                right_ascension, declination,
+                serr
+            ) == ERR) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
+                "Swiss Ephemeris fatal error: %s",
+                serr
+            );
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
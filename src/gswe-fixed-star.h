@@ -0,0 +1,71 @@
+/* gswe-fixed-star.h: Fixed star catalogue
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SWE_GLIB_GSWE_FIXED_STAR_H__
+#define __SWE_GLIB_GSWE_FIXED_STAR_H__
+
+#include <glib-object.h>
+
+#include "gswe-timestamp.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GsweFixedStar:
+ *
+ * <structname>GsweFixedStar</structname> is an opaque structure whose members
+ * cannot be accessed directly.
+ *
+ * Since: 2.2
+ */
+typedef struct _GsweFixedStar GsweFixedStar;
+
+GType gswe_fixed_star_get_type(void);
+#define GSWE_TYPE_FIXED_STAR (gswe_fixed_star_get_type())
+
+GsweFixedStar *gswe_fixed_star_ref(GsweFixedStar *fixed_star);
+
+void gswe_fixed_star_unref(GsweFixedStar *fixed_star);
+
+guint gswe_fixed_star_get_number(GsweFixedStar *fixed_star);
+
+const gchar *gswe_fixed_star_get_name(GsweFixedStar *fixed_star);
+
+const gchar *gswe_fixed_star_get_nomenclature(GsweFixedStar *fixed_star);
+
+gdouble gswe_fixed_star_get_magnitude(GsweFixedStar *fixed_star);
+
+gboolean gswe_fixed_star_catalogue_load(GError **err);
+
+guint gswe_fixed_star_catalogue_get_count(void);
+
+GsweFixedStar *gswe_fixed_star_lookup(const gchar *name, GError **err);
+
+GsweFixedStar *gswe_fixed_star_lookup_by_number(guint number, GError **err);
+
+gboolean gswe_fixed_star_catalogue_calculate(
+        GsweTimestamp *timestamp,
+        gdouble *longitude,
+        gdouble *latitude,
+        gdouble *right_ascension,
+        gdouble *declination,
+        GError **err);
+
+G_END_DECLS
+
+#endif /* __SWE_GLIB_GSWE_FIXED_STAR_H__ */
+
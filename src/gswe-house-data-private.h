@@ -34,7 +34,7 @@ struct _GsweHouseData {
     GsweSignInfo *sign_info;
 
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_HOUSE_DATA_PRIVATE_H__ */
@@ -79,7 +79,7 @@ gswe_house_data_new(void)
 GsweHouseData *
 gswe_house_data_ref(GsweHouseData *house_data)
 {
-    house_data->refcount++;
+    g_atomic_int_inc(&house_data->refcount);
 
     return house_data;
 }
@@ -98,7 +98,7 @@ gswe_house_data_unref(GsweHouseData *house_data)
         return;
     }
 
-    if (--house_data->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&house_data->refcount)) {
         gswe_house_data_free(house_data);
     }
 }
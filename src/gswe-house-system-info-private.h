@@ -34,8 +34,12 @@ struct _GsweHouseSystemInfo {
     /* the name of this house system */
     gchar *name;
 
+    /* the untranslated name of the built-in records, used while name is not
+     * set */
+    const gchar *msgid;
+
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_HOUSE_SYSTEM_INFO_PRIVATE_H__ */
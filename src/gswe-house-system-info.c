@@ -16,6 +16,7 @@
  * along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 #include "gswe-types.h"
+#include "swe-glib-private.h"
 #include "gswe-house-system-info.h"
 #include "gswe-house-system-info-private.h"
 
@@ -75,7 +76,7 @@ gswe_house_system_info_new(void)
 GsweHouseSystemInfo *
 gswe_house_system_info_ref(GsweHouseSystemInfo *house_system_info)
 {
-    house_system_info->refcount++;
+    g_atomic_int_inc(&house_system_info->refcount);
 
     return house_system_info;
 }
@@ -90,7 +91,7 @@ gswe_house_system_info_ref(GsweHouseSystemInfo *house_system_info)
 void
 gswe_house_system_info_unref(GsweHouseSystemInfo *house_system_info)
 {
-    if (--house_system_info->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&house_system_info->refcount)) {
         gswe_house_system_info_free(house_system_info);
     }
 }
@@ -177,13 +178,22 @@ gswe_house_system_info_set_name(
  * gswe_house_system_info_get_name:
  * @house_system_info: (in): a #GsweHouseSystemInfo
  *
- * Gets the name of the house system.
+ * Gets the name of the house system. If NLS is enabled, the names of the house
+ * systems known by SWE-GLib are translated on every call, so they follow the
+ * current locale.
  *
  * Returns: (transfer none): the name of the house system
  */
 const gchar *
 gswe_house_system_info_get_name(GsweHouseSystemInfo *house_system_info)
 {
+    if (
+                (house_system_info->name == NULL)
+                && (house_system_info->msgid != NULL)
+            ) {
+        return gswe_translate(house_system_info->msgid);
+    }
+
     return house_system_info->name;
 }
 
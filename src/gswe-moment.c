@@ -39,6 +39,28 @@
             GSWE_TYPE_MOMENT, \
             GsweMomentPrivate))
 
+/* The most houses a house system may have (the Gauquelin sectors) */
+#define GSWE_MOMENT_MAX_HOUSES 36
+
+/*
+ * GsweMomentHouseCusps:
+ * @count: the number of houses, or 0 if they are not calculated
+ * @clockwise: TRUE if the houses follow each other clockwise (in decreasing
+ *             longitude), like the Gauquelin sectors do
+ * @start: the cusp of the first house
+ * @offset: the distance of each house cusp from @start, in the direction of
+ *          the houses. @offset[0] is always 0
+ *
+ * The house cusps of a moment, normalized to ascending order, so the house of
+ * a position can be found with a binary search.
+ */
+typedef struct {
+    guint count;
+    gboolean clockwise;
+    gdouble start;
+    gdouble offset[GSWE_MOMENT_MAX_HOUSES];
+} GsweMomentHouseCusps;
+
 /**
  * GsweMomentPrivate:
  * @timestamp: a #GsweTimestmp object representing the current local time at
@@ -51,18 +73,48 @@
  *            that has a *_revision value here will be recalculated before the
  *            data is served
  * @house_list: (element-type GsweHouseData): the list of house data
+ * @house_cusps: the house cusps of @house_list, for finding houses quickly
  * @house_revision: the revision of the calculated house data
- * @planet_list: (element-type GswePlanetData): the list of planets
+ * @planet_list: (element-type GswePlanetData): the list of planets, in the
+ *               order they were added
+ * @planet_table: the same #GswePlanetData structures as in @planet_list,
+ *                indexed by their planet slot (see gswe_planet_get_slot()).
+ *                The table holds no references of its own
+ * @planet_count: the number of planets added to the moment
+ * @planet_index: the position of each planet in @planet_list, indexed by
+ *                planet slot
+ * @planet_order: the same #GswePlanetData structures as in @planet_list, in
+ *                the same order
  * @points_revision: the revision of the points
  * @element_points: the table of the element points
  * @quality_points: the table of the quality points
  * @moon_phase_revision: the revision of the Moon phase data
  * @moon_phase: the calculated Moon phase data
- * @aspect_list: (element-type GsweAspectData): the list of calculated aspects
+ * @aspect_list: (element-type GsweAspectData): the list of calculated
+ *               aspects. This is a view of @aspect_matrix, and holds no
+ *               references of its own
+ * @aspect_matrix: the aspect data of every planet pair, stored as a lower
+ *                 triangular matrix (see GSWE_MOMENT_PAIR_INDEX())
+ * @aspect_matrix_planets: the number of planets @aspect_matrix is allocated
+ *                         for
  * @aspect_revision: the revision of the aspect data
  * @antiscia_list: (element-type GsweAntisciaData): the list of calculated
- *                    antiscia (mirror points)
+ *                    antiscia (mirror points). This is a view of
+ *                    @antiscion_matrix, and holds no references of its own
+ * @antiscion_matrix: the antiscion data of every planet pair, stored the same
+ *                    way as @aspect_matrix
+ * @antiscion_matrix_planets: the number of planets @antiscion_matrix is
+ *                            allocated for
  * @antiscia_revision: the revision of the antiscia data
+ * @timestamp_signal_handler: the handler of the ::changed signal of
+ *                            @timestamp
+ * @context: the calculation context, or %NULL to calculate with the state of
+ *           the calling thread
+ * @update_depth: the number of gswe_moment_update_begin() calls not yet
+ *                matched by gswe_moment_update_commit()
+ * @update_pending: %TRUE if @moment changed since the outermost
+ *                  gswe_moment_update_begin(), and the ::changed signal is
+ *                  yet to be emitted
  *
  * The private parts of #GsweMoment
  */
@@ -72,18 +124,30 @@ struct _GsweMomentPrivate {
     GsweHouseSystem house_system;
     guint revision;
     GList *house_list;
+    GsweMomentHouseCusps house_cusps;
     guint house_revision;
     GList *planet_list;
+    GswePlanetData *planet_table[GSWE_PLANET_SLOT_COUNT];
+    guint planet_count;
+    guint planet_index[GSWE_PLANET_SLOT_COUNT];
+    GswePlanetData *planet_order[GSWE_PLANET_SLOT_COUNT];
     guint points_revision;
     GHashTable *element_points;
     GHashTable *quality_points;
     guint moon_phase_revision;
     GsweMoonPhaseData *moon_phase;
     GList *aspect_list;
+    GsweAspectData **aspect_matrix;
+    guint aspect_matrix_planets;
     guint aspect_revision;
     GList *antiscia_list;
+    GsweAntiscionData **antiscion_matrix;
+    guint antiscion_matrix_planets;
     guint antiscia_revision;
     gulong timestamp_signal_handler;
+    GsweContext *context;
+    guint update_depth;
+    gboolean update_pending;
 };
 
 enum {
@@ -97,13 +161,38 @@ enum {
     PROP_TIMESTAMP,
     PROP_COORDINATES,
     PROP_HOUSE_SYSTEM,
+    PROP_CONTEXT,
     PROP_COUNT
 };
 
-struct GsweAspectFinder {
-    GswePlanet planet1;
-    GswePlanet planet2;
-};
+/* The number of planet pairs between @n planets */
+#define GSWE_MOMENT_PAIR_COUNT(n) ((n) * ((n) - 1) / 2)
+
+/* The index of the (@i, @j) planet pair in a triangular pair matrix, where @i
+ * and @j are positions in the planet list, and @i != @j. The order of @i and
+ * @j doesn't matter */
+#define GSWE_MOMENT_PAIR_INDEX(i, j) (((i) < (j)) \
+        ? (GSWE_MOMENT_PAIR_COUNT(j) + (i)) \
+        : (GSWE_MOMENT_PAIR_COUNT(i) + (j)))
+
+/*
+ * GsweMomentCircle:
+ * @count: the number of planets on the circle
+ * @max_orb: the largest orb of all the planets on the circle
+ * @position: the planet positions, in ascending order
+ * @index: the position of each planet in the moment's planet list, in the
+ *         same order as @position
+ *
+ * The planets of a moment, sorted by their position on the ecliptic. Used to
+ * find planet pairs that may be in aspect or antiscion without checking every
+ * pair.
+ */
+typedef struct {
+    guint count;
+    gdouble max_orb;
+    gdouble position[GSWE_PLANET_SLOT_COUNT];
+    guint index[GSWE_PLANET_SLOT_COUNT];
+} GsweMomentCircle;
 
 static guint gswe_moment_signals[SIGNAL_LAST] = {0};
 
@@ -245,6 +334,31 @@ gswe_moment_class_init(GsweMomentClass *klass)
             PROP_HOUSE_SYSTEM,
             properties[PROP_HOUSE_SYSTEM]
         );
+
+    /**
+     * GsweMoment:context:
+     *
+     * The calculation context this moment uses, or %NULL if it calculates
+     * with the Swiss Ephemeris state of the calling thread
+     *
+     * Since: 2.2
+     */
+    properties[PROP_CONTEXT] = g_param_spec_object(
+            "context",
+            "Context",
+            "Calculation context",
+            GSWE_TYPE_CONTEXT,
+            G_PARAM_STATIC_NICK
+            | G_PARAM_STATIC_NAME
+            | G_PARAM_STATIC_BLURB
+            | G_PARAM_READABLE
+            | G_PARAM_WRITABLE
+        );
+    g_object_class_install_property(
+            gobject_class,
+            PROP_CONTEXT,
+            properties[PROP_CONTEXT]
+        );
 }
 
 static void
@@ -253,16 +367,52 @@ gswe_moment_emit_changed(GsweMoment *moment)
     g_signal_emit(moment, gswe_moment_signals[SIGNAL_CHANGED], 0);
 }
 
+/*
+ * gswe_moment_invalidate:
+ * @moment: a #GsweMoment
+ *
+ * Marks every calculated value of @moment as outdated, and emits the
+ * ::changed signal, unless an update is in progress; in that case the signal
+ * is emitted only once, by gswe_moment_update_commit().
+ */
+static void
+gswe_moment_invalidate(GsweMoment *moment)
+{
+    // The revision is bumped even during an update, so data fetched in the
+    // middle of it is not served from the cache later
+    moment->priv->revision++;
+
+    if (moment->priv->update_depth > 0) {
+        moment->priv->update_pending = TRUE;
+
+        return;
+    }
+
+    gswe_moment_emit_changed(moment);
+}
+
 static void
 gswe_moment_init(GsweMoment *moment)
 {
     moment->priv = GSWE_MOMENT_GET_PRIVATE(moment);
 
     moment->priv->timestamp = NULL;
+    moment->priv->context = NULL;
     moment->priv->house_list = NULL;
+    moment->priv->house_cusps.count = 0;
     moment->priv->planet_list = NULL;
+    memset(
+            moment->priv->planet_table,
+            0,
+            sizeof(moment->priv->planet_table)
+        );
+    moment->priv->planet_count = 0;
     moment->priv->aspect_list = NULL;
+    moment->priv->aspect_matrix = NULL;
+    moment->priv->aspect_matrix_planets = 0;
     moment->priv->antiscia_list = NULL;
+    moment->priv->antiscion_matrix = NULL;
+    moment->priv->antiscion_matrix_planets = 0;
     moment->priv->moon_phase = gswe_moon_phase_data_new();
     moment->priv->element_points = g_hash_table_new_full(
             g_direct_hash, g_direct_equal,
@@ -278,13 +428,14 @@ gswe_moment_init(GsweMoment *moment)
     moment->priv->aspect_revision = 0;
     moment->priv->antiscia_revision = 0;
     moment->priv->revision = 1;
+    moment->priv->update_depth = 0;
+    moment->priv->update_pending = FALSE;
 }
 
 static void
 gswe_moment_timestamp_changed(GsweTimestamp *timestamp, GsweMoment *moment)
 {
-    moment->priv->revision++;
-    gswe_moment_emit_changed(moment);
+    gswe_moment_invalidate(moment);
 }
 
 /* Dispose object */
@@ -299,6 +450,7 @@ gswe_moment_dispose(GObject *gobject)
         );
 
     g_clear_object(&moment->priv->timestamp);
+    g_clear_object(&moment->priv->context);
 
     G_OBJECT_CLASS(gswe_moment_parent_class)->dispose(gobject);
 }
@@ -308,6 +460,7 @@ static void
 gswe_moment_finalize(GObject *gobject)
 {
     GsweMoment *moment = GSWE_MOMENT(gobject);
+    guint i;
 
     g_clear_object(&moment->priv->timestamp);
 
@@ -322,19 +475,43 @@ gswe_moment_finalize(GObject *gobject)
             (GDestroyNotify)gswe_planet_data_unref
         );
     moment->priv->planet_list = NULL;
-
-    g_list_free_full(
-            moment->priv->aspect_list,
-            (GDestroyNotify)gswe_aspect_data_unref
+    memset(
+            moment->priv->planet_table,
+            0,
+            sizeof(moment->priv->planet_table)
         );
+    moment->priv->planet_count = 0;
+
+    g_list_free(moment->priv->aspect_list);
     moment->priv->aspect_list = NULL;
 
-    g_list_free_full(
-            moment->priv->antiscia_list,
-            (GDestroyNotify)gswe_antiscion_data_unref
-        );
+    for (
+            i = 0;
+            i < GSWE_MOMENT_PAIR_COUNT(moment->priv->aspect_matrix_planets);
+            i++
+        ) {
+        gswe_aspect_data_unref(moment->priv->aspect_matrix[i]);
+    }
+
+    g_free(moment->priv->aspect_matrix);
+    moment->priv->aspect_matrix = NULL;
+    moment->priv->aspect_matrix_planets = 0;
+
+    g_list_free(moment->priv->antiscia_list);
     moment->priv->antiscia_list = NULL;
 
+    for (
+            i = 0;
+            i < GSWE_MOMENT_PAIR_COUNT(moment->priv->antiscion_matrix_planets);
+            i++
+        ) {
+        gswe_antiscion_data_unref(moment->priv->antiscion_matrix[i]);
+    }
+
+    g_free(moment->priv->antiscion_matrix);
+    moment->priv->antiscion_matrix = NULL;
+    moment->priv->antiscion_matrix_planets = 0;
+
     g_hash_table_remove_all(moment->priv->element_points);
 
     g_hash_table_remove_all(moment->priv->quality_points);
@@ -384,6 +561,11 @@ gswe_moment_set_property(
 
             break;
 
+        case PROP_CONTEXT:
+            gswe_moment_set_context(moment, g_value_get_object(value));
+
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 
@@ -424,6 +606,11 @@ gswe_moment_get_property(
 
             break;
 
+        case PROP_CONTEXT:
+            g_value_set_object(value, priv->context);
+
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 
@@ -457,7 +644,6 @@ gswe_moment_set_timestamp(GsweMoment *moment, GsweTimestamp *timestamp)
         g_clear_object(&moment->priv->timestamp);
     }
 
-    moment->priv->revision++;
     moment->priv->timestamp = timestamp;
     g_object_ref(timestamp);
     moment->priv->timestamp_signal_handler = g_signal_connect(
@@ -468,10 +654,39 @@ gswe_moment_set_timestamp(GsweMoment *moment, GsweTimestamp *timestamp)
         );
 
     /* Emit the changed signal to notify registrants of the change */
-    gswe_moment_emit_changed(moment);
+    gswe_moment_invalidate(moment);
     g_object_notify_by_pspec(G_OBJECT(moment), properties[PROP_TIMESTAMP]);
 }
 
+/**
+ * gswe_moment_set_time:
+ * @moment: a GsweMoment object
+ * @instant: the new point in time of @moment
+ * @err: a #GError
+ *
+ * Moves @moment to @instant. If @moment already has a timestamp, its value is
+ * changed with gswe_timestamp_set_time(), so other objects sharing the same
+ * #GsweTimestamp follow the change, too; otherwise a new timestamp is
+ * created.
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_set_time(GsweMoment *moment, const GsweTime *instant, GError **err)
+{
+    GsweTimestamp *timestamp;
+
+    if (moment->priv->timestamp != NULL) {
+        gswe_timestamp_set_time(moment->priv->timestamp, instant, err);
+
+        return;
+    }
+
+    timestamp = gswe_timestamp_new_from_time(instant);
+    gswe_moment_set_timestamp(moment, timestamp);
+    g_object_unref(timestamp);
+}
+
 /**
  * gswe_moment_get_timestamp:
  * @moment: a GsweMoment object
@@ -522,8 +737,7 @@ gswe_moment_set_coordinates(
     moment->priv->coordinates.longitude = longitude;
     moment->priv->coordinates.latitude = latitude;
     moment->priv->coordinates.altitude = altitude;
-    moment->priv->revision++;
-    gswe_moment_emit_changed(moment);
+    gswe_moment_invalidate(moment);
     g_object_notify_by_pspec(G_OBJECT(moment), properties[PROP_COORDINATES]);
 }
 
@@ -556,8 +770,7 @@ gswe_moment_set_house_system(GsweMoment *moment, GsweHouseSystem house_system)
 {
     if (moment->priv->house_system != house_system) {
         moment->priv->house_system = house_system;
-        moment->priv->revision++;
-        gswe_moment_emit_changed(moment);
+        gswe_moment_invalidate(moment);
         g_object_notify_by_pspec(G_OBJECT(moment), properties[PROP_HOUSE_SYSTEM]);
     }
 }
@@ -576,6 +789,148 @@ gswe_moment_get_house_system(GsweMoment *moment)
     return moment->priv->house_system;
 }
 
+/**
+ * gswe_moment_update_begin:
+ * @moment: a GsweMoment object
+ *
+ * Starts a batch of changes on @moment. Until the matching
+ * gswe_moment_update_commit(), changing the timestamp, the coordinates or the
+ * house system of @moment doesn't emit the ::changed signal, and the property
+ * notifications are held back with g_object_freeze_notify(). Updates can be
+ * nested; only the outermost commit emits the signals.
+ *
+ * Only the signals are batched: every change inside an update still bumps
+ * the revision of @moment, just like outside of one. Values fetched from
+ * @moment during an update thus reflect the changes made so far, and are
+ * calculated again if they change later in the same update; fetch them after
+ * gswe_moment_update_commit() to calculate them only once.
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_update_begin(GsweMoment *moment)
+{
+    g_object_freeze_notify(G_OBJECT(moment));
+
+    if (moment->priv->update_depth++ == 0) {
+        moment->priv->update_pending = FALSE;
+    }
+}
+
+/**
+ * gswe_moment_update_commit:
+ * @moment: a GsweMoment object
+ *
+ * Finishes a batch of changes started with gswe_moment_update_begin(). If
+ * this ends the outermost update, and @moment changed during it, the
+ * ::changed signal is emitted once, followed by the held back property
+ * notifications.
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_update_commit(GsweMoment *moment)
+{
+    g_return_if_fail(moment->priv->update_depth > 0);
+
+    if (
+                (--moment->priv->update_depth == 0)
+                && moment->priv->update_pending
+            ) {
+        moment->priv->update_pending = FALSE;
+        gswe_moment_emit_changed(moment);
+    }
+
+    g_object_thaw_notify(G_OBJECT(moment));
+}
+
+/**
+ * gswe_moment_set_all:
+ * @moment: a GsweMoment object
+ * @instant: (allow-none): the new point in time of @moment, or %NULL to keep
+ *           the current one
+ * @longitude: the longitude part of the coordinates, in degrees
+ * @latitude: the latitude part of the coordinates, in degrees
+ * @altitude: the altitude part of the coordinates, in meters
+ * @house_system: the new house system of @moment
+ * @err: a #GError
+ *
+ * Sets the time, the coordinates and the house system of @moment in one
+ * update (see gswe_moment_update_begin()), so the ::changed signal is emitted
+ * at most once. The revision of @moment is still bumped by every value that
+ * changes.
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_set_all(
+        GsweMoment *moment,
+        const GsweTime *instant,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        GError **err)
+{
+    gswe_moment_update_begin(moment);
+
+    if (instant != NULL) {
+        gswe_moment_set_time(moment, instant, err);
+    }
+
+    gswe_moment_set_coordinates(moment, longitude, latitude, altitude);
+    gswe_moment_set_house_system(moment, house_system);
+
+    gswe_moment_update_commit(moment);
+}
+
+/**
+ * gswe_moment_set_context:
+ * @moment: a GsweMoment object
+ * @context: (allow-none): a #GsweContext, or %NULL
+ *
+ * Makes @moment do its calculations with @context. The saved positions and
+ * other caches of the Swiss Ephemeris then stay valid between the
+ * calculations of @moment, even if other moments calculate in the meantime,
+ * e.g. for a different observer. With %NULL, @moment calculates with the
+ * state of the calling thread, which is the default.
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_set_context(GsweMoment *moment, GsweContext *context)
+{
+    if (moment->priv->context == context) {
+        return;
+    }
+
+    if (context != NULL) {
+        g_object_ref(context);
+    }
+
+    g_clear_object(&moment->priv->context);
+    moment->priv->context = context;
+
+    g_object_notify_by_pspec(G_OBJECT(moment), properties[PROP_CONTEXT]);
+}
+
+/**
+ * gswe_moment_get_context:
+ * @moment: a GsweMoment object
+ *
+ * Gets the calculation context of @moment.
+ *
+ * Returns: (transfer none) (allow-none): the #GsweContext of @moment, or
+ *          %NULL if it calculates with the state of the calling thread
+ *
+ * Since: 2.2
+ */
+GsweContext *
+gswe_moment_get_context(GsweMoment *moment)
+{
+    return moment->priv->context;
+}
+
 /**
  * gswe_moment_new:
  *
@@ -621,7 +976,7 @@ gswe_moment_new_full(
 
     moment->priv->timestamp = timestamp;
     g_object_ref(timestamp);
-    g_signal_connect(
+    moment->priv->timestamp_signal_handler = g_signal_connect(
             G_OBJECT(timestamp),
             "changed",
             G_CALLBACK(gswe_moment_timestamp_changed),
@@ -635,18 +990,749 @@ gswe_moment_new_full(
     return moment;
 }
 
-static gint
-find_planet_by_id(GswePlanetData *planet_data, GswePlanet *planet)
+static inline gdouble
+gswe_moment_house_offset(
+        const GsweMomentHouseCusps *house_cusps,
+        gdouble position)
 {
-    if (planet_data->planet_info == NULL) {
-        return -1;
+    gdouble offset = (house_cusps->clockwise)
+        ? house_cusps->start - position
+        : position - house_cusps->start;
+
+    if ((offset = fmod(offset, 360.0)) < 0.0) {
+        offset += 360.0;
     }
 
-    if (planet_data->planet_info->planet == *planet) {
+    return offset;
+}
+
+/*
+ * gswe_moment_house_cusps_init:
+ * @house_cusps: the #GsweMomentHouseCusps to fill
+ * @sweph_id: the Swiss Ephemeris ID of the house system
+ * @cusps: the house cusps as returned by swe_houses(); @cusps[1] is the cusp
+ *         of the first house
+ */
+static void
+gswe_moment_house_cusps_init(
+        GsweMomentHouseCusps *house_cusps,
+        gchar sweph_id,
+        const gdouble *cusps)
+{
+    guint i;
+
+    // The Gauquelin sectors are the only ones swe_houses() returns more than
+    // 12 cusps for, and they are numbered clockwise
+    house_cusps->count = (sweph_id == 'G') ? 36 : 12;
+    house_cusps->clockwise = (sweph_id == 'G');
+    house_cusps->start = cusps[1];
+
+    for (i = 0; i < house_cusps->count; i++) {
+        house_cusps->offset[i] = gswe_moment_house_offset(
+                house_cusps,
+                cusps[i + 1]
+            );
+    }
+}
+
+/*
+ * gswe_moment_house_cusps_find:
+ * @house_cusps: a #GsweMomentHouseCusps
+ * @position: an ecliptic position
+ *
+ * Returns: the house in which @position is, or 0 if the houses are not
+ *          calculated
+ */
+static gint
+gswe_moment_house_cusps_find(
+        const GsweMomentHouseCusps *house_cusps,
+        gdouble position)
+{
+    gdouble offset;
+    guint low = 0,
+          high = house_cusps->count;
+
+    if (house_cusps->count == 0) {
         return 0;
     }
 
-    return 1;
+    offset = gswe_moment_house_offset(house_cusps, position);
+
+    // Find the last cusp not after offset. offset[low] <= offset holds all
+    // the time, as offset[0] is 0
+    while (high - low > 1) {
+        guint middle = (low + high) / 2;
+
+        if (house_cusps->offset[middle] <= offset) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low + 1;
+}
+
+/* The points gswe_moment_house_point() knows */
+static const GswePlanet gswe_moment_house_points[] = {
+    GSWE_PLANET_ASCENDANT,
+    GSWE_PLANET_DESCENDANT,
+    GSWE_PLANET_MC,
+    GSWE_PLANET_IC,
+    GSWE_PLANET_VERTEX,
+    GSWE_PLANET_ANTIVERTEX,
+};
+
+/*
+ * gswe_moment_house_point:
+ * @planet: a house point, like GSWE_PLANET_ASCENDANT
+ * @ascmc: the points returned by swe_houses()
+ * @position: (out): the position of @planet
+ *
+ * Gets the position of @planet from the points swe_houses() returns. The
+ * descendant, the IC and the antivertex are opposite to the Ascendant, the
+ * MC and the vertex on the full circle.
+ *
+ * Returns: %FALSE if @planet is not a house point
+ */
+static gboolean
+gswe_moment_house_point(
+        GswePlanet planet,
+        const gdouble *ascmc,
+        gdouble *position)
+{
+    switch (planet) {
+        case GSWE_PLANET_ASCENDANT:
+            *position = ascmc[0];
+
+            return TRUE;
+
+        case GSWE_PLANET_DESCENDANT:
+            *position = fmod(ascmc[0] + 180.0, 360.0);
+
+            return TRUE;
+
+        case GSWE_PLANET_MC:
+            *position = ascmc[1];
+
+            return TRUE;
+
+        case GSWE_PLANET_IC:
+            *position = fmod(ascmc[1] + 180.0, 360.0);
+
+            return TRUE;
+
+        case GSWE_PLANET_VERTEX:
+            *position = ascmc[3];
+
+            return TRUE;
+
+        case GSWE_PLANET_ANTIVERTEX:
+            *position = fmod(ascmc[3] + 180.0, 360.0);
+
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+/*
+ * gswe_moment_south_node:
+ * @x2: the position of the north node, as returned by swe_calc()
+ *
+ * Turns the position of the north node into that of the south node, which is
+ * on the opposite side of the chart: both the longitude and the latitude are
+ * mirrored.
+ */
+static void
+gswe_moment_south_node(gdouble *x2)
+{
+    x2[0] = fmod(x2[0] + 180.0, 360.0);
+    x2[1] = -x2[1];
+    x2[4] = -x2[4];
+}
+
+/*
+ * GsweMomentSeriesJob:
+ *
+ * The parameters of a gswe_moment_calculate_series() or
+ * gswe_moment_calculate_series_parallel() call, shared by all the worker
+ * threads of the latter.
+ */
+typedef struct {
+    const gdouble *julian_days;
+    const GsweTime *times;
+    guint count;
+    gboolean universal_time;
+    GsweCoordinates coordinates;
+    GsweHouseSystemInfo *house_system_info;
+    gboolean need_houses;
+    const GswePlanet *planets;
+    GswePlanetInfo **planet_infos;
+    guint planet_count;
+    GsweMomentSeries *series;
+
+    /* protects @error */
+    GMutex lock;
+
+    /* the most important error raised by the worker threads */
+    GError *error;
+} GsweMomentSeriesJob;
+
+/*
+ * GsweMomentSeriesChunk:
+ * @first: the index of the first Julian day to calculate
+ * @last: the index after the last Julian day to calculate
+ *
+ * A range of Julian days calculated by one gswe_moment_series_worker() call.
+ */
+typedef struct {
+    guint first;
+    guint last;
+} GsweMomentSeriesChunk;
+
+static gboolean
+gswe_moment_series_job_init(
+        GsweMomentSeriesJob *job,
+        const gdouble *julian_days,
+        guint count,
+        gboolean universal_time,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        GsweMomentSeries *series,
+        GError **err)
+{
+    guint p;
+
+    gswe_init();
+
+    job->julian_days = julian_days;
+    job->times = NULL;
+    job->count = count;
+    job->universal_time = universal_time;
+    job->coordinates.longitude = longitude;
+    job->coordinates.latitude = latitude;
+    job->coordinates.altitude = altitude;
+    job->house_system_info = NULL;
+    job->need_houses = FALSE;
+    job->planets = planets;
+    job->planet_infos = NULL;
+    job->planet_count = planet_count;
+    job->series = series;
+    job->error = NULL;
+    g_mutex_init(&job->lock);
+
+    if (house_system != GSWE_HOUSE_SYSTEM_NONE) {
+        if ((job->house_system_info = gswe_house_system_info_lookup(
+                        house_system
+                    )) == NULL) {
+            g_set_error(
+                    err,
+                    GSWE_ERROR, GSWE_ERROR_UNKNOWN_HSYS,
+                    "Unknown house system"
+                );
+
+            return FALSE;
+        }
+
+        job->need_houses = (series->house != NULL);
+    }
+
+    job->planet_infos = g_new(GswePlanetInfo *, planet_count);
+
+    for (p = 0; p < planet_count; p++) {
+        if ((job->planet_infos[p] = gswe_planet_info_lookup(
+                        planets[p]
+                    )) == NULL) {
+            g_set_error(
+                    err,
+                    GSWE_ERROR, GSWE_ERROR_UNKNOWN_PLANET,
+                    "Unknown planet"
+                );
+
+            return FALSE;
+        }
+
+        if (!job->planet_infos[p]->real_body) {
+            if (job->house_system_info == NULL) {
+                g_set_error(
+                        err,
+                        GSWE_ERROR, GSWE_ERROR_UNKNOWN_HSYS,
+                        "Virtual points can only be calculated with a house "
+                        "system set"
+                    );
+
+                return FALSE;
+            }
+
+            job->need_houses = TRUE;
+        }
+    }
+
+    return TRUE;
+}
+
+static void
+gswe_moment_series_job_clear(GsweMomentSeriesJob *job)
+{
+    g_free(job->planet_infos);
+    g_mutex_clear(&job->lock);
+}
+
+/*
+ * gswe_moment_series_calculate_range:
+ * @job: a #GsweMomentSeriesJob
+ * @first: the index of the first Julian day to calculate
+ * @last: the index after the last Julian day to calculate
+ * @err: a #GError
+ *
+ * Does the actual calculations of gswe_moment_calculate_series() for the
+ * [@first; @last) range of Julian days. As it only touches that range of
+ * the output arrays, it may run on multiple threads for different ranges.
+ *
+ * Returns: %FALSE on fatal errors
+ */
+static gboolean
+gswe_moment_series_calculate_range(
+        GsweMomentSeriesJob *job,
+        guint first,
+        guint last,
+        GError **err)
+{
+    GsweMomentSeries *series = job->series;
+    guint p,
+          t;
+
+    gswe_thread_init();
+    swe_set_topo(
+            job->coordinates.longitude,
+            job->coordinates.latitude,
+            job->coordinates.altitude
+        );
+
+    for (t = first; t < last; t++) {
+        gdouble jd,
+                cusps[GSWE_MOMENT_MAX_HOUSES + 1],
+                ascmc[10];
+        GsweMomentHouseCusps house_cusps;
+
+        if (job->times != NULL) {
+            jd = job->times[t].julian_day_et;
+        } else {
+            jd = job->julian_days[t];
+
+            if (job->universal_time) {
+                jd += swe_deltat(jd);
+            }
+        }
+
+        // GsweMoment also passes the ET Julian day to swe_houses(), so we do
+        // the same to get the same results
+        if (job->need_houses) {
+            swe_houses(
+                    jd,
+                    job->coordinates.latitude,
+                    job->coordinates.longitude,
+                    job->house_system_info->sweph_id,
+                    cusps,
+                    ascmc
+                );
+            gswe_moment_house_cusps_init(
+                    &house_cusps,
+                    job->house_system_info->sweph_id,
+                    cusps
+                );
+        }
+
+        for (p = 0; p < job->planet_count; p++) {
+            guint index = p * job->count + t;
+            gdouble x2[6] = { 0.0 };
+            GsweZodiac sign;
+
+            if (job->planet_infos[p]->real_body) {
+                gchar serr[AS_MAXCH];
+                gint ret;
+
+                if ((ret = swe_calc(
+                                jd,
+                                job->planet_infos[p]->sweph_id,
+                                SEFLG_SPEED | SEFLG_TOPOCTR,
+                                x2,
+                                serr
+                            )) < 0) {
+                    g_clear_error(err);
+                    g_set_error(
+                            err,
+                            GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
+                            "Swiss Ephemeris fatal error: %s",
+                            serr
+                        );
+
+                    return FALSE;
+                } else if (
+                        (ret != (SEFLG_SPEED | SEFLG_TOPOCTR))
+                        && (err != NULL)
+                        && (*err == NULL)
+                    ) {
+                    if (ret & SEFLG_MOSEPH) {
+                        g_set_error_literal(
+                                err,
+                                GSWE_ERROR, GSWE_ERROR_SWE_NONFATAL,
+                                "Swiss Ephemeris data file not installed, "
+                                "using the Moshier ephemeris"
+                            );
+                    } else {
+                        g_set_error_literal(
+                                err,
+                                GSWE_ERROR, GSWE_ERROR_SWE_NONFATAL,
+                                "Swiss Ephemeris non-fatal error"
+                            );
+                    }
+                }
+
+                if (job->planets[p] == GSWE_PLANET_MOON_SOUTH_NODE) {
+                    gswe_moment_south_node(x2);
+                }
+            } else if (!gswe_moment_house_point(
+                        job->planets[p],
+                        ascmc,
+                        &x2[0]
+                    )) {
+                g_clear_error(err);
+                g_set_error(
+                        err,
+                        GSWE_ERROR, GSWE_ERROR_UNKNOWN_PLANET,
+                        "The position of planet %d can not be calculated",
+                        job->planets[p]
+                    );
+
+                return FALSE;
+            }
+
+            // If position happens to be exactly 0, this calculation yields
+            // GSWE_SIGN_NONE, but should be GSWE_SIGN_ARIES
+            if ((sign = (GsweZodiac)ceil(x2[0] / 30.0)) == GSWE_SIGN_NONE) {
+                sign = GSWE_SIGN_ARIES;
+            }
+
+            if (series->longitude) {
+                series->longitude[index] = x2[0];
+            }
+
+            if (series->latitude) {
+                series->latitude[index] = x2[1];
+            }
+
+            if (series->speed) {
+                series->speed[index] = x2[3];
+            }
+
+            if (series->sign) {
+                series->sign[index] = sign;
+            }
+
+            if (series->house) {
+                series->house[index] = (job->house_system_info == NULL)
+                    ? 0
+                    : gswe_moment_house_cusps_find(&house_cusps, x2[0]);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * gswe_moment_calculate_series:
+ * @julian_days: (array length=count) (in): the Julian days to calculate the
+ *               planet positions for
+ * @count: the number of elements in @julian_days
+ * @universal_time: %TRUE if @julian_days are in Universal Time (UT), %FALSE if
+ *                  they are in Ephemeris Time (ET)
+ * @longitude: the longitude part of the observer's position, in degrees
+ * @latitude: the latitude part of the observer's position, in degrees
+ * @altitude: the altitude part of the coordinates, in meters
+ * @house_system: the house system to use
+ * @planets: (array length=planet_count) (in): the planets to calculate
+ * @planet_count: the number of elements in @planets
+ * @series: (out caller-allocates): a #GsweMomentSeries with arrays large
+ *          enough for @count × @planet_count elements
+ * @err: a #GError
+ *
+ * Calculates the same planets for many points in time, the same way a
+ * #GsweMoment would do for each of them, without creating any objects. This
+ * is the preferred way to calculate time lines or charts of a date range.
+ *
+ * The data of @planets[p] at @julian_days[t] is stored at index
+ * <literal>p * @count + t</literal> of each array in @series.
+ *
+ * Returns: %TRUE if the calculation succeeded. @err may be set even in this
+ *          case, if the Swiss Ephemeris fell back to a less precise method
+ *          (see gswe_moment_get_planet())
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_moment_calculate_series(
+        const gdouble *julian_days,
+        guint count,
+        gboolean universal_time,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        GsweMomentSeries *series,
+        GError **err)
+{
+    GsweMomentSeriesJob job;
+    gboolean ret = FALSE;
+
+    if (gswe_moment_series_job_init(
+                &job,
+                julian_days, count, universal_time,
+                longitude, latitude, altitude,
+                house_system,
+                planets, planet_count,
+                series,
+                err
+            )) {
+        ret = gswe_moment_series_calculate_range(&job, 0, count, err);
+    }
+
+    gswe_moment_series_job_clear(&job);
+
+    return ret;
+}
+
+/**
+ * gswe_moment_calculate_time_series:
+ * @times: (array length=count) (in): the points in time to calculate the
+ *         planet positions for
+ * @count: the number of elements in @times
+ * @longitude: the longitude part of the observer's position, in degrees
+ * @latitude: the latitude part of the observer's position, in degrees
+ * @altitude: the altitude part of the coordinates, in meters
+ * @house_system: the house system to use
+ * @planets: (array length=planet_count) (in): the planets to calculate
+ * @planet_count: the number of elements in @planets
+ * @series: (out caller-allocates): a #GsweMomentSeries with arrays large
+ *          enough for @count × @planet_count elements
+ * @err: a #GError
+ *
+ * Does the same as gswe_moment_calculate_series(), but takes the points in
+ * time as #GsweTime values, e.g. the ones stepped through with
+ * gswe_time_add_days().
+ *
+ * Returns: %TRUE if the calculation succeeded. @err may be set even in this
+ *          case, if the Swiss Ephemeris fell back to a less precise method
+ *          (see gswe_moment_get_planet())
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_moment_calculate_time_series(
+        const GsweTime *times,
+        guint count,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        GsweMomentSeries *series,
+        GError **err)
+{
+    GsweMomentSeriesJob job;
+    gboolean ret = FALSE;
+
+    if (gswe_moment_series_job_init(
+                &job,
+                NULL, count, FALSE,
+                longitude, latitude, altitude,
+                house_system,
+                planets, planet_count,
+                series,
+                err
+            )) {
+        job.times = times;
+        ret = gswe_moment_series_calculate_range(&job, 0, count, err);
+    }
+
+    gswe_moment_series_job_clear(&job);
+
+    return ret;
+}
+
+static void
+gswe_moment_series_worker(
+        GsweMomentSeriesChunk *chunk,
+        GsweMomentSeriesJob *job)
+{
+    GError *err = NULL;
+
+    gswe_moment_series_calculate_range(job, chunk->first, chunk->last, &err);
+
+    if (err == NULL) {
+        return;
+    }
+
+    g_mutex_lock(&job->lock);
+
+    // Keep the first error, unless it is just a fallback warning and this
+    // one is a real failure
+    if (
+            (job->error == NULL)
+            || (
+                (job->error->code == GSWE_ERROR_SWE_NONFATAL)
+                && (err->code != GSWE_ERROR_SWE_NONFATAL)
+            )
+        ) {
+        g_clear_error(&job->error);
+        job->error = err;
+    } else {
+        g_error_free(err);
+    }
+
+    g_mutex_unlock(&job->lock);
+}
+
+/**
+ * gswe_moment_calculate_series_parallel:
+ * @julian_days: (array length=count) (in): the Julian days to calculate the
+ *               planet positions for
+ * @count: the number of elements in @julian_days
+ * @universal_time: %TRUE if @julian_days are in Universal Time (UT), %FALSE if
+ *                  they are in Ephemeris Time (ET)
+ * @longitude: the longitude part of the observer's position, in degrees
+ * @latitude: the latitude part of the observer's position, in degrees
+ * @altitude: the altitude part of the coordinates, in meters
+ * @house_system: the house system to use
+ * @planets: (array length=planet_count) (in): the planets to calculate
+ * @planet_count: the number of elements in @planets
+ * @max_threads: the maximum number of threads to use, or 0 to use one thread
+ *               for each processor
+ * @series: (out caller-allocates): a #GsweMomentSeries with arrays large
+ *          enough for @count × @planet_count elements
+ * @err: a #GError
+ *
+ * Does the same as gswe_moment_calculate_series(), but splits @julian_days
+ * into chunks, and calculates them in a pool of worker threads. Each thread
+ * has its own Swiss Ephemeris state, so they don't block each other.
+ *
+ * Returns: %TRUE if the calculation succeeded. @err may be set even in this
+ *          case, if the Swiss Ephemeris fell back to a less precise method
+ *          (see gswe_moment_get_planet())
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_moment_calculate_series_parallel(
+        const gdouble *julian_days,
+        guint count,
+        gboolean universal_time,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        guint max_threads,
+        GsweMomentSeries *series,
+        GError **err)
+{
+    GsweMomentSeriesJob job;
+    GsweMomentSeriesChunk *chunks;
+    GThreadPool *pool;
+    guint chunk_count,
+          i;
+    gboolean ret;
+
+    if (!gswe_moment_series_job_init(
+                &job,
+                julian_days, count, universal_time,
+                longitude, latitude, altitude,
+                house_system,
+                planets, planet_count,
+                series,
+                err
+            )) {
+        gswe_moment_series_job_clear(&job);
+
+        return FALSE;
+    }
+
+    if (max_threads == 0) {
+#if GLIB_CHECK_VERSION(2, 36, 0)
+        max_threads = g_get_num_processors();
+#else
+        max_threads = 1;
+#endif
+    }
+
+    // A few chunks per thread keep all of them busy even if some chunks take
+    // longer than others
+    chunk_count = MIN(count, max_threads * 4);
+
+    if ((max_threads == 1) || (chunk_count <= 1)) {
+        ret = gswe_moment_series_calculate_range(&job, 0, count, err);
+        gswe_moment_series_job_clear(&job);
+
+        return ret;
+    }
+
+    if ((pool = g_thread_pool_new(
+                    (GFunc)gswe_moment_series_worker,
+                    &job,
+                    max_threads,
+                    FALSE,
+                    err
+                )) == NULL) {
+        gswe_moment_series_job_clear(&job);
+
+        return FALSE;
+    }
+
+    chunks = g_new(GsweMomentSeriesChunk, chunk_count);
+
+    for (i = 0; i < chunk_count; i++) {
+        chunks[i].first = (guint)((guint64)count * i / chunk_count);
+        chunks[i].last = (guint)((guint64)count * (i + 1) / chunk_count);
+        g_thread_pool_push(pool, &chunks[i], NULL);
+    }
+
+    // Wait for all the chunks to finish
+    g_thread_pool_free(pool, FALSE, TRUE);
+    g_free(chunks);
+
+    ret = (job.error == NULL)
+        || (job.error->code == GSWE_ERROR_SWE_NONFATAL);
+
+    if (job.error) {
+        g_propagate_error(err, job.error);
+    }
+
+    gswe_moment_series_job_clear(&job);
+
+    return ret;
+}
+
+static GswePlanetData *
+gswe_moment_lookup_planet(GsweMoment *moment, GswePlanet planet)
+{
+    gint slot = gswe_planet_get_slot(planet);
+
+    if (slot < 0) {
+        return NULL;
+    }
+
+    return moment->priv->planet_table[slot];
 }
 
 static void
@@ -659,17 +1745,8 @@ calculate_data_by_position(
     GswePlanetData *planet_data;
     GsweZodiac sign;
     GsweSignInfo *sign_info;
-    GList *result;
-
-    if ((result = g_list_find_custom(
-                    moment->priv->planet_list,
-                    &planet,
-                    (GCompareFunc)find_planet_by_id
-                )) == NULL) {
-        return;
-    }
 
-    if ((planet_data = (GswePlanetData *)(result->data)) == NULL) {
+    if ((planet_data = gswe_moment_lookup_planet(moment, planet)) == NULL) {
         return;
     }
 
@@ -685,10 +1762,7 @@ calculate_data_by_position(
         sign = GSWE_SIGN_ARIES;
     }
 
-    if ((sign_info = g_hash_table_lookup(
-                    gswe_sign_info_table,
-                    GINT_TO_POINTER(sign)
-                )) == NULL) {
+    if ((sign_info = gswe_sign_info_lookup(sign)) == NULL) {
         g_error("Calculations brought an unknown sign!");
     }
 
@@ -702,7 +1776,7 @@ calculate_data_by_position(
 static void
 gswe_moment_calculate_house_positions(GsweMoment *moment, GError **err)
 {
-    gdouble cusps[13],
+    gdouble cusps[GSWE_MOMENT_MAX_HOUSES + 1],
             ascmc[10],
             jd;
     gint i;
@@ -717,6 +1791,7 @@ gswe_moment_calculate_house_positions(GsweMoment *moment, GError **err)
             (GDestroyNotify)gswe_house_data_unref
         );
     moment->priv->house_list = NULL;
+    moment->priv->house_cusps.count = 0;
 
     // If no house system is set, we need no calculations at all. Just leave
     // the list empty and return
@@ -726,9 +1801,8 @@ gswe_moment_calculate_house_positions(GsweMoment *moment, GError **err)
         return;
     }
 
-    if ((house_system_info = g_hash_table_lookup(
-                    gswe_house_system_info_table,
-                    GINT_TO_POINTER(moment->priv->house_system)
+    if ((house_system_info = gswe_house_system_info_lookup(
+                    moment->priv->house_system
                 )) == NULL) {
         g_set_error(
                 err,
@@ -747,35 +1821,39 @@ gswe_moment_calculate_house_positions(GsweMoment *moment, GError **err)
         return;
     }
 
+    gswe_context_enter(moment->priv->context);
     swe_houses(
             jd,
             moment->priv->coordinates.latitude,
             moment->priv->coordinates.longitude,
             house_system_info->sweph_id,
-            cusps,
-            ascmc
+            cusps,
+            ascmc
+        );
+    gswe_context_leave(moment->priv->context);
+
+    gswe_moment_house_cusps_init(
+            &moment->priv->house_cusps,
+            house_system_info->sweph_id,
+            cusps
         );
 
-    /* TODO: SWE house system 'G' (Gauquelin sector cusps) have 36 houses; we
-     * should detect that somehow (house system 'G' is not implemented yet in
-     * GsweHouseSystem, and all other house systems have exactly 12 houses, so
-     * this should not cause trouble yet, though) */
-    for (i = 12; i >= 1; i--) {
+    for (i = moment->priv->house_cusps.count; i >= 1; i--) {
         GsweSignInfo *sign_info;
         GsweHouseData *house_data = gswe_house_data_new();
 
         house_data->house = i;
         house_data->cusp_position = cusps[i];
 
-        if ((sign_info = g_hash_table_lookup(
-                        gswe_sign_info_table,
-                        GINT_TO_POINTER((gint)ceilf(cusps[i] / 30.0))
+        if ((sign_info = gswe_sign_info_lookup(
+                        (gint)ceilf(cusps[i] / 30.0)
                     )) == NULL) {
             g_list_free_full(
                     moment->priv->house_list,
                     (GDestroyNotify)gswe_house_data_unref
                 );
             moment->priv->house_list = NULL;
+            moment->priv->house_cusps.count = 0;
             moment->priv->house_revision = 0;
             g_set_error(
                     err,
@@ -797,46 +1875,16 @@ gswe_moment_calculate_house_positions(GsweMoment *moment, GError **err)
 
     // The Ascendant, MC and Vertex points are also calculated by swe_houses(),
     // so let's update them.
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_ASCENDANT)) {
-        calculate_data_by_position(
-                moment,
-                GSWE_PLANET_ASCENDANT,
-                ascmc[0],
-                err
-            );
-    }
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_DESCENDANT)) {
-        calculate_data_by_position(
-                moment,
-                GSWE_PLANET_DESCENDANT,
-                fmod(ascmc[0] + 180.0, 180.0),
-                err
-            );
-    }
-
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_MC)) {
-        calculate_data_by_position(moment, GSWE_PLANET_MC, ascmc[1], err);
-    }
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_IC)) {
-        calculate_data_by_position(
-                moment,
-                GSWE_PLANET_IC,
-                fmod(ascmc[2] + 180.0, 180.0),
-                err
-            );
-    }
+    for (i = 0; i < G_N_ELEMENTS(gswe_moment_house_points); i++) {
+        GswePlanet point = gswe_moment_house_points[i];
+        gdouble position;
 
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_VERTEX)) {
-        calculate_data_by_position(moment, GSWE_PLANET_VERTEX, ascmc[3], err);
-    }
-
-    if (gswe_moment_has_planet(moment, GSWE_PLANET_ANTIVERTEX)) {
-        calculate_data_by_position(
-                moment,
-                GSWE_PLANET_ANTIVERTEX,
-                fmod(ascmc[3] + 180.0, 180.0),
-                err
-            );
+        if (
+                gswe_moment_has_planet(moment, point)
+                && gswe_moment_house_point(point, ascmc, &position)
+            ) {
+            calculate_data_by_position(moment, point, position, err);
+        }
     }
 }
 
@@ -874,11 +1922,7 @@ gswe_moment_get_house_cusps(GsweMoment *moment, GError **err)
 gboolean
 gswe_moment_has_planet(GsweMoment *moment, GswePlanet planet)
 {
-    return (g_list_find_custom(
-                moment->priv->planet_list,
-                &planet,
-                (GCompareFunc)find_planet_by_id
-            ) != NULL);
+    return (gswe_moment_lookup_planet(moment, planet) != NULL);
 }
 
 /**
@@ -900,10 +1944,7 @@ gswe_moment_add_planet(GsweMoment *moment, GswePlanet planet, GError **err)
         return;
     }
 
-    if ((planet_info = g_hash_table_lookup(
-                    gswe_planet_info_table,
-                    GINT_TO_POINTER(planet)
-                )) == NULL) {
+    if ((planet_info = gswe_planet_info_lookup(planet)) == NULL) {
         g_set_error(
                 err,
                 GSWE_ERROR, GSWE_ERROR_UNKNOWN_PLANET,
@@ -917,22 +1958,24 @@ gswe_moment_add_planet(GsweMoment *moment, GswePlanet planet, GError **err)
     planet_data->planet_info = gswe_planet_info_ref(planet_info);
     planet_data->revision = 0;
 
+    // The house points are only set while the houses are calculated, so the
+    // houses need a recalculation even if they are up to date
+    if (planet_info->real_body == FALSE) {
+        moment->priv->house_revision = 0;
+    }
+
     moment->priv->planet_list = g_list_append(
             moment->priv->planet_list,
             planet_data
         );
+    moment->priv->planet_table[gswe_planet_get_slot(planet)] = planet_data;
+    moment->priv->planet_index[gswe_planet_get_slot(planet)]
+        = moment->priv->planet_count;
+    moment->priv->planet_order[moment->priv->planet_count++] = planet_data;
 
     g_signal_emit(moment, gswe_moment_signals[SIGNAL_PLANET_ADDED], 0, planet);
 }
 
-static void
-planet_add(gpointer key, gpointer value, GsweMoment *moment)
-{
-    GswePlanet planet = (GswePlanet)GPOINTER_TO_INT(key);
-
-    gswe_moment_add_planet(moment, planet, NULL);
-}
-
 /**
  * gswe_moment_add_all_planets:
  * @moment: a GsweMoment object
@@ -942,7 +1985,64 @@ planet_add(gpointer key, gpointer value, GsweMoment *moment)
 void
 gswe_moment_add_all_planets(GsweMoment *moment)
 {
-    g_hash_table_foreach(gswe_planet_info_table, (GHFunc)planet_add, moment);
+    gint slot;
+
+    for (slot = 0; slot < GSWE_PLANET_SLOT_COUNT; slot++) {
+        if (gswe_planet_infos[slot].refcount > 0) {
+            gswe_moment_add_planet(
+                    moment,
+                    gswe_planet_infos[slot].planet,
+                    NULL
+                );
+        }
+    }
+}
+
+// The kinds of Swiss Ephemeris problems logged by
+// gswe_moment_calculate_planet()
+typedef enum {
+    GSWE_MOMENT_PLANET_ERROR_FATAL,
+    GSWE_MOMENT_PLANET_ERROR_MOSHIER,
+    GSWE_MOMENT_PLANET_ERROR_NONFATAL,
+    GSWE_MOMENT_PLANET_ERROR_COUNT
+} GsweMomentPlanetError;
+
+// Planets for which a Swiss Ephemeris problem has already been logged, for
+// every kind of problem, indexed by gswe_planet_get_slot(). A missing data
+// file fails the same way for every chart, so it is logged only once instead
+// of on every calculation
+static gint planet_error_logged
+    [GSWE_MOMENT_PLANET_ERROR_COUNT][GSWE_PLANET_SLOT_COUNT];
+
+static gboolean
+planet_error_needs_log(
+        GswePlanetInfo *planet_info,
+        GsweMomentPlanetError error)
+{
+    gint slot = gswe_planet_get_slot(planet_info->planet);
+
+    return (slot < 0)
+        || g_atomic_int_compare_and_exchange(
+                &planet_error_logged[error][slot],
+                0,
+                1
+            );
+}
+
+// The ephemeris the Swiss Ephemeris has used, according to the flags
+// returned by swe_calc()
+static GsweEphemeris
+ephemeris_from_flags(gint ret)
+{
+    if (ret & SEFLG_MOSEPH) {
+        return GSWE_EPHEMERIS_MOSHIER;
+    }
+
+    if (ret & SEFLG_JPLEPH) {
+        return GSWE_EPHEMERIS_JPL;
+    }
+
+    return GSWE_EPHEMERIS_SWISS;
 }
 
 static void
@@ -950,46 +2050,29 @@ gswe_moment_calculate_planet(GsweMoment *moment,
                              GswePlanet planet,
                              GError     **err)
 {
-    GswePlanetData *planet_data;
-    gpointer       data         = g_list_find_custom(
-            moment->priv->planet_list,
-            &planet,
-            (GCompareFunc)find_planet_by_id
-        );
-
-    g_return_if_fail(data != NULL);
-
-    planet_data = (GswePlanetData *)(g_list_find_custom(
-                moment->priv->planet_list,
-                &planet,
-                (GCompareFunc)find_planet_by_id
-            )->data);
+    GswePlanetData *planet_data = gswe_moment_lookup_planet(moment, planet);
     gchar serr[AS_MAXCH];
     gint ret;
     gdouble x2[6],
             jd;
     GError *calc_err = NULL;
 
-    if (planet_data == NULL) {
-        return;
-    }
+    g_return_if_fail(planet_data != NULL);
 
     if (planet_data->revision == moment->priv->revision) {
         return;
     }
 
-    swe_set_topo(
-            moment->priv->coordinates.longitude,
-            moment->priv->coordinates.latitude,
-            moment->priv->coordinates.altitude
-        );
     jd = gswe_timestamp_get_julian_day_et(moment->priv->timestamp, err);
 
     if (planet_data->planet_info->real_body == FALSE) {
         if (
             (planet_data->planet_info->planet != GSWE_PLANET_ASCENDANT)
+            && (planet_data->planet_info->planet != GSWE_PLANET_DESCENDANT)
             && (planet_data->planet_info->planet != GSWE_PLANET_MC)
+            && (planet_data->planet_info->planet != GSWE_PLANET_IC)
             && (planet_data->planet_info->planet != GSWE_PLANET_VERTEX)
+            && (planet_data->planet_info->planet != GSWE_PLANET_ANTIVERTEX)
         ) {
             g_warning(
                     "The position data of planet %d can not be "
@@ -1000,7 +2083,8 @@ gswe_moment_calculate_planet(GsweMoment *moment,
             return;
         } else {
             // gswe_moment_calculate_house_positions() calculates house cusp
-            // positions, together with Ascendant, MC and Vertex points
+            // positions, together with the Ascendant, MC and Vertex points
+            // and their opposites
             gswe_moment_calculate_house_positions(moment, err);
 
             return;
@@ -1011,36 +2095,88 @@ gswe_moment_calculate_planet(GsweMoment *moment,
         return;
     }
 
-    if ((ret = swe_calc(
-                    jd,
-                    planet_data->planet_info->sweph_id,
-                    SEFLG_SPEED | SEFLG_TOPOCTR,
-                    x2,
-                    serr
-                )) < 0) {
-        g_warning("Swiss Ephemeris error: %s", serr);
-        g_set_error(
+    // The Swiss Ephemeris keeps its saved positions unless the observer
+    // really changes, so this is cheap for every planet of the same moment.
+    // It still has to be done here, as another moment may have set a
+    // different observer since our last calculation, unless we have a
+    // context of our own
+    gswe_context_enter(moment->priv->context);
+    swe_set_topo(
+            moment->priv->coordinates.longitude,
+            moment->priv->coordinates.latitude,
+            moment->priv->coordinates.altitude
+        );
+    ret = swe_calc(
+            jd,
+            planet_data->planet_info->sweph_id,
+            SEFLG_SPEED | SEFLG_TOPOCTR,
+            x2,
+            serr
+        );
+    gswe_context_leave(moment->priv->context);
+
+    // The messages are only formatted when they are logged; the errors are
+    // fixed strings, so a chart that keeps failing the same way stays cheap
+    if (ret < 0) {
+        planet_data->ephemeris = GSWE_EPHEMERIS_NONE;
+
+        if (planet_error_needs_log(
+                    planet_data->planet_info,
+                    GSWE_MOMENT_PLANET_ERROR_FATAL
+                )) {
+            g_warning("Swiss Ephemeris error: %s", serr);
+        }
+
+        g_set_error_literal(
                 err,
                 GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
-                "Swiss Ephemeris fatal error: %s",
-                serr
+                "Swiss Ephemeris fatal error"
             );
 
         return;
+    }
+
+    planet_data->ephemeris = ephemeris_from_flags(ret);
+
+    if (planet_data->ephemeris == GSWE_EPHEMERIS_MOSHIER) {
+        // The data file of the planet is not installed. This is reported
+        // by gswe_planet_data_get_ephemeris(), too
+        if (planet_error_needs_log(
+                    planet_data->planet_info,
+                    GSWE_MOMENT_PLANET_ERROR_MOSHIER
+                )) {
+            g_warning(
+                    "Swiss Ephemeris data file for %s is not installed, "
+                    "using the Moshier ephemeris",
+                    gswe_planet_info_get_name(planet_data->planet_info)
+                );
+        }
+
+        g_set_error_literal(
+                err,
+                GSWE_ERROR, GSWE_ERROR_SWE_NONFATAL,
+                "Swiss Ephemeris data file not installed, "
+                "using the Moshier ephemeris"
+            );
     } else if (ret != (SEFLG_SPEED | SEFLG_TOPOCTR)) {
-        g_warning("Swiss Ephemeris non-fatal error: %s", serr);
-        g_set_error(
+        if (planet_error_needs_log(
+                    planet_data->planet_info,
+                    GSWE_MOMENT_PLANET_ERROR_NONFATAL
+                )) {
+            g_warning("Swiss Ephemeris non-fatal error: %s", serr);
+        }
+
+        g_set_error_literal(
                 err,
                 GSWE_ERROR, GSWE_ERROR_SWE_NONFATAL,
-                "Swiss Ephemeris error: %s",
-                serr
+                "Swiss Ephemeris non-fatal error"
             );
     }
 
     // The south node is actually on the opposite side of the chart,
     // so let’s invert the position.
     if (planet == GSWE_PLANET_MOON_SOUTH_NODE) {
-        x2[0] = fmod(x2[0] + 180.0, 180.0);
+        gswe_moment_south_node(x2);
     }
 
     calculate_data_by_position(moment, planet, x2[0], &calc_err);
@@ -1167,47 +2303,62 @@ gswe_moment_get_house_planets(GsweMoment *moment, guint house)
  *
  * Returns the number of the house in which @position is.
  *
- * Returns: the number of the house in which @position is. This function always
- *          yields 0 if the associated house system is #GSWE_HOUSE_SYSTEM_NONE.
+ * Returns: the number of the house in which @position is (between 1 and 12,
+ *          or 1 and 36 for #GSWE_HOUSE_SYSTEM_GAUQUELIN). This function always
+ *          yields 0 if the associated house system is #GSWE_HOUSE_SYSTEM_NONE,
+ *          or if the house cusps can not be calculated.
  */
 gint
 gswe_moment_get_house(GsweMoment *moment, gdouble position, GError **err)
 {
-    gint i;
-
     if (moment->priv->house_system == GSWE_HOUSE_SYSTEM_NONE) {
         return 0;
     }
 
     gswe_moment_calculate_house_positions(moment, err);
 
-    /* TODO: SWE house system 'G' (Gauquelin sector cusps) have 36 houses; we
-     * should detect that somehow (house system 'G' is not implemented yet in
-     * GsweHouseSystem, and all other house systems have exactly 12 houses, so
-     * this should not cause trouble yet, though) */
-    for (i = 1; i <= 12; i++) {
-        gint j = (i < 12) ? i + 1 : 1;
-        gdouble cusp_i = *(gdouble *)g_list_nth_data(
-                moment->priv->house_list,
-                i - 1
-            ),
-                cusp_j = *(gdouble *)g_list_nth_data(
-                        moment->priv->house_list,
-                        j - 1
-                    );
+    return gswe_moment_house_cusps_find(&moment->priv->house_cusps, position);
+}
 
-        if (cusp_j < cusp_i) {
-            if ((position >= cusp_i) || (position < cusp_j)) {
-                return i;
-            }
-        } else {
-            if ((position >= cusp_i) && (position < cusp_j)) {
-                return i;
-            }
-        }
+/**
+ * gswe_moment_get_houses:
+ * @moment: a GsweMoment object
+ * @positions: (array length=count): ecliptic positions
+ * @houses: (out caller-allocates) (array length=count): return location for
+ *          the house numbers
+ * @count: the number of elements in @positions and @houses
+ * @err: a #GError
+ *
+ * Gets the house of every position in @positions, the same way
+ * gswe_moment_get_house() does, but calculating the house cusps only once.
+ * The house of @positions[i] is stored in @houses[i].
+ *
+ * Since: 2.2
+ */
+void
+gswe_moment_get_houses(
+        GsweMoment *moment,
+        const gdouble *positions,
+        gint *houses,
+        guint count,
+        GError **err)
+{
+    guint i;
+
+    if (moment->priv->house_system == GSWE_HOUSE_SYSTEM_NONE) {
+        memset(houses, 0, count * sizeof(gint));
+
+        return;
     }
 
-    return 0;
+    gswe_moment_calculate_house_positions(moment, err);
+
+    for (i = 0; i < count; i++) {
+        houses[i] = gswe_moment_house_cusps_find(
+                &moment->priv->house_cusps,
+                positions[i]
+            );
+    }
 }
 
 /**
@@ -1230,20 +2381,9 @@ gswe_moment_get_house(GsweMoment *moment, gdouble position, GError **err)
 GswePlanetData *
 gswe_moment_get_planet(GsweMoment *moment, GswePlanet planet, GError **err)
 {
-    GList *planet_element;
     GswePlanetData *planet_data;
 
-    if ((planet_element = g_list_find_custom(
-                    moment->priv->planet_list,
-                    &planet,
-                    (GCompareFunc)find_planet_by_id
-                )) == NULL) {
-        return NULL;
-    }
-
-    planet_data = (GswePlanetData *)(planet_element->data);
-
-    if (planet_data == NULL) {
+    if ((planet_data = gswe_moment_lookup_planet(moment, planet)) == NULL) {
         g_set_error(
                 err,
                 GSWE_ERROR, GSWE_ERROR_UNKNOWN_PLANET,
@@ -1401,87 +2541,197 @@ gswe_moment_get_moon_phase(GsweMoment *moment, GError **err)
     return gswe_moon_phase_data_ref(moment->priv->moon_phase);
 }
 
-static gint
-find_aspect_by_both_planets(
-        GsweAspectData *aspect,
-        struct GsweAspectFinder *aspect_finder)
+/*
+ * gswe_moment_build_circle:
+ * @moment: a GsweMoment
+ * @circle: the #GsweMomentCircle to fill
+ *
+ * Sorts the (already calculated) planets of @moment by their position.
+ */
+static void
+gswe_moment_build_circle(GsweMoment *moment, GsweMomentCircle *circle)
 {
-    if (
-        (
-            (aspect->planet1->planet_info->planet == aspect_finder->planet1)
-            && (aspect->planet2->planet_info->planet == aspect_finder->planet2)
-        )
-        || (
-            (aspect->planet1->planet_info->planet == aspect_finder->planet2)
-            && (aspect->planet2->planet_info->planet == aspect_finder->planet1)
-        )
-    ) {
-        return 0;
+    guint i;
+
+    circle->count = 0;
+    circle->max_orb = 0.0;
+
+    // There are at most GSWE_PLANET_SLOT_COUNT planets in a moment, so a
+    // simple insertion sort is more than enough here
+    for (i = 0; i < moment->priv->planet_count; i++) {
+        GswePlanetData *planet_data = moment->priv->planet_order[i];
+        guint j = circle->count++;
+
+        while ((j > 0) && (circle->position[j - 1] > planet_data->position)) {
+            circle->position[j] = circle->position[j - 1];
+            circle->index[j] = circle->index[j - 1];
+            j--;
+        }
+
+        circle->position[j] = planet_data->position;
+        circle->index[j] = i;
+        circle->max_orb = fmax(
+                circle->max_orb,
+                planet_data->planet_info->orb
+            );
+    }
+}
+
+/*
+ * gswe_moment_circle_mark_window:
+ * @circle: a #GsweMomentCircle
+ * @from: a position in @circle
+ * @start: the start of the window on the ecliptic, in degrees
+ * @width: the width of the window, in degrees. Must be less than 360
+ * @candidates: a pair matrix to mark candidate pairs in
+ *
+ * Marks the pairs made of the planet at @from and every other planet in the
+ * [@start; @start + @width] window of the ecliptic in @candidates.
+ */
+static void
+gswe_moment_circle_mark_window(
+        GsweMomentCircle *circle,
+        guint from,
+        gdouble start,
+        gdouble width,
+        gboolean *candidates)
+{
+    guint low = 0,
+          high = circle->count,
+          i;
+
+    if ((start = fmod(start, 360.0)) < 0.0) {
+        start += 360.0;
+    }
+
+    // Find the first planet not before start…
+    while (low < high) {
+        guint middle = (low + high) / 2;
+
+        if (circle->position[middle] < start) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // …then walk the circle until we leave the window
+    for (i = 0; i < circle->count; i++, low++) {
+        gdouble gap;
+
+        if (low == circle->count) {
+            low = 0;
+        }
+
+        if ((gap = circle->position[low] - start) < 0.0) {
+            gap += 360.0;
+        }
+
+        if (gap > width) {
+            break;
+        }
+
+        if (low != from) {
+            candidates[GSWE_MOMENT_PAIR_INDEX(
+                    circle->index[from],
+                    circle->index[low]
+                )] = TRUE;
+        }
+    }
+}
+
+static void
+gswe_moment_grow_aspect_matrix(GsweMoment *moment)
+{
+    GsweMomentPrivate *priv = moment->priv;
+    guint i,
+          j;
+
+    if (priv->aspect_matrix_planets == priv->planet_count) {
+        return;
     }
 
-    return 1;
+    // Pairs are stored ordered by their later planet, so adding new planets
+    // only appends to the matrix
+    priv->aspect_matrix = g_renew(
+            GsweAspectData *,
+            priv->aspect_matrix,
+            GSWE_MOMENT_PAIR_COUNT(priv->planet_count)
+        );
+
+    for (j = priv->aspect_matrix_planets; j < priv->planet_count; j++) {
+        for (i = 0; i < j; i++) {
+            GsweAspectData *aspect_data = gswe_aspect_data_new();
+
+            aspect_data->planet1 = gswe_planet_data_ref(priv->planet_order[j]);
+            aspect_data->planet2 = gswe_planet_data_ref(priv->planet_order[i]);
+            priv->aspect_matrix[GSWE_MOMENT_PAIR_INDEX(i, j)] = aspect_data;
+            priv->aspect_list = g_list_prepend(priv->aspect_list, aspect_data);
+        }
+    }
+
+    priv->aspect_matrix_planets = priv->planet_count;
 }
 
 static void
 gswe_moment_calculate_aspects(GsweMoment *moment)
 {
-    GList *oplanet,
-          *iplanet;
+    GsweMomentPrivate *priv = moment->priv;
+    GsweMomentCircle circle;
+    gboolean candidates[GSWE_MOMENT_PAIR_COUNT(GSWE_PLANET_SLOT_COUNT)];
+    GsweAspectInfo *aspect_info;
+    gint aspect;
+    guint i;
 
-    if (moment->priv->aspect_revision == moment->priv->revision) {
+    if (priv->aspect_revision == priv->revision) {
         return;
     }
 
     gswe_moment_calculate_all_planets(moment);
-    g_list_free_full(
-            moment->priv->aspect_list,
-            (GDestroyNotify)gswe_aspect_data_unref
+    gswe_moment_grow_aspect_matrix(moment);
+    gswe_moment_build_circle(moment, &circle);
+
+    memset(
+            candidates,
+            0,
+            GSWE_MOMENT_PAIR_COUNT(priv->planet_count) * sizeof(gboolean)
         );
-    moment->priv->aspect_list = NULL;
 
-    for (
-            oplanet = moment->priv->planet_list;
-            oplanet;
-            oplanet = g_list_next(oplanet)) {
-        for (
-                iplanet = moment->priv->planet_list;
-                iplanet;
-                iplanet = g_list_next(iplanet)) {
-            GswePlanetData *outer_planet = oplanet->data,
-                           *inner_planet = iplanet->data;
-            struct GsweAspectFinder aspect_finder;
-            GsweAspectData *aspect_data;
-            GList *aspect_data_element;
-
-            if (outer_planet->planet_info->planet
-                    == inner_planet->planet_info->planet
-                ) {
-                continue;
-            }
+    // For every aspect, mark the pairs whose distance may be within the
+    // largest possible orb of that aspect. Every other pair is known to have
+    // no aspect at all
+    for (aspect = 0; aspect < GSWE_ASPECT_COUNT; aspect++) {
+        gdouble orb,
+                window_start;
 
-            aspect_finder.planet1 = outer_planet->planet_info->planet;
-            aspect_finder.planet2 = inner_planet->planet_info->planet;
-
-            if ((aspect_data_element = g_list_find_custom(
-                            moment->priv->aspect_list,
-                            &aspect_finder,
-                            (GCompareFunc)find_aspect_by_both_planets
-                        )) != NULL) {
-                gswe_aspect_data_calculate(aspect_data_element->data);
-            } else {
-                aspect_data = gswe_aspect_data_new_with_planets(
-                        inner_planet,
-                        outer_planet
-                    );
-                moment->priv->aspect_list = g_list_prepend(
-                        moment->priv->aspect_list,
-                        aspect_data
-                    );
-            }
+        if ((aspect == GSWE_ASPECT_NONE)
+                || ((aspect_info = gswe_aspect_info_lookup(aspect)) == NULL)) {
+            continue;
+        }
+
+        orb = fmax(1.0, circle.max_orb - aspect_info->orb_modifier);
+        window_start = fmax(0.0, aspect_info->size - orb);
+
+        for (i = 0; i < circle.count; i++) {
+            gswe_moment_circle_mark_window(
+                    &circle,
+                    i,
+                    circle.position[i] + window_start,
+                    aspect_info->size + orb - window_start,
+                    candidates
+                );
+        }
+    }
+
+    for (i = 0; i < GSWE_MOMENT_PAIR_COUNT(priv->planet_count); i++) {
+        if (candidates[i]) {
+            gswe_aspect_data_calculate(priv->aspect_matrix[i]);
+        } else {
+            gswe_aspect_data_clear(priv->aspect_matrix[i]);
         }
     }
 
-    moment->priv->aspect_revision = moment->priv->revision;
+    priv->aspect_revision = priv->revision;
 }
 
 /**
@@ -1524,8 +2774,9 @@ gswe_moment_get_planet_aspects(
         GswePlanet planet,
         GError **err)
 {
-    GList *ret = NULL,
-          *aspect;
+    GList *ret = NULL;
+    guint index,
+          i;
 
     if (!gswe_moment_has_planet(moment, planet)) {
         g_set_error(
@@ -1539,18 +2790,16 @@ gswe_moment_get_planet_aspects(
 
     gswe_moment_calculate_aspects(moment);
 
-    for (
-            aspect = moment->priv->aspect_list;
-            aspect;
-            aspect = g_list_next(aspect)
-        ) {
-        GsweAspectData *aspect_data = aspect->data;
+    index = moment->priv->planet_index[gswe_planet_get_slot(planet)];
 
-        if (
-            (aspect_data->planet1->planet_info->planet == planet)
-            || (aspect_data->planet2->planet_info->planet == planet)
-        ) {
-            ret = g_list_prepend(ret, aspect_data);
+    for (i = 0; i < moment->priv->planet_count; i++) {
+        if (i != index) {
+            ret = g_list_prepend(
+                    ret,
+                    moment->priv->aspect_matrix[
+                        GSWE_MOMENT_PAIR_INDEX(index, i)
+                    ]
+                );
         }
     }
 
@@ -1579,9 +2828,6 @@ gswe_moment_get_aspect_by_planets(
         GswePlanet planet2,
         GError **err)
 {
-    struct GsweAspectFinder aspect_finder;
-    GList *aspect_data_element;
-
     if (
             !gswe_moment_has_planet(moment, planet1)
             || !gswe_moment_has_planet(moment, planet2)
@@ -1595,107 +2841,115 @@ gswe_moment_get_aspect_by_planets(
         return NULL;
     }
 
-    aspect_finder.planet1 = planet1;
-    aspect_finder.planet2 = planet2;
-
-    if ((aspect_data_element = g_list_find_custom(
-                    moment->priv->aspect_list,
-                    &aspect_finder,
-                    (GCompareFunc)find_aspect_by_both_planets
-                )) != NULL) {
-        return aspect_data_element->data;
+    if (planet1 == planet2) {
+        return NULL;
     }
 
-    return NULL;
+    gswe_moment_calculate_aspects(moment);
+
+    return moment->priv->aspect_matrix[GSWE_MOMENT_PAIR_INDEX(
+            moment->priv->planet_index[gswe_planet_get_slot(planet1)],
+            moment->priv->planet_index[gswe_planet_get_slot(planet2)]
+        )];
 }
 
-static gint
-find_antiscion_by_both_planets(
-        GsweAntiscionData *antiscion,
-        struct GsweAspectFinder *antiscion_finder)
+static void
+gswe_moment_grow_antiscion_matrix(GsweMoment *moment)
 {
-    if (
-        (
-            (antiscion->planet1->planet_info->planet
-                == antiscion_finder->planet1)
-            && (antiscion->planet2->planet_info->planet
-                == antiscion_finder->planet2)
-        )
-        || (
-            (antiscion->planet1->planet_info->planet
-                == antiscion_finder->planet2)
-            && (antiscion->planet2->planet_info->planet
-                == antiscion_finder->planet1)
-        )
-    ) {
-        return 0;
+    GsweMomentPrivate *priv = moment->priv;
+    guint i,
+          j;
+
+    if (priv->antiscion_matrix_planets == priv->planet_count) {
+        return;
+    }
+
+    priv->antiscion_matrix = g_renew(
+            GsweAntiscionData *,
+            priv->antiscion_matrix,
+            GSWE_MOMENT_PAIR_COUNT(priv->planet_count)
+        );
+
+    for (j = priv->antiscion_matrix_planets; j < priv->planet_count; j++) {
+        for (i = 0; i < j; i++) {
+            GsweAntiscionData *antiscion_data = gswe_antiscion_data_new();
+
+            antiscion_data->planet1 = gswe_planet_data_ref(
+                    priv->planet_order[j]
+                );
+            antiscion_data->planet2 = gswe_planet_data_ref(
+                    priv->planet_order[i]
+                );
+            priv->antiscion_matrix[GSWE_MOMENT_PAIR_INDEX(i, j)]
+                = antiscion_data;
+            priv->antiscia_list = g_list_prepend(
+                    priv->antiscia_list,
+                    antiscion_data
+                );
+        }
     }
 
-    return 1;
+    priv->antiscion_matrix_planets = priv->planet_count;
 }
 
 static void
 gswe_moment_calculate_antiscia(GsweMoment *moment)
 {
-    GList *oplanet,
-          *iplanet;
+    GsweMomentPrivate *priv = moment->priv;
+    GsweMomentCircle circle;
+    gboolean candidates[GSWE_MOMENT_PAIR_COUNT(GSWE_PLANET_SLOT_COUNT)];
+    GsweAntiscionAxisInfo *axis_info;
+    gint axis;
+    guint i;
 
-    if (moment->priv->antiscia_revision == moment->priv->revision) {
+    if (priv->antiscia_revision == priv->revision) {
         return;
     }
 
     gswe_moment_calculate_all_planets(moment);
-    g_list_free_full(
-            moment->priv->antiscia_list,
-            (GDestroyNotify)gswe_antiscion_data_unref
+    gswe_moment_grow_antiscion_matrix(moment);
+    gswe_moment_build_circle(moment, &circle);
+
+    memset(
+            candidates,
+            0,
+            GSWE_MOMENT_PAIR_COUNT(priv->planet_count) * sizeof(gboolean)
         );
-    moment->priv->antiscia_list = NULL;
 
-    for (
-            oplanet = moment->priv->planet_list;
-            oplanet;
-            oplanet = g_list_next(oplanet)
-        ) {
-        for (
-                iplanet = moment->priv->planet_list;
-                iplanet;
-                iplanet = g_list_next(iplanet)
-            ) {
-            GswePlanetData *outer_planet = oplanet->data,
-                           *inner_planet = iplanet->data;
-            struct GsweAspectFinder antiscion_finder;
-            GsweAntiscionData *antiscion_data;
-            GList *antiscion_data_element;
-
-            if (outer_planet->planet_info->planet
-                    == inner_planet->planet_info->planet
-                ) {
-                continue;
-            }
+    // The mirror of a planet on an axis starting at S is at 2S - position, so
+    // only planets within the largest orb around that point may be antiscia
+    for (axis = 0; axis < GSWE_ANTISCION_AXIS_COUNT; axis++) {
+        gdouble start_point;
 
-            antiscion_finder.planet1 = outer_planet->planet_info->planet;
-            antiscion_finder.planet2 = inner_planet->planet_info->planet;
-
-            if ((antiscion_data_element = g_list_find_custom(
-                            moment->priv->antiscia_list,
-                            &antiscion_finder,
-                            (GCompareFunc)find_antiscion_by_both_planets)
-                    ) != NULL) {
-                gswe_antiscion_data_calculate(antiscion_data_element->data);
-            } else {
-                antiscion_data = gswe_antiscion_data_new_with_planets(
-                        inner_planet,
-                        outer_planet
-                    );
-                moment->priv->antiscia_list = g_list_prepend(
-                        moment->priv->antiscia_list,
-                        antiscion_data
-                    );
-            }
+        if ((axis == GSWE_ANTISCION_AXIS_NONE)
+                || ((axis_info = gswe_antiscion_axis_info_lookup(axis))
+                    == NULL)) {
+            continue;
+        }
+
+        start_point = (axis_info->start_sign->sign - 1) * 30.0
+            + axis_info->sign_offset;
+
+        for (i = 0; i < circle.count; i++) {
+            gswe_moment_circle_mark_window(
+                    &circle,
+                    i,
+                    2 * start_point - circle.position[i] - circle.max_orb,
+                    2 * circle.max_orb,
+                    candidates
+                );
+        }
+    }
+
+    for (i = 0; i < GSWE_MOMENT_PAIR_COUNT(priv->planet_count); i++) {
+        if (candidates[i]) {
+            gswe_antiscion_data_calculate(priv->antiscion_matrix[i]);
+        } else {
+            gswe_antiscion_data_clear(priv->antiscion_matrix[i]);
         }
     }
 
-    moment->priv->antiscia_revision = moment->priv->revision;
+    priv->antiscia_revision = priv->revision;
 }
 
 /**
@@ -1735,8 +2989,9 @@ gswe_moment_get_all_planet_antiscia(
         GswePlanet planet,
         GError **err)
 {
-    GList *ret = NULL,
-          *antiscion_l;
+    GList *ret = NULL;
+    guint index,
+          i;
 
     if (!gswe_moment_has_planet(moment, planet)) {
         g_set_error(
@@ -1750,14 +3005,16 @@ gswe_moment_get_all_planet_antiscia(
 
     gswe_moment_calculate_antiscia(moment);
 
-    glforeach (antiscion_l, moment->priv->antiscia_list) {
-        GsweAntiscionData *antiscion_data = antiscion_l->data;
+    index = moment->priv->planet_index[gswe_planet_get_slot(planet)];
 
-        if (
-                (antiscion_data->planet1->planet_info->planet == planet)
-                || (antiscion_data->planet2->planet_info->planet == planet)
-            ) {
-            ret = g_list_prepend(ret, antiscion_data);
+    for (i = 0; i < moment->priv->planet_count; i++) {
+        if (i != index) {
+            ret = g_list_prepend(
+                    ret,
+                    moment->priv->antiscion_matrix[
+                        GSWE_MOMENT_PAIR_INDEX(index, i)
+                    ]
+                );
         }
     }
 
@@ -1817,8 +3074,9 @@ gswe_moment_get_axis_planet_antiscia(
         GswePlanet planet,
         GError **err)
 {
-    GList *ret = NULL,
-          *antiscion_l;
+    GList *ret = NULL;
+    guint index,
+          i;
 
     if (!gswe_moment_has_planet(moment, planet)) {
         g_set_error(
@@ -1832,16 +3090,20 @@ gswe_moment_get_axis_planet_antiscia(
 
     gswe_moment_calculate_antiscia(moment);
 
-    glforeach (antiscion_l, moment->priv->antiscia_list) {
-        GsweAntiscionData *antiscion_data = antiscion_l->data;
+    index = moment->priv->planet_index[gswe_planet_get_slot(planet)];
 
-        if (
-            (
-                (antiscion_data->planet1->planet_info->planet == planet)
-                || (antiscion_data->planet2->planet_info->planet == planet)
-            )
-            && (antiscion_data->antiscion_axis_info->axis == axis)
-        ) {
+    for (i = 0; i < moment->priv->planet_count; i++) {
+        GsweAntiscionData *antiscion_data;
+
+        if (i == index) {
+            continue;
+        }
+
+        antiscion_data = moment->priv->antiscion_matrix[
+                GSWE_MOMENT_PAIR_INDEX(index, i)
+            ];
+
+        if (antiscion_data->antiscion_axis_info->axis == axis) {
             ret = g_list_prepend(ret, antiscion_data);
         }
     }
@@ -1871,9 +3133,6 @@ gswe_moment_get_antiscion_by_planets(
         GswePlanet planet2,
         GError **err)
 {
-    struct GsweAspectFinder antiscion_finder;
-    GList *antiscion_data_element;
-
     if (
             !gswe_moment_has_planet(moment, planet1)
             || !gswe_moment_has_planet(moment, planet2)
@@ -1887,17 +3146,15 @@ gswe_moment_get_antiscion_by_planets(
         return NULL;
     }
 
-    antiscion_finder.planet1 = planet1;
-    antiscion_finder.planet2 = planet2;
-
-    if ((antiscion_data_element = g_list_find_custom(
-                    moment->priv->antiscia_list,
-                    &antiscion_finder,
-                    (GCompareFunc)find_antiscion_by_both_planets
-                )) != NULL) {
-        return antiscion_data_element->data;
+    if (planet1 == planet2) {
+        return NULL;
     }
 
-    return NULL;
+    gswe_moment_calculate_antiscia(moment);
+
+    return moment->priv->antiscion_matrix[GSWE_MOMENT_PAIR_INDEX(
+            moment->priv->planet_index[gswe_planet_get_slot(planet1)],
+            moment->priv->planet_index[gswe_planet_get_slot(planet2)]
+        )];
 }
 
@@ -21,6 +21,7 @@
 #include <glib-object.h>
 
 #include "gswe-timestamp.h"
+#include "gswe-context.h"
 #include "gswe-moon-phase-data.h"
 #include "gswe-planet-data.h"
 #include "gswe-types.h"
@@ -98,6 +99,27 @@ struct _GsweMomentClass {
     void (*_swe_glib_reserved20)(void);
 };
 
+/**
+ * GsweMomentSeries:
+ * @longitude: (array): ecliptic longitudes, in degrees
+ * @latitude: (array): ecliptic latitudes, in degrees
+ * @speed: (array): speeds in longitude, in degrees per day
+ * @sign: (array): the signs of the positions in @longitude
+ * @house: (array): the houses of the positions in @longitude
+ *
+ * Caller-allocated buffers for gswe_moment_calculate_series(). Any of the
+ * arrays may be %NULL, if those values are not needed.
+ *
+ * Since: 2.2
+ */
+typedef struct _GsweMomentSeries {
+    gdouble *longitude;
+    gdouble *latitude;
+    gdouble *speed;
+    GsweZodiac *sign;
+    gint *house;
+} GsweMomentSeries;
+
 /* used by GSWE_TYPE_MOMENT */
 GType gswe_moment_get_type(void);
 
@@ -111,10 +133,54 @@ GsweMoment *gswe_moment_new_full(
         gdouble altitude,
         GsweHouseSystem house_system);
 
+gboolean gswe_moment_calculate_series(
+        const gdouble *julian_days,
+        guint count,
+        gboolean universal_time,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        GsweMomentSeries *series,
+        GError **err);
+
+gboolean gswe_moment_calculate_time_series(
+        const GsweTime *times,
+        guint count,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        GsweMomentSeries *series,
+        GError **err);
+
+gboolean gswe_moment_calculate_series_parallel(
+        const gdouble *julian_days,
+        guint count,
+        gboolean universal_time,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        const GswePlanet *planets,
+        guint planet_count,
+        guint max_threads,
+        GsweMomentSeries *series,
+        GError **err);
+
 void gswe_moment_set_timestamp(GsweMoment *moment, GsweTimestamp *timestamp);
 
 GsweTimestamp *gswe_moment_get_timestamp(GsweMoment *moment);
 
+void gswe_moment_set_time(
+        GsweMoment *moment,
+        const GsweTime *instant,
+        GError **err);
+
 void gswe_moment_set_coordinates(
         GsweMoment *moment,
         gdouble longitude,
@@ -129,10 +195,34 @@ void gswe_moment_set_house_system(
 
 GsweHouseSystem gswe_moment_get_house_system(GsweMoment *moment);
 
+void gswe_moment_set_context(GsweMoment *moment, GsweContext *context);
+
+GsweContext *gswe_moment_get_context(GsweMoment *moment);
+
+void gswe_moment_update_begin(GsweMoment *moment);
+
+void gswe_moment_update_commit(GsweMoment *moment);
+
+void gswe_moment_set_all(
+        GsweMoment *moment,
+        const GsweTime *instant,
+        gdouble longitude,
+        gdouble latitude,
+        gdouble altitude,
+        GsweHouseSystem house_system,
+        GError **err);
+
 GList *gswe_moment_get_house_cusps(GsweMoment *moment, GError **err);
 
 gint gswe_moment_get_house(GsweMoment *moment, gdouble position, GError **err);
 
+void gswe_moment_get_houses(
+        GsweMoment *moment,
+        const gdouble *positions,
+        gint *houses,
+        guint count,
+        GError **err);
+
 gboolean gswe_moment_has_planet(GsweMoment *moment, GswePlanet planet);
 
 void gswe_moment_add_planet(
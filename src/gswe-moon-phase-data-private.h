@@ -30,7 +30,7 @@ struct _GsweMoonPhaseData {
     gdouble illumination;
 
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_MOON_PHASE_DATA_PRIVATE_H__ */
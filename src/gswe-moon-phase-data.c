@@ -73,7 +73,7 @@ gswe_moon_phase_data_new(void)
 GsweMoonPhaseData *
 gswe_moon_phase_data_ref(GsweMoonPhaseData *moon_phase_data)
 {
-    moon_phase_data->refcount++;
+    g_atomic_int_inc(&moon_phase_data->refcount);
 
     return moon_phase_data;
 }
@@ -92,7 +92,7 @@ gswe_moon_phase_data_unref(GsweMoonPhaseData *moon_phase_data)
         return;
     }
 
-    if (--moon_phase_data->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&moon_phase_data->refcount)) {
         g_free(moon_phase_data);
     }
 }
@@ -39,11 +39,14 @@ struct _GswePlanetData {
      * planet is in */
     GsweSignInfo *sign_info;
 
+    /* The ephemeris the position is calculated from */
+    GsweEphemeris ephemeris;
+
     /* An internal version number of the calculation */
     guint revision;
 
     /* reference count */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_PLANET_DATA_PRIVATE_H__ */
@@ -84,7 +84,7 @@ gswe_planet_data_new(void)
 GswePlanetData *
 gswe_planet_data_ref(GswePlanetData *planet_data)
 {
-    planet_data->refcount++;
+    g_atomic_int_inc(&planet_data->refcount);
 
     return planet_data;
 }
@@ -103,7 +103,7 @@ gswe_planet_data_unref(GswePlanetData *planet_data)
         return;
     }
 
-    if (--planet_data->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&planet_data->refcount)) {
         gswe_planet_data_free(planet_data);
     }
 }
@@ -126,10 +126,7 @@ gswe_planet_data_set_planet(
 {
     GswePlanetInfo *planet_info;
 
-    if ((planet_info = g_hash_table_lookup(
-                    gswe_planet_info_table,
-                    GINT_TO_POINTER(planet)
-                )) == NULL) {
+    if ((planet_info = gswe_planet_info_lookup(planet)) == NULL) {
         g_set_error(err,
                 GSWE_ERROR, GSWE_ERROR_UNKNOWN_PLANET,
                 "Planet is unknown"
@@ -245,6 +242,28 @@ gswe_planet_data_get_retrograde(GswePlanetData *planet_data)
     return planet_data->retrograde;
 }
 
+/**
+ * gswe_planet_data_get_ephemeris:
+ * @planet_data: (in): a #GswePlanetData
+ *
+ * Gets the ephemeris the position of the planet is calculated from. If the
+ * Swiss Ephemeris data file for the planet and date is not installed, this
+ * is %GSWE_EPHEMERIS_MOSHIER, and the position is less precise.
+ *
+ * Returns: the ephemeris used for the last calculation of the planet
+ *
+ * Since: 2.2
+ */
+GsweEphemeris
+gswe_planet_data_get_ephemeris(GswePlanetData *planet_data)
+{
+    if (planet_data == NULL) {
+        return GSWE_EPHEMERIS_NONE;
+    }
+
+    return planet_data->ephemeris;
+}
+
 /**
  * gswe_planet_data_get_house:
  * @planet_data: (in): a #GswePlanetData
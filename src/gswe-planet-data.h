@@ -62,6 +62,8 @@ gdouble gswe_planet_data_get_position(GswePlanetData *planet_data);
 
 gboolean gswe_planet_data_get_retrograde(GswePlanetData *planet_data);
 
+GsweEphemeris gswe_planet_data_get_ephemeris(GswePlanetData *planet_data);
+
 guint gswe_planet_data_get_house(GswePlanetData *planet_data);
 
 GsweZodiac gswe_planet_data_get_sign(GswePlanetData *planet_data);
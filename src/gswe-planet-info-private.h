@@ -41,11 +41,15 @@ struct _GswePlanetInfo {
     /* the planet's name */
     gchar *name;
 
+    /* the untranslated name of the built-in records, used while name is not
+     * set */
+    const gchar *msgid;
+
     /* the value this planet counts in the element/quality points table */
     gint points;
 
     /* reference counter */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_PLANET_INFO_PRIVATE_H__ */
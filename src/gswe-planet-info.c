@@ -16,6 +16,7 @@
  * along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 #include "gswe-types.h"
+#include "swe-glib-private.h"
 
 #include "gswe-planet-info.h"
 #include "gswe-planet-info-private.h"
@@ -65,7 +66,7 @@ gswe_planet_info_new(void)
 GswePlanetInfo *
 gswe_planet_info_ref(GswePlanetInfo *planet_info)
 {
-    planet_info->refcount++;
+    g_atomic_int_inc(&planet_info->refcount);
 
     return planet_info;
 }
@@ -90,7 +91,7 @@ gswe_planet_info_free(GswePlanetInfo *planet_info)
 void
 gswe_planet_info_unref(GswePlanetInfo *planet_info)
 {
-    if (--planet_info->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&planet_info->refcount)) {
         gswe_planet_info_free(planet_info);
     }
 }
@@ -186,6 +187,10 @@ gswe_planet_info_get_real_body(GswePlanetInfo *planet_info)
  *
  * Sets the orb of @planet_info. This value is used in aspect and antiscion
  * calculations.
+ *
+ * The planets known by SWE-GLib are shared by all threads, and this is not
+ * thread safe for them: change their orb only during initialization, before
+ * any thread starts calculating.
  */
 void
 gswe_planet_info_set_orb(GswePlanetInfo *planet_info, gdouble orb)
@@ -228,13 +233,19 @@ gswe_planet_info_set_name(GswePlanetInfo *planet_info, const gchar *name)
  * gswe_planet_info_get_name:
  * @planet_info: (in): A #GswePlanetInfo
  *
- * Gets the name of the planet.
+ * Gets the name of the planet. If NLS is enabled, the names of the planets
+ * known by SWE-GLib are translated on every call, so they follow the current
+ * locale.
  *
  * Returns: (transfer none): the planet's name
  */
 const gchar *
 gswe_planet_info_get_name(GswePlanetInfo *planet_info)
 {
+    if ((planet_info->name == NULL) && (planet_info->msgid != NULL)) {
+        return gswe_translate(planet_info->msgid);
+    }
+
     return planet_info->name;
 }
 
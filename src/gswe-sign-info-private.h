@@ -30,6 +30,10 @@ struct _GsweSignInfo {
     /* the name of this sign */
     gchar *name;
 
+    /* the untranslated name of the built-in records, used while name is not
+     * set */
+    const gchar *msgid;
+
     /* the element of the sign */
     GsweElement element;
 
@@ -37,7 +41,7 @@ struct _GsweSignInfo {
     GsweQuality quality;
 
     /* Reference counter */
-    guint refcount;
+    volatile gint refcount;
 };
 
 #endif /* __SWE_GLIB_GSWE_SIGN_INFO_PRIVATE_H__ */
@@ -16,6 +16,7 @@
  * along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 #include "gswe-types.h"
+#include "swe-glib-private.h"
 
 #include "gswe-sign-info.h"
 #include "gswe-sign-info-private.h"
@@ -74,7 +75,7 @@ gswe_sign_info_new(void)
 GsweSignInfo *
 gswe_sign_info_ref(GsweSignInfo *sign_info)
 {
-    sign_info->refcount++;
+    g_atomic_int_inc(&sign_info->refcount);
 
     return sign_info;
 }
@@ -89,7 +90,7 @@ gswe_sign_info_ref(GsweSignInfo *sign_info)
 void
 gswe_sign_info_unref(GsweSignInfo *sign_info)
 {
-    if (--sign_info->refcount == 0) {
+    if (g_atomic_int_dec_and_test(&sign_info->refcount)) {
         gswe_sign_info_free(sign_info);
     }
 }
@@ -142,13 +143,19 @@ gswe_sign_info_set_name(GsweSignInfo *sign_info, const gchar *name)
  * gswe_sign_info_get_name:
  * @sign_info: (in): a #GsweSignInfo
  *
- * Gets the name associated with this sign.
+ * Gets the name associated with this sign. If NLS is enabled, the names of the
+ * signs known by SWE-GLib are translated on every call, so they follow the
+ * current locale.
  *
  * Returns: (transfer none): the name of the zodiac sign
  */
 const gchar *
 gswe_sign_info_get_name(GsweSignInfo *sign_info)
 {
+    if ((sign_info->name == NULL) && (sign_info->msgid != NULL)) {
+        return gswe_translate(sign_info->msgid);
+    }
+
     return sign_info->name;
 }
 
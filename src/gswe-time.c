@@ -0,0 +1,791 @@
+/* gswe-time.c: Plain time value with conversion functions
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+
+#include "swe-glib-private.h"
+#include "swe-glib.h"
+#include "gswe-time.h"
+
+#include "../swe/src/swephexp.h"
+
+/**
+ * SECTION:gswe-time
+ * @short_description: a plain time value
+ * @title: GsweTime
+ * @stability: Stable
+ * @include: swe-glib.h
+ *
+ * #GsweTime holds a point in time as Julian day values, and provides the
+ * conversions between Gregorian dates, Julian days in Ephemeris and Universal
+ * Time, and sidereal time as plain functions.
+ *
+ * It is meant for code that steps through many points in time, like
+ * searching for events or drawing time lines, where the property
+ * notifications of a #GsweTimestamp would cost more than the calculations
+ * themselves. #GsweTimestamp uses the same conversions internally, and can be
+ * converted to and from a #GsweTime with gswe_timestamp_get_time() and
+ * gswe_timestamp_set_time().
+ *
+ * To convert many dates at once, like the records of a large data set, use
+ * the array versions of the conversions, like gswe_time_utc_to_jd_array().
+ * They do the calendar calculations with integer arithmetic on whole arrays,
+ * and look up leap seconds only when the date passes one, which is much
+ * faster than converting the dates one by one, especially if they are
+ * sorted.
+ */
+
+// The same values as in swedate.c
+#define J1972 2441317.5
+#define NLEAP_INIT 10
+
+// The calendar calculations below shift the years by 1000 cycles of the
+// Gregorian calendar, so all intermediate values are positive between the
+// years -400000 and 400000, and the integer divisions round down
+#define CALENDAR_SHIFT_YEARS 400000
+#define CALENDAR_SHIFT_DAYS (146097 * 1000)
+
+enum {
+    DATE_VALID,
+    DATE_LEAP_SECOND,
+    DATE_INVALID
+};
+
+G_DEFINE_BOXED_TYPE(
+        GsweTime,
+        gswe_time,
+        (GBoxedCopyFunc)gswe_time_copy,
+        (GBoxedFreeFunc)gswe_time_free);
+
+/**
+ * gswe_time_copy:
+ * @instant: a #GsweTime
+ *
+ * Creates a heap allocated copy of @instant.
+ *
+ * Returns: (transfer full): a new #GsweTime. Free it with gswe_time_free()
+ *
+ * Since: 2.2
+ */
+GsweTime *
+gswe_time_copy(const GsweTime *instant)
+{
+    GsweTime *ret = g_new(GsweTime, 1);
+
+    *ret = *instant;
+
+    return ret;
+}
+
+/**
+ * gswe_time_free:
+ * @instant: a #GsweTime created by gswe_time_copy()
+ *
+ * Frees @instant.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_free(GsweTime *instant)
+{
+    g_free(instant);
+}
+
+/**
+ * gswe_time_set_julian_day_et:
+ * @instant: a #GsweTime
+ * @julian_day: the Julian day in Ephemeris Time (ET)
+ *
+ * Sets @instant to @julian_day, and calculates its Universal Time (UT) value
+ * the same way the Swiss Ephemeris does when it converts dates. The time zone
+ * offset of @instant is not changed.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_set_julian_day_et(GsweTime *instant, gdouble julian_day)
+{
+    gdouble delta_t,
+            julian_day_ut;
+
+    gswe_thread_init();
+
+    // Delta T is a function of UT, so approach it from the ET value. This is
+    // what swe_jdet_to_utc() and swe_utc_to_jd() do, too
+    delta_t = swe_deltat(julian_day);
+    julian_day_ut = julian_day - swe_deltat(julian_day - delta_t);
+    julian_day_ut = julian_day - swe_deltat(julian_day_ut);
+
+    instant->julian_day_et = julian_day;
+    instant->julian_day_ut = julian_day_ut;
+}
+
+/**
+ * gswe_time_set_julian_day_ut:
+ * @instant: a #GsweTime
+ * @julian_day: the Julian day in Universal Time (UT)
+ *
+ * Sets @instant to @julian_day, and calculates its Ephemeris Time (ET) value.
+ * The time zone offset of @instant is not changed.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_set_julian_day_ut(GsweTime *instant, gdouble julian_day)
+{
+    gswe_thread_init();
+
+    instant->julian_day_et = julian_day + swe_deltat(julian_day);
+    instant->julian_day_ut = julian_day;
+}
+
+/**
+ * gswe_time_set_gregorian:
+ * @instant: a #GsweTime
+ * @year: the year
+ * @month: the month
+ * @day: the day
+ * @hour: the hour
+ * @minute: the minute
+ * @second: the second, with its fractions
+ * @timezone_offset: the time zone offset of the date, in hours
+ * @err: a #GError
+ *
+ * Sets @instant to the given Gregorian date of the time zone
+ * @timezone_offset. Leap seconds are taken into account for dates after
+ * 1972, as UTC is defined.
+ *
+ * Returns: %TRUE on success. If the date is invalid, @err is set, and
+ *          @instant is not changed
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_time_set_gregorian(
+        GsweTime *instant,
+        gint year, gint month, gint day,
+        gint hour, gint minute, gdouble second,
+        gdouble timezone_offset,
+        GError **err)
+{
+    gint utc_year,
+         utc_month,
+         utc_day,
+         utc_hour,
+         utc_minute;
+    gdouble utc_second,
+            dret[2];
+    gchar serr[AS_MAXCH];
+
+    gswe_thread_init();
+    swe_utc_time_zone(
+            year, month, day,
+            hour, minute, second,
+            timezone_offset,
+            &utc_year, &utc_month, &utc_day,
+            &utc_hour, &utc_minute, &utc_second
+        );
+
+    if (swe_utc_to_jd(
+                utc_year, utc_month, utc_day,
+                utc_hour, utc_minute, utc_second,
+                SE_GREG_CAL, dret, serr
+            ) == ERR) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
+                "Swiss Ephemeris error: %s", serr
+            );
+
+        return FALSE;
+    }
+
+    instant->julian_day_et = dret[0];
+    instant->julian_day_ut = dret[1];
+    instant->timezone_offset = timezone_offset;
+
+    return TRUE;
+}
+
+/**
+ * gswe_time_get_gregorian:
+ * @instant: a #GsweTime
+ * @year: (out) (allow-none): a place to store the year
+ * @month: (out) (allow-none): a place to store the month
+ * @day: (out) (allow-none): a place to store the day
+ * @hour: (out) (allow-none): a place to store the hour
+ * @minute: (out) (allow-none): a place to store the minute
+ * @second: (out) (allow-none): a place to store the second, with its fractions
+ *
+ * Converts @instant to a Gregorian date in the time zone of @instant. Any of
+ * the output parameters may be %NULL.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_get_gregorian(
+        const GsweTime *instant,
+        gint *year, gint *month, gint *day,
+        gint *hour, gint *minute, gdouble *second)
+{
+    gint utc_year,
+         utc_month,
+         utc_day,
+         utc_hour,
+         utc_minute,
+         local_year,
+         local_month,
+         local_day,
+         local_hour,
+         local_minute;
+    gdouble utc_second,
+            local_second;
+
+    gswe_thread_init();
+    swe_jdet_to_utc(
+            instant->julian_day_et,
+            SE_GREG_CAL,
+            &utc_year, &utc_month, &utc_day,
+            &utc_hour, &utc_minute, &utc_second
+        );
+    swe_utc_time_zone(
+            utc_year, utc_month, utc_day,
+            utc_hour, utc_minute, utc_second,
+            0 - instant->timezone_offset,
+            &local_year, &local_month, &local_day,
+            &local_hour, &local_minute, &local_second
+        );
+
+    if (year) {
+        *year = local_year;
+    }
+
+    if (month) {
+        *month = local_month;
+    }
+
+    if (day) {
+        *day = local_day;
+    }
+
+    if (hour) {
+        *hour = local_hour;
+    }
+
+    if (minute) {
+        *minute = local_minute;
+    }
+
+    if (second) {
+        *second = local_second;
+    }
+}
+
+/**
+ * gswe_time_add_days:
+ * @instant: a #GsweTime
+ * @days: the number of days to add to @instant; may be negative or
+ *        fractional
+ *
+ * Moves @instant by @days days of Ephemeris Time, which is the usual way to
+ * step through a range of dates.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_add_days(GsweTime *instant, gdouble days)
+{
+    gswe_time_set_julian_day_et(instant, instant->julian_day_et + days);
+}
+
+/**
+ * gswe_time_get_sidereal_time:
+ * @instant: a #GsweTime
+ *
+ * Gets the sidereal time on the Greenwich Meridian at @instant.
+ *
+ * Returns: the sidereal time in hours. To get the degrees, multiply this value
+ * by 15.
+ *
+ * Since: 2.2
+ */
+gdouble
+gswe_time_get_sidereal_time(const GsweTime *instant)
+{
+    gswe_thread_init();
+
+    return swe_sidtime(instant->julian_day_ut);
+}
+
+// The Julian day number of a Gregorian date; the Julian day of its midnight is
+// this value minus 0.5
+static inline gint
+day_number_from_date(gint year, gint month, gint day)
+{
+    // The year starts in March, so the leap day is at its end
+    gint a = (14 - month) / 12,
+         y = year + 4800 + CALENDAR_SHIFT_YEARS - a,
+         m = month + 12 * a - 3;
+
+    return day + (153 * m + 2) / 5
+        + 365 * y + y / 4 - y / 100 + y / 400
+        - 32045 - CALENDAR_SHIFT_DAYS;
+}
+
+// The day number of the date a Julian day falls on. It rounds down without
+// floor(), which GCC does not vectorize without -fno-trapping-math
+static inline gint
+day_number_from_julian_day(gdouble julian_day)
+{
+    gdouble noon = julian_day + 0.5;
+    gint day_number = (gint)noon;
+
+    return day_number - (day_number > noon);
+}
+
+static inline void
+date_from_day_number(gint day_number, gint *year, gint *month, gint *day)
+{
+    gint j = day_number + CALENDAR_SHIFT_DAYS,
+         f = j + 1401 + (((4 * j + 274277) / 146097) * 3) / 4 - 38,
+         e = 4 * f + 3,
+         h = 5 * ((e % 1461) / 4) + 2;
+
+    *day = (h % 153) / 5 + 1;
+    *month = (h / 153 + 2) % 12 + 1;
+    *year = e / 1461 - 4716 + (14 - *month) / 12 - CALENDAR_SHIFT_YEARS;
+}
+
+// Moves *index to the number of leap seconds inserted before the date
+// yyyymmdd. Dates usually come in order, so it starts from the index of the
+// previous one
+static inline gint
+count_leap_seconds(const gint32 *leap_dates, gint leap_count, gint *index, gint date)
+{
+    while ((*index > 0) && (date <= leap_dates[*index - 1])) {
+        (*index)--;
+    }
+
+    while ((*index < leap_count) && (date > leap_dates[*index])) {
+        (*index)++;
+    }
+
+    return *index;
+}
+
+/**
+ * gswe_time_julday_array:
+ * @year: (array length=count): the years
+ * @month: (array length=count): the months
+ * @day: (array length=count): the days
+ * @hour: (array length=count): the hours, with their fractions
+ * @count: the number of dates
+ * @julian_days: (out caller-allocates) (array length=count): a place to store
+ *               the Julian days
+ *
+ * Converts @count Gregorian dates to Julian days, like swe_julday() does with
+ * one. There is no time scale involved, so the Julian days are in the time
+ * scale of the dates. The years must be between -400000 and 400000.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_julday_array(
+        const gint *year, const gint *month, const gint *day,
+        const gdouble *hour,
+        guint count,
+        gdouble *julian_days)
+{
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        julian_days[i] = day_number_from_date(year[i], month[i], day[i])
+            - 0.5 + hour[i] / 24.0;
+    }
+}
+
+/**
+ * gswe_time_revjul_array:
+ * @julian_days: (array length=count): the Julian days
+ * @count: the number of Julian days
+ * @year: (out caller-allocates) (array length=count): a place to store the
+ *        years
+ * @month: (out caller-allocates) (array length=count): a place to store the
+ *         months
+ * @day: (out caller-allocates) (array length=count): a place to store the
+ *       days
+ * @hour: (out caller-allocates) (array length=count): a place to store the
+ *        hours, with their fractions
+ *
+ * Converts @count Julian days to Gregorian dates, like swe_revjul() does with
+ * one.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_revjul_array(
+        const gdouble *julian_days,
+        guint count,
+        gint *year, gint *month, gint *day,
+        gdouble *hour)
+{
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        gint day_number = day_number_from_julian_day(julian_days[i]);
+
+        date_from_day_number(day_number, &year[i], &month[i], &day[i]);
+        hour[i] = (julian_days[i] - day_number + 0.5) * 24.0;
+    }
+}
+
+/**
+ * gswe_time_utc_to_jd_array:
+ * @dates: the Gregorian dates
+ * @timezone_offsets: (array length=count) (allow-none): the time zone offsets
+ *                    of the dates in hours, or %NULL if all of them are in
+ *                    UTC
+ * @count: the number of dates
+ * @julian_days_et: (out caller-allocates) (array length=count): a place to
+ *                  store the Julian days in Ephemeris Time (ET)
+ * @julian_days_ut: (out caller-allocates) (array length=count) (allow-none):
+ *                  a place to store the Julian days in Universal Time (UT), or
+ *                  %NULL if they are not needed
+ * @err: a #GError
+ *
+ * Converts @count Gregorian dates to Julian days. The result is the same as
+ * calling gswe_time_set_gregorian() for each date, but the dates are checked
+ * more strictly: months, days, hours and minutes out of their range are
+ * invalid, instead of being carried over to the next unit. A second of 60 is
+ * valid only at the end of a day UTC that has a leap second.
+ *
+ * Returns: %TRUE if all dates are valid. Otherwise @err is set, and the Julian
+ *          days of the invalid dates are set to NaN, while the valid ones are
+ *          converted
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_time_utc_to_jd_array(
+        const GsweDateArrays *dates,
+        const gdouble *timezone_offsets,
+        guint count,
+        gdouble *julian_days_et,
+        gdouble *julian_days_ut,
+        GError **err)
+{
+    guint i,
+          invalid = 0,
+          first_invalid = 0;
+    gint leap_count,
+         leap_index = 0,
+         checked_day = G_MININT;
+    const gint32 *leap_dates;
+    gint *day_numbers = g_new(gint, count),
+         *utc_dates = g_new(gint, count);
+    guint8 *states = g_new(guint8, count);
+    gdouble *utc_hours = g_new(gdouble, count),
+            *utc_zones = NULL,
+            tjd_et_1972 = J1972 + (32.184 + NLEAP_INIT) / 86400.0;
+    const gdouble *zones = timezone_offsets;
+    gboolean ut1_input = FALSE;
+    // Local copies, so the compiler knows the arrays do not change in the
+    // loop
+    GsweDateArrays in = *dates;
+
+    // A conditional in the loop would stop it from being vectorized
+    if (zones == NULL) {
+        zones = utc_zones = g_new0(gdouble, count);
+    }
+
+    // Check the dates, and convert them to UTC. This is what
+    // swe_utc_time_zone() does, without branches, so it can be vectorized
+    for (i = 0; i < count; i++) {
+        gint year = in.year[i],
+             month = in.month[i],
+             day = in.day[i],
+             hour = in.hour[i],
+             minute = in.minute[i],
+             day_number = day_number_from_date(year, month, day),
+             leap = (in.second[i] >= 60.0),
+             utc_year,
+             utc_month,
+             utc_day;
+        gdouble second = in.second[i] - leap,
+                utc_hour = hour + minute / 60.0 + second / 3600.0 - zones[i];
+        gboolean valid = (month >= 1) & (month <= 12)
+            & (day >= 1)
+            & (day_number < day_number_from_date(year, month + 1, 1))
+            & (hour >= 0) & (hour < 24)
+            & (minute >= 0) & (minute < 60)
+            & (second >= 0.0) & (second < 60.0);
+
+        day_number += (utc_hour >= 24.0) - (utc_hour < 0.0);
+        utc_hour += 24.0 * ((utc_hour < 0.0) - (utc_hour >= 24.0));
+
+        // A leap second can only be the last second of a day in UTC
+        valid &= !leap | (utc_hour >= 23.0 + 59.0 / 60.0);
+
+        date_from_day_number(day_number, &utc_year, &utc_month, &utc_day);
+
+        day_numbers[i] = day_number;
+        utc_dates[i] = utc_year * 10000 + utc_month * 100 + utc_day;
+        utc_hours[i] = utc_hour + leap / 3600.0;
+        states[i] = (valid) ? ((leap) ? DATE_LEAP_SECOND : DATE_VALID) : DATE_INVALID;
+    }
+
+    gswe_thread_init();
+    leap_count = swe_get_leap_seconds(&leap_dates);
+
+    for (i = 0; i < count; i++) {
+        gdouble midnight = day_numbers[i] - 0.5,
+                julian_day_et,
+                julian_day_ut,
+                delta_t;
+        gint leap_seconds = NLEAP_INIT;
+
+        if (states[i] != DATE_INVALID) {
+            if (midnight < J1972) {
+                // UTC is defined from 1972; earlier dates are in UT1, and
+                // can not have leap seconds
+                if (states[i] == DATE_LEAP_SECOND) {
+                    states[i] = DATE_INVALID;
+                }
+            } else {
+                leap_seconds += count_leap_seconds(
+                        leap_dates, leap_count,
+                        &leap_index,
+                        utc_dates[i]
+                    );
+
+                // If the leap second table is not up to date, the dates
+                // after its end are taken as UT1, like swe_utc_to_jd()
+                // does. This needs Delta T, so it is checked once a day
+                if (day_numbers[i] != checked_day) {
+                    checked_day = day_numbers[i];
+                    ut1_input = (swe_deltat_ex(midnight, -1, NULL) * 86400.0
+                        - leap_seconds - 32.184 >= 1.0);
+                }
+
+                if (
+                            !ut1_input
+                            && (states[i] == DATE_LEAP_SECOND)
+                            && (
+                                (leap_index >= leap_count)
+                                || (utc_dates[i] != leap_dates[leap_index])
+                            )
+                        ) {
+                    states[i] = DATE_INVALID;
+                }
+            }
+        }
+
+        if (states[i] == DATE_INVALID) {
+            if (invalid++ == 0) {
+                first_invalid = i;
+            }
+
+            julian_days_et[i] = NAN;
+
+            if (julian_days_ut) {
+                julian_days_ut[i] = NAN;
+            }
+
+            continue;
+        }
+
+        if ((midnight < J1972) || ut1_input) {
+            julian_day_ut = midnight + utc_hours[i] / 24.0;
+            julian_day_et = julian_day_ut + swe_deltat_ex(julian_day_ut, -1, NULL);
+        } else {
+            julian_day_et = tjd_et_1972
+                + (day_numbers[i] - (J1972 + 0.5))
+                + utc_hours[i] / 24.0
+                + (leap_seconds - NLEAP_INIT) / 86400.0;
+
+            if (julian_days_ut) {
+                delta_t = swe_deltat_ex(julian_day_et, -1, NULL);
+                julian_day_ut = julian_day_et - swe_deltat_ex(julian_day_et - delta_t, -1, NULL);
+                julian_day_ut = julian_day_et - swe_deltat_ex(julian_day_ut, -1, NULL);
+            }
+        }
+
+        julian_days_et[i] = julian_day_et;
+
+        if (julian_days_ut) {
+            julian_days_ut[i] = julian_day_ut;
+        }
+    }
+
+    g_free(day_numbers);
+    g_free(utc_dates);
+    g_free(utc_hours);
+    g_free(utc_zones);
+    g_free(states);
+
+    if (invalid > 0) {
+        g_set_error(
+                err,
+                GSWE_ERROR, GSWE_ERROR_INVALID_DATE,
+                "%u of the dates are invalid, the first one at index %u",
+                invalid, first_invalid
+            );
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * gswe_time_jdet_to_utc_array:
+ * @julian_days_et: (array length=count): the Julian days in Ephemeris Time
+ *                  (ET)
+ * @timezone_offsets: (array length=count) (allow-none): the time zone offsets
+ *                    to convert to, in hours, or %NULL to get the dates in UTC
+ * @count: the number of Julian days
+ * @dates: a place to store the Gregorian dates. All of its arrays must hold
+ *         @count elements
+ *
+ * Converts @count Julian days to Gregorian dates. The result is the same as
+ * calling gswe_time_get_gregorian() for each Julian day.
+ *
+ * Since: 2.2
+ */
+void
+gswe_time_jdet_to_utc_array(
+        const gdouble *julian_days_et,
+        const gdouble *timezone_offsets,
+        guint count,
+        GsweDateArrays *dates)
+{
+    guint i;
+    gint leap_count,
+         leap_index = 0,
+         next_leap_index = -1;
+    const gint32 *leap_dates;
+    gdouble *clock_days = g_new(gdouble, count),
+            *utc_zones = NULL,
+            tjd_et_1972 = J1972 + (32.184 + NLEAP_INIT) / 86400.0,
+            next_leap_et = 0.0;
+    const gdouble *zones = timezone_offsets;
+    guint8 *second_60 = g_new(guint8, count);
+    // See gswe_time_utc_to_jd_array() for why these are needed
+    GsweDateArrays out = *dates;
+
+    if (zones == NULL) {
+        zones = utc_zones = g_new0(gdouble, count);
+    }
+
+    gswe_thread_init();
+    leap_count = swe_get_leap_seconds(&leap_dates);
+
+    // Find the Julian days in UTC (or UT1 when UTC is not defined) the same
+    // way as swe_jdet_to_utc() does
+    for (i = 0; i < count; i++) {
+        gdouble julian_day_et = julian_days_et[i],
+                delta_t = swe_deltat_ex(julian_day_et, -1, NULL),
+                julian_day_ut;
+        gint year,
+             month,
+             day,
+             leap_seconds;
+
+        delta_t = swe_deltat_ex(julian_day_et - delta_t, -1, NULL);
+        julian_day_ut = julian_day_et - swe_deltat_ex(julian_day_et - delta_t, -1, NULL);
+        second_60[i] = 0;
+
+        if (julian_day_et < tjd_et_1972) {
+            clock_days[i] = julian_day_ut;
+
+            continue;
+        }
+
+        // This may miss the leap second of the last day
+        date_from_day_number(day_number_from_julian_day(julian_day_ut - 1.0), &year, &month, &day);
+        leap_seconds = count_leap_seconds(
+                leap_dates, leap_count,
+                &leap_index,
+                year * 10000 + month * 100 + day
+            );
+
+        if (leap_seconds < leap_count) {
+            // The start of the day after the next leap second. This is the
+            // same for many dates, so it is calculated only when the next
+            // leap second changes
+            if (next_leap_index != leap_seconds) {
+                gint32 leap_date = leap_dates[leap_seconds];
+                gdouble dret[2];
+
+                next_leap_index = leap_seconds;
+                date_from_day_number(
+                        day_number_from_date(
+                            leap_date / 10000,
+                            (leap_date % 10000) / 100,
+                            leap_date % 100
+                        ) + 1,
+                        &year, &month, &day
+                    );
+                swe_utc_to_jd(year, month, day, 0, 0, 0, SE_GREG_CAL, dret, NULL);
+                next_leap_et = dret[0];
+            }
+
+            if (julian_day_et >= next_leap_et) {
+                leap_seconds++;
+            } else if (julian_day_et > next_leap_et - 1.0 / 86400.0) {
+                second_60[i] = 1;
+            }
+        }
+
+        clock_days[i] = J1972 + (julian_day_et - tjd_et_1972)
+            - (gdouble)(leap_seconds + second_60[i]) / 86400.0;
+
+        // If the leap second table is not up to date, return UT1
+        if (delta_t * 86400.0 - (leap_seconds + NLEAP_INIT) - 32.184 >= 1.0) {
+            clock_days[i] = julian_day_et - delta_t;
+            second_60[i] = 0;
+        }
+    }
+
+    // Convert to the time zones and split the dates into fields, like
+    // swe_utc_time_zone() does. Dates and times are split in separate loops,
+    // as the compiler gives up vectorizing a loop that writes all six arrays
+    for (i = 0; i < count; i++) {
+        date_from_day_number(
+                day_number_from_julian_day(clock_days[i] + zones[i] / 24.0),
+                &out.year[i], &out.month[i], &out.day[i]
+            );
+    }
+
+    for (i = 0; i < count; i++) {
+        gdouble local_day = clock_days[i] + zones[i] / 24.0,
+                hour = (local_day - day_number_from_julian_day(local_day) + 0.5) * 24.0,
+                minute;
+        gint whole_hour = (gint)hour,
+             whole_minute;
+
+        minute = (hour - whole_hour) * 60.0;
+        whole_minute = (gint)minute;
+        out.hour[i] = whole_hour;
+        out.minute[i] = whole_minute;
+        out.second[i] = (minute - whole_minute) * 60.0 + second_60[i];
+    }
+
+    g_free(clock_days);
+    g_free(utc_zones);
+    g_free(second_60);
+}
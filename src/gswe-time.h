@@ -0,0 +1,127 @@
+/* gswe-time.h: Plain time value with conversion functions
+ *
+ * Copyright © 2013  Gergely Polonkai
+ *
+ * SWE-GLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SWE-GLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SWE_GLIB_GSWE_TIME_H__
+#define __SWE_GLIB_GSWE_TIME_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GsweTime:
+ * @julian_day_et: the Julian day in Ephemeris Time (ET)
+ * @julian_day_ut: the Julian day in Universal Time (UT), the same instant as
+ *                 @julian_day_et
+ * @timezone_offset: the time zone offset in hours, relative to UTC, used
+ *                   when the instant is converted to a Gregorian date
+ *
+ * A point in time as a plain value. Unlike #GsweTimestamp, it has no
+ * properties or signals, so it can be stack allocated, copied with an
+ * assignment, and stored in arrays. The fields should be changed only with
+ * the gswe_time_set_*() functions (except @timezone_offset), which keep
+ * @julian_day_et and @julian_day_ut in sync.
+ *
+ * Since: 2.2
+ */
+typedef struct _GsweTime {
+    gdouble julian_day_et;
+    gdouble julian_day_ut;
+    gdouble timezone_offset;
+} GsweTime;
+
+/**
+ * GsweDateArrays:
+ * @year: the years
+ * @month: the months, from 1 to 12
+ * @day: the days of the month
+ * @hour: the hours
+ * @minute: the minutes
+ * @second: the seconds, with their fractions
+ *
+ * A list of Gregorian dates, stored as one array for each field. This is the
+ * input of gswe_time_utc_to_jd_array(), and the output of
+ * gswe_time_jdet_to_utc_array(). All arrays must have the same number of
+ * elements.
+ *
+ * Since: 2.2
+ */
+typedef struct _GsweDateArrays {
+    gint *year;
+    gint *month;
+    gint *day;
+    gint *hour;
+    gint *minute;
+    gdouble *second;
+} GsweDateArrays;
+
+GType gswe_time_get_type(void);
+#define GSWE_TYPE_TIME (gswe_time_get_type())
+
+GsweTime *gswe_time_copy(const GsweTime *instant);
+
+void gswe_time_free(GsweTime *instant);
+
+void gswe_time_set_julian_day_et(GsweTime *instant, gdouble julian_day);
+
+void gswe_time_set_julian_day_ut(GsweTime *instant, gdouble julian_day);
+
+gboolean gswe_time_set_gregorian(
+        GsweTime *instant,
+        gint year, gint month, gint day,
+        gint hour, gint minute, gdouble second,
+        gdouble timezone_offset,
+        GError **err);
+
+void gswe_time_get_gregorian(
+        const GsweTime *instant,
+        gint *year, gint *month, gint *day,
+        gint *hour, gint *minute, gdouble *second);
+
+void gswe_time_add_days(GsweTime *instant, gdouble days);
+
+gdouble gswe_time_get_sidereal_time(const GsweTime *instant);
+
+void gswe_time_julday_array(
+        const gint *year, const gint *month, const gint *day,
+        const gdouble *hour,
+        guint count,
+        gdouble *julian_days);
+
+void gswe_time_revjul_array(
+        const gdouble *julian_days,
+        guint count,
+        gint *year, gint *month, gint *day,
+        gdouble *hour);
+
+gboolean gswe_time_utc_to_jd_array(
+        const GsweDateArrays *dates,
+        const gdouble *timezone_offsets,
+        guint count,
+        gdouble *julian_days_et,
+        gdouble *julian_days_ut,
+        GError **err);
+
+void gswe_time_jdet_to_utc_array(
+        const gdouble *julian_days_et,
+        const gdouble *timezone_offsets,
+        guint count,
+        GsweDateArrays *dates);
+
+G_END_DECLS
+
+#endif /* __SWE_GLIB_GSWE_TIME_H__ */
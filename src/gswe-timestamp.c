@@ -22,6 +22,7 @@
 #include "../swe/src/swephexp.h"
 #include "swe-glib-private.h"
 #include "swe-glib.h"
+#include "gswe-time.h"
 #include "gswe-timestamp.h"
 
 /**
@@ -32,6 +33,12 @@
  * @include: swe-glib/swe-glib.h
  *
  * This object converts Gregorian dates to Julian days and vice versa.
+ *
+ * #GsweTimestamp is an observable wrapper around a #GsweTime: it does the
+ * same conversions, but notifies about each change through its properties
+ * and the ::changed signal. When stepping through many points in time, use a
+ * #GsweTime, and pass it to gswe_timestamp_set_time() or
+ * gswe_moment_set_time() only when needed.
  */
 
 #define GSWE_TIMESTAMP_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE( \
@@ -51,10 +58,11 @@ struct _GsweTimestampPrivate {
     gint gregorian_minute;
     gint gregorian_second;
     gint gregorian_microsecond;
-    gdouble gregorian_timezone_offset;
 
-    gdouble julian_day;
-    gdouble julian_day_ut;
+    GsweTime time;
+
+    guint update_depth;
+    gboolean update_pending;
 };
 
 enum {
@@ -368,6 +376,12 @@ gswe_timestamp_class_init(GsweTimestampClass *klass)
 static void
 gswe_timestamp_emit_changed(GsweTimestamp *timestamp)
 {
+    if (timestamp->priv->update_depth > 0) {
+        timestamp->priv->update_pending = TRUE;
+
+        return;
+    }
+
     g_signal_emit(timestamp, gswe_timestamp_signals[SIGNAL_CHANGED], 0);
 }
 
@@ -564,14 +578,14 @@ gswe_timestamp_get_property(
         case PROP_GREGORIAN_TIMEZONE_OFFSET:
             g_value_set_double(
                     value,
-                    timestamp->priv->gregorian_timezone_offset);
+                    timestamp->priv->time.timezone_offset);
 
             break;
 
         case PROP_JULIAN_DAY:
             g_value_set_double(
                     value,
-                    timestamp->priv->julian_day
+                    timestamp->priv->time.julian_day_et
                 );
 
             break;
@@ -607,13 +621,7 @@ gswe_timestamp_calculate_all(GsweTimestamp *timestamp, GError **err)
 static void
 gswe_timestamp_calculate_gregorian(GsweTimestamp *timestamp, GError **err)
 {
-    gint utc_year,
-         utc_month,
-         utc_day,
-         utc_hour,
-         utc_minute;
-    gdouble utc_second,
-            local_second;
+    gdouble local_second;
 
     if ((timestamp->priv->valid_dates & GSWE_VALID_GREGORIAN) == GSWE_VALID_GREGORIAN) {
         return;
@@ -630,16 +638,8 @@ gswe_timestamp_calculate_gregorian(GsweTimestamp *timestamp, GError **err)
         return;
     }
 
-    swe_jdet_to_utc(
-            timestamp->priv->julian_day,
-            SE_GREG_CAL,
-            &utc_year, &utc_month, &utc_day,
-            &utc_hour, &utc_minute, &utc_second
-        );
-    swe_utc_time_zone(
-            utc_year, utc_month, utc_day,
-            utc_hour, utc_minute, utc_second,
-            0 - timestamp->priv->gregorian_timezone_offset,
+    gswe_time_get_gregorian(
+            &timestamp->priv->time,
             &timestamp->priv->gregorian_year,
             &timestamp->priv->gregorian_month,
             &timestamp->priv->gregorian_day,
@@ -651,6 +651,7 @@ gswe_timestamp_calculate_gregorian(GsweTimestamp *timestamp, GError **err)
     timestamp->priv->gregorian_microsecond = (
             local_second - floor(local_second))
                * 1000;
+    timestamp->priv->valid_dates |= GSWE_VALID_GREGORIAN;
 
     g_object_notify_by_pspec(
             G_OBJECT(timestamp),
@@ -725,6 +726,55 @@ gswe_timestamp_get_instant_recalc(GsweTimestamp *timestamp)
     return timestamp->priv->instant_recalc;
 }
 
+/**
+ * gswe_timestamp_update_begin:
+ * @timestamp: a GsweTimestamp
+ *
+ * Starts a batch of changes on @timestamp, e.g. setting the Gregorian date
+ * components one by one. Until the matching gswe_timestamp_update_commit(),
+ * the ::changed signal is not emitted, and the property notifications are
+ * held back with g_object_freeze_notify(). Updates can be nested; only the
+ * outermost commit emits the signals.
+ *
+ * Since: 2.2
+ */
+void
+gswe_timestamp_update_begin(GsweTimestamp *timestamp)
+{
+    g_object_freeze_notify(G_OBJECT(timestamp));
+
+    if (timestamp->priv->update_depth++ == 0) {
+        timestamp->priv->update_pending = FALSE;
+    }
+}
+
+/**
+ * gswe_timestamp_update_commit:
+ * @timestamp: a GsweTimestamp
+ *
+ * Finishes a batch of changes started with gswe_timestamp_update_begin(). If
+ * this ends the outermost update, and @timestamp changed during it, the
+ * ::changed signal is emitted once, followed by the held back property
+ * notifications.
+ *
+ * Since: 2.2
+ */
+void
+gswe_timestamp_update_commit(GsweTimestamp *timestamp)
+{
+    g_return_if_fail(timestamp->priv->update_depth > 0);
+
+    if (
+                (--timestamp->priv->update_depth == 0)
+                && timestamp->priv->update_pending
+            ) {
+        timestamp->priv->update_pending = FALSE;
+        gswe_timestamp_emit_changed(timestamp);
+    }
+
+    g_object_thaw_notify(G_OBJECT(timestamp));
+}
+
 /**
  * gswe_timestamp_set_gregorian_full:
  * @timestamp: a GsweTimestamp
@@ -753,6 +803,8 @@ gswe_timestamp_set_gregorian_full(
 {
     gboolean changed = FALSE;
 
+    g_object_freeze_notify(G_OBJECT(timestamp));
+
     if (timestamp->priv->gregorian_year != year) {
         timestamp->priv->gregorian_year = year;
 
@@ -830,8 +882,8 @@ gswe_timestamp_set_gregorian_full(
         changed = TRUE;
     }
 
-    if (timestamp->priv->gregorian_timezone_offset != time_zone_offset) {
-        timestamp->priv->gregorian_timezone_offset = time_zone_offset;
+    if (timestamp->priv->time.timezone_offset != time_zone_offset) {
+        timestamp->priv->time.timezone_offset = time_zone_offset;
 
         g_object_notify_by_pspec(
                 G_OBJECT(timestamp),
@@ -860,6 +912,8 @@ gswe_timestamp_set_gregorian_full(
 
         gswe_timestamp_emit_changed(timestamp);
     }
+
+    g_object_thaw_notify(G_OBJECT(timestamp));
 }
 
 /**
@@ -1300,12 +1354,12 @@ gswe_timestamp_set_gregorian_timezone(
         gdouble gregorian_timezone_offset,
         GError **err)
 {
-    if (timestamp->priv->gregorian_timezone_offset == gregorian_timezone_offset) {
+    if (timestamp->priv->time.timezone_offset == gregorian_timezone_offset) {
         return;
     }
 
     gswe_timestamp_calculate_julian(timestamp, NULL);
-    timestamp->priv->gregorian_timezone_offset = gregorian_timezone_offset;
+    timestamp->priv->time.timezone_offset = gregorian_timezone_offset;
     timestamp->priv->valid_dates &= ~GSWE_VALID_GREGORIAN;
 
     g_object_notify_by_pspec(
@@ -1327,22 +1381,12 @@ gswe_timestamp_set_gregorian_timezone(
 gdouble
 gswe_timestamp_get_gregorian_timezone(GsweTimestamp *timestamp)
 {
-    return timestamp->priv->gregorian_timezone_offset;
+    return timestamp->priv->time.timezone_offset;
 }
 
 static void
 gswe_timestamp_calculate_julian(GsweTimestamp *timestamp, GError **err)
 {
-    gint utc_year,
-         utc_month,
-         utc_day,
-         utc_hour,
-         utc_minute,
-         retval;
-    gdouble utc_second,
-            dret[2];
-    gchar serr[AS_MAXCH];
-
     if ((timestamp->priv->valid_dates & GSWE_VALID_JULIAN_DAY) == GSWE_VALID_JULIAN_DAY) {
         return;
     }
@@ -1357,35 +1401,52 @@ gswe_timestamp_calculate_julian(GsweTimestamp *timestamp, GError **err)
         return;
     }
 
-    swe_utc_time_zone(
-            timestamp->priv->gregorian_year,
-            timestamp->priv->gregorian_month,
-            timestamp->priv->gregorian_day,
-            timestamp->priv->gregorian_hour,
-            timestamp->priv->gregorian_minute,
-            timestamp->priv->gregorian_second
-                + timestamp->priv->gregorian_microsecond / 1000.0,
-            timestamp->priv->gregorian_timezone_offset,
-            &utc_year, &utc_month, &utc_day,
-            &utc_hour, &utc_minute, &utc_second
+    if (gswe_time_set_gregorian(
+                &timestamp->priv->time,
+                timestamp->priv->gregorian_year,
+                timestamp->priv->gregorian_month,
+                timestamp->priv->gregorian_day,
+                timestamp->priv->gregorian_hour,
+                timestamp->priv->gregorian_minute,
+                timestamp->priv->gregorian_second
+                    + timestamp->priv->gregorian_microsecond / 1000.0,
+                timestamp->priv->time.timezone_offset,
+                err
+            )) {
+        timestamp->priv->valid_dates |= GSWE_VALID_JULIAN_DAY;
+    }
+}
+
+/*
+ * gswe_timestamp_set_julian_day_valid:
+ * @timestamp: a #GsweTimestamp
+ * @err: a #GError
+ *
+ * Marks the Julian day values of @timestamp as the only valid ones, after
+ * they have been changed, and notifies the listeners about it.
+ */
+static void
+gswe_timestamp_set_julian_day_valid(GsweTimestamp *timestamp, GError **err)
+{
+    timestamp->priv->valid_dates = GSWE_VALID_JULIAN_DAY;
+    g_object_notify_by_pspec(
+            G_OBJECT(timestamp),
+            gswe_timestamp_props[PROP_GREGORIAN_VALID]
+        );
+    g_object_notify_by_pspec(
+            G_OBJECT(timestamp),
+            gswe_timestamp_props[PROP_JULIAN_DAY_VALID]
+        );
+    g_object_notify_by_pspec(
+            G_OBJECT(timestamp),
+            gswe_timestamp_props[PROP_JULIAN_DAY]
         );
 
-    if (
-            (retval = swe_utc_to_jd(
-                utc_year, utc_month, utc_day,
-                utc_hour, utc_minute, utc_second,
-                SE_GREG_CAL, dret, serr)
-            ) == ERR) {
-        g_set_error(
-                err,
-                GSWE_ERROR, GSWE_ERROR_SWE_FATAL,
-                "Swiss Ephemeris error: %s", serr
-            );
-    } else {
-        timestamp->priv->julian_day = dret[0];
-        timestamp->priv->julian_day_ut = dret[1];
-        timestamp->priv->valid_dates |= GSWE_VALID_JULIAN_DAY;
+    if (timestamp->priv->instant_recalc == TRUE) {
+        gswe_timestamp_calculate_all(timestamp, err);
     }
+
+    gswe_timestamp_emit_changed(timestamp);
 }
 
 /**
@@ -1435,56 +1496,8 @@ gswe_timestamp_set_julian_day_et(
         gdouble julian_day,
         GError **err)
 {
-    GError *err_local = NULL;
-
-    timestamp->priv->julian_day = julian_day;
-    timestamp->priv->valid_dates = GSWE_VALID_JULIAN_DAY;
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_GREGORIAN_VALID]
-        );
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_JULIAN_DAY_VALID]
-        );
-
-    // to get exact UT value, we must calculate gregorian date, and
-    // reverse-engineer the UT value from that. This is an overkill, but libswe
-    // doesn’t provide an API for that.
-    gswe_timestamp_calculate_gregorian(timestamp, &err_local);
-
-    if (err_local) {
-        if (err) {
-            *err = err_local;
-        }
-
-        return;
-    }
-
-    timestamp->priv->valid_dates = GSWE_VALID_GREGORIAN;
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_GREGORIAN_VALID]
-        );
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_JULIAN_DAY_VALID]
-        );
-    gswe_timestamp_calculate_julian(timestamp, &err_local);
-
-    if (err_local) {
-        if (err) {
-            *err = err_local;
-        }
-
-        return;
-    }
-
-    if (timestamp->priv->instant_recalc == TRUE) {
-        gswe_timestamp_calculate_all(timestamp, err);
-    }
-
-    gswe_timestamp_emit_changed(timestamp);
+    gswe_time_set_julian_day_et(&timestamp->priv->time, julian_day);
+    gswe_timestamp_set_julian_day_valid(timestamp, err);
 }
 
 /**
@@ -1503,7 +1516,7 @@ gswe_timestamp_get_julian_day_et(GsweTimestamp *timestamp, GError **err)
 {
     gswe_timestamp_calculate_julian(timestamp, err);
 
-    return timestamp->priv->julian_day;
+    return timestamp->priv->time.julian_day_et;
 }
 
 /**
@@ -1525,56 +1538,8 @@ gswe_timestamp_set_julian_day_ut(
         gdouble julian_day,
         GError **err)
 {
-    GError *err_local = NULL;
-
-    timestamp->priv->julian_day_ut = julian_day;
-    timestamp->priv->valid_dates = GSWE_VALID_JULIAN_DAY;
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_GREGORIAN_VALID]
-        );
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_JULIAN_DAY_VALID]
-        );
-
-    // to get exact ET value, we must calculate gregorian date, and
-    // reverse-engineer the ET value from that. This is an overkill, but libswe
-    // doesn’t provide an API for that.
-    gswe_timestamp_calculate_gregorian(timestamp, err);
-
-    if (err_local) {
-        if (err) {
-            *err = err_local;
-        }
-
-        return;
-    }
-
-    timestamp->priv->valid_dates = GSWE_VALID_GREGORIAN;
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_GREGORIAN_VALID]
-        );
-    g_object_notify_by_pspec(
-            G_OBJECT(timestamp),
-            gswe_timestamp_props[PROP_JULIAN_DAY_VALID]
-        );
-    gswe_timestamp_calculate_julian(timestamp, err);
-
-    if (err_local) {
-        if (err) {
-            *err = err_local;
-        }
-
-        return;
-    }
-
-    if (timestamp->priv->instant_recalc == TRUE) {
-        gswe_timestamp_calculate_all(timestamp, err);
-    }
-
-    gswe_timestamp_emit_changed(timestamp);
+    gswe_time_set_julian_day_ut(&timestamp->priv->time, julian_day);
+    gswe_timestamp_set_julian_day_valid(timestamp, err);
 }
 
 /**
@@ -1593,7 +1558,7 @@ gswe_timestamp_get_julian_day_ut(GsweTimestamp *timestamp, GError **err)
 {
     gswe_timestamp_calculate_julian(timestamp, err);
 
-    return timestamp->priv->julian_day_ut;
+    return timestamp->priv->time.julian_day_ut;
 }
 
 /**
@@ -1625,7 +1590,80 @@ gswe_timestamp_get_sidereal_time(GsweTimestamp *timestamp, GError **err)
         return 0.0;
     }
 
-    return swe_sidtime(timestamp->priv->julian_day_ut);
+    return gswe_time_get_sidereal_time(&timestamp->priv->time);
+}
+
+/**
+ * gswe_timestamp_set_time:
+ * @timestamp: a #GsweTimestamp
+ * @instant: the new value of @timestamp
+ * @err: a #GError
+ *
+ * Sets @timestamp to the point in time, and the time zone, of @instant. This
+ * emits the ::changed signal only once, so it is the cheapest way to move a
+ * #GsweTimestamp (and the #GsweMoment objects using it) through many points
+ * in time. @err is populated with calculation errors if the <link
+ * linkend="GsweTimestamp--instant-recalc">instant-recalc</link> property's
+ * value is TRUE and a calculation error happens.
+ *
+ * Since: 2.2
+ */
+void
+gswe_timestamp_set_time(
+        GsweTimestamp *timestamp,
+        const GsweTime *instant,
+        GError **err)
+{
+    gboolean timezone_changed = (
+            timestamp->priv->time.timezone_offset != instant->timezone_offset
+        );
+
+    timestamp->priv->time = *instant;
+
+    if (timezone_changed) {
+        g_object_notify_by_pspec(
+                G_OBJECT(timestamp),
+                gswe_timestamp_props[PROP_GREGORIAN_TIMEZONE_OFFSET]
+            );
+    }
+
+    gswe_timestamp_set_julian_day_valid(timestamp, err);
+}
+
+/**
+ * gswe_timestamp_get_time:
+ * @timestamp: a #GsweTimestamp
+ * @instant: (out caller-allocates): a #GsweTime to store the value of
+ *           @timestamp in
+ * @err: a #GError
+ *
+ * Gets the value of @timestamp as a plain #GsweTime, which can then be used
+ * with the gswe_time_*() functions.
+ *
+ * Returns: %TRUE on success. If the Julian day values of @timestamp can not
+ *          be calculated, @err is set, and @instant is not changed
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_timestamp_get_time(
+        GsweTimestamp *timestamp,
+        GsweTime *instant,
+        GError **err)
+{
+    GError *local_err = NULL;
+
+    gswe_timestamp_calculate_julian(timestamp, &local_err);
+
+    if (local_err) {
+        g_propagate_error(err, local_err);
+
+        return FALSE;
+    }
+
+    *instant = timestamp->priv->time;
+
+    return TRUE;
 }
 
 /**
@@ -1710,6 +1748,28 @@ gswe_timestamp_new_from_julian_day(gdouble julian_day)
     return timestamp;
 }
 
+/**
+ * gswe_timestamp_new_from_time:
+ * @instant: a #GsweTime
+ *
+ * Creates a new GsweTimestamp object, initialized with the value of
+ * @instant.
+ *
+ * Returns: a new GsweTimestamp object.
+ *
+ * Since: 2.2
+ */
+GsweTimestamp *
+gswe_timestamp_new_from_time(const GsweTime *instant)
+{
+    GsweTimestamp *timestamp;
+
+    timestamp = gswe_timestamp_new();
+    gswe_timestamp_set_time(timestamp, instant, NULL);
+
+    return timestamp;
+}
+
 /**
  * gswe_timestamp_set_now_local:
  * @timestamp: the #GsweTimestamp to operate on
@@ -21,6 +21,8 @@
 
 #include <glib-object.h>
 
+#include "gswe-time.h"
+
 #define GSWE_TYPE_TIMESTAMP             (gswe_timestamp_get_type())
 #define GSWE_TIMESTAMP(obj)             (G_TYPE_CHECK_INSTANCE_CAST( \
             (obj), \
@@ -126,6 +128,10 @@ void gswe_timestamp_set_instant_recalc(GsweTimestamp *timestamp,
 
 gboolean gswe_timestamp_get_instant_recalc(GsweTimestamp *timestamp);
 
+void gswe_timestamp_update_begin(GsweTimestamp *timestamp);
+
+void gswe_timestamp_update_commit(GsweTimestamp *timestamp);
+
 void gswe_timestamp_set_gregorian_year(GsweTimestamp *timestamp,
                                        gint          gregorian_year,
                                        GError        **err);
@@ -204,6 +210,16 @@ gdouble gswe_timestamp_get_julian_day_ut(GsweTimestamp *timestamp,
 gdouble gswe_timestamp_get_sidereal_time(GsweTimestamp *timestamp,
                                          GError        **err);
 
+GsweTimestamp *gswe_timestamp_new_from_time(const GsweTime *instant);
+
+void gswe_timestamp_set_time(GsweTimestamp  *timestamp,
+                             const GsweTime *instant,
+                             GError         **err);
+
+gboolean gswe_timestamp_get_time(GsweTimestamp *timestamp,
+                                 GsweTime      *instant,
+                                 GError        **err);
+
 void gswe_timestamp_set_now_local(GsweTimestamp *timestamp,
                                                  GError        **err);
 
@@ -35,14 +35,20 @@
  * GswePlanet:
  * @GSWE_PLANET_NONE: no planet
  * @GSWE_PLANET_ASCENDANT: the ascendant
- * @GSWE_PLANET_DESCENDANT: the descendant
+ * @GSWE_PLANET_DESCENDANT: the descendant (the point opposing the ascendant;
+ *                          before 2.2 it was folded into [0; 180))
  * @GSWE_PLANET_MC: midheaven (Medium Coeli)
- * @GSWE_PLANET_IC: Immum Coeli
+ * @GSWE_PLANET_IC: Immum Coeli (the point opposing the MC; before 2.2 it
+ *                  opposed the ARMC)
  * @GSWE_PLANET_VERTEX: the Vertex (the point where the ecliptic meats the
  *                      primal vertical)
- * @GSWE_PLANET_ANTIVERTEX: the Antivertex (the point opposing the Vertex)
+ * @GSWE_PLANET_ANTIVERTEX: the Antivertex (the point opposing the Vertex;
+ *                          before 2.2 it was folded into [0; 180))
  * @GSWE_PLANET_MOON_NODE: the mean ascending (north) Moon node
- * @GSWE_PLANET_MOON_SOUTH_NODE: the mean descending (south) Moon node
+ * @GSWE_PLANET_MOON_SOUTH_NODE: the mean descending (south) Moon node (the
+ *                               point opposing the north node, with its
+ *                               latitude mirrored; before 2.2 it was folded
+ *                               into [0; 180) and kept the latitude)
  * @GSWE_PLANET_MOON_APOGEE: the mean Moon apogee (sometimes called Dark Moon,
  *                           or Lilith)
  * @GSWE_PLANET_SUN: the Sun
@@ -277,6 +283,8 @@ typedef enum {
  * @GSWE_HOUSE_SYSTEM_PLACIDUS: Placidus house system
  * @GSWE_HOUSE_SYSTEM_KOCH: Koch house system
  * @GSWE_HOUSE_SYSTEM_EQUAL: Equal house system
+ * @GSWE_HOUSE_SYSTEM_GAUQUELIN: Gauquelin sectors. Unlike the other house
+ *                               systems, it has 36 houses (Since: 2.2)
  *
  * The house systems currently known by SWE-GLib.
  */
@@ -284,7 +292,8 @@ typedef enum {
     GSWE_HOUSE_SYSTEM_NONE,
     GSWE_HOUSE_SYSTEM_PLACIDUS,
     GSWE_HOUSE_SYSTEM_KOCH,
-    GSWE_HOUSE_SYSTEM_EQUAL
+    GSWE_HOUSE_SYSTEM_EQUAL,
+    GSWE_HOUSE_SYSTEM_GAUQUELIN
 } GsweHouseSystem;
 
 /**
@@ -315,6 +324,29 @@ typedef enum {
     GSWE_MOON_PHASE_DARK
 } GsweMoonPhase;
 
+/**
+ * GsweEphemeris:
+ * @GSWE_EPHEMERIS_NONE: the position is not calculated from an ephemeris
+ *                       (e.g. it is derived from the house cusps), or it
+ *                       is not calculated yet
+ * @GSWE_EPHEMERIS_SWISS: the position is calculated from the Swiss
+ *                        Ephemeris data files
+ * @GSWE_EPHEMERIS_MOSHIER: the data file needed for the planet and date is
+ *                          not installed, so the less precise built-in
+ *                          Moshier ephemeris is used
+ * @GSWE_EPHEMERIS_JPL: the position is calculated from a JPL ephemeris file
+ *
+ * The ephemeris a planet position is calculated from.
+ *
+ * Since: 2.2
+ */
+typedef enum {
+    GSWE_EPHEMERIS_NONE,
+    GSWE_EPHEMERIS_SWISS,
+    GSWE_EPHEMERIS_MOSHIER,
+    GSWE_EPHEMERIS_JPL
+} GsweEphemeris;
+
 /**
  * GsweTimestampValidityFlags:
  * @GSWE_VALID_NONE: No valid timestamp
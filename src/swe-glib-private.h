@@ -16,6 +16,7 @@
  */
 #ifdef __SWE_GLIB_BUILDING__
 #ifndef __SWE_GLIB_PRIVATE_H__
+#define __SWE_GLIB_PRIVATE_H__
 
 #include "gswe-timestamp.h"
 #include "gswe-types.h"
@@ -29,18 +30,152 @@
 #include "gswe-antiscion-data-private.h"
 #include "gswe-house-system-info-private.h"
 #include "gswe-house-data-private.h"
+#include "gswe-context-private.h"
 
 extern gboolean gswe_initialized;
 extern gchar *gswe_ephe_path;
 extern GsweTimestamp *gswe_full_moon_base_date;
-extern GHashTable *gswe_planet_info_table;
-extern GHashTable *gswe_sign_info_table;
-extern GHashTable *gswe_house_system_info_table;
-extern GHashTable *gswe_aspect_info_table;
-extern GHashTable *gswe_antiscion_axis_info_table;
 
 GsweCoordinates *gswe_coordinates_copy(GsweCoordinates *coordinates);
 
+void gswe_thread_init(void);
+
+const gchar *gswe_translate(const gchar *msgid);
+
+/* Number of slots needed for each planet range, and in total, to store
+ * #GswePlanet-indexed data in a dense table. The ranges are laid out after
+ * each other in the order of their GSWE_PLANET_OFFSET_* values */
+#define GSWE_PLANET_SLOTS_VIRTUAL_NODES \
+    (GSWE_PLANET_ANTIVERTEX - GSWE_PLANET_OFFSET_VIRTUAL_NODES + 1)
+#define GSWE_PLANET_SLOTS_PLANETS \
+    (GSWE_PLANET_PLUTO - GSWE_PLANET_OFFSET_PLANETS + 1)
+#define GSWE_PLANET_SLOTS_ASTEROIDS \
+    (GSWE_PLANET_HYGIEA - GSWE_PLANET_OFFSET_ASTEROIDS + 1)
+#define GSWE_PLANET_SLOT_COUNT ( \
+        GSWE_PLANET_SLOTS_VIRTUAL_NODES \
+        + GSWE_PLANET_SLOTS_PLANETS \
+        + GSWE_PLANET_SLOTS_ASTEROIDS \
+    )
+
+/*
+ * gswe_planet_get_slot:
+ * @planet: a planet ID
+ *
+ * Maps @planet to its index in a dense table of GSWE_PLANET_SLOT_COUNT
+ * elements.
+ *
+ * Returns: the slot of @planet, or -1 if @planet is not a planet known by
+ *          SWE-GLib
+ */
+static inline gint
+gswe_planet_get_slot(GswePlanet planet)
+{
+    if (planet < GSWE_PLANET_OFFSET_VIRTUAL_NODES) {
+        return -1;
+    }
+
+    if (planet < GSWE_PLANET_OFFSET_PLANETS) {
+        return planet - GSWE_PLANET_OFFSET_VIRTUAL_NODES;
+    }
+
+    if (planet <= GSWE_PLANET_PLUTO) {
+        return GSWE_PLANET_SLOTS_VIRTUAL_NODES
+            + planet - GSWE_PLANET_OFFSET_PLANETS;
+    }
+
+    if ((planet >= GSWE_PLANET_OFFSET_ASTEROIDS)
+            && (planet <= GSWE_PLANET_HYGIEA)) {
+        return GSWE_PLANET_SLOTS_VIRTUAL_NODES
+            + GSWE_PLANET_SLOTS_PLANETS
+            + planet - GSWE_PLANET_OFFSET_ASTEROIDS;
+    }
+
+    return -1;
+}
+
+/* The same as gswe_planet_get_slot() for planets known to be valid, usable
+ * in constant expressions */
+#define GSWE_PLANET_SLOT(planet) ( \
+        ((planet) >= GSWE_PLANET_OFFSET_ASTEROIDS) \
+            ? GSWE_PLANET_SLOTS_VIRTUAL_NODES + GSWE_PLANET_SLOTS_PLANETS \
+                + (planet) - GSWE_PLANET_OFFSET_ASTEROIDS \
+            : ((planet) >= GSWE_PLANET_OFFSET_PLANETS) \
+                ? GSWE_PLANET_SLOTS_VIRTUAL_NODES \
+                    + (planet) - GSWE_PLANET_OFFSET_PLANETS \
+                : (planet) - GSWE_PLANET_OFFSET_VIRTUAL_NODES \
+    )
+
+#define GSWE_SIGN_COUNT (GSWE_SIGN_PISCES + 1)
+#define GSWE_HOUSE_SYSTEM_COUNT (GSWE_HOUSE_SYSTEM_GAUQUELIN + 1)
+#define GSWE_ASPECT_COUNT (GSWE_ASPECT_QUINCUNX + 1)
+#define GSWE_ANTISCION_AXIS_COUNT (GSWE_ANTISCION_AXIS_MID_LEO + 1)
+
+/* The info records known by SWE-GLib. The planets are indexed by their
+ * slots, everything else by their IDs; the refcount of unused elements is 0 */
+extern GswePlanetInfo gswe_planet_infos[GSWE_PLANET_SLOT_COUNT];
+extern GsweSignInfo gswe_sign_infos[GSWE_SIGN_COUNT];
+extern GsweHouseSystemInfo gswe_house_system_infos[GSWE_HOUSE_SYSTEM_COUNT];
+extern GsweAspectInfo gswe_aspect_infos[GSWE_ASPECT_COUNT];
+extern GsweAntiscionAxisInfo gswe_antiscion_axis_infos[GSWE_ANTISCION_AXIS_COUNT];
+
+/* Lookup functions for the above tables. They return NULL if the given ID
+ * has no record */
+static inline GswePlanetInfo *
+gswe_planet_info_lookup(GswePlanet planet)
+{
+    gint slot = gswe_planet_get_slot(planet);
+
+    if ((slot < 0) || (gswe_planet_infos[slot].refcount == 0)) {
+        return NULL;
+    }
+
+    return &gswe_planet_infos[slot];
+}
+
+static inline GsweSignInfo *
+gswe_sign_info_lookup(GsweZodiac sign)
+{
+    if ((sign < 0) || (sign >= GSWE_SIGN_COUNT)
+            || (gswe_sign_infos[sign].refcount == 0)) {
+        return NULL;
+    }
+
+    return &gswe_sign_infos[sign];
+}
+
+static inline GsweHouseSystemInfo *
+gswe_house_system_info_lookup(GsweHouseSystem house_system)
+{
+    if ((house_system < 0) || (house_system >= GSWE_HOUSE_SYSTEM_COUNT)
+            || (gswe_house_system_infos[house_system].refcount == 0)) {
+        return NULL;
+    }
+
+    return &gswe_house_system_infos[house_system];
+}
+
+static inline GsweAspectInfo *
+gswe_aspect_info_lookup(GsweAspect aspect)
+{
+    if ((aspect < 0) || (aspect >= GSWE_ASPECT_COUNT)
+            || (gswe_aspect_infos[aspect].refcount == 0)) {
+        return NULL;
+    }
+
+    return &gswe_aspect_infos[aspect];
+}
+
+static inline GsweAntiscionAxisInfo *
+gswe_antiscion_axis_info_lookup(GsweAntiscionAxis axis)
+{
+    if ((axis < 0) || (axis >= GSWE_ANTISCION_AXIS_COUNT)
+            || (gswe_antiscion_axis_infos[axis].refcount == 0)) {
+        return NULL;
+    }
+
+    return &gswe_antiscion_axis_infos[axis];
+}
+
 #endif /* __SWE_GLIB_PRIVATE_H__ */
 #else /* not defined __SWE_GLIB_BUILDING__ */
 #error __FILE__ "Can not be included, unless building SWE-GLib"
@@ -16,6 +16,9 @@
  * along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 #include <glib.h>
+#ifdef GSWE_EPHEMERIS_RESOURCE
+#include <gio/gio.h>
+#endif
 #define GETTEXT_PACKAGE "swe-glib"
 #include <glib/gi18n-lib.h>
 
@@ -32,6 +35,22 @@
  *
  * Basic utility and initialization functions. They don't operate on SWE-GLib's
  * objects, but on the library as a whole, including global tables.
+ *
+ * SWE-GLib can be used from multiple threads. gswe_init() and
+ * gswe_init_with_dir() may be called from any thread; the library is
+ * initialized only once. The info structures (#GswePlanetInfo,
+ * #GsweSignInfo, etc.) and the global tables holding them may be shared
+ * between threads freely, as long as no thread changes them. Their setters,
+ * like gswe_aspect_info_set_size(), gswe_aspect_info_set_orb_modifier() and
+ * gswe_planet_info_set_orb(), are not thread safe on the records known by
+ * SWE-GLib: call them only during initialization, before other threads start
+ * calculating. Every thread has its own Swiss Ephemeris state, which SWE-GLib
+ * sets up on first use.
+ *
+ * #GsweMoment and #GsweTimestamp objects, however, must only be used by one
+ * thread at a time. To calculate many charts on multiple threads, either
+ * create separate objects in each thread, or use
+ * gswe_moment_calculate_series_parallel().
  */
 
 /**
@@ -48,6 +67,8 @@
  *                             gswe_moment_add_planet()
  * @GSWE_ERROR_UNKNOWN_ANTISCION_AXIS: the given axis is unknown to SWE-GLib
  * @GSWE_ERROR_UNKNOWN_ASPECT: the given aspect is unknown to SWE-GLib
+ * @GSWE_ERROR_UNKNOWN_STAR: the given star is not in the star catalogue
+ *                           (Since: 2.2)
  *
  * Error codes returned by the SWE-GLib functions.
  */
@@ -62,649 +83,778 @@
 
 gboolean gswe_initialized = FALSE;
 gchar *gswe_ephe_path = NULL;
-GHashTable *gswe_planet_info_table;
-GHashTable *gswe_sign_info_table;
-GHashTable *gswe_house_system_info_table;
-GHashTable *gswe_aspect_info_table;
-GHashTable *gswe_antiscion_axis_info_table;
 GsweTimestamp *gswe_full_moon_base_date;
-static gboolean gswe_initializing = FALSE;
-
-#define ADD_PLANET(ht, v, i, s, r, n, o, h) \
-    (v) = gswe_planet_info_new(); \
-    (v)->planet = (i); \
-    (v)->sweph_id = (s); \
-    (v)->real_body = (r); \
-    (v)->orb = (o); \
-    (v)->name = g_strdup(n); \
-    (v)->points = (h); \
-    g_hash_table_replace((ht), GINT_TO_POINTER(i), (v)); \
-
-#define ADD_SIGN(ht, v, s, n, e, q) \
-    (v) = gswe_sign_info_new(); \
-    (v)->sign = (s); \
-    (v)->name = g_strdup(n); \
-    (v)->element = (e); \
-    (v)->quality = (q); \
-    g_hash_table_replace((ht), GINT_TO_POINTER(s), (v)); \
-
-#define ADD_HOUSE_SYSTEM(ht, v, i, s, n) \
-    (v) = gswe_house_system_info_new(); \
-    (v)->house_system = i; \
-    (v)->sweph_id = s; \
-    (v)->name = g_strdup(n); \
-    g_hash_table_replace((ht), GINT_TO_POINTER(i), (v)); \
-
-#define ADD_ASPECT(ht, v, i, n, s, o, h, m) \
-    (v) = gswe_aspect_info_new(); \
-    (v)->aspect = (i); \
-    (v)->name = g_strdup(n); \
-    (v)->size = (s); \
-    (v)->orb_modifier = (o); \
-    (v)->harmonic = (h); \
-    (v)->major = (m); \
-    g_hash_table_replace((ht), GINT_TO_POINTER(i), (v)); \
-
-#define ADD_ANTISCION(ht, v, hts, vs, i, n, s, m) \
-    (v) = gswe_antiscion_axis_info_new(); \
-    (vs) = g_hash_table_lookup((hts), GINT_TO_POINTER(i)); \
-    (v)->axis = (i); \
-    (v)->start_sign = (vs); \
-    (v)->name = g_strdup(n); \
-    (v)->sign_offset = m; \
-    g_hash_table_replace((ht), GINT_TO_POINTER(i), (v)); \
 
-/**
- * gswe_error_quark:
- *
- * Gets the SWE-GLib Error Quark.
- *
- * Return value: a #GQuark
- */
-#if GLIB_CHECK_VERSION(2, 34, 0)
-G_DEFINE_QUARK(gswe-error-quark, gswe_error);
-#else
-GQuark
-gswe_error_quark(void)
-{
-    return g_quark_from_static_string("gswe-error-quark");
-}
-#endif
+/* the guard of the one-time initialization in gswe_init_with_dir() */
+static gsize gswe_init_once = 0;
 
-/**
- * gswe_init_with_dir:
- * @directory: the path that contains the Swiss Ephemeris data files
- *
- * Initializes the SWE-GLib library with @directory as the Swiss Ephemeris
- * data files' location. This, or gswe_init() must be called before any
- * calculations are made.
- */
-void gswe_init_with_dir(gchar *directory)
-{
-    GswePlanetInfo *planet_info;
-    GsweSignInfo *sign_info;
-    GsweHouseSystemInfo *house_system_info;
-    GsweAspectInfo *aspect_info;
-    GsweAntiscionAxisInfo *antiscion_axis_info;
+/* set in the thread running gswe_init_with_dir(), while it runs */
+static GPrivate gswe_initializing = G_PRIVATE_INIT(NULL);
 
-    if (gswe_initialized) {
-        return;
-    }
+/* set in every thread that has already set up its Swiss Ephemeris state */
+static GPrivate gswe_thread_initialized = G_PRIVATE_INIT(NULL);
 
-    if (gswe_initializing) {
-        return;
+/* the value of gswe_set_interpolate_nutation(), applied to every Swiss
+ * Ephemeris state by gswe_thread_init() and gswe_context_enter() */
+static volatile gint gswe_interpolate_nutation = FALSE;
+
+#define PLANET(i, s, r, n, o, h) \
+    [GSWE_PLANET_SLOT(i)] = { \
+        .planet = (i), \
+        .sweph_id = (s), \
+        .real_body = (r), \
+        .orb = (o), \
+        .points = (h), \
+        .refcount = 1, \
+        .msgid = (n) \
     }
 
-    gswe_initializing = TRUE;
+/* The signs are referenced by their table, and by the antiscion axes starting
+ * in them (see ANTISCION below) */
+#define SIGN_REFS(s) (1 \
+        + ((s) == GSWE_SIGN_ARIES) \
+        + ((s) == GSWE_SIGN_TAURUS) \
+        + ((s) == GSWE_SIGN_CANCER) \
+        + ((s) == GSWE_SIGN_LEO) \
+    )
 
-    /* Before 2.36, g_type_init() must have been called. Let's do it! */
-#if !GLIB_CHECK_VERSION(2, 36, 0)
-    g_type_init();
-#endif
+#define SIGN(s, n, e, q) \
+    [s] = { \
+        .sign = (s), \
+        .element = (e), \
+        .quality = (q), \
+        .refcount = SIGN_REFS(s), \
+        .msgid = (n) \
+    }
 
-    bindtextdomain(GETTEXT_PACKAGE, LOCALEDIR);
-    bind_textdomain_codeset(GETTEXT_PACKAGE, "UTF-8");
+#define HOUSE_SYSTEM(i, s, n) \
+    [i] = { \
+        .house_system = (i), \
+        .sweph_id = (s), \
+        .refcount = 1, \
+        .msgid = (n) \
+    }
 
-    gswe_planet_info_table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify)gswe_planet_info_unref
-        );
+#define ASPECT(i, n, s, o, h, m) \
+    [i] = { \
+        .aspect = (i), \
+        .size = (s), \
+        .orb_modifier = (o), \
+        .harmonic = (h), \
+        .major = (m), \
+        .refcount = 1, \
+        .msgid = (n) \
+    }
+
+#define ANTISCION(i, n, s, m) \
+    [i] = { \
+        .axis = (i), \
+        .start_sign = ((s) == GSWE_SIGN_NONE) ? NULL : &gswe_sign_infos[s], \
+        .sign_offset = (m), \
+        .refcount = 1, \
+        .msgid = (n) \
+    }
 
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+/* The info records known by SWE-GLib, indexed by their IDs (planets by
+ * gswe_planet_get_slot()). Slots without a record are all zeros. The names
+ * are translated by the getters on every call, in the current locale */
+GswePlanetInfo gswe_planet_infos[GSWE_PLANET_SLOT_COUNT] = {
+    PLANET(
             GSWE_PLANET_ASCENDANT,
             -1,
             FALSE,
-            _("Ascendant"),
+            N_("Ascendant"),
             9.0,
             2
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
-               GSWE_PLANET_DESCENDANT,
-               -1,
-               FALSE,
-               _("Descendant"),
-               0.0,
-               0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
+            GSWE_PLANET_DESCENDANT,
+            -1,
+            FALSE,
+            N_("Descendant"),
+            0.0,
+            0
+        ),
+    PLANET(
             GSWE_PLANET_MC,
             -1,
             FALSE,
-            _("Midheaven"),
+            N_("Midheaven"),
             5.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
-               GSWE_PLANET_IC,
-               -1,
-               FALSE,
-               _("Immum Coeli"),
-               0.0,
-               0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
+            GSWE_PLANET_IC,
+            -1,
+            FALSE,
+            N_("Immum Coeli"),
+            0.0,
+            0
+        ),
+    PLANET(
             GSWE_PLANET_VERTEX,
             -1,
             FALSE,
-            _("Vertex"),
+            N_("Vertex"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
-               GSWE_PLANET_ANTIVERTEX,
-               -1,
-               FALSE,
-               _("Anti-vertex"),
-               0.0,
-               0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
+            GSWE_PLANET_ANTIVERTEX,
+            -1,
+            FALSE,
+            N_("Anti-vertex"),
+            0.0,
+            0
+        ),
+    PLANET(
             GSWE_PLANET_MOON_NODE,
             SE_MEAN_NODE,
             TRUE,
-            _("Ascending Moon Node"),
+            N_("Ascending Moon Node"),
             2.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
-               GSWE_PLANET_MOON_SOUTH_NODE,
-               // As this is just the opposing point of the mean node,
-               // we actually calculate that, and simply add 180
-               // degrees when queried.
-               SE_MEAN_NODE,
-               TRUE,
-               _("Descending Moon Node"),
-               2.0,
-               0);
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
+            GSWE_PLANET_MOON_SOUTH_NODE,
+            // As this is just the opposing point of the mean node,
+            // we actually calculate that, and simply add 180
+            // degrees when queried.
+            SE_MEAN_NODE,
+            TRUE,
+            N_("Descending Moon Node"),
+            2.0,
+            0),
+    PLANET(
             GSWE_PLANET_MOON_APOGEE,
             SE_MEAN_APOG,
             TRUE,
-            _("Dark Moon"),
+            N_("Dark Moon"),
             2.0,
             0
-        );
-
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_SUN,
             SE_SUN,
             TRUE,
-            _("Sun"),
+            N_("Sun"),
             13.0,
             2
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_MOON,
             SE_MOON,
             TRUE,
-            _("Moon"),
+            N_("Moon"),
             9.0,
             2
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_MERCURY,
             SE_MERCURY,
             TRUE,
-            _("Mercury"),
+            N_("Mercury"),
             7.0,
             2
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_VENUS,
             SE_VENUS,
             TRUE,
-            _("Venus"),
+            N_("Venus"),
             7.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_MARS,
             SE_MARS,
             TRUE,
-            _("Mars"),
+            N_("Mars"),
             7.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_JUPITER,
             SE_JUPITER,
             TRUE,
-            _("Jupiter"),
+            N_("Jupiter"),
             9.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_SATURN,
             SE_SATURN,
             TRUE,
-            _("Saturn"),
+            N_("Saturn"),
             7.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_URANUS,
             SE_URANUS,
             TRUE,
-            _("Uranus"),
+            N_("Uranus"),
             5.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_NEPTUNE,
             SE_NEPTUNE,
             TRUE,
-            _("Neptune"),
+            N_("Neptune"),
             5.0,
             1
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_PLUTO,
             SE_PLUTO,
             TRUE,
-            _("Pluto"),
+            N_("Pluto"),
             3.0,
             1
-        );
-
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_CHIRON,
             SE_CHIRON,
             TRUE,
-            _("Chiron"),
+            N_("Chiron"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_CERES,
             SE_CERES,
             TRUE,
-            _("Ceres"),
+            N_("Ceres"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_PALLAS,
             SE_PALLAS,
             TRUE,
-            _("Pallas"),
+            N_("Pallas"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_JUNO,
             SE_JUNO,
             TRUE,
-            _("Juno"),
+            N_("Juno"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_VESTA,
             SE_VESTA,
             TRUE,
-            _("Vesta"),
+            N_("Vesta"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_PHOLUS,
             SE_PHOLUS,
             TRUE,
-            _("Pholus"),
+            N_("Pholus"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_NESSUS,
             SE_AST_OFFSET + 7066,
             TRUE,
-            _("Nessus"),
+            N_("Nessus"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_CHARIKLO,
             SE_AST_OFFSET + 10199,
             TRUE,
-            _("Chariklo"),
+            N_("Chariklo"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_SEDNA,
             SE_AST_OFFSET + 90377,
             TRUE,
-            _("Sedna"),
+            N_("Sedna"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_ERIS,
             SE_AST_OFFSET + 136199,
             TRUE,
-            _("Eris"),
+            N_("Eris"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_DEJANIRA,
             SE_AST_OFFSET + 157,
             TRUE,
-            _("Dejanira"),
+            N_("Dejanira"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_CIRCE,
             SE_AST_OFFSET + 34,
             TRUE,
-            _("Circe"),
+            N_("Circe"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_ORCUS,
             SE_AST_OFFSET + 90482,
             TRUE,
-            _("Orcus"),
+            N_("Orcus"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_ASBOLUS,
             SE_AST_OFFSET + 8405,
             TRUE,
-            _("Asbolus"),
+            N_("Asbolus"),
             2.0,
             0
-        );
-    ADD_PLANET(gswe_planet_info_table, planet_info,
+        ),
+    PLANET(
             GSWE_PLANET_HYGIEA,
             SE_AST_OFFSET + 10,
             TRUE,
-            _("Hygiea"),
+            N_("Hygiea"),
             2.0,
             0
-        );
-
-    gswe_sign_info_table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify)gswe_sign_info_unref
-        );
+        ),
+};
 
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+GsweSignInfo gswe_sign_infos[GSWE_SIGN_COUNT] = {
+    SIGN(
             GSWE_SIGN_ARIES,
-            _("Aries"),
+            N_("Aries"),
             GSWE_ELEMENT_FIRE,
             GSWE_QUALITY_CARDINAL
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_TAURUS,
-            _("Taurus"),
+            N_("Taurus"),
             GSWE_ELEMENT_EARTH,
             GSWE_QUALITY_FIX
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_GEMINI,
-            _("Gemini"),
+            N_("Gemini"),
             GSWE_ELEMENT_AIR,
             GSWE_QUALITY_MUTABLE
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_CANCER,
-            _("Cancer"),
+            N_("Cancer"),
             GSWE_ELEMENT_WATER,
             GSWE_QUALITY_CARDINAL
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_LEO,
-            _("Leo"),
+            N_("Leo"),
             GSWE_ELEMENT_FIRE,
             GSWE_QUALITY_FIX
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_VIRGO,
-            _("Virgo"),
+            N_("Virgo"),
             GSWE_ELEMENT_EARTH,
             GSWE_QUALITY_MUTABLE
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_LIBRA,
-            _("Libra"),
+            N_("Libra"),
             GSWE_ELEMENT_AIR,
             GSWE_QUALITY_CARDINAL
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_SCORPIO,
-            _("Scorpio"),
+            N_("Scorpio"),
             GSWE_ELEMENT_WATER,
             GSWE_QUALITY_FIX
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_SAGITTARIUS,
-            _("Sagittarius"),
+            N_("Sagittarius"),
             GSWE_ELEMENT_FIRE,
             GSWE_QUALITY_MUTABLE
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_CAPRICORN,
-            _("Capricorn"),
+            N_("Capricorn"),
             GSWE_ELEMENT_EARTH,
             GSWE_QUALITY_CARDINAL
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_AQUARIUS,
-            _("Aquarius"),
+            N_("Aquarius"),
             GSWE_ELEMENT_AIR,
             GSWE_QUALITY_FIX
-        );
-    ADD_SIGN(gswe_sign_info_table, sign_info,
+        ),
+    SIGN(
             GSWE_SIGN_PISCES,
-            _("Pisces"),
+            N_("Pisces"),
             GSWE_ELEMENT_WATER,
             GSWE_QUALITY_MUTABLE
-        );
-
-    gswe_house_system_info_table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify)gswe_house_system_info_unref
-        );
+        ),
+};
 
-    ADD_HOUSE_SYSTEM(gswe_house_system_info_table, house_system_info,
+GsweHouseSystemInfo gswe_house_system_infos[GSWE_HOUSE_SYSTEM_COUNT] = {
+    HOUSE_SYSTEM(
             GSWE_HOUSE_SYSTEM_NONE,
             0,
-            _("None")
-        );
-    ADD_HOUSE_SYSTEM(gswe_house_system_info_table, house_system_info,
+            N_("None")
+        ),
+    HOUSE_SYSTEM(
             GSWE_HOUSE_SYSTEM_PLACIDUS,
             'P',
-            _("Placidus")
-        );
-    ADD_HOUSE_SYSTEM(gswe_house_system_info_table, house_system_info,
+            N_("Placidus")
+        ),
+    HOUSE_SYSTEM(
             GSWE_HOUSE_SYSTEM_KOCH,
             'K',
-            _("Koch")
-        );
-    ADD_HOUSE_SYSTEM(gswe_house_system_info_table, house_system_info,
+            N_("Koch")
+        ),
+    HOUSE_SYSTEM(
             GSWE_HOUSE_SYSTEM_EQUAL,
             'E',
-            _("Equal")
-        );
-
-    gswe_aspect_info_table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify)gswe_aspect_info_unref
-        );
+            N_("Equal")
+        ),
+    HOUSE_SYSTEM(
+            GSWE_HOUSE_SYSTEM_GAUQUELIN,
+            'G',
+            N_("Gauquelin sectors")
+        ),
+};
 
-    // Note that because all aspects must be <= 180°, GSWE_ASPECT_NONE can
-    // never really exist. It is provided for name fetching purposes only.
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+// Note that because all aspects must be <= 180°, GSWE_ASPECT_NONE can never
+// really exist. It is provided for name fetching purposes only.
+GsweAspectInfo gswe_aspect_infos[GSWE_ASPECT_COUNT] = {
+    ASPECT(
             GSWE_ASPECT_NONE,
-            _("None"),
+            N_("None"),
             360,
             4,
             FALSE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_CONJUCTION,
-            _("Conjuction"),
+            N_("Conjuction"),
             0,
             0,
             TRUE,
             TRUE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_OPPOSITION,
-            _("Opposition"),
+            N_("Opposition"),
             180,
             0,
             TRUE,
             TRUE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_TRINE,
-            _("Trine"),
+            N_("Trine"),
             120,
             0,
             TRUE,
             TRUE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_SQUARE,
-            _("Square"),
+            N_("Square"),
             90,
             0,
             FALSE,
             TRUE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_SEXTILE,
-            _("Sextile"),
+            N_("Sextile"),
             60,
             1,
             TRUE,
             TRUE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_QUINCUNX,
-            _("Quincunx"),
+            N_("Quincunx"),
             150,
             2,
             FALSE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_SEMISEXTILE,
-            _("Semi-sextile"),
+            N_("Semi-sextile"),
             30,
             2,
             TRUE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_SEMISQUARE,
-            _("Semi-square"),
+            N_("Semi-square"),
             45,
             2,
             FALSE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_SESQUISQUARE,
-            _("Sesqui-square"),
+            N_("Sesqui-square"),
             135,
             2,
             FALSE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_QUINTILE,
-            _("Quintile"),
+            N_("Quintile"),
             72,
             3,
             TRUE,
             FALSE
-        );
-    ADD_ASPECT(gswe_aspect_info_table, aspect_info,
+        ),
+    ASPECT(
             GSWE_ASPECT_BIQUINTILE,
-            _("Bi-quintile"),
+            N_("Bi-quintile"),
             144,
             3,
             TRUE,
             FALSE
-        );
+        ),
+};
 
-    gswe_antiscion_axis_info_table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify)gswe_antiscion_axis_info_unref
-        );
-
-    ADD_ANTISCION(gswe_antiscion_axis_info_table, antiscion_axis_info,
-            gswe_sign_info_table, sign_info,
+GsweAntiscionAxisInfo gswe_antiscion_axis_infos[GSWE_ANTISCION_AXIS_COUNT] = {
+    ANTISCION(
             GSWE_ANTISCION_AXIS_NONE,
-            _("None"),
+            N_("None"),
             GSWE_SIGN_NONE,
             0.0
-        );
-    ADD_ANTISCION(gswe_antiscion_axis_info_table, antiscion_axis_info,
-            gswe_sign_info_table, sign_info,
+        ),
+    ANTISCION(
             GSWE_ANTISCION_AXIS_ARIES,
-            _("Aries/Libra"),
+            N_("Aries/Libra"),
             GSWE_SIGN_ARIES,
             0.0
-        );
-    ADD_ANTISCION(gswe_antiscion_axis_info_table, antiscion_axis_info,
-            gswe_sign_info_table, sign_info,
+        ),
+    ANTISCION(
             GSWE_ANTISCION_AXIS_MID_TAURUS,
-            _("mid Taurus/Scorpio"),
+            N_("mid Taurus/Scorpio"),
             GSWE_SIGN_TAURUS,
             15.0
-        );
-    ADD_ANTISCION(gswe_antiscion_axis_info_table, antiscion_axis_info,
-            gswe_sign_info_table, sign_info,
+        ),
+    ANTISCION(
             GSWE_ANTISCION_AXIS_CANCER,
-            _("Cancer/Capricorn"),
+            N_("Cancer/Capricorn"),
             GSWE_SIGN_CANCER,
             0.0
-        );
-    ADD_ANTISCION(gswe_antiscion_axis_info_table, antiscion_axis_info,
-            gswe_sign_info_table, sign_info,
+        ),
+    ANTISCION(
             GSWE_ANTISCION_AXIS_MID_LEO,
-            _("mid Leo/Aquarius"),
+            N_("mid Leo/Aquarius"),
             GSWE_SIGN_LEO,
             15.0
+        ),
+};
+
+/**
+ * gswe_error_quark:
+ *
+ * Gets the SWE-GLib Error Quark.
+ *
+ * Return value: a #GQuark
+ */
+#if GLIB_CHECK_VERSION(2, 34, 0)
+G_DEFINE_QUARK(gswe-error-quark, gswe_error);
+#else
+GQuark
+gswe_error_quark(void)
+{
+    return g_quark_from_static_string("gswe-error-quark");
+}
+#endif
+
+/* the ephemeris bundle embedded into the library, kept alive while the Swiss
+ * Ephemeris uses it */
+#ifdef GSWE_EPHEMERIS_RESOURCE
+static GBytes *gswe_ephemeris_bundle = NULL;
+#endif
+
+/*
+ * gswe_load_ephemeris_bundle:
+ * @directory: the path that contains the Swiss Ephemeris data files
+ *
+ * Makes the Swiss Ephemeris read its data files from the ephemeris bundle, if
+ * there is one: either the one embedded into the library as a resource, or
+ * sweph.bundle in @directory. Files not in the bundle are still looked up in
+ * @directory.
+ */
+static void
+gswe_load_ephemeris_bundle(gchar *directory)
+{
+    gchar serr[AS_MAXCH];
+    gchar *bundle_path;
+
+#ifdef GSWE_EPHEMERIS_RESOURCE
+    gsize size;
+
+    gswe_ephemeris_bundle = g_resources_lookup_data(
+            "/eu/polonkai/gergely/swe-glib/sweph.bundle",
+            G_RESOURCE_LOOKUP_FLAGS_NONE,
+            NULL
         );
 
+    if (gswe_ephemeris_bundle != NULL) {
+        const guchar *data = g_bytes_get_data(gswe_ephemeris_bundle, &size);
+
+        if (swe_set_ephe_bundle((guchar *)data, (gint32)size, serr) == OK) {
+            return;
+        }
+
+        g_warning("Can not use the embedded ephemeris files: %s", serr);
+        g_bytes_unref(gswe_ephemeris_bundle);
+        gswe_ephemeris_bundle = NULL;
+    }
+#endif
+
+    bundle_path = g_build_filename(directory, "sweph.bundle", NULL);
+
+    if (
+            g_file_test(bundle_path, G_FILE_TEST_IS_REGULAR)
+            && (swe_open_ephe_bundle(bundle_path, serr) != OK)
+        ) {
+        g_warning("Can not use the ephemeris bundle %s: %s", bundle_path, serr);
+    }
+
+    g_free(bundle_path);
+}
+
+/**
+ * gswe_init_with_dir:
+ * @directory: the path that contains the Swiss Ephemeris data files
+ *
+ * Initializes the SWE-GLib library with @directory as the Swiss Ephemeris
+ * data files' location. This, or gswe_init() must be called before any
+ * calculations are made.
+ *
+ * If SWE-GLib was built with the ephemeris files embedded, or @directory
+ * contains an ephemeris bundle named sweph.bundle, the data files are read
+ * from there.
+ */
+void gswe_init_with_dir(gchar *directory)
+{
+    // Many of the functions called below call gswe_init() themselves. In this
+    // thread they must return immediately instead of waiting for us to finish
+    if (g_private_get(&gswe_initializing)) {
+        return;
+    }
+
+    if (!g_once_init_enter(&gswe_init_once)) {
+        gswe_thread_init();
+
+        return;
+    }
+
+    g_private_set(&gswe_initializing, GINT_TO_POINTER(TRUE));
+
+    gswe_ephe_path = g_strdup(directory);
+    gswe_load_ephemeris_bundle(directory);
+    gswe_thread_init();
+
+    /* Before 2.36, g_type_init() must have been called. Let's do it! */
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+    g_type_init();
+#endif
+
+    bindtextdomain(GETTEXT_PACKAGE, LOCALEDIR);
+    bind_textdomain_codeset(GETTEXT_PACKAGE, "UTF-8");
+
+    gswe_aspect_classifier_init();
+
     gswe_full_moon_base_date = gswe_timestamp_new_from_gregorian_full(
             2005, 5, 8,
             3, 48, 0, 0,
             0.0
         );
 
-    gswe_ephe_path = g_strdup(directory);
-    swe_set_ephe_path(directory);
     gswe_initialized = TRUE;
+    g_private_set(&gswe_initializing, NULL);
+    g_once_init_leave(&gswe_init_once, 1);
+}
+
+/*
+ * gswe_thread_init:
+ *
+ * Sets up the Swiss Ephemeris for the calling thread. The Swiss Ephemeris
+ * keeps its state (open files, saved positions, observer position, etc.) in
+ * thread local storage, so every thread has to do this before calling any
+ * swe_* functions. Calling it more than once in the same thread is cheap.
+ *
+ * It also applies the library wide settings, like the one of
+ * gswe_set_interpolate_nutation(), to the thread's state, so they take effect
+ * in threads that were set up before they changed.
+ */
+void
+gswe_thread_init(void)
+{
+    if (g_private_get(&gswe_thread_initialized) == NULL) {
+        swe_set_ephe_path(gswe_ephe_path);
+        g_private_set(&gswe_thread_initialized, GINT_TO_POINTER(TRUE));
+    }
+
+    // This returns immediately if the setting did not change
+    swe_set_interpolate_nut(gswe_get_interpolate_nutation());
+}
+
+/**
+ * gswe_set_interpolate_nutation:
+ * @interpolate: %TRUE to interpolate nutation and obliquity
+ *
+ * Sets whether nutation and the obliquity of the ecliptic are interpolated
+ * from values cached at fixed steps, instead of summing their series for
+ * every date. Interpolation makes calculating many close dates (e.g. with
+ * gswe_moment_calculate_series()) faster, while changing positions by less
+ * than 0.0001 arc seconds. It is off by default.
+ *
+ * The setting is library wide: it applies to every thread, every #GsweMoment
+ * and every #GsweContext, from their next calculation on.
+ *
+ * Since: 2.2
+ */
+void
+gswe_set_interpolate_nutation(gboolean interpolate)
+{
+    g_atomic_int_set(&gswe_interpolate_nutation, (interpolate != FALSE));
+}
+
+/**
+ * gswe_get_interpolate_nutation:
+ *
+ * Gets the value set by gswe_set_interpolate_nutation().
+ *
+ * Returns: %TRUE if nutation and obliquity are interpolated
+ *
+ * Since: 2.2
+ */
+gboolean
+gswe_get_interpolate_nutation(void)
+{
+    return g_atomic_int_get(&gswe_interpolate_nutation);
 }
 
 /**
@@ -731,10 +881,7 @@ gswe_init(void)
 GswePlanetInfo *
 gswe_find_planet_info_by_id(GswePlanet planet, GError **err)
 {
-    GswePlanetInfo *ret = g_hash_table_lookup(
-            gswe_planet_info_table,
-            GINT_TO_POINTER(planet)
-        );
+    GswePlanetInfo *ret = gswe_planet_info_lookup(planet);
 
     if (ret == NULL) {
         g_set_error(
@@ -759,10 +906,7 @@ gswe_find_planet_info_by_id(GswePlanet planet, GError **err)
 GsweSignInfo *
 gswe_find_sign_info_by_id(GsweZodiac sign, GError **err)
 {
-    GsweSignInfo *ret = g_hash_table_lookup(
-            gswe_sign_info_table,
-            GINT_TO_POINTER(sign)
-        );
+    GsweSignInfo *ret = gswe_sign_info_lookup(sign);
 
     if (ret == NULL) {
         g_set_error(
@@ -787,10 +931,7 @@ gswe_find_sign_info_by_id(GsweZodiac sign, GError **err)
 GsweHouseSystemInfo *
 gswe_find_house_system_info_by_id(GsweHouseSystem house_system, GError **err)
 {
-    GsweHouseSystemInfo *ret = g_hash_table_lookup(
-            gswe_house_system_info_table,
-            GINT_TO_POINTER(house_system)
-        );
+    GsweHouseSystemInfo *ret = gswe_house_system_info_lookup(house_system);
 
     if (ret == NULL) {
         g_set_error(
@@ -815,10 +956,7 @@ gswe_find_house_system_info_by_id(GsweHouseSystem house_system, GError **err)
 GsweAspectInfo *
 gswe_find_aspect_info_by_id(GsweAspect aspect, GError **err)
 {
-    GsweAspectInfo *ret = g_hash_table_lookup(
-            gswe_aspect_info_table,
-            GINT_TO_POINTER(aspect)
-        );
+    GsweAspectInfo *ret = gswe_aspect_info_lookup(aspect);
 
     if (ret == NULL) {
         g_set_error(
@@ -846,10 +984,7 @@ gswe_find_antiscion_axis_info_by_id(
         GsweAntiscionAxis antiscion_axis,
         GError **err)
 {
-    GsweAntiscionAxisInfo *ret = g_hash_table_lookup(
-            gswe_antiscion_axis_info_table,
-            GINT_TO_POINTER(antiscion_axis)
-        );
+    GsweAntiscionAxisInfo *ret = gswe_antiscion_axis_info_lookup(antiscion_axis);
 
     if (ret == NULL) {
         g_set_error(
@@ -867,15 +1002,24 @@ gswe_find_antiscion_axis_info_by_id(
  *
  * Returns: (element-type GsweHouseSystemInfo) (transfer container):
  * All #GsweHouseSystemInfo registered with SWE-GLib. The elements of
- * this list should not be modified nor freed. The list is only valid
- * until a new house system is registered.
+ * this list should not be modified nor freed. The list is ordered by
+ * the house system IDs.
  *
  * Since: 2.1.0
  */
 GList *
 gswe_all_house_systems(void)
 {
-    return g_hash_table_get_values(gswe_house_system_info_table);
+    GList *ret = NULL;
+    gint i;
+
+    for (i = GSWE_HOUSE_SYSTEM_COUNT - 1; i >= 0; i--) {
+        if (gswe_house_system_infos[i].refcount > 0) {
+            ret = g_list_prepend(ret, &gswe_house_system_infos[i]);
+        }
+    }
+
+    return ret;
 }
 
 /**
@@ -883,15 +1027,24 @@ gswe_all_house_systems(void)
  *
  * Returns: (element-type GswePlanetInfo) (transfer container): All
  * #GswePlanetInfo registered with SWE-GLib. The elements of this list
- * should not be modified nor freed. The list is only valid until a
- * new planet is registered.
+ * should not be modified nor freed. The list is ordered by the planet
+ * IDs.
  *
  * Since: 2.1.0
  */
 GList *
 gswe_all_planets(void)
 {
-    return g_hash_table_get_values(gswe_planet_info_table);
+    GList *ret = NULL;
+    gint i;
+
+    for (i = GSWE_PLANET_SLOT_COUNT - 1; i >= 0; i--) {
+        if (gswe_planet_infos[i].refcount > 0) {
+            ret = g_list_prepend(ret, &gswe_planet_infos[i]);
+        }
+    }
+
+    return ret;
 }
 
 /**
@@ -899,15 +1052,24 @@ gswe_all_planets(void)
  *
  * Returns: (element-type GsweAspectInfo) (transfer container): All
  * #GsweAspectInfo registered with SWE-GLib. The elements of this list
- * should not be modified nor freed. The list is only valid until a
- * new aspect is registered.
+ * should not be modified nor freed. The list is ordered by the aspect
+ * IDs.
  *
  * Since: 2.1.0
  */
 GList *
 gswe_all_aspects(void)
 {
-    return g_hash_table_get_values(gswe_aspect_info_table);
+    GList *ret = NULL;
+    gint i;
+
+    for (i = GSWE_ASPECT_COUNT - 1; i >= 0; i--) {
+        if (gswe_aspect_infos[i].refcount > 0) {
+            ret = g_list_prepend(ret, &gswe_aspect_infos[i]);
+        }
+    }
+
+    return ret;
 }
 
 /**
@@ -915,13 +1077,36 @@ gswe_all_aspects(void)
  *
  * Returns: (element-type GsweAntiscionAxisInfo) (transfer container):
  * All #GsweAntiscionAxisInfo registered with SWE-GLib. The elements
- * of this list should not be modified nor freed. The list is only
- * valid until a new antiscion axis is registered.
+ * of this list should not be modified nor freed. The list is ordered
+ * by the axis IDs.
  *
  * Since: 2.1.0
  */
 GList *
 gswe_all_antiscion_axes(void)
 {
-    return g_hash_table_get_values(gswe_antiscion_axis_info_table);
+    GList *ret = NULL;
+    gint i;
+
+    for (i = GSWE_ANTISCION_AXIS_COUNT - 1; i >= 0; i--) {
+        if (gswe_antiscion_axis_infos[i].refcount > 0) {
+            ret = g_list_prepend(ret, &gswe_antiscion_axis_infos[i]);
+        }
+    }
+
+    return ret;
+}
+
+/*
+ * gswe_translate:
+ * @msgid: an untranslated string from one of the info tables
+ *
+ * Translates @msgid using the message catalogue of SWE-GLib.
+ *
+ * Returns: (transfer none): the translated string
+ */
+const gchar *
+gswe_translate(const gchar *msgid)
+{
+    return _(msgid);
 }
@@ -30,7 +30,10 @@
 #include "gswe-antiscion-data.h"
 #include "gswe-house-system-info.h"
 #include "gswe-house-data.h"
+#include "gswe-fixed-star.h"
+#include "gswe-time.h"
 #include "gswe-timestamp.h"
+#include "gswe-context.h"
 #include "gswe-moment.h"
 #include "gswe-enumtypes.h"
 
@@ -46,6 +49,7 @@ typedef enum {
     GSWE_ERROR_UNKNOWN_PLANET,
     GSWE_ERROR_UNKNOWN_ANTISCION_AXIS,
     GSWE_ERROR_UNKNOWN_ASPECT,
+    GSWE_ERROR_UNKNOWN_STAR,
 } GsweError;
 
 #define GSWE_ERROR gswe_error_quark()
@@ -53,6 +57,10 @@ GQuark gswe_error_quark(void);
 
 void gswe_init();
 
+void gswe_set_interpolate_nutation(gboolean interpolate);
+
+gboolean gswe_get_interpolate_nutation(void);
+
 GswePlanetInfo *gswe_find_planet_info_by_id(GswePlanet planet, GError **err);
 
 GsweSignInfo *gswe_find_sign_info_by_id(GsweZodiac sign, GError **err);
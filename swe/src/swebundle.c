@@ -0,0 +1,263 @@
+/*
+  swebundle.c	packs ephemeris files into an ephemeris bundle, which
+		swe_open_ephe_bundle() or swe_set_ephe_bundle() can use
+		instead of the files (s. the format in sweph.h)
+
+  usage: swebundle [-b jd] [-e jd] [-p bodies] -o bundle [-d dir] file ...
+         swebundle [-b jd] [-e jd] [-p bodies] -O outdir [-d dir] file ...
+
+  the files are given by their names relative to the ephemeris path
+  (e.g. sepl_18.se1 or ast0/se00433.se1), and are read from the
+  directory dir (default: the current directory).
+
+  with -b, -e or -p, the .se1 files are compacted before they are
+  packed (s. swe_compact_ephe_file()): only the data from the Julian
+  day (ET) given with -b to the one given with -e are kept, and only
+  the bodies given with -p, as a comma separated list of planet 
+  numbers (e.g. 0,1,4,15,10433). files without any of these data are
+  left out.
+  with -O, the files are written into the directory outdir instead of
+  a bundle; its subdirectories (like ast0) must exist.
+
+  This file is distributed under the same license conditions as the
+  other files of the Swiss Ephemeris.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "swephexp.h"
+#include "sweph.h"
+
+#define BUNDLE_ALIGN	8
+#define BUNDLE_MAXBODIES	100
+
+struct infile {
+  char *name;		/* name in the bundle */
+  char *path;		/* where it is read from */
+  AS_BOOL is_temp;	/* path is a compacted file to be removed */
+  uint32 len;
+  uint32 off;
+};
+
+static int infile_cmp(const void *a, const void *b)
+{
+  return strcmp(((const struct infile *) a)->name, ((const struct infile *) b)->name);
+}
+
+static void put_uint32(unsigned char *p, uint32 v)
+{
+  p[0] = (unsigned char) (v & 0xff);
+  p[1] = (unsigned char) ((v >> 8) & 0xff);
+  p[2] = (unsigned char) ((v >> 16) & 0xff);
+  p[3] = (unsigned char) ((v >> 24) & 0xff);
+}
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: swebundle [-b jd] [-e jd] [-p bodies] -o bundle [-d dir] file ...\n");
+  fprintf(stderr, "       swebundle [-b jd] [-e jd] [-p bodies] -O outdir [-d dir] file ...\n");
+  exit(2);
+}
+
+static char *make_path(char *dir, char *name)
+{
+  char *path;
+  if ((path = (char *) malloc(strlen(dir) + strlen(name) + 2)) == NULL) {
+    fprintf(stderr, "swebundle: out of memory\n");
+    exit(1);
+  }
+  sprintf(path, "%s/%s", dir, name);
+  return path;
+}
+
+static int copy_file(char *from, char *to)
+{
+  unsigned char buf[8192];
+  size_t n;
+  FILE *fp, *ofp;
+  int err = 0;
+  if ((fp = fopen(from, "rb")) == NULL) {
+    fprintf(stderr, "swebundle: cannot read %s\n", from);
+    return ERR;
+  }
+  if ((ofp = fopen(to, "wb")) == NULL) {
+    fprintf(stderr, "swebundle: cannot create %s\n", to);
+    fclose(fp);
+    return ERR;
+  }
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    fwrite(buf, n, 1, ofp);
+  err = ferror(fp) | ferror(ofp);
+  fclose(fp);
+  if (err | fclose(ofp)) {
+    fprintf(stderr, "swebundle: cannot write %s\n", to);
+    return ERR;
+  }
+  return OK;
+}
+
+int main(int argc, char *argv[])
+{
+  char *outname = NULL, *outdir = NULL, *dir = ".", *sp;
+  char serr[AS_MAXCH], tmpname[AS_MAXCH];
+  struct infile *files;
+  int nfiles = 0, nkept, i;
+  AS_BOOL do_compact = FALSE;
+  double tjd_start = -1e10, tjd_end = 1e10;
+  int32 ipl[BUNDLE_MAXBODIES], nipl = 0, retc;
+  uint32 off;
+  unsigned char *hdr, buf[8192], pad[BUNDLE_ALIGN];
+  size_t hdrlen, n;
+  FILE *fp, *ofp;
+  if ((files = (struct infile *) calloc((size_t) argc, sizeof(struct infile))) == NULL) {
+    fprintf(stderr, "swebundle: out of memory\n");
+    return 1;
+  }
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outname = argv[++i];
+    } else if (strcmp(argv[i], "-O") == 0 && i + 1 < argc) {
+      outdir = argv[++i];
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      dir = argv[++i];
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      tjd_start = atof(argv[++i]);
+      do_compact = TRUE;
+    } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+      tjd_end = atof(argv[++i]);
+      do_compact = TRUE;
+    } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      for (sp = argv[++i]; *sp != '\0' && nipl < BUNDLE_MAXBODIES; ) {
+	ipl[nipl++] = atoi(sp);
+	while (*sp != '\0' && *sp != ',')
+	  sp++;
+	if (*sp == ',')
+	  sp++;
+      }
+      do_compact = TRUE;
+    } else if (*argv[i] == '-') {
+      usage();
+    } else {
+      if (strlen(argv[i]) >= SEI_BUNDLE_NAMELEN) {
+	fprintf(stderr, "swebundle: file name %s is too long\n", argv[i]);
+	return 1;
+      }
+      files[nfiles++].name = argv[i];
+    }
+  }
+  if ((outname == NULL) == (outdir == NULL) || nfiles == 0)
+    usage();
+  qsort((void *) files, (size_t) nfiles, sizeof(struct infile), infile_cmp);
+  for (i = 1; i < nfiles; i++) {
+    if (strcmp(files[i].name, files[i-1].name) == 0) {
+      fprintf(stderr, "swebundle: %s is given twice\n", files[i].name);
+      return 1;
+    }
+  }
+  /* compact the ephemeris files; with -O, the other files are copied */
+  for (i = 0, nkept = 0; i < nfiles; i++) {
+    files[i].path = make_path(dir, files[i].name);
+    sp = strrchr(files[i].name, '.');
+    if (do_compact && sp != NULL && strcmp(sp + 1, SE_FILE_SUFFIX) == 0) {
+      if (outdir != NULL) {
+	sp = make_path(outdir, files[i].name);
+      } else {
+	if (strlen(outname) + 20 >= AS_MAXCH) {
+	  fprintf(stderr, "swebundle: bundle name %s is too long\n", outname);
+	  return 1;
+	}
+	sprintf(tmpname, "%s.%d.tmp", outname, i);
+	sp = strdup(tmpname);
+	files[i].is_temp = TRUE;
+      }
+      retc = swe_compact_ephe_file(files[i].path, sp, tjd_start, tjd_end, 
+	      nipl > 0 ? ipl : NULL, nipl, serr);
+      if (retc == ERR) {
+	fprintf(stderr, "swebundle: %s\n", serr);
+	return 1;
+      }
+      free(files[i].path);
+      files[i].path = sp;
+      if (retc != OK)	/* nothing left of the file */
+	continue;
+    } else if (outdir != NULL) {
+      sp = make_path(outdir, files[i].name);
+      if (copy_file(files[i].path, sp) != OK)
+	return 1;
+      free(sp);
+    }
+    files[nkept++] = files[i];
+  }
+  nfiles = nkept;
+  if (outdir != NULL)
+    return 0;
+  if (nfiles == 0) {
+    fprintf(stderr, "swebundle: no data left for the bundle\n");
+    return 1;
+  }
+  /* the directory, then the files */
+  hdrlen = 16 + (size_t) nfiles * SEI_BUNDLE_DIRENT;
+  off = (uint32) ((hdrlen + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN);
+  for (i = 0; i < nfiles; i++) {
+    long len;
+    if ((fp = fopen(files[i].path, "rb")) == NULL
+      || fseek(fp, 0L, SEEK_END) != 0 || (len = ftell(fp)) < 0) {
+      fprintf(stderr, "swebundle: cannot read %s\n", files[i].path);
+      return 1;
+    }
+    fclose(fp);
+    if ((uint32) len > 0x7fffffffu - off) {
+      fprintf(stderr, "swebundle: the bundle would be too big\n");
+      return 1;
+    }
+    files[i].len = (uint32) len;
+    files[i].off = off;
+    off += (uint32) ((files[i].len + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN);
+  }
+  if ((hdr = (unsigned char *) calloc(1, hdrlen)) == NULL) {
+    fprintf(stderr, "swebundle: out of memory\n");
+    return 1;
+  }
+  memcpy(hdr, SEI_BUNDLE_MAGIC, 8);
+  put_uint32(hdr + 8, (uint32) nfiles);
+  for (i = 0; i < nfiles; i++) {
+    unsigned char *dp = hdr + 16 + i * SEI_BUNDLE_DIRENT;
+    strcpy((char *) dp, files[i].name);
+    put_uint32(dp + SEI_BUNDLE_NAMELEN, files[i].off);
+    put_uint32(dp + SEI_BUNDLE_NAMELEN + 4, files[i].len);
+  }
+  memset(pad, 0, sizeof(pad));
+  if ((ofp = fopen(outname, "wb")) == NULL) {
+    fprintf(stderr, "swebundle: cannot create %s\n", outname);
+    return 1;
+  }
+  fwrite(hdr, hdrlen, 1, ofp);
+  fwrite(pad, (size_t) files[0].off - hdrlen, 1, ofp);
+  for (i = 0; i < nfiles; i++) {
+    uint32 total = 0;
+    if ((fp = fopen(files[i].path, "rb")) == NULL) {
+      fprintf(stderr, "swebundle: cannot read %s\n", files[i].path);
+      return 1;
+    }
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      fwrite(buf, n, 1, ofp);
+      total += (uint32) n;
+    }
+    fclose(fp);
+    if (total != files[i].len) {
+      fprintf(stderr, "swebundle: %s has changed while reading it\n", files[i].path);
+      return 1;
+    }
+    fwrite(pad, (size_t) ((BUNDLE_ALIGN - total % BUNDLE_ALIGN) % BUNDLE_ALIGN), 1, ofp);
+  }
+  if (ferror(ofp) | fclose(ofp)) {
+    fprintf(stderr, "swebundle: cannot write %s\n", outname);
+    return 1;
+  }
+  for (i = 0; i < nfiles; i++) {
+    if (files[i].is_temp)
+      remove(files[i].path);
+  }
+  return 0;
+}
@@ -85,6 +85,10 @@
 
 # include "swephexp.h"
 # include "sweph.h"
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# define SWI_USE_PTHREAD
+# include <pthread.h>
+#endif
 
 static TLS AS_BOOL init_leapseconds_done = FALSE;
 
@@ -278,7 +282,7 @@ void CALL_CONV swe_utc_time_zone(
 /* Leap seconds were inserted at the end of the following days:*/
 #define NLEAP_SECONDS 26
 #define NLEAP_SECONDS_SPACE 100
-static TLS int leap_seconds[NLEAP_SECONDS_SPACE] = {
+static const int leap_seconds_builtin[NLEAP_SECONDS_SPACE] = {
 19720630,
 19721231,
 19731231,
@@ -310,23 +314,43 @@ static TLS int leap_seconds[NLEAP_SECONDS_SPACE] = {
 #define J1972 2441317.5
 #define NLEAP_INIT 10
 
+/* the table leap_seconds_builtin, with the dates from seleapsec.txt
+ * (s. init_leapsec()). it does not change, and is shared by all threads
+ * that use the same ephemeris path */
+struct leapsec_tab {
+  char ephepath[AS_MAXCH];
+  int tabsiz;
+  int leap_seconds[NLEAP_SECONDS_SPACE];
+  struct leapsec_tab *next;
+};
+#ifdef SWI_USE_PTHREAD
+static struct leapsec_tab *leapsec_tabs = NULL;
+static pthread_mutex_t leapsec_tabs_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+static TLS struct leapsec_tab *leapsec_tabs = NULL;
+#endif
+/* the table used by the calling thread */
+static TLS const int *leap_seconds = leap_seconds_builtin;
+static TLS int leap_seconds_tabsiz = NLEAP_SECONDS;
+
 /* Read additional leap second dates from external file, if given.
  */
-static int init_leapsec(void)
+static struct leapsec_tab *read_leapsec(void)
 {
   FILE *fp;
   int ndat, ndat_last;
-  int tabsiz = 0;
-  int i;
+  int tabsiz;
   char s[AS_MAXCH];
   char *sp;
-  if (!init_leapseconds_done) {
-    init_leapseconds_done = TRUE;
-    tabsiz = NLEAP_SECONDS;
-    ndat_last = leap_seconds[NLEAP_SECONDS - 1];
-    /* no error message if file is missing */
-    if ((fp = swi_fopen(-1, "seleapsec.txt", swed.ephepath, NULL)) == NULL)
-      return NLEAP_SECONDS; 
+  struct leapsec_tab *tab;
+  if ((tab = (struct leapsec_tab *) calloc(1, sizeof(struct leapsec_tab))) == NULL)
+    return NULL;
+  strcpy(tab->ephepath, swed.ephepath);
+  memcpy((void *) tab->leap_seconds, (void *) leap_seconds_builtin, sizeof(leap_seconds_builtin));
+  tabsiz = NLEAP_SECONDS;
+  ndat_last = leap_seconds_builtin[NLEAP_SECONDS - 1];
+  /* no error message if file is missing */
+  if ((fp = swi_fopen(-1, "seleapsec.txt", swed.ephepath, NULL)) != NULL) {
     while(fgets(s, AS_MAXCH, fp) != NULL) {
       sp = s;
       while (*sp == ' ' || *sp == '\t') sp++;
@@ -338,22 +362,59 @@ static int init_leapsec(void)
         continue;
       /* table space is limited. no error msg, if exceeded */
       if (tabsiz >= NLEAP_SECONDS_SPACE)
-        return tabsiz;
-      leap_seconds[tabsiz] = ndat;
+        break;
+      tab->leap_seconds[tabsiz] = ndat;
       tabsiz++;
     }
-    if (tabsiz > NLEAP_SECONDS) leap_seconds[tabsiz] = 0; /* end mark */
     fclose(fp);
-    return tabsiz;
   }
-  /* find table size */
-  tabsiz = 0;
-  for (i = 0; i < NLEAP_SECONDS_SPACE; i++) {
-    if (leap_seconds[i] == 0) 
+  tab->tabsiz = tabsiz;
+  return tab;
+}
+
+/* Makes leap_seconds point to the table of the ephemeris path; it is 
+ * read only once by all threads.
+ */
+static int init_leapsec(void)
+{
+  struct leapsec_tab *tab;
+  if (init_leapseconds_done)
+    return leap_seconds_tabsiz;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_lock(&leapsec_tabs_lock);
+#endif
+  for (tab = leapsec_tabs; tab != NULL; tab = tab->next) {
+    if (strcmp(tab->ephepath, swed.ephepath) == 0)
       break;
-    else
-      tabsiz++;
   }
+  if (tab == NULL && (tab = read_leapsec()) != NULL) {
+    tab->next = leapsec_tabs;
+    leapsec_tabs = tab;
+  }
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_unlock(&leapsec_tabs_lock);
+#endif
+  /* out of memory: the built-in table, tried again next time */
+  if (tab == NULL)
+    return NLEAP_SECONDS;
+  init_leapseconds_done = TRUE;
+  leap_seconds = tab->leap_seconds;
+  leap_seconds_tabsiz = tab->tabsiz;
+  return leap_seconds_tabsiz;
+}
+
+/*
+ * Output: *dates points to the table of leap seconds used by swe_utc_to_jd()
+ *         and swe_jdet_to_utc(), as dates yyyymmdd in ascending order; 
+ *         the leap seconds were inserted at the end of these days.
+ *         The table must not be changed or freed.
+ *
+ * Function returns the number of dates in the table.
+ */
+int32 CALL_CONV swe_get_leap_seconds(const int32 **dates)
+{
+  int32 tabsiz = init_leapsec();
+  *dates = (const int32 *) leap_seconds;
   return tabsiz;
 }
 
@@ -181,6 +181,8 @@ DllImport void  CALL_CONV_IMP swe_utc_time_zone(
 	int32 *iyear_out, int32 *imonth_out, int32 *iday_out,
 	int32 *ihour_out, int32 *imin_out, double *dsec_out);
 
+DllImport int32  CALL_CONV_IMP swe_get_leap_seconds(const int32 **dates);
+
 DllImport int32  CALL_CONV_IMP swe_utc_to_jd(
         int32 iyear, int32 imonth, int32 iday, 
 	int32 ihour, int32 imin, double dsec, 
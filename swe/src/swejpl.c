@@ -70,6 +70,17 @@
 #endif
 
 #include <string.h>
+/* as the ephemeris files in sweph.c, the JPL file is memory mapped 
+ * where possible; define SWI_NO_MMAP to always read it through stdio */
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# ifndef SWI_NO_MMAP
+#  define SWI_USE_MMAP
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <pthread.h>
+# endif
+#endif
 #include "swephexp.h"
 #include "sweph.h"
 #include "swejpl.h"
@@ -87,6 +98,9 @@
 
 #define DEBUG_DO_SHOW	FALSE
 
+/* number of decoded records kept by a thread, s. get_record() */
+#define JPL_NREC_CACHE	4
+
 /*
  * local globals
  */
@@ -104,10 +118,44 @@ struct jpl_save {
   double buf[1500];
   double pc[18], vc[18], ac[18], jc[18];
   short do_km;
+  /* state of interp() */
+  int np, nv, nac, njk;
+  double twot;
+  /* state of state() */
+  int32 irecsz;
+  int32 nrl, lpt[3], ncoeffs;
+  /* the mapping of the file, or NULL if it is read through jplfptr */
+  unsigned char *mdata;
+  off_t mlen;
+  /* records of a mapped file decoded for this thread, only used if the
+   * file has foreign byte order; rec_order[0] is the slot of the most
+   * recently used one */
+  double *rec_cache;
+  int32 rec_nr[JPL_NREC_CACHE];
+  int rec_order[JPL_NREC_CACHE];
 };
 
 static TLS struct jpl_save *js;
 
+#ifdef SWI_USE_MMAP
+/* the mapped JPL files. A mapping is read-only and shared by all 
+ * threads using the same file; they take the records directly from 
+ * it instead of seeking and reading them into their own js->buf.
+ */
+struct jpl_mapping {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+  unsigned char *addr;
+  int nref;
+  struct jpl_mapping *next;
+};
+static struct jpl_mapping *jpl_mappings = NULL;
+static pthread_mutex_t jpl_mappings_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+static AS_BOOL jpl_use_mmap = TRUE;
+
 static int state (double et, int32 *list, int do_bary, 
 		  double *pv, double *pvsun, double *nut, char *serr);
 static int interp(double *buf, double t, double intv, int32 ncfin, 
@@ -115,6 +163,9 @@ static int interp(double *buf, double t, double intv, int32 ncfin,
 static int32 fsizer(char *serr);
 static void reorder(char *x, int size, int number);
 static int read_const_jpl(double *ss, char *serr);
+static void map_jpl_file(void);
+static void unmap_jpl_file(void);
+static double *get_record(int32 nr, double et, char *serr);
 
 /* information about eh_ipt[] and buf[]
 DE200	DE102		  	DE403
@@ -458,11 +509,6 @@ int swi_pleph(double et, int ntarg, int ncent, double *rrd, char *serr)
 static int interp(double *buf, double t, double intv, int32 ncfin, 
 		  int32 ncmin, int32 nain, int32 ifl, double *pv)
 {
-  /* Initialized data */
-  static TLS int np, nv;
-  static TLS int nac;
-  static TLS int njk;
-  static TLS double twot = 0.;
   double *pc = js->pc;
   double *vc = js->vc;
   double *ac = js->ac;
@@ -495,21 +541,21 @@ static int interp(double *buf, double t, double intv, int32 ncfin,
    *  contains the value of tc on the previous call.) 
    */
   if (tc != pc[1]) {
-    np = 2;
-    nv = 3;
-    nac = 4;
-    njk = 5;
+    js->np = 2;
+    js->nv = 3;
+    js->nac = 4;
+    js->njk = 5;
     pc[1] = tc;
-    twot = tc + tc;
+    js->twot = tc + tc;
   }
   /*
    *  be sure that at least 'ncf' polynomials have been evaluated 
    *  and are stored in the array 'pc'. 
    */
-  if (np < ncf) {
-    for (i = np; i < ncf; ++i) 
-      pc[i] = twot * pc[i - 1] - pc[i - 2];
-    np = ncf;
+  if (js->np < ncf) {
+    for (i = js->np; i < ncf; ++i) 
+      pc[i] = js->twot * pc[i - 1] - pc[i - 2];
+    js->np = ncf;
   }
   /*  interpolate to get position for each component */
   for (i = 0; i < ncm; ++i) {
@@ -524,11 +570,11 @@ static int interp(double *buf, double t, double intv, int32 ncfin,
    *       derivative polynomials have been generated and stored. 
    */
   bma = (na + na) / intv;
-  vc[2] = twot + twot;
-  if (nv < ncf) {
-    for (i = nv; i < ncf; ++i) 
-      vc[i] = twot * vc[i - 1] + pc[i - 1] + pc[i - 1] - vc[i - 2];
-    nv = ncf;
+  vc[2] = js->twot + js->twot;
+  if (js->nv < ncf) {
+    for (i = js->nv; i < ncf; ++i) 
+      vc[i] = js->twot * vc[i - 1] + pc[i - 1] + pc[i - 1] - vc[i - 2];
+    js->nv = ncf;
   }
   /*       interpolate to get velocity for each component */
   for (i = 0; i < ncm; ++i) {
@@ -543,10 +589,10 @@ static int interp(double *buf, double t, double intv, int32 ncfin,
   /*       re-do if necessary */
   bma2 = bma * bma;
   ac[3] = pc[1] * 24.;
-  if (nac < ncf) {
-    nac = ncf;
-    for (i = nac; i < ncf; ++i) 
-      ac[i] = twot * ac[i - 1] + vc[i - 1] * 4. - ac[i - 2];
+  if (js->nac < ncf) {
+    js->nac = ncf;
+    for (i = js->nac; i < ncf; ++i) 
+      ac[i] = js->twot * ac[i - 1] + vc[i - 1] * 4. - ac[i - 2];
   }
   /*       get acceleration for each component */
   for (i = 0; i < ncm; ++i) {
@@ -561,10 +607,10 @@ static int interp(double *buf, double t, double intv, int32 ncfin,
   /*       re-do if necessary */
   bma3 = bma * bma2;
   jc[4] = pc[1] * 192.;
-  if (njk < ncf) {
-    njk = ncf;
-    for (i = njk; i < ncf; ++i) 
-      jc[i] = twot * jc[i - 1] + ac[i - 1] * 6. - jc[i - 2];
+  if (js->njk < ncf) {
+    js->njk = ncf;
+    for (i = js->njk; i < ncf; ++i) 
+      jc[i] = js->twot * jc[i - 1] + ac[i - 1] * 6. - jc[i - 2];
   }
   /*       get jerk for each component */
   for (i = 0; i < ncm; ++i) {
@@ -641,22 +687,20 @@ static int state(double et, int32 *list, int do_bary,
   int i, j, k;
   int32 nseg;
   off_t flen, nb;
-  double *buf = js->buf;
+  double *buf;
   double aufac, s, t, intv, ts[4];
   int32 nrecl, ksize;
   int32 nr;
   double et_mn, et_fr;
   int32 *ipt = js->eh_ipt;
   char ch_ttl[252];
-  static TLS int32 irecsz;
-  static TLS int32 nrl, lpt[3], ncoeffs;
   if (js->jplfptr == NULL) {
     ksize = fsizer(serr); /* the number of single precision words in a record */
     nrecl = 4;
     if (ksize == NOT_AVAILABLE)
       return NOT_AVAILABLE;
-    irecsz = nrecl * ksize; 	/* record size in bytes */
-    ncoeffs = ksize / 2;	/* # of coefficients, doubles */
+    js->irecsz = nrecl * ksize; 	/* record size in bytes */
+    js->ncoeffs = ksize / 2;	/* # of coefficients, doubles */
     /* ttl = ephemeris title, e.g.
      * "JPL Planetary Ephemeris DE404/LE404
      *  Start Epoch: JED=   625296.5-3001 DEC 21 00:00:00
@@ -692,18 +736,18 @@ static int state(double et, int32 *list, int do_bary,
     fread((void *) &js->eh_denum, sizeof(int32), 1, js->jplfptr);
     if (js->do_reorder)
       reorder((char *) &js->eh_denum, sizeof(int32), 1);
-    fread((void *) &lpt[0], sizeof(int32), 3, js->jplfptr);
+    fread((void *) &js->lpt[0], sizeof(int32), 3, js->jplfptr);
     if (js->do_reorder)
-      reorder((char *) &lpt[0], sizeof(int32), 3);
+      reorder((char *) &js->lpt[0], sizeof(int32), 3);
     /* cval[]:  other constants in next record */
-    FSEEK(js->jplfptr, (off_t) (1L * irecsz), 0);
+    FSEEK(js->jplfptr, (off_t) (1L * js->irecsz), 0);
     fread((void *) &js->eh_cval[0], sizeof(double), 400, js->jplfptr);
     if (js->do_reorder)
       reorder((char *) &js->eh_cval[0], sizeof(double), 400);
     /* new 26-aug-2008: verify correct block size */
     for (i = 0; i < 3; ++i) 
-      ipt[i + 36] = lpt[i];
-    nrl = 0;
+      ipt[i + 36] = js->lpt[i];
+    js->nrl = 0;
     /* is file length correct? */
     /* file length */
     FSEEK(js->jplfptr, (off_t) 0L, SEEK_END);
@@ -737,11 +781,11 @@ static int state(double et, int32 *list, int do_bary,
     }
     /* check if start and end dates in segments are the same as in 
      * file header */
-    FSEEK(js->jplfptr, (off_t) (2L * irecsz), 0);
+    FSEEK(js->jplfptr, (off_t) (2L * js->irecsz), 0);
     fread((void *) &ts[0], sizeof(double), 2, js->jplfptr);
     if (js->do_reorder)
       reorder((char *) &ts[0], sizeof(double), 2);
-    FSEEK(js->jplfptr, (off_t) ((nseg + 2 - 1) * ((off_t) irecsz)), 0);
+    FSEEK(js->jplfptr, (off_t) ((nseg + 2 - 1) * ((off_t) js->irecsz)), 0);
     fread((void *) &ts[2], sizeof(double), 2, js->jplfptr);
     if (js->do_reorder)
       reorder((char *) &ts[2], sizeof(double), 2);
@@ -750,6 +794,7 @@ static int state(double et, int32 *list, int do_bary,
 	sprintf(serr, "JPL ephemeris file is corrupt; start/end date check failed. %.1f != %.1f || %.1f != %.1f", ts[0],js->eh_ss[0],ts[3],js->eh_ss[1]);
       return NOT_AVAILABLE;
     }
+    map_jpl_file();
   }
   if (list == NULL) 
     return 0;
@@ -768,24 +813,8 @@ static int state(double et, int32 *list, int do_bary,
   if (et_mn == js->eh_ss[1]) 
     --nr;	/* end point of ephemeris, use last record */
   t = (et_mn - ((nr - 2) * js->eh_ss[2] + js->eh_ss[0]) + et_fr) / js->eh_ss[2];
-  /* read correct record if not in core */
-  if (nr != nrl) {
-    nrl = nr;
-    if (FSEEK(js->jplfptr, (off_t) (nr * ((off_t) irecsz)), 0) != 0) {
-      if (serr != NULL) 
-	sprintf(serr, "Read error in JPL eph. at %f\n", et);
-      return NOT_AVAILABLE;
-    }
-    for (k = 1; k <= ncoeffs; ++k) {
-      if ( fread((void *) &buf[k - 1], sizeof(double), 1, js->jplfptr) != 1) {
-	if (serr != NULL) 
-	  sprintf(serr, "Read error in JPL eph. at %f\n", et);
-	return NOT_AVAILABLE;
-      }
-      if (js->do_reorder)
-	reorder((char *) &buf[k-1], sizeof(double), 1);
-    }
-  }
+  if ((buf = get_record(nr, et, serr)) == NULL)
+    return NOT_AVAILABLE;
   if (js->do_km) {
     intv = js->eh_ss[2] * 86400.;
     aufac = 1.;
@@ -825,6 +854,164 @@ static int state(double et, int32 *list, int do_bary,
   return OK;
 } 
 
+/*
+ * returns the coefficients of record nr, or NULL if it cannot be read.
+ * records of a mapped file are used in place, or, if the file has 
+ * foreign byte order, decoded into the least recently used slot of 
+ * js->rec_cache; so positions at a few different times (e.g. of several
+ * bodies with light-time) do not decode the same records again and again.
+ * without a mapping, the record is read into js->buf, unless it is 
+ * there already.
+ */
+static double *get_record(int32 nr, double et, char *serr)
+{
+  int i, k, slot;
+  double *buf;
+#ifdef SWI_USE_MMAP
+  if (js->mdata != NULL) {
+    if (nr < 0 || (off_t) (nr + 1) * js->irecsz > js->mlen) {
+      if (serr != NULL) 
+	sprintf(serr, "Read error in JPL eph. at %f\n", et);
+      return NULL;
+    }
+    buf = (double *) (js->mdata + (off_t) nr * js->irecsz);
+    if (!js->do_reorder)
+      return buf;
+    for (i = 0; i < JPL_NREC_CACHE - 1; i++) {
+      if (js->rec_nr[js->rec_order[i]] == nr)
+	break;
+    }
+    slot = js->rec_order[i];
+    memmove(&js->rec_order[1], &js->rec_order[0], i * sizeof(int));
+    js->rec_order[0] = slot;
+    if (js->rec_nr[slot] != nr) {
+      js->rec_nr[slot] = nr;
+      memcpy(js->rec_cache + slot * js->ncoeffs, buf, js->ncoeffs * sizeof(double));
+      reorder((char *) (js->rec_cache + slot * js->ncoeffs), sizeof(double), js->ncoeffs);
+    }
+    return js->rec_cache + slot * js->ncoeffs;
+  }
+#endif
+  buf = js->buf;
+  /* read correct record if not in core */
+  if (nr != js->nrl) {
+    js->nrl = nr;
+    if (FSEEK(js->jplfptr, (off_t) (nr * ((off_t) js->irecsz)), 0) != 0) {
+      if (serr != NULL) 
+	sprintf(serr, "Read error in JPL eph. at %f\n", et);
+      return NULL;
+    }
+    for (k = 1; k <= js->ncoeffs; ++k) {
+      if ( fread((void *) &buf[k - 1], sizeof(double), 1, js->jplfptr) != 1) {
+	js->nrl = 0;
+	if (serr != NULL) 
+	  sprintf(serr, "Read error in JPL eph. at %f\n", et);
+	return NULL;
+      }
+      if (js->do_reorder)
+	reorder((char *) &buf[k-1], sizeof(double), 1);
+    }
+  }
+  return buf;
+}
+
+/*
+ * maps the opened JPL file into memory, if possible. if it is not, the 
+ * records are read through js->jplfptr.
+ */
+static void map_jpl_file(void)
+{
+#ifdef SWI_USE_MMAP
+  struct stat st;
+  struct jpl_mapping *mp;
+  void *addr;
+  int i;
+  js->mdata = NULL;
+  js->mlen = 0;
+  if (!jpl_use_mmap || fstat(fileno(js->jplfptr), &st) != 0)
+    return;
+  if (st.st_size <= 0 || (off_t) (size_t) st.st_size != st.st_size)
+    return;
+  if (js->do_reorder) {
+    if ((js->rec_cache = (double *) CALLOC((size_t) JPL_NREC_CACHE * js->ncoeffs, sizeof(double))) == NULL)
+      return;
+    for (i = 0; i < JPL_NREC_CACHE; i++) {
+      js->rec_nr[i] = -1;
+      js->rec_order[i] = i;
+    }
+  }
+  pthread_mutex_lock(&jpl_mappings_lock);
+  for (mp = jpl_mappings; mp != NULL; mp = mp->next) {
+    if (mp->dev == st.st_dev && mp->ino == st.st_ino
+      && mp->size == st.st_size && mp->mtime == st.st_mtime)
+      break;
+  }
+  if (mp == NULL) {
+    addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fileno(js->jplfptr), 0);
+    if (addr == MAP_FAILED
+      || (mp = (struct jpl_mapping *) malloc(sizeof(struct jpl_mapping))) == NULL) {
+      if (addr != MAP_FAILED)
+	munmap(addr, (size_t) st.st_size);
+      pthread_mutex_unlock(&jpl_mappings_lock);
+      if (js->rec_cache != NULL)
+	FREE((void *) js->rec_cache);
+      js->rec_cache = NULL;
+      return;
+    }
+    mp->dev = st.st_dev;
+    mp->ino = st.st_ino;
+    mp->size = st.st_size;
+    mp->mtime = st.st_mtime;
+    mp->addr = (unsigned char *) addr;
+    mp->nref = 0;
+    mp->next = jpl_mappings;
+    jpl_mappings = mp;
+  }
+  mp->nref++;
+  pthread_mutex_unlock(&jpl_mappings_lock);
+  js->mdata = mp->addr;
+  js->mlen = st.st_size;
+#endif
+}
+
+/*
+ * releases the mapping of the JPL file, if any
+ */
+static void unmap_jpl_file(void)
+{
+#ifdef SWI_USE_MMAP
+  struct jpl_mapping *mp, **pmp;
+  if (js->mdata != NULL) {
+    pthread_mutex_lock(&jpl_mappings_lock);
+    for (pmp = &jpl_mappings; (mp = *pmp) != NULL; pmp = &mp->next) {
+      if (mp->addr == js->mdata) {
+	if (--mp->nref == 0) {
+	  *pmp = mp->next;
+	  munmap((void *) mp->addr, (size_t) mp->size);
+	  free(mp);
+	}
+	break;
+      }
+    }
+    pthread_mutex_unlock(&jpl_mappings_lock);
+  }
+#endif
+  if (js->rec_cache != NULL)
+    FREE((void *) js->rec_cache);
+  js->rec_cache = NULL;
+  js->mdata = NULL;
+  js->mlen = 0;
+}
+
+/*
+ * with on = FALSE, JPL files opened afterwards are read through stdio
+ * even if they could be mapped (for tests and benchmarks)
+ */
+void swi_jpl_use_mmap(AS_BOOL on)
+{
+  jpl_use_mmap = on;
+}
+
 /* 
  *  this entry obtains the constants from the ephemeris file 
  *  call state to initialize the ephemeris and read in the constants 
@@ -883,6 +1070,7 @@ static void reorder(char *x, int size, int number)
 void swi_close_jpl_file(void)
 {
   if (js != NULL) {
+    unmap_jpl_file();
     if (js->jplfptr != NULL)
       fclose(js->jplfptr);
     if (js->jplfname != NULL) 
@@ -924,6 +1112,15 @@ int swi_open_jpl_file(double *ss, char *fname, char *fpath, char *serr)
   return retc;
 }
 
+/* installs the JPL reader state js_new in the calling thread and 
+ * returns the previous one, s. swe_context_switch() */
+struct jpl_save *swi_jpl_exchange_state(struct jpl_save *js_new)
+{
+  struct jpl_save *js_old = js;
+  js = js_new;
+  return js_old;
+}
+
 int32 swi_get_jpl_denum()
 {
   return js->eh_denum;
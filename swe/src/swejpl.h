@@ -100,5 +100,14 @@ extern int swi_open_jpl_file(double *ss, char *fname, char *fpath, char *serr);
 
 extern int32 swi_get_jpl_denum(void);
 
+struct jpl_save;
+extern struct jpl_save *swi_jpl_exchange_state(struct jpl_save *js_new);
+
+/*
+ * with on = FALSE, JPL files opened afterwards are not memory mapped,
+ * but read through stdio.
+ */
+extern void swi_jpl_use_mmap(AS_BOOL on);
+
 extern void swi_IERS_FK5(double *xin, double *xout, int dir);
 
@@ -0,0 +1,131 @@
+/*
+  swejplbench.c	compares the speed of reading a JPL ephemeris file through
+		stdio and through a memory mapping (s. swejpl.c)
+
+  usage: swejplbench [-p path] [-f jplfile] [-b jd] [-s step] [-n dates] [-r]
+
+  computes the positions of the Sun, Moon and planets from the JPL
+  file jplfile (default: SE_FNAME_DFT) in the directory path (default:
+  the current directory) for n dates (default: 100000), from the Julian
+  day (ET) given with -b (default: 2451545.0), step days after each
+  other (default: 0.5). with -r, the dates are visited in random order.
+  the sweep is timed once with each reader, and the largest difference
+  between their results is printed (it should be 0).
+
+  build it with "make swejplbench".
+
+  This file is distributed under the same license conditions as the
+  other files of the Swiss Ephemeris.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "swephexp.h"
+#include "sweph.h"
+#include "swejpl.h"
+
+#define NBODIES	(SE_PLUTO - SE_SUN + 1)
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: swejplbench [-p path] [-f jplfile] [-b jd] [-s step] [-n dates] [-r]\n");
+  exit(2);
+}
+
+/* computes all bodies for all dates, and returns the CPU time used */
+static double sweep(char *path, char *fname, AS_BOOL use_mmap, double *jd, int n, double *xout, int *nerr)
+{
+  double x[6];
+  char serr[AS_MAXCH];
+  int32 iflag = SEFLG_JPLEPH | SEFLG_SPEED, retflag;
+  int i, ipl;
+  clock_t t0;
+  swe_close();
+  swi_jpl_use_mmap(use_mmap);
+  swe_set_ephe_path(path);
+  swe_set_jpl_file(fname);
+  *nerr = 0;
+  t0 = clock();
+  for (i = 0; i < n; i++) {
+    for (ipl = SE_SUN; ipl <= SE_PLUTO; ipl++) {
+      retflag = swe_calc(jd[i], ipl, iflag, x, serr);
+      if (retflag < 0 || !(retflag & SEFLG_JPLEPH)) {
+	if (*nerr == 0)
+	  fprintf(stderr, "swejplbench: jd %f, body %d: %s\n", jd[i], ipl, serr);
+	(*nerr)++;
+      }
+      xout[i * NBODIES + ipl - SE_SUN] = x[0];
+    }
+  }
+  return (double) (clock() - t0) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+  char *path = ".", *fname = SE_FNAME_DFT;
+  double tjd_start = 2451545.0, step = 0.5, t, tstdio, tmmap, dmax = 0;
+  double *jd, *xstdio, *xmmap;
+  int n = 100000, i, j, nerr;
+  AS_BOOL shuffle = FALSE;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      path = argv[++i];
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      fname = argv[++i];
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      tjd_start = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      step = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      n = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      shuffle = TRUE;
+    } else {
+      usage();
+    }
+  }
+  if (n <= 0)
+    usage();
+  jd = (double *) malloc(n * sizeof(double));
+  xstdio = (double *) malloc((size_t) n * NBODIES * sizeof(double));
+  xmmap = (double *) malloc((size_t) n * NBODIES * sizeof(double));
+  if (jd == NULL || xstdio == NULL || xmmap == NULL) {
+    fprintf(stderr, "swejplbench: out of memory\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++)
+    jd[i] = tjd_start + i * step;
+  if (shuffle) {
+    srand(1);
+    for (i = n - 1; i > 0; i--) {
+      j = rand() % (i + 1);
+      t = jd[i]; jd[i] = jd[j]; jd[j] = t;
+    }
+  }
+  /* the first sweep only brings the file into the page cache */
+  sweep(path, fname, FALSE, jd, n, xstdio, &nerr);
+  if (nerr > 0) {
+    fprintf(stderr, "swejplbench: %d positions could not be computed from %s\n", nerr, fname);
+    return 1;
+  }
+  tstdio = sweep(path, fname, FALSE, jd, n, xstdio, &nerr);
+  tmmap = sweep(path, fname, TRUE, jd, n, xmmap, &nerr);
+  swe_close();
+  for (i = 0; i < n * NBODIES; i++) {
+    if (fabs(xstdio[i] - xmmap[i]) > dmax)
+      dmax = fabs(xstdio[i] - xmmap[i]);
+  }
+  printf("%d dates, %s order, %d bodies\n", n, shuffle ? "random" : "ascending", NBODIES);
+  printf("stdio: %8.3f s  %8.3f us/position\n", tstdio, tstdio * 1e6 / n / NBODIES);
+  printf("mmap:  %8.3f s  %8.3f us/position\n", tmmap, tmmap * 1e6 / n / NBODIES);
+  if (tmmap > 0)
+    printf("speedup: %.2f\n", tstdio / tmmap);
+  printf("largest difference: %g degrees\n", dmax);
+  free(jd);
+  free(xstdio);
+  free(xmmap);
+  return 0;
+}
@@ -63,6 +63,23 @@
 
 #include <string.h>
 #include <ctype.h>
+/* ephemeris files are memory mapped where possible; define SWI_NO_MMAP
+ * to always read them through stdio */
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# define SWI_USE_PTHREAD
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <pthread.h>
+# ifndef SWI_NO_MMAP
+#  define SWI_USE_MMAP
+#  include <sys/mman.h>
+# endif
+/* ephemeris bundles, s. swe_set_ephe_bundle(); define SWI_NO_BUNDLE to
+ * build without them */
+# ifndef SWI_NO_BUNDLE
+#  define SWI_USE_BUNDLE
+# endif
+#endif
 #include "swejpl.h"
 #include "swephexp.h"
 #include "sweph.h"
@@ -83,7 +100,7 @@ struct meff_ele {double r,m;};
 /****************
  * global stuff *
  ****************/
-TLS struct swe_data swed = {FALSE,	/* ephe_path_is_set = FALSE */
+TLS struct swe_data swi_swed_own = {FALSE,	/* ephe_path_is_set = FALSE */
                             FALSE,	/* jpl_file_is_open = FALSE */
                             NULL,	/* fixfp, fixed stars file pointer */
 #if 0
@@ -104,6 +121,7 @@ TLS struct swe_data swed = {FALSE,	/* ephe_path_is_set = FALSE */
 			    FALSE,	/* is_tid_acc_manual */
 			    FALSE,	/* init_dt_done */
 			    };
+TLS struct swe_data *swi_swed_ctx = NULL;
 
 /*************
  * constants *
@@ -149,6 +167,33 @@ static int32 swecalc(double tjd, int ipl, int32 iflag, double *x, char *serr);
 static int do_fread(void *targ, int size, int count, int corrsize, 
 		    FILE *fp, int32 fpos, int freord, int fendian, int ifno, 
 		    char *serr);
+static void map_ephe_file(struct file_data *fdp);
+static void close_ephe_file(struct file_data *fdp);
+static AS_BOOL get_shared_header(int ifno);
+#ifdef SWI_USE_BUNDLE
+static FILE *bundle_fopen(char *fname, char *fnamp);
+static AS_BOOL bundle_find(char *fnam, unsigned char **data, int32 *len);
+#endif
+#ifdef SWI_USE_PTHREAD
+static int file_stat(FILE *fp, char *fnam, struct stat *st);
+#endif
+static void park_ephe_file(int ifno);
+static AS_BOOL take_pooled_file(double tjd, int ipli, int ifno);
+static void trim_file_pool(int32 nfiles);
+static AS_BOOL file_has_body(struct file_data *fdp, int ipli);
+static void clear_file_misses(void);
+static void put_shared_header(int ifno);
+static int get_cached_segment(double tjd, int ipli, int ifno);
+static void put_cached_segment(int ipli, int ifno);
+static AS_BOOL get_series_position(double tjd, int ipli, double *xp);
+static void clear_cheb_series(void);
+static double cheb_series_date(struct cheb_series *csp, int32 k);
+static struct seg_cache_file *segment_cache_file(struct file_data *fdp);
+static void segment_cache_file_close(struct file_data *fdp);
+static struct fixstar_cat *fixstar_cat_get(FILE *fp, char *fnam);
+static void fixstar_cat_release(void);
+static int32 fixstar_cat_find(struct fixstar_cat *cat, char *sstar, int star_nr, AS_BOOL isnomclat, char *serr);
+static int32 open_fixstar_file(char *serr);
 static int get_new_segment(double tjd, int ipli, int ifno, char *serr);
 static int main_planet(double tjd, int ipli, int32 epheflag, int32 iflag,
 		       char *serr);
@@ -296,8 +341,7 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
 	swed.jpl_file_is_open = FALSE;
       }
       for (i = 0; i < SEI_NEPHFILES; i ++) {
-	if (swed.fidat[i].fptr != NULL) 
-	  fclose(swed.fidat[i].fptr);
+	close_ephe_file(&swed.fidat[i]);
 	memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
       }
       swed.last_epheflag = epheflag;
@@ -452,6 +496,37 @@ int32 CALL_CONV swe_calc_ut(double tjd_ut, int32 ipl, int32 iflag,
   return retval;
 }
 
+/* computes the positions of a body at the nsteps dates (ET)
+ * tjd_start, tjd_start + tjd_step, tjd_start + 2 * tjd_step, ...
+ * and stores them in xx[0..6*nsteps-1], 6 values per date, as swe_calc()
+ * would. 
+ * with the Swiss Ephemeris, the chebyshew series of the ephemeris
+ * segments are evaluated for many of the dates at once, which is faster
+ * than calling swe_calc() for each date.
+ * returns the flag bits of the last position or ERR; in case of an
+ * error, the positions of the dates before the failing one are stored.
+ */
+int32 CALL_CONV swe_calc_series(double tjd_start, double tjd_step, 
+	int32 nsteps, int ipl, int32 iflag, double *xx, char *serr) 
+{
+  int32 k, retflag = iflag;
+  struct cheb_series *csp = &swed.chebser;
+  swi_init_swed_if_start();
+  clear_cheb_series();
+  csp->tstart = tjd_start;
+  csp->tstep = tjd_step;
+  csp->nsteps = (tjd_step != 0) ? nsteps : 0;
+  for (k = 0; k < nsteps; k++) {
+    csp->kcur = k;
+    csp->tjdcur = cheb_series_date(csp, k);
+    retflag = swe_calc(csp->tjdcur, ipl, iflag, xx + 6 * k, serr);
+    if (retflag == ERR)
+      break;
+  }
+  clear_cheb_series();
+  return retflag;
+}
+
 static int32 swecalc(double tjd, int ipl, int32 iflag, double *x, char *serr) 
 {
   int i;
@@ -1086,6 +1161,9 @@ int32 swi_init_swed_if_start(void)
 {
   /* initialisation of swed, when called first time from */
   if (!swed.ephe_path_is_set) {
+    trim_file_pool(0);
+    clear_file_misses();
+    fixstar_cat_release();
     memset((void *) &swed, 0, sizeof(struct swe_data));
     strcpy(swed.ephepath, SE_EPHE_PATH);
     strcpy(swed.jplfnam, SE_FNAME_DFT);
@@ -1103,11 +1181,15 @@ static void swi_close_keep_topo_etc(void)
   int i;
   /* close SWISSEPH files */
   for (i = 0; i < SEI_NEPHFILES; i ++) {
-    if (swed.fidat[i].fptr != NULL) 
-      fclose(swed.fidat[i].fptr);
+    close_ephe_file(&swed.fidat[i]);
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  trim_file_pool(0);
+  clear_file_misses();
+  /* the delta t table of a new ephemeris path is looked up again */
+  swed.dttab = NULL;
+  swed.init_dt_done = FALSE;
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1123,6 +1205,7 @@ static void swi_close_keep_topo_etc(void)
     fclose(swed.fixfp);
     swed.fixfp = NULL;
   }
+  fixstar_cat_release();
   swe_set_tid_acc(SE_TIDAL_AUTOMATIC);
   swed.is_old_starfile = FALSE;
   swed.i_saved_planet_name = 0;
@@ -1138,11 +1221,12 @@ void CALL_CONV swe_close(void)
   int i;
   /* close SWISSEPH files */
   for (i = 0; i < SEI_NEPHFILES; i ++) {
-    if (swed.fidat[i].fptr != NULL) 
-      fclose(swed.fidat[i].fptr);
+    close_ephe_file(&swed.fidat[i]);
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  trim_file_pool(0);
+  clear_file_misses();
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1158,6 +1242,7 @@ void CALL_CONV swe_close(void)
     fclose(swed.fixfp);
     swed.fixfp = NULL;
   }
+  fixstar_cat_release();
   swe_set_tid_acc(SE_TIDAL_AUTOMATIC);
   swed.geopos_is_set = FALSE;
   swed.ayana_is_set = FALSE;
@@ -1168,14 +1253,13 @@ void CALL_CONV swe_close(void)
   memset((void *) &swed.sidd, 0, sizeof(struct sid_data));
   swed.timeout = 0;
   swed.last_epheflag = 0;
-  if (swed.dpsi != NULL) {
-    free(swed.dpsi);
-    swed.dpsi = NULL;
-  }
-  if (swed.deps != NULL) {
-    free(swed.deps);
-    swed.deps = NULL;
-  }
+  /* the tables belong to all threads, s. load_dpsi_deps() */
+  swed.dpsi = NULL;
+  swed.deps = NULL;
+  swed.eop_dpsi_loaded = 0;
+  /* the delta t table, too, s. init_dt() */
+  swed.dttab = NULL;
+  swed.init_dt_done = FALSE;
 /*  swed.ephe_path_is_set = FALSE;
   *swed.ephepath = '\0'; */
 #ifdef TRACE
@@ -1203,6 +1287,75 @@ void CALL_CONV swe_close(void)
 #endif  /* TRACE */
 }
 
+/* creates a calculation context. a context holds everything that
+ * otherwise is kept per thread: ephemeris path, open files, saved 
+ * positions, observer position, sidereal mode, astronomical models etc.
+ * after swe_context_switch(ctx), all functions of the Swiss Ephemeris
+ * work with the state of ctx, and the previous state stays intact, 
+ * caches included, until it is switched back to. so alternating between
+ * a few configurations costs no recalculation. 
+ * a new context is in the state of a thread that has not yet called 
+ * any function; the ephemeris path etc. have to be set after switching
+ * to it.
+ * returns NULL, if there is not enough memory. */
+struct swe_context *CALL_CONV swe_context_new(void)
+{
+  return (struct swe_context *) calloc(1, sizeof(struct swe_context));
+}
+
+/* makes ctx the calculation context of the calling thread; with
+ * ctx == NULL, the thread goes back to its own state.
+ * a context can be active in only one thread at a time, and has to be
+ * switched away from before the thread ends. */
+int32 CALL_CONV swe_context_switch(struct swe_context *ctx, char *serr)
+{
+  struct swe_context *ctx_prev = swe_context_get_current();
+  if (ctx == ctx_prev)
+    return OK;
+  if (ctx != NULL && ctx->is_active) {
+    if (serr != NULL)
+      strcpy(serr, "calculation context is active in another thread");
+    return ERR;
+  }
+  /* the JPL reader keeps its own state */
+  if (ctx_prev != NULL) {
+    ctx_prev->jpl = swi_jpl_exchange_state(ctx_prev->jpl);
+    ctx_prev->is_active = FALSE;
+  }
+  if (ctx != NULL) {
+    ctx->jpl = swi_jpl_exchange_state(ctx->jpl);
+    ctx->is_active = TRUE;
+    swi_swed_ctx = &ctx->data;
+  } else {
+    swi_swed_ctx = NULL;
+  }
+  return OK;
+}
+
+/* returns the calculation context of the calling thread, NULL if it 
+ * uses its own state */
+struct swe_context *CALL_CONV swe_context_get_current(void)
+{
+  /* data is the first member of struct swe_context */
+  return (struct swe_context *) swi_swed_ctx;
+}
+
+/* closes the files of a calculation context and frees it. the context 
+ * must not be active in another thread. */
+void CALL_CONV swe_context_free(struct swe_context *ctx)
+{
+  struct swe_context *ctx_prev = swe_context_get_current();
+  if (ctx == NULL)
+    return;
+  if (ctx_prev == ctx)
+    ctx_prev = NULL;
+  if (swe_context_switch(ctx, NULL) != OK)
+    return;
+  swe_close();
+  swe_context_switch(ctx_prev, NULL);
+  free((void *) ctx);
+}
+
 /* sets ephemeris file path. 
  * also calls swe_close(). this makes sure that swe_calc()
  * won't return planet positions previously computed from other
@@ -1269,15 +1422,88 @@ void CALL_CONV swe_set_ephe_path(char *path)
 #endif
 }
 
+/* the tables of dpsi and deps (s. read_dpsi_deps()) do not change, and
+ * are shared by all threads that use the same ephemeris path */
+struct eop_table {
+  char ephepath[AS_MAXCH];
+  int loaded;		/* as swed.eop_dpsi_loaded */
+  double tjd_beg;
+  double tjd_beg_horizons;
+  double tjd_end;
+  double *dpsi;
+  double *deps;
+  struct eop_table *next;
+};
+#ifdef SWI_USE_PTHREAD
+static struct eop_table *eop_tables = NULL;
+static pthread_mutex_t eop_tables_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+static TLS struct eop_table *eop_tables = NULL;
+#endif
+
+static void read_dpsi_deps(void);
+
 void load_dpsi_deps(void)
+{
+  struct eop_table *tab;
+  if (swed.eop_dpsi_loaded > 0) 
+    return;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_lock(&eop_tables_lock);
+#endif
+  for (tab = eop_tables; tab != NULL; tab = tab->next) {
+    if (strcmp(tab->ephepath, swed.ephepath) == 0)
+      break;
+  }
+  if (tab == NULL) {
+    swed.dpsi = NULL;
+    swed.deps = NULL;
+    read_dpsi_deps();
+    /* if the files could not be read, they will be tried again later */
+    if (swed.eop_dpsi_loaded <= 0
+      || (tab = (struct eop_table *) calloc(1, sizeof(struct eop_table))) == NULL) {
+      if (swed.dpsi != NULL)
+	free(swed.dpsi);
+      if (swed.deps != NULL)
+	free(swed.deps);
+      swed.dpsi = NULL;
+      swed.deps = NULL;
+      if (swed.eop_dpsi_loaded > 0)
+	swed.eop_dpsi_loaded = ERR;
+#ifdef SWI_USE_PTHREAD
+      pthread_mutex_unlock(&eop_tables_lock);
+#endif
+      return;
+    }
+    strcpy(tab->ephepath, swed.ephepath);
+    tab->loaded = swed.eop_dpsi_loaded;
+    tab->tjd_beg = swed.eop_tjd_beg;
+    tab->tjd_beg_horizons = swed.eop_tjd_beg_horizons;
+    tab->tjd_end = swed.eop_tjd_end;
+    tab->dpsi = swed.dpsi;
+    tab->deps = swed.deps;
+    tab->next = eop_tables;
+    eop_tables = tab;
+  }
+  swed.eop_dpsi_loaded = tab->loaded;
+  swed.eop_tjd_beg = tab->tjd_beg;
+  swed.eop_tjd_beg_horizons = tab->tjd_beg_horizons;
+  swed.eop_tjd_end = tab->tjd_end;
+  swed.dpsi = tab->dpsi;
+  swed.deps = tab->deps;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_unlock(&eop_tables_lock);
+#endif
+}
+
+/* reads dpsi and deps into newly allocated swed.dpsi and swed.deps */
+static void read_dpsi_deps(void)
 {
   FILE *fp;
   char s[AS_MAXCH];
   char *cpos[20];
   int n = 0, np, iyear, mjd = 0, mjdsv = 0;
   double dpsi, deps, TJDOFS = 2400000.5;
-  if (swed.eop_dpsi_loaded > 0) 
-    return;
   fp = swi_fopen(-1, DPSI_DEPS_IAU1980_FILE_EOPC04, swed.ephepath, NULL);
   if (fp == NULL) {
     swed.eop_dpsi_loaded = ERR;
@@ -2044,11 +2270,11 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
    ******************************/
   if (fdp->fptr != NULL) {
     /* if tjd is beyond file range, close old file.
-     * if new asteroid, close old file. */
+     * if new asteroid, close old file. 
+     * (it is kept open in the pool of files, if possible) */
     if (tjd < fdp->tfstart || tjd > fdp->tfend
       || (ipl == SEI_ANYBODY && ipli != pdp->ibdy)) { 	
-      fclose(fdp->fptr);
-      fdp->fptr = NULL;
+      park_ephe_file(ifno);
       if (pdp->refep != NULL) 
 	free((void *) pdp->refep);
       pdp->refep = NULL;
@@ -2058,7 +2284,7 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
     }
   }
   /* if sweph file not open, find and open it */
-  if (fdp->fptr == NULL) {
+  if (fdp->fptr == NULL && !take_pooled_file(tjd, ipli, ifno)) {
     swi_gen_filename(tjd, ipli, fname); 
     strcpy(subdirnam, fname);
     sp = strrchr(subdirnam, (int) *DIR_GLUE);
@@ -2100,9 +2326,15 @@ again:
     }
     /* during the search error messages may have been built, delete them */
     if (serr != NULL) *serr = '\0';	
-    retc = read_const(ifno, serr);
-    if (retc != OK)
-      return(retc);
+    if (!get_shared_header(ifno)) {
+      retc = read_const(ifno, serr);
+      if (retc != OK)
+	return(retc);
+      put_shared_header(ifno);
+    }
+    map_ephe_file(fdp);
+    fdp->sfile = segment_cache_file(fdp);
+    strcpy(fdp->gnam, fname);
   }
   /* if first ephemeris file (J-3000), it might start a mars period
    * after -3000. if last ephemeris file (J3000), it might end a
@@ -2120,11 +2352,21 @@ again:
     }
     return(NOT_AVAILABLE);
   }
+  /* a compacted file may not have all bodies, s. swe_compact_ephe_file() */
+  if (!file_has_body(fdp, ipli)) {
+    if (serr != NULL) {
+      sprintf(s, "body %d not in ephemeris file %.200s;", ipli, fdp->fnam);
+      if (strlen(serr) + strlen(s) < AS_MAXCH)
+	strcat(serr, s);
+    }
+    return(NOT_AVAILABLE);
+  }
   /******************************
    * get planet's position      
    ******************************/
   /* get new segment, if necessary */
-  if (pdp->segp == NULL || tjd < pdp->tseg0 || tjd > pdp->tseg1) {
+  if ((pdp->segp == NULL || tjd < pdp->tseg0 || tjd > pdp->tseg1)
+      && !get_cached_segment(tjd, ipl, ifno)) {
     retc = get_new_segment(tjd, ipl, ifno, serr);
     if (retc != OK)
       return(retc);
@@ -2134,6 +2376,7 @@ again:
       rot_back(ipl); /**/
     else
       pdp->neval = pdp->ncoe;
+    put_cached_segment(ipl, ifno);
   }
   /* evaluate chebyshew polynomial for tjd */
   t = (tjd - pdp->tseg0) / pdp->dseg;
@@ -2145,12 +2388,22 @@ again:
    * 2. the speed flag has been specified.
    */
   need_speed = (do_save || (iflag & SEFLG_SPEED));
-  for (i = 0; i <= 2; i++) {
-    xp[i]  = swi_echeb (t, pdp->segp+(i*pdp->ncoe), pdp->neval);
-    if (need_speed)
-      xp[i+3] = swi_edcheb(t, pdp->segp+(i*pdp->ncoe), pdp->neval) / pdp->dseg * 2;
-    else 
-      xp[i+3] = 0;	/* von Alois als billiger fix, evtl. illegal */
+  if (get_series_position(tjd, ipl, xp)) {
+    /* evaluated together with the following dates of swe_calc_series() */
+    for (i = 3; i <= 5; i++) {
+      if (need_speed)
+	xp[i] = xp[i] / pdp->dseg * 2;
+      else 
+	xp[i] = 0;
+    }
+  } else {
+    swi_echeb_xyz(t, pdp->segp, pdp->ncoe, pdp->neval, xp, need_speed ? xp + 3 : NULL);
+    for (i = 3; i <= 5; i++) {
+      if (need_speed)
+	xp[i] = xp[i] / pdp->dseg * 2;
+      else 
+	xp[i] = 0;	/* von Alois als billiger fix, evtl. illegal */
+    }
   }
   /* if planet wanted is barycentric sun and must be computed
    * from heliocentric earth and barycentric earth: the 
@@ -2208,6 +2461,62 @@ again:
 /*
  * Alois 2.12.98: inserted error message generation for file not found 
  */
+/* hash of a file name, for the list of missing files */
+static uint32 file_miss_key(char *fname)
+{
+  uint32 h = 2166136261u;
+  for (; *fname != '\0'; fname++) {
+    h ^= (unsigned char) *fname;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static struct file_miss *find_file_miss(char *fname)
+{
+  struct file_miss *mp;
+  uint32 key = file_miss_key(fname);
+  for (mp = swed.filemiss; mp != NULL; mp = mp->next) {
+    if (mp->key == key && strcmp(mp->fname, fname) == 0)
+      return mp;
+  }
+  return NULL;
+}
+
+/* remembers that fname is not in the ephemeris path, with the error 
+ * message msg */
+static void add_file_miss(char *fname, char *msg)
+{
+  struct file_miss *mp;
+  size_t lf = strlen(fname) + 1, lm = strlen(msg) + 1;
+  if (swed.nfilemiss >= SEI_FILEMISS_MAX)
+    return;
+  /* the strings are stored after the structure */
+  if ((mp = (struct file_miss *) malloc(sizeof(struct file_miss) + lf + lm)) == NULL)
+    return;
+  mp->key = file_miss_key(fname);
+  mp->fname = (char *) (mp + 1);
+  mp->msg = mp->fname + lf;
+  memcpy(mp->fname, fname, lf);
+  memcpy(mp->msg, msg, lm);
+  mp->next = swed.filemiss;
+  swed.filemiss = mp;
+  swed.nfilemiss++;
+}
+
+static void clear_file_misses(void)
+{
+  struct file_miss *mp;
+  while ((mp = swed.filemiss) != NULL) {
+    swed.filemiss = mp->next;
+    free((void *) mp);
+  }
+  swed.nfilemiss = 0;
+}
+
+/* opens the file fname in one of the directories of ephepath. files
+ * that are not found in the ephemeris path of the calling thread are
+ * remembered, and not looked for again. */
 FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
 {
   int np, i, j;
@@ -2216,11 +2525,23 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
   char *cpos[20];
   char s[2 * AS_MAXCH];
   char s1[AS_MAXCH];
+  AS_BOOL use_misses = (ephepath == swed.ephepath);
+  struct file_miss *mp;
   if (ifno >= 0) {
     fnamp = swed.fidat[ifno].fnam;
   } else {
     fnamp = fn; 
   }
+  /* before the misses, as they may date from before the bundle was set */
+#ifdef SWI_USE_BUNDLE
+  if ((fp = bundle_fopen(fname, fnamp)) != NULL)
+    return fp;
+#endif
+  if (use_misses && (mp = find_file_miss(fname)) != NULL) {
+    if (serr != NULL)
+      strcpy(serr, mp->msg);
+    return NULL;
+  }
   strcpy(s1, ephepath);
   np = swi_cutstr(s1, PATH_SEPARATOR, cpos, 20);
   *s = '\0';
@@ -2249,6 +2570,8 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
   s[AS_MAXCH-1] = '\0';		/* s must not be longer then AS_MAXCH */
   if (serr != NULL)
     strcpy(serr, s);
+  if (use_misses)
+    add_file_miss(fname, s);
   return NULL;
 }
 
@@ -3898,7 +4221,6 @@ static int get_new_segment(double tjd, int ipli, int ifno, char *serr)
   retc = do_fread((void *) &fpos, 3, 1, 4, fp, fpos, freord, fendian, ifno, serr);
   if (retc != OK)
     goto return_error_gns;
-  fseek(fp, fpos, SEEK_SET);
   /* clear space of chebyshew coefficients */
   if (pdp->segp == NULL)
     pdp->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8);
@@ -3907,8 +4229,9 @@ static int get_new_segment(double tjd, int ipli, int ifno, char *serr)
   for (icoord = 0; icoord < 3; icoord++) {
     idbl = icoord * pdp->ncoe;
     /* first read header */
-    /* first bit indicates number of sizes of packed coefficients */
-    retc = do_fread((void *) &c[0], 1, 2, 1, fp, SEI_CURR_FPOS, freord, fendian, ifno, serr);
+    /* first bit indicates number of sizes of packed coefficients;
+     * the first header is at fpos, the others follow each other */
+    retc = do_fread((void *) &c[0], 1, 2, 1, fp, (icoord == 0) ? fpos : SEI_CURR_FPOS, freord, fendian, ifno, serr);
     if (retc != OK)
       goto return_error_gns;
     if (c[0] & 128) {
@@ -4010,9 +4333,7 @@ static int get_new_segment(double tjd, int ipli, int ifno, char *serr)
 #endif
   return(OK);
 return_error_gns:
-  fclose(fdp->fptr);
-  free(fdp->fptr);
-  fdp->fptr = NULL;
+  close_ephe_file(fdp);
   free_planets();
   return ERR;
 }
@@ -4369,9 +4690,7 @@ file_damage:
     }
   }
 return_error:
-  fclose(fdp->fptr);
-  free(fdp->fptr);
-  fdp->fptr = NULL;
+  close_ephe_file(fdp);
   free_planets();
   return(ERR);
 }
@@ -4396,22 +4715,44 @@ static int do_fread(void *trg, int size, int count, int corrsize, FILE *fp, int3
   int totsize;
   unsigned char space[1000];
   unsigned char *targ = (unsigned char *) trg;
+  unsigned char *src;
+  struct file_data *fdp = &swed.fidat[ifno];
   totsize = size * count;
-  if (fpos >= 0) 
-    fseek(fp, fpos, SEEK_SET);
-  /* if no byte reorder has to be done, and read size == return size */
-  if (!freord && size == corrsize) {
-    if (fread((void *) targ, (size_t) totsize, 1, fp) == 0) {
+  if (fdp->mdata != NULL && fdp->fptr == fp) {
+    /* memory mapped file: decode directly from the mapped bytes */
+    if (fpos >= 0)
+      fdp->mpos = fpos;
+    if (fdp->mpos < 0 || totsize > fdp->mlen - fdp->mpos) {
       if (serr != NULL) {
-	strcpy(serr, "Ephemeris file is damaged (1). ");
-	if (strlen(serr) + strlen(swed.fidat[ifno].fnam) < AS_MAXCH - 1) {
-	  sprintf(serr, "Ephemeris file %s is damaged (2).", swed.fidat[ifno].fnam);
+	strcpy(serr, "Ephemeris file is damaged (5). ");
+	if (strlen(serr) + strlen(fdp->fnam) < AS_MAXCH - 1) {
+	  sprintf(serr, "Ephemeris file %s is damaged (6).", fdp->fnam);
 	}
       }
       return(ERR);
-    } else
+    }
+    src = fdp->mdata + fdp->mpos;
+    fdp->mpos += totsize;
+    if (!freord && size == corrsize) {
+      memcpy((void *) targ, (void *) src, (size_t) totsize);
       return(OK);
+    }
   } else {
+    if (fpos >= 0) 
+      fseek(fp, fpos, SEEK_SET);
+    /* if no byte reorder has to be done, and read size == return size */
+    if (!freord && size == corrsize) {
+      if (fread((void *) targ, (size_t) totsize, 1, fp) == 0) {
+	if (serr != NULL) {
+	  strcpy(serr, "Ephemeris file is damaged (1). ");
+	  if (strlen(serr) + strlen(swed.fidat[ifno].fnam) < AS_MAXCH - 1) {
+	    sprintf(serr, "Ephemeris file %s is damaged (2).", swed.fidat[ifno].fnam);
+	  }
+	}
+	return(ERR);
+      } else
+	return(OK);
+    }
     if (fread((void *) &space[0], (size_t) totsize, 1, fp) == 0) {
       if (serr != NULL) {
 	strcpy(serr, "Ephemeris file is damaged (3). ");
@@ -4421,158 +4762,1533 @@ static int do_fread(void *trg, int size, int count, int corrsize, FILE *fp, int3
       }
       return(ERR);
     }
-    if (size != corrsize) {
-      memset((void *) targ, 0, (size_t) count * corrsize);
-    }
-    for(i = 0; i < count; i++) {
-      for (j = size-1; j >= 0; j--) {
-	if (freord) 
-	  k = size-j-1;
-        else 
-	  k = j;
-        if (size != corrsize) 
-          if ((fendian == SEI_FILE_BIGENDIAN && !freord) ||
-              (fendian == SEI_FILE_LITENDIAN &&  freord))
-	    k += corrsize - size;
-        targ[i*corrsize+k] = space[i*size+j];
-      }
+    src = space;
+  }
+  if (size != corrsize) {
+    memset((void *) targ, 0, (size_t) count * corrsize);
+  }
+  for(i = 0; i < count; i++) {
+    for (j = size-1; j >= 0; j--) {
+      if (freord) 
+	k = size-j-1;
+      else 
+	k = j;
+      if (size != corrsize) 
+	if ((fendian == SEI_FILE_BIGENDIAN && !freord) ||
+	    (fendian == SEI_FILE_LITENDIAN &&  freord))
+	  k += corrsize - size;
+      targ[i*corrsize+k] = src[i*size+j];
     }
   }
   return(OK);
 }
 
+#ifdef SWI_USE_MMAP
+/* Memory mapped ephemeris files. The mappings are read-only, and shared
+ * by all threads (the swed structure of every thread refers to the same
+ * mapping of a file) and, through the page cache, by all processes.
+ */
+struct mapped_file {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+  unsigned char *addr;
+  int nref;
+  struct mapped_file *next;
+};
+static struct mapped_file *mapped_files = NULL;
+static pthread_mutex_t mapped_files_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 /* SWISSEPH
- * adds reference orbit to chebyshew series (if SEI_FLG_ELLIPSE),
- * rotates series to mean equinox of J2000
- *
- * ipli		planet number
+ * maps an opened ephemeris file into memory, if possible.
+ * if it is not, the file is read through fdp->fptr.
  */
-static void rot_back(int ipli)
+static void map_ephe_file(struct file_data *fdp)
 {
-  int i;
-  double t, tdiff;
-  double qav, pav, dn;
-  double omtild, com, som, cosih2;
-  double x[MAXORD+1][3];
-  double uix[3], uiy[3], uiz[3];
-  double xrot, yrot, zrot;
-  double *chcfx, *chcfy, *chcfz;
-  double *refepx, *refepy;
-  double seps2000 = swed.oec2000.seps;
-  double ceps2000 = swed.oec2000.ceps;
-  struct plan_data *pdp = &swed.pldat[ipli];
-  int nco = pdp->ncoe;
-  t = pdp->tseg0 + pdp->dseg / 2;
-  chcfx = pdp->segp;
-  chcfy = chcfx + nco;
-  chcfz = chcfx + 2 * nco;
-  tdiff= (t - pdp->telem) / 365250.0;
-  if (ipli == SEI_MOON) {
-    dn = pdp->prot + tdiff * pdp->dprot;
-    i = (int) (dn / TWOPI);
-    dn -= i * TWOPI;
-    qav = (pdp->qrot + tdiff * pdp->dqrot) * cos(dn);
-    pav = (pdp->qrot + tdiff * pdp->dqrot) * sin(dn);
-  } else {
-    qav = pdp->qrot + tdiff * pdp->dqrot;
-    pav = pdp->prot + tdiff * pdp->dprot;
-  }
-  /*calculate cosine and sine of average perihelion longitude. */
-  for (i = 0; i < nco; i++) {
-    x[i][0] = chcfx[i];
-    x[i][1] = chcfy[i];
-    x[i][2] = chcfz[i];
+#ifdef SWI_USE_MMAP
+  struct stat st;
+  struct mapped_file *mf;
+  void *addr;
+  fdp->mdata = NULL;
+  fdp->mlen = 0;
+  fdp->mpos = 0;
+#ifdef SWI_USE_BUNDLE
+  /* the contents of a file of the bundle are in memory already */
+  if (bundle_find(fdp->fnam, &fdp->mdata, &fdp->mlen))
+    return;
+#endif
+  if (fdp->fptr == NULL || fstat(fileno(fdp->fptr), &st) != 0)
+    return;
+  if (st.st_size <= 0 || st.st_size > 0x7fffffff)
+    return;
+  pthread_mutex_lock(&mapped_files_lock);
+  for (mf = mapped_files; mf != NULL; mf = mf->next) {
+    if (mf->dev == st.st_dev && mf->ino == st.st_ino
+      && mf->size == st.st_size && mf->mtime == st.st_mtime)
+      break;
   }
-  if (pdp->iflg & SEI_FLG_ELLIPSE) {
-    refepx = pdp->refep;
-    refepy = refepx + nco;
-    omtild = pdp->peri + tdiff * pdp->dperi;
-    i = (int) (omtild / TWOPI);
-    omtild -= i * TWOPI;
-    com = cos(omtild);
-    som = sin(omtild);
-    /*add reference orbit.  */ 
-    for (i = 0; i < nco; i++) {
-      x[i][0] = chcfx[i] + com * refepx[i] - som * refepy[i];
-      x[i][1] = chcfy[i] + com * refepy[i] + som * refepx[i];
+  if (mf == NULL) {
+    addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fileno(fdp->fptr), 0);
+    if (addr == MAP_FAILED
+      || (mf = (struct mapped_file *) malloc(sizeof(struct mapped_file))) == NULL) {
+      if (addr != MAP_FAILED)
+	munmap(addr, (size_t) st.st_size);
+      pthread_mutex_unlock(&mapped_files_lock);
+      return;
     }
-  }
-  /* construct right handed orthonormal system with first axis along
-     origin of longitudes and third axis along angular momentum    
-     this uses the standard formulas for equinoctal variables   
-     (see papers by broucke and by cefola).      */
-  cosih2 = 1.0 / (1.0 + qav * qav + pav * pav);
-  /*     calculate orbit pole. */
-  uiz[0] = 2.0 * pav * cosih2;
-  uiz[1] = -2.0 * qav * cosih2;
-  uiz[2] = (1.0 - qav * qav - pav * pav) * cosih2;
-  /*     calculate origin of longitudes vector. */
-  uix[0] = (1.0 + qav * qav - pav * pav) * cosih2;
-  uix[1] = 2.0 * qav * pav * cosih2;
-  uix[2] = -2.0 * pav * cosih2;
-  /*     calculate vector in orbital plane orthogonal to origin of    
-        longitudes.                                               */ 
-  uiy[0] =2.0 * qav * pav * cosih2;
-  uiy[1] =(1.0 - qav * qav + pav * pav) * cosih2;
-  uiy[2] =2.0 * qav * cosih2;
-  /*     rotate to actual orientation in space.         */ 
-  for (i = 0; i < nco; i++) {
-    xrot = x[i][0] * uix[0] + x[i][1] * uiy[0] + x[i][2] * uiz[0];
-    yrot = x[i][0] * uix[1] + x[i][1] * uiy[1] + x[i][2] * uiz[1];
-    zrot = x[i][0] * uix[2] + x[i][1] * uiy[2] + x[i][2] * uiz[2];
-    if (fabs(xrot) + fabs(yrot) + fabs(zrot) >= 1e-14) 
-      pdp->neval = i;
-    x[i][0] = xrot;
-    x[i][1] = yrot;
-    x[i][2] = zrot;
-    if (ipli == SEI_MOON) {
-      /* rotate to j2000 equator */
-      x[i][1] = ceps2000 * yrot - seps2000 * zrot;
-      x[i][2] = seps2000 * yrot + ceps2000 * zrot;
+    mf->dev = st.st_dev;
+    mf->ino = st.st_ino;
+    mf->size = st.st_size;
+    mf->mtime = st.st_mtime;
+    mf->addr = (unsigned char *) addr;
+    mf->nref = 0;
+    mf->next = mapped_files;
+    mapped_files = mf;
+  }
+  mf->nref++;
+  pthread_mutex_unlock(&mapped_files_lock);
+  fdp->mdata = mf->addr;
+  fdp->mlen = (int32) st.st_size;
+#endif
+}
+
+/* SWISSEPH
+ * closes an ephemeris file, and releases its mapping
+ */
+static void close_ephe_file(struct file_data *fdp)
+{
+#ifdef SWI_USE_MMAP
+  struct mapped_file *mf, **pmf;
+  if (fdp->mdata != NULL) {
+    pthread_mutex_lock(&mapped_files_lock);
+    for (pmf = &mapped_files; (mf = *pmf) != NULL; pmf = &mf->next) {
+      if (mf->addr == fdp->mdata) {
+	if (--mf->nref == 0) {
+	  *pmf = mf->next;
+	  munmap((void *) mf->addr, (size_t) mf->size);
+	  free(mf);
+	}
+	break;
+      }
     }
+    pthread_mutex_unlock(&mapped_files_lock);
   }
-  for (i = 0; i < nco; i++) {
-    chcfx[i] = x[i][0];
-    chcfy[i] = x[i][1];
-    chcfz[i] = x[i][2];
-  }
+#endif
+  fdp->mdata = NULL;
+  fdp->mlen = 0;
+  fdp->mpos = 0;
+  if (fdp->fptr != NULL)
+    fclose(fdp->fptr);
+  fdp->fptr = NULL;
+  segment_cache_file_close(fdp);
 }
 
-/* Adjust position from Earth-Moon barycenter to Earth
- *
- * xemb = hel./bar. position or velocity vectors of emb (input)
- *                                                  earth (output)
- * xmoon= geocentric position or velocity vector of moon
+#ifdef SWI_USE_BUNDLE
+/* SWISSEPH
+ * ephemeris bundle, s. sweph.h. the bundle is shared by all threads;
+ * it must stay in memory as long as files opened from it are in use. 
+ * a file of the bundle is opened as a stdio stream on its contents, and
+ * its contents serve as the mapping of the file (s. map_ephe_file()).
  */
-static void embofs(double *xemb, double *xmoon)
+struct bundle_file {
+  char *name;		/* relative name of the file */
+  unsigned char *data;	/* contents */
+  int32 len;
+};
+
+struct ephe_bundle {
+  unsigned char *base;	/* the bundle */
+  int32 len;
+  AS_BOOL is_mapped;	/* mapped by swe_open_ephe_bundle() */
+  AS_BOOL is_malloced;	/* read by swe_open_ephe_bundle() */
+  int32 nfiles;
+  struct bundle_file *files;	/* sorted by name */
+};
+static struct ephe_bundle *ephe_bundle = NULL;
+static pthread_mutex_t ephe_bundle_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32 bundle_uint32(unsigned char *p)
 {
-  int i;
-  for (i = 0; i <= 2; i++)
-    xemb[i] -= xmoon[i] / (EARTH_MOON_MRAT + 1.0);
+  return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
 }
 
-/* calculates the nutation matrix
- * nu		pointer to nutation data structure
- * oe		pointer to epsilon data structure
- */
-static void nut_matrix(struct nut *nu, struct epsilon *oe) 
+static int bundle_file_cmp(const void *a, const void *b)
 {
-  double psi, eps;
-  double sinpsi, cospsi, sineps, coseps, sineps0, coseps0;
-  psi = nu->nutlo[0];
-  eps = oe->eps + nu->nutlo[1];
-  sinpsi = sin(psi);
-  cospsi = cos(psi);
-  sineps0 = oe->seps;
-  coseps0 = oe->ceps;
-  sineps = sin(eps);
-  coseps = cos(eps);
-  nu->matrix[0][0] = cospsi;
-  nu->matrix[0][1] = sinpsi * coseps;
-  nu->matrix[0][2] = sinpsi * sineps;
-  nu->matrix[1][0] = -sinpsi * coseps0;
-  nu->matrix[1][1] = cospsi * coseps * coseps0 + sineps * sineps0;
-  nu->matrix[1][2] = cospsi * sineps * coseps0 - coseps * sineps0;
+  return strcmp(((const struct bundle_file *) a)->name, ((const struct bundle_file *) b)->name);
+}
+
+/* looks up the file fname (relative to the ephemeris path) in the 
+ * bundle */
+static AS_BOOL bundle_lookup(char *fname, unsigned char **data, int32 *len)
+{
+  struct bundle_file key, *bf = NULL;
+  key.name = fname;
+  pthread_mutex_lock(&ephe_bundle_lock);
+  if (ephe_bundle != NULL)
+    bf = (struct bundle_file *) bsearch((void *) &key, (void *) ephe_bundle->files, 
+	  (size_t) ephe_bundle->nfiles, sizeof(struct bundle_file), bundle_file_cmp);
+  if (bf != NULL) {
+    *data = bf->data;
+    *len = bf->len;
+  }
+  pthread_mutex_unlock(&ephe_bundle_lock);
+  return bf != NULL;
+}
+
+/* looks up the file fnam, as returned by bundle_fopen(), in the bundle */
+static AS_BOOL bundle_find(char *fnam, unsigned char **data, int32 *len)
+{
+  size_t l = strlen(SEI_BUNDLE_DIR);
+  if (strncmp(fnam, SEI_BUNDLE_DIR, l) != 0)
+    return FALSE;
+  return bundle_lookup(fnam + l, data, len);
+}
+
+/* opens the file fname of the bundle, if it is there, and stores its
+ * name, prefixed with SEI_BUNDLE_DIR, in fnamp */
+static FILE *bundle_fopen(char *fname, char *fnamp)
+{
+  unsigned char *data;
+  int32 len;
+  if (strlen(SEI_BUNDLE_DIR) + strlen(fname) >= AS_MAXCH)
+    return NULL;
+  if (!bundle_lookup(fname, &data, &len))
+    return NULL;
+  sprintf(fnamp, "%s%s", SEI_BUNDLE_DIR, fname);
+  return fmemopen((void *) data, (size_t) len, "r");
+}
+
+/* checks the bundle and builds its directory */
+static struct ephe_bundle *bundle_new(unsigned char *data, int32 len, char *serr)
+{
+  struct ephe_bundle *bp;
+  struct bundle_file *bf;
+  unsigned char *dp;
+  uint32 nfiles, off, flen;
+  int32 i;
+  if (len < 16 || memcmp(data, SEI_BUNDLE_MAGIC, 8) != 0)
+    goto damaged;
+  nfiles = bundle_uint32(data + 8);
+  if (nfiles > (uint32) (len - 16) / SEI_BUNDLE_DIRENT)
+    goto damaged;
+  if ((bp = (struct ephe_bundle *) calloc(1, sizeof(struct ephe_bundle))) == NULL
+    || (bp->files = (struct bundle_file *) calloc((size_t) nfiles + 1, sizeof(struct bundle_file))) == NULL) {
+    if (bp != NULL)
+      free(bp);
+    if (serr != NULL)
+      strcpy(serr, "error in malloc() for ephemeris bundle");
+    return NULL;
+  }
+  for (i = 0; i < (int32) nfiles; i++) {
+    dp = data + 16 + i * SEI_BUNDLE_DIRENT;
+    bf = &bp->files[i];
+    off = bundle_uint32(dp + SEI_BUNDLE_NAMELEN);
+    flen = bundle_uint32(dp + SEI_BUNDLE_NAMELEN + 4);
+    if (memchr(dp, '\0', SEI_BUNDLE_NAMELEN) == NULL
+      || off > (uint32) len || flen > (uint32) len - off) {
+      free(bp->files);
+      free(bp);
+      goto damaged;
+    }
+    bf->name = (char *) dp;
+    bf->data = data + off;
+    bf->len = (int32) flen;
+  }
+  qsort((void *) bp->files, (size_t) nfiles, sizeof(struct bundle_file), bundle_file_cmp);
+  bp->base = data;
+  bp->len = len;
+  bp->nfiles = (int32) nfiles;
+  return bp;
+damaged:
+  if (serr != NULL)
+    strcpy(serr, "ephemeris bundle is damaged");
+  return NULL;
+}
+
+static void bundle_free(struct ephe_bundle *bp)
+{
+  if (bp == NULL)
+    return;
+#ifdef SWI_USE_MMAP
+  if (bp->is_mapped)
+    munmap((void *) bp->base, (size_t) bp->len);
+#endif
+  if (bp->is_malloced)
+    free((void *) bp->base);
+  free((void *) bp->files);
+  free((void *) bp);
+}
+
+/* installs the bundle bp, replacing the previous one */
+static void bundle_install(struct ephe_bundle *bp)
+{
+  struct ephe_bundle *old;
+  pthread_mutex_lock(&ephe_bundle_lock);
+  old = ephe_bundle;
+  ephe_bundle = bp;
+  pthread_mutex_unlock(&ephe_bundle_lock);
+  bundle_free(old);
+}
+#endif
+
+/* gets the identity of the opened file fp with the name fnam, to notice
+ * if a file has been changed */
+#ifdef SWI_USE_PTHREAD
+static int file_stat(FILE *fp, char *fnam, struct stat *st)
+{
+#ifdef SWI_USE_BUNDLE
+  unsigned char *data;
+  int32 len;
+  if (bundle_find(fnam, &data, &len)) {
+    memset((void *) st, 0, sizeof(struct stat));
+    st->st_ino = (ino_t) (size_t) data;
+    st->st_size = len;
+    return 0;
+  }
+#endif
+  return fstat(fileno(fp), st);
+}
+#endif
+
+/* uses the ephemeris files packed into the bundle data (s. sweph.h),
+ * which is len bytes long, instead of the files in the ephemeris path.
+ * files that are not in the bundle are still looked for in the path.
+ * the bundle is shared by all threads, and data must stay valid as long
+ * as they calculate. data = NULL stops using the bundle; like setting
+ * another bundle, this must not be done while other threads calculate. 
+ * returns OK or ERR. */
+int32 CALL_CONV swe_set_ephe_bundle(unsigned char *data, int32 len, char *serr)
+{
+#ifdef SWI_USE_BUNDLE
+  struct ephe_bundle *bp = NULL;
+  if (data != NULL && (bp = bundle_new(data, len, serr)) == NULL)
+    return ERR;
+  bundle_install(bp);
+  return OK;
+#else
+  if (serr != NULL)
+    strcpy(serr, "ephemeris bundles are not supported on this platform");
+  return ERR;
+#endif
+}
+
+/* like swe_set_ephe_bundle(), with the bundle in the file fname, which
+ * is memory mapped, or read, if it cannot be mapped */
+int32 CALL_CONV swe_open_ephe_bundle(char *fname, char *serr)
+{
+#ifdef SWI_USE_BUNDLE
+  struct ephe_bundle *bp;
+  unsigned char *data = NULL;
+  struct stat st;
+  AS_BOOL is_mapped = FALSE;
+  FILE *fp;
+  if ((fp = fopen(fname, BFILE_R_ACCESS)) == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "ephemeris bundle %.200s not found", fname);
+    return ERR;
+  }
+  if (fstat(fileno(fp), &st) != 0 || st.st_size <= 0 || st.st_size > 0x7fffffff) {
+    fclose(fp);
+    if (serr != NULL)
+      sprintf(serr, "ephemeris bundle %.200s is damaged", fname);
+    return ERR;
+  }
+#ifdef SWI_USE_MMAP
+  data = (unsigned char *) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+  if (data == (unsigned char *) MAP_FAILED)
+    data = NULL;
+  else
+    is_mapped = TRUE;
+#endif
+  if (data == NULL) {
+    if ((data = (unsigned char *) malloc((size_t) st.st_size)) == NULL
+      || fread((void *) data, (size_t) st.st_size, 1, fp) != 1) {
+      if (data != NULL)
+	free(data);
+      fclose(fp);
+      if (serr != NULL)
+	sprintf(serr, "ephemeris bundle %.200s could not be read", fname);
+      return ERR;
+    }
+  }
+  fclose(fp);
+  if ((bp = bundle_new(data, (int32) st.st_size, serr)) == NULL) {
+#ifdef SWI_USE_MMAP
+    if (is_mapped)
+      munmap((void *) data, (size_t) st.st_size);
+#endif
+    if (!is_mapped)
+      free(data);
+    return ERR;
+  }
+  bp->is_mapped = is_mapped;
+  bp->is_malloced = !is_mapped;
+  bundle_install(bp);
+  return OK;
+#else
+  if (serr != NULL)
+    strcpy(serr, "ephemeris bundles are not supported on this platform");
+  return ERR;
+#endif
+}
+
+/* is the body ipli (an SEI_ number or an asteroid number) in the
+ * ephemeris file? */
+static AS_BOOL file_has_body(struct file_data *fdp, int ipli)
+{
+  int i;
+  for (i = 0; i < fdp->npl; i++) {
+    if (fdp->ipl[i] == ipli)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* SWISSEPH
+ * compaction of ephemeris files: a copy of an ephemeris file that holds
+ * only some of its bodies, and only the segments of a range of dates.
+ * the segments are copied as they are, so positions computed from the
+ * compacted file are the same as from the original one.
+ */
+static uint32 compact_get_int(unsigned char *p, int size, int fendian)
+{
+  uint32 v = 0;
+  int i;
+  for (i = 0; i < size; i++) {
+    if (fendian == SEI_FILE_BIGENDIAN)
+      v = (v << 8) | p[i];
+    else
+      v = (v << 8) | p[size-1-i];
+  }
+  return v;
+}
+
+static void compact_put_int(unsigned char *p, uint32 v, int size, int fendian)
+{
+  int i;
+  for (i = 0; i < size; i++) {
+    if (fendian == SEI_FILE_BIGENDIAN)
+      p[size-1-i] = (unsigned char) (v >> (8 * i));
+    else
+      p[i] = (unsigned char) (v >> (8 * i));
+  }
+}
+
+static void compact_put_double(unsigned char *p, double d, int freord)
+{
+  unsigned char *dp = (unsigned char *) &d;
+  int i;
+  for (i = 0; i < 8; i++)
+    p[i] = freord ? dp[7-i] : dp[i];
+}
+
+/* length of the segment at p, which may not be longer than len;
+ * 0 if it is damaged. s. get_new_segment() for the packing. */
+static int32 compact_segment_length(unsigned char *p, int32 len, int ncoe)
+{
+  int32 n = 0;
+  int icoord, i, nsize[6], nco;
+  for (icoord = 0; icoord < 3; icoord++) {
+    if (n + 4 > len)
+      return 0;
+    if (p[n] & 128) {
+      nsize[0] = p[n+1] / 16; nsize[1] = p[n+1] % 16;
+      nsize[2] = p[n+2] / 16; nsize[3] = p[n+2] % 16;
+      nsize[4] = p[n+3] / 16; nsize[5] = p[n+3] % 16;
+      n += 4;
+    } else {
+      nsize[0] = p[n] / 16; nsize[1] = p[n] % 16;
+      nsize[2] = p[n+1] / 16; nsize[3] = p[n+1] % 16;
+      nsize[4] = nsize[5] = 0;
+      n += 2;
+    }
+    for (i = 0, nco = 0; i < 6; i++)
+      nco += nsize[i];
+    if (nco > ncoe)
+      return 0;
+    for (i = 0; i < 4; i++)
+      n += nsize[i] * (4 - i);
+    n += (nsize[4] + 1) / 2 + (nsize[5] + 3) / 4;
+  }
+  if (n > len)
+    return 0;
+  return n;
+}
+
+/* is body ibdy (an SEI_ number or an asteroid number) wanted, if the
+ * bodies ipl (SE_ numbers) are? */
+static AS_BOOL compact_wants_body(int ibdy, int ifno, int32 *ipl, int32 nipl)
+{
+  int i;
+  if (ipl == NULL || nipl <= 0)
+    return TRUE;
+  /* all positions are computed from these */
+  if (ifno == SEI_FILE_PLANET && (ibdy == SEI_EMB || ibdy == SEI_SUNBARY))
+    return TRUE;
+  for (i = 0; i < nipl; i++) {
+    if (ipl[i] >= SE_AST_OFFSET) {
+      if (ibdy == ipl[i])
+	return TRUE;
+    } else if (ifno == SEI_FILE_MOON) {
+      if (ipl[i] == SE_MOON || ipl[i] == SE_TRUE_NODE || ipl[i] == SE_OSCU_APOG)
+	return TRUE;
+    } else if (ifno != SEI_FILE_ANY_AST && ipl[i] >= SE_MERCURY && ipl[i] <= SE_VESTA 
+      && pnoext2int[ipl[i]] == ibdy && ipl[i] != SE_MOON) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+struct compact_body {
+  int kpl;		/* number in the original file */
+  int32 iseg0, nseg;	/* segments that are kept */
+  int32 cpos;		/* position of the constants in the original file */
+  int32 clen;
+  int32 dlen;		/* length of the index and the segments */
+};
+
+/* s. swe_compact_ephe_file(); is called in a context of its own */
+static int32 compact_ephe_file(char *fin, char *fout, double tjd_start, double tjd_end, int32 *ipl, int32 nipl, char *serr)
+{
+  struct file_data *fdp;
+  struct plan_data *pdp;
+  struct compact_body cb[SEI_FILE_NMAXPLAN];
+  unsigned char *src = NULL, *trg = NULL, *p;
+  int32 flen, tlen, pos, hlen, crcpos, lndx, dpos, seglen, l;
+  int32 i, j, k, nkeep = 0, nbytes_ipl;
+  int ifno, freord, fendian;
+  double tfstart = 0, tfend = 0, t0, t1;
+  char *sp;
+  FILE *fp;
+  int32 retc = ERR;
+  /* which kind of file is it? */
+  if ((sp = strrchr(fin, (int) *DIR_GLUE)) == NULL)
+    sp = fin;
+  else
+    sp++;
+  if (strncmp(sp, "sepl", 4) == 0)
+    ifno = SEI_FILE_PLANET;
+  else if (strncmp(sp, "semo", 4) == 0)
+    ifno = SEI_FILE_MOON;
+  else if (strncmp(sp, "seas", 4) == 0)
+    ifno = SEI_FILE_MAIN_AST;
+  else
+    ifno = SEI_FILE_ANY_AST;
+  fdp = &swed.fidat[ifno];
+  if (strlen(fin) >= AS_MAXCH || (fdp->fptr = fopen(fin, BFILE_R_ACCESS)) == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "ephemeris file %.200s not found", fin);
+    return ERR;
+  }
+  strcpy(fdp->fnam, fin);
+  if (read_const(ifno, serr) != OK)
+    return ERR;
+  freord = (int) fdp->iflg & SEI_FILE_REORD;
+  fendian = (int) fdp->iflg & SEI_FILE_LITENDIAN;
+  /* the file as it is */
+  fp = fdp->fptr;
+  if (fseek(fp, 0L, SEEK_END) != 0 || (flen = (int32) ftell(fp)) <= 0
+    || (src = (unsigned char *) malloc((size_t) flen)) == NULL
+    || fseek(fp, 0L, SEEK_SET) != 0 || fread((void *) src, (size_t) flen, 1, fp) != 1) {
+    if (serr != NULL)
+      sprintf(serr, "ephemeris file %.200s could not be read", fin);
+    goto end_compact;
+  }
+  /* the header lines, s. read_const() */
+  for (pos = 0, i = 0; i < (ifno == SEI_FILE_ANY_AST ? 4 : 3) && pos < flen; pos++) {
+    if (src[pos] == '\n')
+      i++;
+  }
+  hlen = pos;
+  if (hlen + 30 + fdp->npl * 4 + 30 + 4 + 5 * 8 > flen)
+    goto file_damage;
+  nbytes_ipl = (compact_get_int(src + hlen + 28, 2, fendian) > 256) ? 4 : 2;
+  pos = hlen + 30 + fdp->npl * nbytes_ipl;
+  if (ifno == SEI_FILE_ANY_AST)
+    pos += 30;
+  crcpos = pos;
+  pos += 4 + 5 * 8;
+  /* the bodies and segments to keep */
+  for (i = 0; i < fdp->npl; i++) {
+    k = fdp->ipl[i];
+    pdp = &swed.pldat[k >= SE_AST_OFFSET ? SEI_ANYBODY : k];
+    cb[nkeep].kpl = i;
+    cb[nkeep].cpos = pos;
+    cb[nkeep].clen = 90 + ((pdp->iflg & SEI_FLG_ELLIPSE) ? pdp->ncoe * 2 * 8 : 0);
+    pos += cb[nkeep].clen;
+    if (!compact_wants_body(k, ifno, ipl, nipl))
+      continue;
+    t0 = tjd_start > pdp->tfstart ? tjd_start : pdp->tfstart;
+    t1 = tjd_end < pdp->tfend ? tjd_end : pdp->tfend;
+    if (t0 > t1)
+      continue;
+    cb[nkeep].iseg0 = (int32) ((t0 - pdp->tfstart) / pdp->dseg);
+    j = (int32) ((t1 - pdp->tfstart) / pdp->dseg);
+    if (j >= pdp->nndx)
+      j = pdp->nndx - 1;
+    cb[nkeep].nseg = j - cb[nkeep].iseg0 + 1;
+    if (cb[nkeep].nseg <= 0)
+      continue;
+    /* the range of the file is where all bodies kept are */
+    t0 = pdp->tfstart + cb[nkeep].iseg0 * pdp->dseg;
+    t1 = pdp->tfstart + (cb[nkeep].iseg0 + cb[nkeep].nseg) * pdp->dseg;
+    if (nkeep == 0 || t0 > tfstart)
+      tfstart = t0;
+    if (nkeep == 0 || t1 < tfend)
+      tfend = t1;
+    /* the index keeps its length, so that the segments are found as 
+     * before; the segments not kept are 0 in it */
+    cb[nkeep].dlen = pdp->nndx * 3;
+    for (j = 0; j < cb[nkeep].nseg; j++) {
+      l = pdp->lndx0 + (cb[nkeep].iseg0 + j) * 3;
+      if (l < 0 || l + 3 > flen)
+	goto file_damage;
+      dpos = (int32) compact_get_int(src + l, 3, fendian);
+      if (dpos <= 0 || dpos >= flen 
+	|| (seglen = compact_segment_length(src + dpos, flen - dpos, pdp->ncoe)) == 0)
+	goto file_damage;
+      cb[nkeep].dlen += seglen;
+    }
+    nkeep++;
+  }
+  if (nkeep > 0) {
+    if (tfstart < fdp->tfstart)
+      tfstart = fdp->tfstart;
+    if (tfend > fdp->tfend)
+      tfend = fdp->tfend;
+    /* no date in the range of the file may fall into a segment that is
+     * not kept, rounding errors included */
+    for (i = 0; i < nkeep; i++) {
+      k = fdp->ipl[cb[i].kpl];
+      pdp = &swed.pldat[k >= SE_AST_OFFSET ? SEI_ANYBODY : k];
+      while ((int32) ((tfstart - pdp->tfstart) / pdp->dseg) < cb[i].iseg0)
+	tfstart += pdp->dseg * 1e-9;
+      while ((int32) ((tfend - pdp->tfstart) / pdp->dseg) >= cb[i].iseg0 + cb[i].nseg)
+	tfend -= pdp->dseg * 1e-9;
+    }
+  }
+  if (nkeep == 0 || tfstart > tfend) {
+    if (serr != NULL)
+      sprintf(serr, "ephemeris file %.200s has no data for the bodies and dates", fin);
+    retc = NOT_AVAILABLE;
+    goto end_compact;
+  }
+  /* the compacted file */
+  tlen = hlen + 30 + nkeep * nbytes_ipl + (ifno == SEI_FILE_ANY_AST ? 30 : 0) + 4 + 5 * 8;
+  for (i = 0; i < nkeep; i++)
+    tlen += cb[i].clen + cb[i].dlen;
+  if (tlen >= 0x1000000) {	/* the index holds 3 byte positions */
+    if (serr != NULL)
+      sprintf(serr, "compacted ephemeris file %.200s would be too big", fout);
+    goto end_compact;
+  }
+  if ((trg = (unsigned char *) calloc((size_t) tlen, 1)) == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "error in malloc() for compacted ephemeris file");
+    goto end_compact;
+  }
+  memcpy(trg, src, (size_t) hlen + 4);	/* header lines, byte order */
+  compact_put_int(trg + hlen + 4, (uint32) tlen, 4, fendian);
+  memcpy(trg + hlen + 8, src + hlen + 8, 4);	/* DE number */
+  compact_put_double(trg + hlen + 12, tfstart, freord);
+  compact_put_double(trg + hlen + 20, tfend, freord);
+  compact_put_int(trg + hlen + 28, (uint32) nkeep + (nbytes_ipl == 4 ? 256 : 0), 2, fendian);
+  p = trg + hlen + 30;
+  for (i = 0; i < nkeep; i++, p += nbytes_ipl)
+    memcpy(p, src + hlen + 30 + cb[i].kpl * nbytes_ipl, (size_t) nbytes_ipl);
+  if (ifno == SEI_FILE_ANY_AST) {
+    memcpy(p, src + hlen + 30 + fdp->npl * nbytes_ipl, 30);	/* name */
+    p += 30;
+  }
+  compact_put_int(p, swi_crc32(trg, (int) (p - trg)), 4, fendian);
+  p += 4;
+  memcpy(p, src + crcpos + 4, 5 * 8);	/* general constants */
+  p += 5 * 8;
+  /* constants of the bodies, with the new ranges and indexes */
+  lndx = (int32) (p - trg);
+  for (i = 0; i < nkeep; i++)
+    lndx += cb[i].clen;
+  for (i = 0; i < nkeep; i++) {
+    k = fdp->ipl[cb[i].kpl];
+    pdp = &swed.pldat[k >= SE_AST_OFFSET ? SEI_ANYBODY : k];
+    memcpy(p, src + cb[i].cpos, (size_t) cb[i].clen);
+    compact_put_int(p, (uint32) lndx, 4, fendian);
+    p += cb[i].clen;
+    lndx += cb[i].dlen;
+  }
+  /* indexes and segments */
+  for (i = 0; i < nkeep; i++) {
+    k = fdp->ipl[cb[i].kpl];
+    pdp = &swed.pldat[k >= SE_AST_OFFSET ? SEI_ANYBODY : k];
+    dpos = (int32) (p - trg) + pdp->nndx * 3;
+    for (j = 0; j < cb[i].nseg; j++) {
+      l = (int32) compact_get_int(src + pdp->lndx0 + (cb[i].iseg0 + j) * 3, 3, fendian);
+      seglen = compact_segment_length(src + l, flen - l, pdp->ncoe);
+      compact_put_int(p + (cb[i].iseg0 + j) * 3, (uint32) dpos, 3, fendian);
+      memcpy(trg + dpos, src + l, (size_t) seglen);
+      dpos += seglen;
+    }
+    p = trg + dpos;
+  }
+  if ((fp = fopen(fout, BFILE_W_CREATE)) == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "could not create %.200s", fout);
+    goto end_compact;
+  }
+  if ((fwrite((void *) trg, (size_t) tlen, 1, fp) != 1) | fclose(fp)) {
+    if (serr != NULL)
+      sprintf(serr, "could not write %.200s", fout);
+    goto end_compact;
+  }
+  retc = OK;
+  goto end_compact;
+file_damage:
+  if (serr != NULL)
+    sprintf(serr, "Ephemeris file %.200s is damaged (7). ", fin);
+end_compact:
+  if (src != NULL)
+    free(src);
+  if (trg != NULL)
+    free(trg);
+  return retc;
+}
+
+/* writes to fout a copy of the ephemeris file fin, with only the bodies
+ * ipl (SE_ numbers, nipl of them; all with ipl == NULL) and only the
+ * segments that cover the dates tjd_start to tjd_end (ET). bodies that 
+ * all positions depend on are kept in any case. fout must have the 
+ * same name as fin, in another directory. 
+ * the state of the calling thread is left alone.
+ * returns OK, NOT_AVAILABLE if there is nothing to keep (fout is not
+ * written then), or ERR. */
+int32 CALL_CONV swe_compact_ephe_file(char *fin, char *fout, double tjd_start, double tjd_end, int32 *ipl, int32 nipl, char *serr)
+{
+  struct swe_context *ctx, *ctx_prev = swe_context_get_current();
+  int32 retc;
+  if ((ctx = swe_context_new()) == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "error in malloc() for calculation context");
+    return ERR;
+  }
+  if (swe_context_switch(ctx, serr) != OK) {
+    free((void *) ctx);
+    return ERR;
+  }
+  retc = compact_ephe_file(fin, fout, tjd_start, tjd_end, ipl, nipl, serr);
+  swe_context_switch(ctx_prev, NULL);
+  swe_context_free(ctx);
+  return retc;
+}
+
+/* SWISSEPH
+ * pool of ephemeris files that are not used at the moment, but are kept
+ * open, s. struct pooled_file.
+ */
+static int32 file_pool_size(void)
+{
+  return swed.filepool_size_is_set ? swed.filepool_size : SEI_FILEPOOL_DEFAULT_SIZE;
+}
+
+/* closes the least recently used files of the pool, keeping nfiles */
+static void trim_file_pool(int32 nfiles)
+{
+  struct pooled_file *pf, **ppf;
+  int32 n = 0;
+  for (ppf = &swed.filepool; (pf = *ppf) != NULL; ) {
+    if (n < nfiles) {
+      n++;
+      ppf = &pf->next;
+      continue;
+    }
+    *ppf = pf->next;
+    close_ephe_file(&pf->fd);
+    free((void *) pf);
+  }
+  swed.filepool_n = n;
+}
+
+/* puts the open file swed.fidat[ifno] into the pool, or closes it, if
+ * the pool has been disabled */
+static void park_ephe_file(int ifno)
+{
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct pooled_file *pf;
+  if (fdp->fptr == NULL)
+    return;
+  if (file_pool_size() <= 0 || *fdp->gnam == '\0'
+    || (pf = (struct pooled_file *) malloc(sizeof(struct pooled_file))) == NULL) {
+    close_ephe_file(fdp);
+    return;
+  }
+  pf->ifno = ifno;
+  pf->fd = *fdp;
+  pf->next = swed.filepool;
+  swed.filepool = pf;
+  swed.filepool_n++;
+  fdp->fptr = NULL;
+  fdp->mdata = NULL;
+  fdp->mlen = 0;
+  fdp->mpos = 0;
+  fdp->sfile = NULL;	/* the pooled file refers to it now */
+  if (swed.filepool_n > file_pool_size())
+    trim_file_pool(file_pool_size());
+}
+
+/* if the file that sweph() would open for planet ipli and date tjd is
+ * in the pool, takes it out and makes it swed.fidat[ifno] again. 
+ * returns FALSE, if the file must be opened. */
+static AS_BOOL take_pooled_file(double tjd, int ipli, int ifno)
+{
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct pooled_file *pf, **ppf;
+  char fname[AS_MAXCH];
+  if (swed.filepool == NULL)
+    return FALSE;
+  swi_gen_filename(tjd, ipli, fname);
+  for (ppf = &swed.filepool; (pf = *ppf) != NULL; ppf = &pf->next) {
+    if (pf->ifno == ifno && strcmp(pf->fd.gnam, fname) == 0)
+      break;
+  }
+  if (pf == NULL)
+    return FALSE;
+  *ppf = pf->next;
+  swed.filepool_n--;
+  *fdp = pf->fd;
+  free((void *) pf);
+  /* the planets of the file need its constants again */
+  if (get_shared_header(ifno))
+    return TRUE;
+  /* they are not shared, or the file has been changed */
+  if (fdp->mdata == NULL && fseek(fdp->fptr, 0L, SEEK_SET) == 0
+    && read_const(ifno, NULL) == OK)
+    return TRUE;
+  close_ephe_file(fdp);
+  return FALSE;
+}
+
+/* sets the number of ephemeris files that the calling thread keeps open
+ * while it does not use them; 0 closes them as soon as they are not 
+ * needed */
+void CALL_CONV swe_set_ephe_file_pool_size(int32 nfiles)
+{
+  swi_init_swed_if_start();
+  swed.filepool_size_is_set = TRUE;
+  swed.filepool_size = (nfiles > 0) ? nfiles : 0;
+  trim_file_pool(swed.filepool_size);
+}
+
+/* SWISSEPH
+ * constants of ephemeris files (the data read by read_const()), shared
+ * by all threads. a thread that opens a file another thread has opened
+ * before copies the constants instead of reading and checking the 
+ * header of the file again.
+ */
+#ifdef SWI_USE_PTHREAD
+struct ephe_header {
+  char fnam[AS_MAXCH];
+  int ifno;
+  dev_t dev;		/* identity of the file */
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+  struct file_data fd;	/* constants of the file; fptr and mdata unused */
+  struct gen_const gcdat;
+  char astelem[AS_MAXCH * 2];	/* for SEI_FILE_ANY_AST */
+  double ast_G, ast_H, ast_diam;
+  struct plan_data *pd;	/* constants of the fd.npl planets */
+  struct ephe_header *next;
+};
+static struct ephe_header *ephe_headers = NULL;
+static pthread_mutex_t ephe_headers_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* the plan_data of planet fdp->ipl[kpl], as in read_const() */
+static struct plan_data *header_plan_data(struct file_data *fdp, int kpl)
+{
+  if (fdp->ipl[kpl] >= SE_AST_OFFSET)
+    return &swed.pldat[SEI_ANYBODY];
+  return &swed.pldat[fdp->ipl[kpl]];
+}
+
+/* copies the constants read by read_const() */
+static void copy_plan_const(struct plan_data *pdp, struct plan_data *src)
+{
+  pdp->ibdy = src->ibdy;
+  pdp->iflg = src->iflg;
+  pdp->ncoe = src->ncoe;
+  pdp->lndx0 = src->lndx0;
+  pdp->nndx = src->nndx;
+  pdp->tfstart = src->tfstart;
+  pdp->tfend = src->tfend;
+  pdp->dseg = src->dseg;
+  pdp->telem = src->telem;
+  pdp->prot = src->prot;
+  pdp->qrot = src->qrot;
+  pdp->dprot = src->dprot;
+  pdp->dqrot = src->dqrot;
+  pdp->rmax = src->rmax;
+  pdp->peri = src->peri;
+  pdp->dperi = src->dperi;
+}
+#endif
+
+/* gets the constants of the opened file swed.fidat[ifno] from the 
+ * shared headers. returns FALSE if they have not been read yet; 
+ * read_const() must be called then. */
+static AS_BOOL get_shared_header(int ifno)
+{
+#ifdef SWI_USE_PTHREAD
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct ephe_header *hp;
+  struct plan_data *pdp;
+  struct stat st;
+  int kpl;
+  if (fdp->fptr == NULL || file_stat(fdp->fptr, fdp->fnam, &st) != 0)
+    return FALSE;
+  pthread_mutex_lock(&ephe_headers_lock);
+  for (hp = ephe_headers; hp != NULL; hp = hp->next) {
+    if (hp->ifno == ifno && strcmp(hp->fnam, fdp->fnam) == 0
+      && hp->dev == st.st_dev && hp->ino == st.st_ino
+      && hp->size == st.st_size && hp->mtime == st.st_mtime)
+      break;
+  }
+  if (hp == NULL) {
+    pthread_mutex_unlock(&ephe_headers_lock);
+    return FALSE;
+  }
+  fdp->fversion = hp->fd.fversion;
+  strcpy(fdp->astnam, hp->fd.astnam);
+  fdp->sweph_denum = hp->fd.sweph_denum;
+  fdp->tfstart = hp->fd.tfstart;
+  fdp->tfend = hp->fd.tfend;
+  fdp->iflg = hp->fd.iflg;
+  fdp->npl = hp->fd.npl;
+  memcpy((void *) fdp->ipl, (void *) hp->fd.ipl, sizeof(fdp->ipl));
+  swed.gcdat = hp->gcdat;
+  if (ifno == SEI_FILE_ANY_AST) {
+    strcpy(swed.astelem, hp->astelem);
+    swed.ast_G = hp->ast_G;
+    swed.ast_H = hp->ast_H;
+    swed.ast_diam = hp->ast_diam;
+  }
+  for (kpl = 0; kpl < fdp->npl; kpl++) {
+    pdp = header_plan_data(fdp, kpl);
+    copy_plan_const(pdp, &hp->pd[kpl]);
+    /* as in read_const() */
+    if (pdp->iflg & SEI_FLG_ELLIPSE) {
+      if (pdp->refep != NULL) {
+	free((void *) pdp->refep);
+	pdp->refep = NULL;
+	if (pdp->segp != NULL) {
+	  free((void *) pdp->segp);
+	  pdp->segp = NULL;
+	}
+      }
+      if ((pdp->refep = (double *) malloc((size_t) pdp->ncoe * 2 * 8)) == NULL)
+	break;
+      memcpy((void *) pdp->refep, (void *) hp->pd[kpl].refep, (size_t) pdp->ncoe * 2 * 8);
+    }
+  }
+  pthread_mutex_unlock(&ephe_headers_lock);
+  /* out of memory; read the file, which will fail as well */
+  if (kpl < fdp->npl)
+    return FALSE;
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/* makes the constants of swed.fidat[ifno], which read_const() has just
+ * read, available to the other threads */
+static void put_shared_header(int ifno)
+{
+#ifdef SWI_USE_PTHREAD
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct ephe_header *hp, **php;
+  struct plan_data *pdp;
+  struct stat st;
+  int kpl;
+  if (fdp->fptr == NULL || file_stat(fdp->fptr, fdp->fnam, &st) != 0)
+    return;
+  if ((hp = (struct ephe_header *) calloc(1, sizeof(struct ephe_header))) == NULL)
+    return;
+  if ((hp->pd = (struct plan_data *) calloc((size_t) fdp->npl, sizeof(struct plan_data))) == NULL) {
+    free(hp);
+    return;
+  }
+  strcpy(hp->fnam, fdp->fnam);
+  hp->ifno = ifno;
+  hp->dev = st.st_dev;
+  hp->ino = st.st_ino;
+  hp->size = st.st_size;
+  hp->mtime = st.st_mtime;
+  hp->fd = *fdp;
+  hp->fd.fptr = NULL;
+  hp->fd.mdata = NULL;
+  hp->gcdat = swed.gcdat;
+  if (ifno == SEI_FILE_ANY_AST) {
+    strcpy(hp->astelem, swed.astelem);
+    hp->ast_G = swed.ast_G;
+    hp->ast_H = swed.ast_H;
+    hp->ast_diam = swed.ast_diam;
+  }
+  for (kpl = 0; kpl < fdp->npl; kpl++) {
+    pdp = header_plan_data(fdp, kpl);
+    copy_plan_const(&hp->pd[kpl], pdp);
+    if (pdp->iflg & SEI_FLG_ELLIPSE) {
+      if (pdp->refep == NULL
+	|| (hp->pd[kpl].refep = (double *) malloc((size_t) pdp->ncoe * 2 * 8)) == NULL)
+	break;
+      memcpy((void *) hp->pd[kpl].refep, (void *) pdp->refep, (size_t) pdp->ncoe * 2 * 8);
+    }
+  }
+  if (kpl < fdp->npl) {
+    for (kpl = 0; kpl < fdp->npl; kpl++) {
+      if (hp->pd[kpl].refep != NULL)
+	free((void *) hp->pd[kpl].refep);
+    }
+    free(hp->pd);
+    free(hp);
+    return;
+  }
+  pthread_mutex_lock(&ephe_headers_lock);
+  /* drop the headers of files of the same name that have been changed,
+   * and a header another thread has put meanwhile */
+  for (php = &ephe_headers; *php != NULL; ) {
+    struct ephe_header *hp2 = *php;
+    if (hp2->ifno == ifno && strcmp(hp2->fnam, hp->fnam) == 0) {
+      *php = hp2->next;
+      for (kpl = 0; kpl < hp2->fd.npl; kpl++) {
+	if (hp2->pd[kpl].refep != NULL)
+	  free((void *) hp2->pd[kpl].refep);
+      }
+      free(hp2->pd);
+      free(hp2);
+      continue;
+    }
+    php = &hp2->next;
+  }
+  hp->next = ephe_headers;
+  ephe_headers = hp;
+  pthread_mutex_unlock(&ephe_headers_lock);
+#endif
+}
+
+/* SWISSEPH
+ * decoded segment cache.
+ * there is one cache for all threads, so that a thread can use the
+ * segments that other threads have decoded already. the entries are
+ * never changed after they have been made; get_cached_segment() copies
+ * them into swed.pldat[] of the calling thread.
+ */
+#ifdef SWI_USE_PTHREAD
+static struct seg_cache seg_cache = {NULL, NULL, {NULL}, FALSE, 0, 0};
+static pthread_mutex_t seg_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+# define SEG_CACHE_LOCK()	pthread_mutex_lock(&seg_cache_lock)
+# define SEG_CACHE_UNLOCK()	pthread_mutex_unlock(&seg_cache_lock)
+#else
+static TLS struct seg_cache seg_cache = {NULL, NULL, {NULL}, FALSE, 0, 0};
+# define SEG_CACHE_LOCK()
+# define SEG_CACHE_UNLOCK()
+#endif
+
+/* the files the cached segments have been read from: one record for
+ * every file, and for every version of a file that has been replaced.
+ * the entries point to the record of their file, so that files with 
+ * the same hash key cannot get the segments of each other. a record is
+ * freed when neither a cache entry nor an open (or pooled) file refers
+ * to it any more; so swe_close() frees the records of its files, if 
+ * the cache has no segments of them. */
+struct seg_cache_file {
+  char fnam[AS_MAXCH];
+#ifdef SWI_USE_PTHREAD
+  dev_t dev;		/* identity of the file */
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+#endif
+  uint32 key;		/* FNV-1a hash of the above, for the hash table */
+  int32 nref;		/* # of cache entries and files referring to it */
+  struct seg_cache_file *next;
+};
+#ifdef SWI_USE_PTHREAD
+static struct seg_cache_file *seg_cache_files = NULL;
+#else
+static TLS struct seg_cache_file *seg_cache_files = NULL;
+#endif
+
+static uint32 segment_cache_hash(uint32 h, void *data, size_t len)
+{
+  unsigned char *p = (unsigned char *) data;
+  size_t i;
+  for (i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* gets the record of the opened file fdp, making it if the file has not
+ * been opened before. returns NULL if the file cannot be identified; its
+ * segments are not cached then. */
+static struct seg_cache_file *segment_cache_file(struct file_data *fdp)
+{
+  struct seg_cache_file *sfp;
+  uint32 h;
+#ifdef SWI_USE_PTHREAD
+  struct stat st;
+  if (fdp->fptr == NULL || file_stat(fdp->fptr, fdp->fnam, &st) != 0)
+    return NULL;
+#endif
+  h = segment_cache_hash(2166136261u, fdp->fnam, strlen(fdp->fnam));
+#ifdef SWI_USE_PTHREAD
+  h = segment_cache_hash(h, &st.st_size, sizeof(st.st_size));
+  h = segment_cache_hash(h, &st.st_mtime, sizeof(st.st_mtime));
+#endif
+  SEG_CACHE_LOCK();
+  for (sfp = seg_cache_files; sfp != NULL; sfp = sfp->next) {
+    if (sfp->key == h && strcmp(sfp->fnam, fdp->fnam) == 0
+#ifdef SWI_USE_PTHREAD
+      && sfp->dev == st.st_dev && sfp->ino == st.st_ino
+      && sfp->size == st.st_size && sfp->mtime == st.st_mtime
+#endif
+      )
+      break;
+  }
+  if (sfp != NULL) {
+    sfp->nref++;
+  } else if ((sfp = (struct seg_cache_file *) malloc(sizeof(struct seg_cache_file))) != NULL) {
+    strcpy(sfp->fnam, fdp->fnam);
+#ifdef SWI_USE_PTHREAD
+    sfp->dev = st.st_dev;
+    sfp->ino = st.st_ino;
+    sfp->size = st.st_size;
+    sfp->mtime = st.st_mtime;
+#endif
+    sfp->key = h;
+    sfp->nref = 1;
+    sfp->next = seg_cache_files;
+    seg_cache_files = sfp;
+  }
+  SEG_CACHE_UNLOCK();
+  return sfp;
+}
+
+/* drops a reference to the record sfp, and frees it if it was the last
+ * one. the cache must be locked. */
+static void segment_cache_file_unref(struct seg_cache_file *sfp)
+{
+  struct seg_cache_file **psfp;
+  if (--sfp->nref > 0)
+    return;
+  for (psfp = &seg_cache_files; *psfp != NULL; psfp = &(*psfp)->next) {
+    if (*psfp == sfp) {
+      *psfp = sfp->next;
+      break;
+    }
+  }
+  free((void *) sfp);
+}
+
+/* drops the reference of the file fdp, which is being closed, to its
+ * record */
+static void segment_cache_file_close(struct file_data *fdp)
+{
+  if (fdp->sfile == NULL)
+    return;
+  SEG_CACHE_LOCK();
+  segment_cache_file_unref(fdp->sfile);
+  SEG_CACHE_UNLOCK();
+  fdp->sfile = NULL;
+}
+
+static int32 segment_cache_size(void)
+{
+  return seg_cache.size_is_set ? seg_cache.size : SEI_SEGCACHE_DEFAULT_SIZE;
+}
+
+static int segment_cache_slot(struct seg_cache_file *sfile, int ipli, int ibdy, int32 iseg)
+{
+  uint32 h = sfile->key;
+  h = h * 31 + (uint32) ipli;
+  h = h * 31 + (uint32) ibdy;
+  h = h * 31 + (uint32) iseg;
+  return (int) (h % SEI_SEGCACHE_NHASH);
+}
+
+static void segment_cache_unlink(struct seg_cache_entry *ep)
+{
+  struct seg_cache *scp = &seg_cache;
+  if (ep->prev != NULL)
+    ep->prev->next = ep->next;
+  else
+    scp->head = ep->next;
+  if (ep->next != NULL)
+    ep->next->prev = ep->prev;
+  else
+    scp->tail = ep->prev;
+  ep->prev = ep->next = NULL;
+}
+
+static void segment_cache_push_front(struct seg_cache_entry *ep)
+{
+  struct seg_cache *scp = &seg_cache;
+  ep->prev = NULL;
+  ep->next = scp->head;
+  if (scp->head != NULL)
+    scp->head->prev = ep;
+  scp->head = ep;
+  if (scp->tail == NULL)
+    scp->tail = ep;
+}
+
+static void segment_cache_evict(struct seg_cache_entry *ep)
+{
+  struct seg_cache *scp = &seg_cache;
+  struct seg_cache_entry **pp;
+  pp = &scp->hash[segment_cache_slot(ep->sfile, ep->ipli, ep->ibdy, ep->iseg)];
+  for (; *pp != NULL; pp = &(*pp)->hnext) {
+    if (*pp == ep) {
+      *pp = ep->hnext;
+      break;
+    }
+  }
+  segment_cache_unlink(ep);
+  scp->used -= (int32) (sizeof(struct seg_cache_entry) + ep->ncoe * 3 * sizeof(double));
+  segment_cache_file_unref(ep->sfile);
+  free(ep->segp);
+  free(ep);
+}
+
+/* looks up the segment of planet ipli for tjd in the cache. if found, it
+ * is copied to swed.pldat[ipli], and TRUE is returned */
+static int get_cached_segment(double tjd, int ipli, int ifno)
+{
+  struct plan_data *pdp = &swed.pldat[ipli];
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct seg_cache *scp = &seg_cache;
+  struct seg_cache_entry *ep;
+  int32 iseg;
+  if (fdp->sfile == NULL)
+    return FALSE;
+  if (pdp->segp == NULL
+    && (pdp->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8)) == NULL)
+    return FALSE;
+  iseg = (int32) ((tjd - pdp->tfstart) / pdp->dseg);
+  SEG_CACHE_LOCK();
+  if (segment_cache_size() <= 0) {
+    SEG_CACHE_UNLOCK();
+    return FALSE;
+  }
+  for (ep = scp->hash[segment_cache_slot(fdp->sfile, ipli, pdp->ibdy, iseg)]; ep != NULL; ep = ep->hnext) {
+    if (ep->sfile == fdp->sfile && ep->ipli == ipli && ep->ibdy == pdp->ibdy
+      && ep->iseg == iseg && ep->ncoe == pdp->ncoe)
+      break;
+  }
+  if (ep == NULL) {
+    SEG_CACHE_UNLOCK();
+    swed.segcache_misses++;
+    return FALSE;
+  }
+  memcpy((void *) pdp->segp, (void *) ep->segp, (size_t) pdp->ncoe * 3 * 8);
+  pdp->tseg0 = ep->tseg0;
+  pdp->tseg1 = ep->tseg1;
+  pdp->neval = ep->neval;
+  segment_cache_unlink(ep);
+  segment_cache_push_front(ep);
+  SEG_CACHE_UNLOCK();
+  swed.segcache_hits++;
+  return TRUE;
+}
+
+/* stores the current segment of planet ipli in the cache, evicting the
+ * least recently used segments if the cache would grow too big. if
+ * another thread has stored the segment in the meantime, the cache is
+ * left as it is. */
+static void put_cached_segment(int ipli, int ifno)
+{
+  struct plan_data *pdp = &swed.pldat[ipli];
+  struct file_data *fdp = &swed.fidat[ifno];
+  struct seg_cache *scp = &seg_cache;
+  struct seg_cache_entry *ep, *ep2;
+  int32 size;
+  int32 esize = (int32) (sizeof(struct seg_cache_entry) + pdp->ncoe * 3 * sizeof(double));
+  int slot;
+  if (pdp->segp == NULL || fdp->sfile == NULL)
+    return;
+  /* build the entry before taking the lock */
+  if ((ep = (struct seg_cache_entry *) malloc(sizeof(struct seg_cache_entry))) == NULL)
+    return;
+  if ((ep->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8)) == NULL) {
+    free(ep);
+    return;
+  }
+  memcpy((void *) ep->segp, (void *) pdp->segp, (size_t) pdp->ncoe * 3 * 8);
+  ep->sfile = fdp->sfile;
+  ep->ipli = ipli;
+  ep->ibdy = pdp->ibdy;
+  ep->iseg = (int32) ((pdp->tseg0 - pdp->tfstart) / pdp->dseg + 0.5);
+  ep->tseg0 = pdp->tseg0;
+  ep->tseg1 = pdp->tseg1;
+  ep->ncoe = pdp->ncoe;
+  ep->neval = pdp->neval;
+  slot = segment_cache_slot(ep->sfile, ipli, ep->ibdy, ep->iseg);
+  SEG_CACHE_LOCK();
+  size = segment_cache_size();
+  for (ep2 = scp->hash[slot]; ep2 != NULL; ep2 = ep2->hnext) {
+    if (ep2->sfile == ep->sfile && ep2->ipli == ipli && ep2->ibdy == ep->ibdy
+      && ep2->iseg == ep->iseg && ep2->ncoe == ep->ncoe)
+      break;
+  }
+  if (ep2 != NULL || esize > size) {
+    SEG_CACHE_UNLOCK();
+    free(ep->segp);
+    free(ep);
+    return;
+  }
+  while (scp->tail != NULL && scp->used + esize > size)
+    segment_cache_evict(scp->tail);
+  ep->hnext = scp->hash[slot];
+  scp->hash[slot] = ep;
+  segment_cache_push_front(ep);
+  scp->used += esize;
+  ep->sfile->nref++;
+  SEG_CACHE_UNLOCK();
+}
+
+/* set the memory budget of the decoded segment cache, in bytes. the
+ * cache is shared by all threads. 0 disables it, and frees the memory
+ * it uses. */
+void CALL_CONV swe_set_segment_cache_size(int32 nbytes)
+{
+  struct seg_cache *scp = &seg_cache;
+  SEG_CACHE_LOCK();
+  scp->size_is_set = TRUE;
+  scp->size = (nbytes > 0) ? nbytes : 0;
+  while (scp->tail != NULL && scp->used > scp->size)
+    segment_cache_evict(scp->tail);
+  SEG_CACHE_UNLOCK();
+}
+
+/* get the statistics of the decoded segment cache: the hits and misses
+ * of the calling thread, and the memory used by all threads */
+void CALL_CONV swe_get_segment_cache_stats(int32 *hits, int32 *misses, int32 *used)
+{
+  if (hits != NULL)
+    *hits = swed.segcache_hits;
+  if (misses != NULL)
+    *misses = swed.segcache_misses;
+  if (used != NULL) {
+    SEG_CACHE_LOCK();
+    *used = seg_cache.used;
+    SEG_CACHE_UNLOCK();
+  }
+}
+
+/* ends the time series of swe_calc_series() */
+static void clear_cheb_series(void)
+{
+  struct cheb_series *csp = &swed.chebser;
+  int i;
+  for (i = 0; i < SEI_NPLANETS; i++) {
+    if (csp->blk[i] != NULL)
+      free((void *) csp->blk[i]);
+    csp->blk[i] = NULL;
+  }
+  csp->nsteps = 0;
+}
+
+/* the date k of the time series of swe_calc_series(); the block of dates
+ * is evaluated at the very same values, which swe_calc() is called with */
+static double cheb_series_date(struct cheb_series *csp, int32 k)
+{
+  return csp->tstart + k * csp->tstep;
+}
+
+/* if tjd is the date of the time series of swe_calc_series() that
+ * swe_calc() is computing, gets the position and speed of planet ipli
+ * from the block of dates that have been evaluated together, evaluating
+ * a new block first, if necessary. the current segment of the planet
+ * must contain tjd.
+ * only that date itself is served from the block; any other date, such
+ * as a light-time corrected one, returns FALSE and takes the single-date
+ * path, however close it is to a date of the series. */
+static AS_BOOL get_series_position(double tjd, int ipli, double *xp)
+{
+  struct cheb_series *csp = &swed.chebser;
+  struct plan_data *pdp = &swed.pldat[ipli];
+  struct cheb_block *bp;
+  double t[SEI_CHEBSER_BLOCK], tk, *f[3], *df[3];
+  int32 k, n;
+  int i;
+  if (csp->nsteps == 0 || tjd != csp->tjdcur)
+    return FALSE;
+  k = csp->kcur;
+  if ((bp = csp->blk[ipli]) == NULL) {
+    if ((bp = (struct cheb_block *) calloc(1, sizeof(struct cheb_block))) == NULL)
+      return FALSE;
+    csp->blk[ipli] = bp;
+  }
+  if (k < bp->k0 || k >= bp->k0 + bp->nk
+      || bp->tseg0 != pdp->tseg0 || bp->ibdy != pdp->ibdy) {
+    /* the following dates, as long as they are in the same segment */
+    for (n = 0; n < SEI_CHEBSER_BLOCK && k + n < csp->nsteps; n++) {
+      tk = cheb_series_date(csp, k + n);
+      if (tk < pdp->tseg0 || tk > pdp->tseg1)
+	break;
+      t[n] = (tk - pdp->tseg0) / pdp->dseg;
+      t[n] = t[n] * 2 - 1;
+    }
+    for (i = 0; i <= 2; i++) {
+      f[i] = bp->x[i];
+      df[i] = bp->x[i+3];
+    }
+    swi_echeb_many(t, n, pdp->segp, pdp->ncoe, pdp->neval, f, df);
+    bp->ibdy = pdp->ibdy;
+    bp->tseg0 = pdp->tseg0;
+    bp->k0 = k;
+    bp->nk = n;
+  }
+  for (i = 0; i <= 5; i++)
+    xp[i] = bp->x[i][k - bp->k0];
+  return TRUE;
+}
+
+/* SWISSEPH
+ * adds reference orbit to chebyshew series (if SEI_FLG_ELLIPSE),
+ * rotates series to mean equinox of J2000
+ *
+ * ipli		planet number
+ */
+static void rot_back(int ipli)
+{
+  int i;
+  double t, tdiff;
+  double qav, pav, dn;
+  double omtild, com, som, cosih2;
+  double x[MAXORD+1][3];
+  double uix[3], uiy[3], uiz[3];
+  double xrot, yrot, zrot;
+  double *chcfx, *chcfy, *chcfz;
+  double *refepx, *refepy;
+  double seps2000 = swed.oec2000.seps;
+  double ceps2000 = swed.oec2000.ceps;
+  struct plan_data *pdp = &swed.pldat[ipli];
+  int nco = pdp->ncoe;
+  t = pdp->tseg0 + pdp->dseg / 2;
+  chcfx = pdp->segp;
+  chcfy = chcfx + nco;
+  chcfz = chcfx + 2 * nco;
+  tdiff= (t - pdp->telem) / 365250.0;
+  if (ipli == SEI_MOON) {
+    dn = pdp->prot + tdiff * pdp->dprot;
+    i = (int) (dn / TWOPI);
+    dn -= i * TWOPI;
+    qav = (pdp->qrot + tdiff * pdp->dqrot) * cos(dn);
+    pav = (pdp->qrot + tdiff * pdp->dqrot) * sin(dn);
+  } else {
+    qav = pdp->qrot + tdiff * pdp->dqrot;
+    pav = pdp->prot + tdiff * pdp->dprot;
+  }
+  /*calculate cosine and sine of average perihelion longitude. */
+  for (i = 0; i < nco; i++) {
+    x[i][0] = chcfx[i];
+    x[i][1] = chcfy[i];
+    x[i][2] = chcfz[i];
+  }
+  if (pdp->iflg & SEI_FLG_ELLIPSE) {
+    refepx = pdp->refep;
+    refepy = refepx + nco;
+    omtild = pdp->peri + tdiff * pdp->dperi;
+    i = (int) (omtild / TWOPI);
+    omtild -= i * TWOPI;
+    com = cos(omtild);
+    som = sin(omtild);
+    /*add reference orbit.  */ 
+    for (i = 0; i < nco; i++) {
+      x[i][0] = chcfx[i] + com * refepx[i] - som * refepy[i];
+      x[i][1] = chcfy[i] + com * refepy[i] + som * refepx[i];
+    }
+  }
+  /* construct right handed orthonormal system with first axis along
+     origin of longitudes and third axis along angular momentum    
+     this uses the standard formulas for equinoctal variables   
+     (see papers by broucke and by cefola).      */
+  cosih2 = 1.0 / (1.0 + qav * qav + pav * pav);
+  /*     calculate orbit pole. */
+  uiz[0] = 2.0 * pav * cosih2;
+  uiz[1] = -2.0 * qav * cosih2;
+  uiz[2] = (1.0 - qav * qav - pav * pav) * cosih2;
+  /*     calculate origin of longitudes vector. */
+  uix[0] = (1.0 + qav * qav - pav * pav) * cosih2;
+  uix[1] = 2.0 * qav * pav * cosih2;
+  uix[2] = -2.0 * pav * cosih2;
+  /*     calculate vector in orbital plane orthogonal to origin of    
+        longitudes.                                               */ 
+  uiy[0] =2.0 * qav * pav * cosih2;
+  uiy[1] =(1.0 - qav * qav + pav * pav) * cosih2;
+  uiy[2] =2.0 * qav * cosih2;
+  /*     rotate to actual orientation in space.         */ 
+  for (i = 0; i < nco; i++) {
+    xrot = x[i][0] * uix[0] + x[i][1] * uiy[0] + x[i][2] * uiz[0];
+    yrot = x[i][0] * uix[1] + x[i][1] * uiy[1] + x[i][2] * uiz[1];
+    zrot = x[i][0] * uix[2] + x[i][1] * uiy[2] + x[i][2] * uiz[2];
+    if (fabs(xrot) + fabs(yrot) + fabs(zrot) >= 1e-14) 
+      pdp->neval = i;
+    x[i][0] = xrot;
+    x[i][1] = yrot;
+    x[i][2] = zrot;
+    if (ipli == SEI_MOON) {
+      /* rotate to j2000 equator */
+      x[i][1] = ceps2000 * yrot - seps2000 * zrot;
+      x[i][2] = seps2000 * yrot + ceps2000 * zrot;
+    }
+  }
+  for (i = 0; i < nco; i++) {
+    chcfx[i] = x[i][0];
+    chcfy[i] = x[i][1];
+    chcfz[i] = x[i][2];
+  }
+}
+
+/* Adjust position from Earth-Moon barycenter to Earth
+ *
+ * xemb = hel./bar. position or velocity vectors of emb (input)
+ *                                                  earth (output)
+ * xmoon= geocentric position or velocity vector of moon
+ */
+static void embofs(double *xemb, double *xmoon)
+{
+  int i;
+  for (i = 0; i <= 2; i++)
+    xemb[i] -= xmoon[i] / (EARTH_MOON_MRAT + 1.0);
+}
+
+/* calculates the nutation matrix
+ * nu		pointer to nutation data structure
+ * oe		pointer to epsilon data structure
+ */
+static void nut_matrix(struct nut *nu, struct epsilon *oe) 
+{
+  double psi, eps;
+  double sinpsi, cospsi, sineps, coseps, sineps0, coseps0;
+  psi = nu->nutlo[0];
+  eps = oe->eps + nu->nutlo[1];
+  sinpsi = sin(psi);
+  cospsi = cos(psi);
+  sineps0 = oe->seps;
+  coseps0 = oe->ceps;
+  sineps = sin(eps);
+  coseps = cos(eps);
+  nu->matrix[0][0] = cospsi;
+  nu->matrix[0][1] = sinpsi * coseps;
+  nu->matrix[0][2] = sinpsi * sineps;
+  nu->matrix[1][0] = -sinpsi * coseps0;
+  nu->matrix[1][1] = cospsi * coseps * coseps0 + sineps * sineps0;
+  nu->matrix[1][2] = cospsi * sineps * coseps0 - coseps * sineps0;
   nu->matrix[2][0] = -sinpsi * sineps0;
   nu->matrix[2][1] = cospsi * coseps * sineps0 - sineps * coseps0;
   nu->matrix[2][2] = cospsi * sineps * sineps0 + coseps * coseps0;
@@ -5520,9 +7236,8 @@ void swi_check_ecliptic(double tjd, int32 iflag)
 void swi_check_nutation(double tjd, int32 iflag)
 {
   int32 speedf1, speedf2;
-  static TLS int32 nutflag = 0;
   double t;
-  speedf1 = nutflag & SEFLG_SPEED;
+  speedf1 = swed.nutflag & SEFLG_SPEED;
   speedf2 = iflag & SEFLG_SPEED;
   if (!(iflag & SEFLG_NONUT)
 	&& (tjd != swed.nut.tnut || tjd == 0
@@ -5531,7 +7246,7 @@ void swi_check_nutation(double tjd, int32 iflag)
     swed.nut.tnut = tjd;
     swed.nut.snut = sin(swed.nut.nutlo[1]);
     swed.nut.cnut = cos(swed.nut.nutlo[1]);
-    nutflag = iflag;
+    swed.nutflag = iflag;
     nut_matrix(&swed.nut, &swed.oec);
     if (iflag & SEFLG_SPEED) {
       /* once more for 'speed' of nutation, which is needed for 
@@ -5561,76 +7276,555 @@ static int32 plaus_iflag(int32 iflag, int32 ipl, double tjd, char *serr)
   if (iflag & SEFLG_TOPOCTR) {
     iflag = iflag & ~(SEFLG_HELCTR | SEFLG_BARYCTR); 
   }
-  /* if heliocentric bit, turn aberration and deflection off */
-  if (iflag & SEFLG_HELCTR) 
-    iflag |= SEFLG_NOABERR | SEFLG_NOGDEFL; /*iflag |= SEFLG_TRUEPOS;*/
-  /* same, if barycentric bit */
-  if (iflag & SEFLG_BARYCTR) 
-    iflag |= SEFLG_NOABERR | SEFLG_NOGDEFL; /*iflag |= SEFLG_TRUEPOS;*/
-  /* if no_precession bit is set, set also no_nutation bit */
-  if (iflag & SEFLG_J2000)
-    iflag |= SEFLG_NONUT;
-  /* if sidereal bit is set, set also no_nutation bit *
-   * also turn JPL Horizons mode off */
-  if (iflag & SEFLG_SIDEREAL) {
-    iflag |= SEFLG_NONUT;
-    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  /* if heliocentric bit, turn aberration and deflection off */
+  if (iflag & SEFLG_HELCTR) 
+    iflag |= SEFLG_NOABERR | SEFLG_NOGDEFL; /*iflag |= SEFLG_TRUEPOS;*/
+  /* same, if barycentric bit */
+  if (iflag & SEFLG_BARYCTR) 
+    iflag |= SEFLG_NOABERR | SEFLG_NOGDEFL; /*iflag |= SEFLG_TRUEPOS;*/
+  /* if no_precession bit is set, set also no_nutation bit */
+  if (iflag & SEFLG_J2000)
+    iflag |= SEFLG_NONUT;
+  /* if sidereal bit is set, set also no_nutation bit *
+   * also turn JPL Horizons mode off */
+  if (iflag & SEFLG_SIDEREAL) {
+    iflag |= SEFLG_NONUT;
+    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  }
+  /* if truepos is set, turn off grav. defl. and aberration */
+  if (iflag & SEFLG_TRUEPOS)
+    iflag |= (SEFLG_NOGDEFL | SEFLG_NOABERR);
+  if (iflag & SEFLG_MOSEPH)
+    epheflag = SEFLG_MOSEPH;
+  if (iflag & SEFLG_SWIEPH)
+    epheflag = SEFLG_SWIEPH;
+  if (iflag & SEFLG_JPLEPH)
+    epheflag = SEFLG_JPLEPH;
+  if (epheflag == 0)
+    epheflag = SEFLG_DEFAULTEPH;
+  iflag = (iflag & ~SEFLG_EPHMASK) | epheflag;
+  /* SEFLG_JPLHOR only with JPL and Swiss Ephemeeris */
+  if (!(epheflag & SEFLG_JPLEPH)) 
+    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  /* planets that have no JPL Horizons mode */
+  if (ipl == SE_OSCU_APOG || ipl == SE_TRUE_NODE 
+      || ipl == SE_MEAN_APOG || ipl == SE_MEAN_NODE
+      || ipl == SE_INTP_APOG || ipl == SE_INTP_PERG) 
+    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  if (ipl >= SE_FICT_OFFSET && ipl <= SE_FICT_MAX)
+    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  /* SEFLG_JPLHOR requires SEFLG_ICRS, if calculated with * precession/nutation IAU 1980 and corrections dpsi, deps */
+  if (iflag & SEFLG_JPLHOR) {
+    if (swed.eop_dpsi_loaded <= 0 
+       || ((tjd < swed.eop_tjd_beg || tjd > swed.eop_tjd_end) 
+       && jplhor_model != SEMOD_JPLHOR_EXTENDED_1800)) {
+       /*&& !USE_HORIZONS_METHOD_BEFORE_1980)) {*/
+      if (serr != NULL) {
+	switch (swed.eop_dpsi_loaded) {
+	  case 0:
+	    strcpy(serr, "you did not call swe_set_jpl_file(); default to SEFLG_JPLHOR_APPROX");
+	    break;
+	  case -1:
+	    strcpy(serr, "file eop_1962_today.txt not found; default to SEFLG_JPLHOR_APPROX");
+	    break;
+	  case -2:
+	    strcpy(serr, "file eop_1962_today.txt corrupt; default to SEFLG_JPLHOR_APPROX");
+	    break;
+	  case -3:
+	    strcpy(serr, "file eop_finals.txt corrupt; default to SEFLG_JPLHOR_APPROX");
+	    break;
+	}
+      }
+      iflag &= ~SEFLG_JPLHOR;
+      iflag |= SEFLG_JPLHOR_APPROX;
+    }
+  }
+  if (iflag & SEFLG_JPLHOR) 
+    iflag |= SEFLG_ICRS;
+  /*if ((iflag & SEFLG_JPLHOR_APPROX) && FRAME_BIAS_APPROX_HORIZONS) */
+  /*if ((iflag & SEFLG_JPLHOR_APPROX) && !APPROXIMATE_HORIZONS_ASTRODIENST)*/
+  if ((iflag & SEFLG_JPLHOR_APPROX) && jplhora_model != SEMOD_JPLHORA_1)
+    iflag |= SEFLG_ICRS;
+  return iflag;
+}
+
+/* SWISSEPH
+ * in-memory fixed star catalogue.
+ * the star file is read only once, and its stars are indexed by their
+ * traditional names, their nomenclature names and their sequence numbers.
+ * a catalogue is not modified after it has been built, so it is shared
+ * by all threads which use the same star file.
+ */
+struct fixstar_key {
+  char *key;		/* lower case traditional name, or nomenclature
+			 * name (the star data from the first ',' on) */
+  int32 istar;		/* index of the star */
+};
+
+struct fixstar_cat {
+  char fnam[AS_MAXCH];	/* star file the catalogue was read from */
+#ifdef SWI_USE_PTHREAD
+  dev_t dev;		/* identity of the star file, to notice if it */
+  ino_t ino;		/* has been changed */
+  off_t size;
+  time_t mtime;
+#endif
+  int32 nstars;		/* number of stars (non-comment lines) */
+  int32 idamaged;	/* index of the first star without ',', or -1 */
+  int32 fline_damaged;	/* line number of that star in the file */
+  char *buf;		/* the lines of the file, and the names */
+  int32 *data;		/* offset of the line of each star in buf */
+  int32 nkeys;		/* number of stars that can be found by name */
+  struct fixstar_key *byname;	/* sorted by traditional name */
+  struct fixstar_key *bynomclat;	/* sorted by nomenclature name */
+  /* star data in structure of arrays layout, for swe_fixstar_all():
+   * unit vector and space motion per day at the epoch of the star,
+   * parallax in radians, and the epoch (0 for ICRS, 1950 or 2000) */
+  double *sx[6];
+  double *parall;
+  double *epoch;
+  char *valid;		/* FALSE if the data of the star are incomplete */
+  int nref;		/* number of threads using the catalogue */
+  struct fixstar_cat *next;
+};
+
+#ifdef SWI_USE_PTHREAD
+static struct fixstar_cat *fixstar_cats = NULL;
+static pthread_mutex_t fixstar_cats_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+static TLS struct fixstar_cat *fixstar_cats = NULL;
+#endif
+
+static int fixstar_key_cmp(const void *a, const void *b)
+{
+  const struct fixstar_key *ka = (const struct fixstar_key *) a;
+  const struct fixstar_key *kb = (const struct fixstar_key *) b;
+  int cmp = strcmp(ka->key, kb->key);
+  if (cmp != 0)
+    return cmp;
+  return (ka->istar > kb->istar) - (ka->istar < kb->istar);
+}
+
+/* finds the first star (in file order) whose key starts with key */
+static int32 fixstar_key_search(struct fixstar_key *keys, int32 nkeys, char *key)
+{
+  int32 lo = 0, hi = nkeys, mid, istar = -1;
+  size_t cmplen = strlen(key);
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (strcmp(keys[mid].key, key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  /* all keys with this prefix follow each other */
+  for (; lo < nkeys && strncmp(keys[lo].key, key, cmplen) == 0; lo++) {
+    if (istar < 0 || keys[lo].istar < istar)
+      istar = keys[lo].istar;
+  }
+  return istar;
+}
+
+static void fixstar_cat_free(struct fixstar_cat *cat)
+{
+  if (cat == NULL)
+    return;
+  free(cat->buf);
+  free(cat->data);
+  free(cat->byname);
+  free(cat->bynomclat);
+  free(cat->sx[0]);
+  free(cat->valid);
+  free(cat);
+}
+
+/* appends a string to the catalogue buffer; returns its offset, or -1 */
+static int32 fixstar_cat_append(struct fixstar_cat *cat, int32 *nbuf, int32 *nalloc, char *s)
+{
+  int32 len = (int32) strlen(s) + 1, off = *nbuf;
+  char *p;
+  if (*nbuf + len > *nalloc) {
+    int32 n = (*nalloc > 0) ? *nalloc * 2 : 65536;
+    while (*nbuf + len > n)
+      n *= 2;
+    if ((p = (char *) realloc(cat->buf, (size_t) n)) == NULL)
+      return -1;
+    cat->buf = p;
+    *nalloc = n;
+  }
+  memcpy(cat->buf + off, s, (size_t) len);
+  *nbuf += len;
+  return off;
+}
+
+/* computes the unit vector and the space motion per day of a star at
+ * the epoch of its data, like swe_fixstar() does */
+static int fixstar_parse_data(char *data, AS_BOOL is_old_starfile, double *x, double *pparall, double *pepoch)
+{
+  char s[AS_MAXCH], *cpos[20];
+  double ra_s, ra_pm, de_pm, ra, de, cosra, cosde, sinra, sinde;
+  double ra_h, ra_m, de_d, de_m, de_s, radv, parall;
+  char *sde_d;
+  strcpy(s, data);
+  if (swi_cutstr(s, ",", cpos, 20) < 13)
+    return ERR;
+  *pepoch = atof(cpos[2]);
+  ra_h = atof(cpos[3]);
+  ra_m = atof(cpos[4]);
+  ra_s = atof(cpos[5]);
+  de_d = atof(cpos[6]);
+  sde_d = cpos[6];
+  de_m = atof(cpos[7]);
+  de_s = atof(cpos[8]);
+  ra_pm = atof(cpos[9]);
+  de_pm = atof(cpos[10]);
+  radv = atof(cpos[11]);
+  parall = atof(cpos[12]);
+  ra = (ra_s / 3600.0 + ra_m / 60.0 + ra_h) * 15.0;
+  if (strchr(sde_d, '-') == NULL)
+    de = de_s / 3600.0 + de_m / 60.0 + de_d;
+  else
+    de = -de_s / 3600.0 - de_m / 60.0 + de_d;
+  if (is_old_starfile == TRUE) {
+    ra_pm = ra_pm * 15 / 3600.0;
+    de_pm = de_pm / 3600.0;
+  } else {
+    ra_pm = ra_pm / 10.0 / 3600.0;
+    de_pm = de_pm / 10.0 / 3600.0;
+    parall /= 1000.0;
+  }
+  if (parall > 1)
+    parall = (1 / parall / 3600.0);
+  else
+    parall /= 3600;
+  radv *= KM_S_TO_AU_CTY;
+  ra *= DEGTORAD;
+  de *= DEGTORAD;
+  ra_pm *= DEGTORAD;
+  de_pm *= DEGTORAD;
+  ra_pm /= cos(de);
+  parall *= DEGTORAD;
+  x[0] = ra;
+  x[1] = de;
+  x[2] = 1;
+  swi_polcart(x, x);
+  cosra = cos(ra);
+  cosde = cos(de);
+  sinra = sin(ra);
+  sinde = sin(de);
+  x[3] = -ra_pm * cosde * sinra - de_pm * sinde * cosra
+			+ radv * parall * cosde * cosra;
+  x[4] = ra_pm * cosde * cosra - de_pm * sinde * sinra
+			+ radv * parall * cosde * sinra;
+  x[5] = de_pm * cosde + radv * parall * sinde;
+  x[3] /= 36525;
+  x[4] /= 36525;
+  x[5] /= 36525;
+  *pparall = parall;
+  return OK;
+}
+
+/* reads the star file fp into a new catalogue */
+static struct fixstar_cat *fixstar_cat_build(FILE *fp, char *fnam, AS_BOOL is_old_starfile)
+{
+  struct fixstar_cat *cat;
+  char s[AS_MAXCH], fstar[SE_MAX_STNAME + 1], *sp;
+  int32 nbuf = 0, nbufalloc = 0, nalloc = 0, fline = 0, i, j;
+  int32 *nameoff = NULL, *nomoff = NULL, *p;
+  if ((cat = (struct fixstar_cat *) calloc(1, sizeof(struct fixstar_cat))) == NULL)
+    return NULL;
+  strcpy(cat->fnam, fnam);
+  cat->idamaged = -1;
+  rewind(fp);
+  while (fgets(s, AS_MAXCH, fp) != NULL) {
+    fline++;
+    if (*s == '#') continue;
+    if (cat->nstars == nalloc) {
+      nalloc = (nalloc > 0) ? nalloc * 2 : 1024;
+      if ((p = (int32 *) realloc(cat->data, nalloc * sizeof(int32))) == NULL)
+	goto nomem;
+      cat->data = p;
+      if ((p = (int32 *) realloc(nameoff, nalloc * sizeof(int32))) == NULL)
+	goto nomem;
+      nameoff = p;
+      if ((p = (int32 *) realloc(nomoff, nalloc * sizeof(int32))) == NULL)
+	goto nomem;
+      nomoff = p;
+    }
+    i = cat->nstars;
+    if ((cat->data[i] = fixstar_cat_append(cat, &nbuf, &nbufalloc, s)) < 0)
+      goto nomem;
+    nameoff[i] = nomoff[i] = -1;
+    if ((sp = strchr(s, ',')) == NULL) {
+      if (cat->idamaged < 0) {
+	cat->idamaged = i;
+	cat->fline_damaged = fline;
+      }
+    } else {
+      nomoff[i] = cat->data[i] + (int32) (sp - s);
+      /* traditional name as swe_fixstar() compares it: lower case,
+       * without blanks */
+      *sp = '\0';
+      strncpy(fstar, s, SE_MAX_STNAME);
+      fstar[SE_MAX_STNAME] = '\0';
+      while ((sp = strchr(fstar, ' ')) != NULL)
+	swi_strcpy(sp, sp+1);
+      for (sp = fstar; *sp != '\0'; sp++)
+	*sp = tolower((int) *sp);
+      if ((nameoff[i] = fixstar_cat_append(cat, &nbuf, &nbufalloc, fstar)) < 0)
+	goto nomem;
+      cat->nkeys++;
+    }
+    cat->nstars++;
+  }
+  if (cat->nkeys > 0) {
+    cat->byname = (struct fixstar_key *) malloc(cat->nkeys * sizeof(struct fixstar_key));
+    cat->bynomclat = (struct fixstar_key *) malloc(cat->nkeys * sizeof(struct fixstar_key));
+    if (cat->byname == NULL || cat->bynomclat == NULL)
+      goto nomem;
+    for (i = 0, j = 0; i < cat->nstars; i++) {
+      if (nomoff[i] < 0)
+	continue;
+      cat->byname[j].key = cat->buf + nameoff[i];
+      cat->byname[j].istar = i;
+      cat->bynomclat[j].key = cat->buf + nomoff[i];
+      cat->bynomclat[j].istar = i;
+      j++;
+    }
+    qsort(cat->byname, (size_t) cat->nkeys, sizeof(struct fixstar_key), fixstar_key_cmp);
+    qsort(cat->bynomclat, (size_t) cat->nkeys, sizeof(struct fixstar_key), fixstar_key_cmp);
+  }
+  if (cat->nstars > 0) {
+    double x[6];
+    if ((cat->sx[0] = (double *) malloc(cat->nstars * 8 * sizeof(double))) == NULL
+      || (cat->valid = (char *) calloc((size_t) cat->nstars, 1)) == NULL)
+      goto nomem;
+    for (j = 1; j < 6; j++)
+      cat->sx[j] = cat->sx[0] + j * cat->nstars;
+    cat->parall = cat->sx[0] + 6 * cat->nstars;
+    cat->epoch = cat->sx[0] + 7 * cat->nstars;
+    for (i = 0; i < cat->nstars; i++) {
+      if (fixstar_parse_data(cat->buf + cat->data[i], is_old_starfile, x, &cat->parall[i], &cat->epoch[i]) == OK) {
+	cat->valid[i] = TRUE;
+      } else {
+	for (j = 0; j < 6; j++)
+	  x[j] = 0;
+	cat->parall[i] = cat->epoch[i] = 0;
+      }
+      for (j = 0; j < 6; j++)
+	cat->sx[j][i] = x[j];
+    }
+  }
+  free(nameoff);
+  free(nomoff);
+  return cat;
+  nomem:
+  free(nameoff);
+  free(nomoff);
+  fixstar_cat_free(cat);
+  return NULL;
+}
+
+/* gets the catalogue of the opened star file fp, reading it if no
+ * thread has done it yet. returns NULL if it could not be built; the
+ * star file is then searched line by line, as before. */
+static struct fixstar_cat *fixstar_cat_get(FILE *fp, char *fnam)
+{
+  struct fixstar_cat *cat, **pcat;
+#ifdef SWI_USE_PTHREAD
+  struct stat st;
+  if (file_stat(fp, fnam, &st) != 0)
+    return NULL;
+  pthread_mutex_lock(&fixstar_cats_lock);
+#endif
+  for (pcat = &fixstar_cats; (cat = *pcat) != NULL; ) {
+    if (strcmp(cat->fnam, fnam) == 0) {
+#ifdef SWI_USE_PTHREAD
+      if (cat->dev == st.st_dev && cat->ino == st.st_ino
+	&& cat->size == st.st_size && cat->mtime == st.st_mtime)
+	break;
+      /* the file has changed; forget the old catalogue, unless another
+       * thread still uses it */
+      if (cat->nref == 0) {
+	*pcat = cat->next;
+	fixstar_cat_free(cat);
+	continue;
+      }
+#else
+      break;
+#endif
+    }
+    pcat = &cat->next;
+  }
+  if (cat == NULL && (cat = fixstar_cat_build(fp, fnam, swed.is_old_starfile)) != NULL) {
+#ifdef SWI_USE_PTHREAD
+    cat->dev = st.st_dev;
+    cat->ino = st.st_ino;
+    cat->size = st.st_size;
+    cat->mtime = st.st_mtime;
+#endif
+    cat->next = fixstar_cats;
+    fixstar_cats = cat;
+  }
+  if (cat != NULL)
+    cat->nref++;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_unlock(&fixstar_cats_lock);
+#endif
+  return cat;
+}
+
+/* the calling thread stops using its catalogue. the catalogue itself is
+ * kept, so that the star file need not be read again later. */
+static void fixstar_cat_release(void)
+{
+  if (swed.fixcat == NULL)
+    return;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_lock(&fixstar_cats_lock);
+#endif
+  swed.fixcat->nref--;
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_unlock(&fixstar_cats_lock);
+#endif
+  swed.fixcat = NULL;
+}
+
+static char *fixstar_cat_data(struct fixstar_cat *cat, int32 istar)
+{
+  return cat->buf + cat->data[istar];
+}
+
+/* looks a star up in the catalogue, the same way as the star file is
+ * searched by swe_fixstar(): by sequence number (star_nr > 0), by the
+ * beginning of the nomenclature name (isnomclat, sstar starts with ',')
+ * or by the beginning of the traditional name (lower case).
+ * returns the index of the star, -1 if it was not found, or -2 if the
+ * star file is damaged before the star (serr is set then) */
+static int32 fixstar_cat_find(struct fixstar_cat *cat, char *sstar, int star_nr, AS_BOOL isnomclat, char *serr)
+{
+  char key[SE_MAX_STNAME + 1], *sp;
+  int32 istar;
+  if (star_nr > 0)
+    return (star_nr <= cat->nstars) ? star_nr - 1 : -1;
+  strncpy(key, sstar, SE_MAX_STNAME);
+  key[SE_MAX_STNAME] = '\0';
+  while ((sp = strchr(key, ' ')) != NULL)
+    swi_strcpy(sp, sp+1);
+  if (isnomclat)
+    istar = fixstar_key_search(cat->bynomclat, cat->nkeys, key);
+  else
+    istar = fixstar_key_search(cat->byname, cat->nkeys, key);
+  if (cat->idamaged >= 0 && (istar < 0 || cat->idamaged < istar)) {
+    if (serr != NULL)
+      sprintf(serr, "star file %s damaged at line %d", SE_STARFILE, cat->fline_damaged);
+    return -2;
+  }
+  return istar;
+}
+
+/* opens the star file, and gets the in-memory catalogue for it */
+static int32 open_fixstar_file(char *serr)
+{
+  if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE, swed.ephepath, serr)) == NULL) {
+    swed.is_old_starfile = TRUE;
+    if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE_OLD, swed.ephepath, NULL)) == NULL) {
+      swed.is_old_starfile = FALSE;
+      return ERR;
+    }
+  }
+  swed.fixcat = fixstar_cat_get(swed.fixfp, swed.fidat[SEI_FILE_FIXSTAR].fnam);
+  return OK;
+}
+
+/**********************************************************
+ * load the star file into memory. afterwards swe_fixstar(),
+ * swe_fixstar_ut(), swe_fixstar_mag() and swe_fixstar_index()
+ * look stars up in memory, without reading the file again.
+ * the catalogue is shared by all threads.
+ * returns the number of stars in the catalogue, or ERR
+**********************************************************/
+int32 CALL_CONV swe_fixstar_load(char *serr)
+{
+  if (serr != NULL)
+    *serr = '\0';
+  swi_init_swed_if_start();
+  if (swed.fixfp == NULL && open_fixstar_file(serr) == ERR)
+    return ERR;
+  if (swed.fixcat == NULL)
+    swed.fixcat = fixstar_cat_get(swed.fixfp, swed.fidat[SEI_FILE_FIXSTAR].fnam);
+  if (swed.fixcat == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "star file %s could not be loaded into memory", SE_STARFILE);
+    return ERR;
+  }
+  return swed.fixcat->nstars;
+}
+
+/**********************************************************
+ * get the sequence number of a star in the star file
+ * parameters:
+ * star 	name of star or line number in star file, as for
+ *		swe_fixstar(). If no error occurs, the name of the star
+ *		is returned in the format trad_name, nomeclat_name
+ * serr		error return string
+ * returns the sequence number (starting from 1), or ERR
+**********************************************************/
+int32 CALL_CONV swe_fixstar_index(char *star, char *serr)
+{
+  int i;
+  int star_nr = 0;
+  int32 istar;
+  AS_BOOL isnomclat = FALSE;
+  char *cpos[20];
+  char sstar[SE_MAX_STNAME + 1];
+  char s[AS_MAXCH], *sp;
+  if (swe_fixstar_load(serr) == ERR)
+    return ERR;
+  strncpy(sstar, star, SE_MAX_STNAME);
+  sstar[SE_MAX_STNAME] = '\0';
+  if (*sstar == ',') {
+    isnomclat = TRUE;
+  } else if (isdigit((int) *sstar)) {
+    star_nr = atoi(sstar);
+  } else {
+    /* traditional name of star to lower case */
+    for (sp = sstar; *sp != '\0'; sp++) 
+      *sp = tolower((int) *sp);
+    if ((sp = strchr(sstar, ',')) != NULL)
+      *sp = '\0';
   }
-  /* if truepos is set, turn off grav. defl. and aberration */
-  if (iflag & SEFLG_TRUEPOS)
-    iflag |= (SEFLG_NOGDEFL | SEFLG_NOABERR);
-  if (iflag & SEFLG_MOSEPH)
-    epheflag = SEFLG_MOSEPH;
-  if (iflag & SEFLG_SWIEPH)
-    epheflag = SEFLG_SWIEPH;
-  if (iflag & SEFLG_JPLEPH)
-    epheflag = SEFLG_JPLEPH;
-  if (epheflag == 0)
-    epheflag = SEFLG_DEFAULTEPH;
-  iflag = (iflag & ~SEFLG_EPHMASK) | epheflag;
-  /* SEFLG_JPLHOR only with JPL and Swiss Ephemeeris */
-  if (!(epheflag & SEFLG_JPLEPH)) 
-    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
-  /* planets that have no JPL Horizons mode */
-  if (ipl == SE_OSCU_APOG || ipl == SE_TRUE_NODE 
-      || ipl == SE_MEAN_APOG || ipl == SE_MEAN_NODE
-      || ipl == SE_INTP_APOG || ipl == SE_INTP_PERG) 
-    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
-  if (ipl >= SE_FICT_OFFSET && ipl <= SE_FICT_MAX)
-    iflag = iflag & ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
-  /* SEFLG_JPLHOR requires SEFLG_ICRS, if calculated with * precession/nutation IAU 1980 and corrections dpsi, deps */
-  if (iflag & SEFLG_JPLHOR) {
-    if (swed.eop_dpsi_loaded <= 0 
-       || ((tjd < swed.eop_tjd_beg || tjd > swed.eop_tjd_end) 
-       && jplhor_model != SEMOD_JPLHOR_EXTENDED_1800)) {
-       /*&& !USE_HORIZONS_METHOD_BEFORE_1980)) {*/
-      if (serr != NULL) {
-	switch (swed.eop_dpsi_loaded) {
-	  case 0:
-	    strcpy(serr, "you did not call swe_set_jpl_file(); default to SEFLG_JPLHOR_APPROX");
-	    break;
-	  case -1:
-	    strcpy(serr, "file eop_1962_today.txt not found; default to SEFLG_JPLHOR_APPROX");
-	    break;
-	  case -2:
-	    strcpy(serr, "file eop_1962_today.txt corrupt; default to SEFLG_JPLHOR_APPROX");
-	    break;
-	  case -3:
-	    strcpy(serr, "file eop_finals.txt corrupt; default to SEFLG_JPLHOR_APPROX");
-	    break;
-	}
+  while ((sp = strchr(sstar, ' ')) != NULL)
+    swi_strcpy(sp, sp+1);
+  if (*sstar == '\0') {
+    if (serr != NULL)
+      sprintf(serr, "swe_fixstar_index(): star name empty");
+    return ERR;
+  }
+  if ((istar = fixstar_cat_find(swed.fixcat, sstar, star_nr, isnomclat, serr)) < 0) {
+    if (istar == -1 && serr != NULL) {
+      strcpy(serr, "star  not found");
+      if (strlen(serr) + strlen(star) < AS_MAXCH) {
+	sprintf(serr, "star %s not found", star);
       }
-      iflag &= ~SEFLG_JPLHOR;
-      iflag |= SEFLG_JPLHOR_APPROX;
     }
+    return ERR;
   }
-  if (iflag & SEFLG_JPLHOR) 
-    iflag |= SEFLG_ICRS;
-  /*if ((iflag & SEFLG_JPLHOR_APPROX) && FRAME_BIAS_APPROX_HORIZONS) */
-  /*if ((iflag & SEFLG_JPLHOR_APPROX) && !APPROXIMATE_HORIZONS_ASTRODIENST)*/
-  if ((iflag & SEFLG_JPLHOR_APPROX) && jplhora_model != SEMOD_JPLHORA_1)
-    iflag |= SEFLG_ICRS;
-  return iflag;
+  /* return trad. name, nomeclature name */
+  strcpy(s, fixstar_cat_data(swed.fixcat, istar));
+  i = swi_cutstr(s, ",", cpos, 20);
+  swi_right_trim(cpos[0]);
+  if (strlen(cpos[0]) > SE_MAX_STNAME)
+    cpos[0][SE_MAX_STNAME] = '\0';
+  strcpy(star, cpos[0]);
+  if (i > 1) {
+    swi_right_trim(cpos[1]);
+    if (strlen(cpos[1]) > SE_MAX_STNAME-1)
+      cpos[1][SE_MAX_STNAME-1] = '\0';
+    if (strlen(cpos[0]) + strlen(cpos[1]) + 1 < SE_MAX_STNAME - 1)
+      sprintf(star + strlen(star), ",%s", cpos[1]);
+  }
+  return istar + 1;
 }
 
 /**********************************************************
@@ -5693,8 +7887,7 @@ int32 CALL_CONV swe_fixstar(char *star, double tjd, int32 iflag,
       swed.jpl_file_is_open = FALSE;
     }
     for (i = 0; i < SEI_NEPHFILES; i ++) {
-      if (swed.fidat[i].fptr != NULL) 
-	fclose(swed.fidat[i].fptr);
+      close_ephe_file(&swed.fidat[i]);
       memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
     }
     swed.last_epheflag = epheflag;
@@ -5747,10 +7940,7 @@ int32 CALL_CONV swe_fixstar(char *star, double tjd, int32 iflag,
    * Comment lines start with # and are ignored.
    ******************************************************/
   if (swed.fixfp == NULL) {
-    if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE, swed.ephepath, serr)) == NULL) {
-      swed.is_old_starfile = TRUE;
-      if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE_OLD, swed.ephepath, NULL)) == NULL) {
-	swed.is_old_starfile = FALSE;
+    if (open_fixstar_file(serr) == ERR) {
 	/* no fixed star file available. If Spica is called, we provide it
 	 * even without a star file, because Spica is required for the
 	 * Ayanamsha SE_SIDM_TRUE_CITRA */
@@ -5769,10 +7959,20 @@ int32 CALL_CONV swe_fixstar(char *star, double tjd, int32 iflag,
 	  strcpy(sstar, "pushya");
 	  goto found;
 	}
-	retc = ERR;
-	goto return_err;
-      }
+      retc = ERR;
+      goto return_err;
+    }
+  }
+  /* look the star up in the in-memory catalogue, if it could be built */
+  if (swed.fixcat != NULL) {
+    if ((i = fixstar_cat_find(swed.fixcat, sstar, star_nr, isnomclat, serr)) >= 0) {
+      strcpy(s, fixstar_cat_data(swed.fixcat, i));
+      goto found;
     }
+    if (i == -1)
+      goto not_found;
+    retc = ERR;
+    goto return_err;
   }
   rewind(swed.fixfp);
   while (fgets(s, AS_MAXCH, swed.fixfp) != NULL) {
@@ -5812,6 +8012,7 @@ int32 CALL_CONV swe_fixstar(char *star, double tjd, int32 iflag,
     if (strncmp(fstar, sstar, cmplen) == 0) 
       goto found;
   }
+  not_found:
   if (serr != NULL) {
     sprintf(serr, "star  not found");
     if (strlen(serr) + strlen(star) < AS_MAXCH) {
@@ -6141,6 +8342,334 @@ int32 CALL_CONV swe_fixstar_ut(char *star, double tjd_ut, int32 iflag,
   return retflag;
 }
 
+/**********************************************************
+ * get the positions of all stars of the star file
+ * parameters:
+ * tjd 		absolute julian day
+ * iflag	s. swecalc(); SEFLG_EQUATORIAL, SEFLG_XYZ and the speed
+ *		flag are ignored
+ * lon, lat	arrays for returning the ecliptic longitudes and latitudes
+ * ra, dec	arrays for returning the right ascensions and declinations
+ * serr		error return string
+ * each array must have room for as many values as swe_fixstar_load()
+ * returns; any of them may be NULL. stars with incomplete data get 0.
+ * the stars are computed together, stage by stage, in loops over
+ * arrays that the compiler can vectorize.
+**********************************************************/
+
+/* applies a linear transformation of positions (given by its 3 x 3
+ * matrix m, m[i] being the image of the i-th unit vector) to n stars */
+static void fixstar_rotate(double m[3][3], double *x, double *y, double *z, double *xn, double *yn, double *zn, int32 n)
+{
+  int32 i;
+  double x0, y0, z0;
+  for (i = 0; i < n; i++) {
+    x0 = x[i];
+    y0 = y[i];
+    z0 = z[i];
+    xn[i] = m[0][0] * x0 + m[1][0] * y0 + m[2][0] * z0;
+    yn[i] = m[0][1] * x0 + m[1][1] * y0 + m[2][1] * z0;
+    zn[i] = m[0][2] * x0 + m[1][2] * y0 + m[2][2] * z0;
+  }
+}
+
+/* cartesian to polar coordinates, degrees or radians */
+static void fixstar_polar(double *x, double *y, double *z, double *lon, double *lat, int32 n, int32 iflag)
+{
+  int32 i;
+  double f = (iflag & SEFLG_RADIANS) ? 1.0 : RADTODEG;
+  for (i = 0; i < n; i++) {
+    double l = atan2(y[i], x[i]);
+    if (l < 0.0)
+      l += TWOPI;
+    if (lon != NULL)
+      lon[i] = l * f;
+    if (lat != NULL)
+      lat[i] = atan2(z[i], sqrt(x[i] * x[i] + y[i] * y[i])) * f;
+  }
+}
+
+/* swe_fixstar_all() for the flags its vectorized code does not cover:
+ * every star is computed by swe_fixstar() */
+static int32 fixstar_all_each(double tjd, int32 iflag, double *lon, double *lat, double *ra, double *dec, int32 nstars, char *serr)
+{
+  int32 i, retflag = iflag;
+  double xx[6];
+  char star[SE_MAX_STNAME * 2];
+  for (i = 0; i < nstars; i++) {
+    if (lon != NULL || lat != NULL) {
+      sprintf(star, "%d", i + 1);
+      if ((retflag = swe_fixstar(star, tjd, iflag & ~SEFLG_EQUATORIAL, xx, NULL)) == ERR)
+	xx[0] = xx[1] = 0;
+      if (lon != NULL) lon[i] = xx[0];
+      if (lat != NULL) lat[i] = xx[1];
+    }
+    if (ra != NULL || dec != NULL) {
+      sprintf(star, "%d", i + 1);
+      if ((retflag = swe_fixstar(star, tjd, iflag | SEFLG_EQUATORIAL, xx, NULL)) == ERR)
+	xx[0] = xx[1] = 0;
+      if (ra != NULL) ra[i] = xx[0];
+      if (dec != NULL) dec[i] = xx[1];
+    }
+  }
+  if (retflag == ERR && serr != NULL)
+    sprintf(serr, "swe_fixstar_all(): star %d could not be computed", nstars);
+  return retflag;
+}
+
+int32 CALL_CONV swe_fixstar_all(double tjd, int32 iflag, double *lon, double *lat, double *ra, double *dec, char *serr)
+{
+  struct fixstar_cat *cat;
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *psdp = &swed.pldat[SEI_SUNBARY];
+  struct epsilon *oe;
+  int32 i, j, nstars, epheflag, iflgsave, denum;
+  int retc;
+  double m[3][3], mcat[3][3], mecl[3][3];
+  double xobs[6], xearth[6], e[3], v[3], xx[6];
+  double *X, *Y, *Z, *G, *wbuf;
+  double re, sin_sunr, g0, v2, b_1;
+  double *sx[6];
+  if (serr != NULL)
+    *serr = '\0';
+  if ((nstars = swe_fixstar_load(serr)) == ERR)
+    return ERR;
+  if (nstars == 0)
+    return iflag;
+  cat = swed.fixcat;
+  iflag |= SEFLG_SPEED; /* as swe_fixstar() */
+  iflag &= ~(SEFLG_EQUATORIAL | SEFLG_XYZ);
+  iflgsave = iflag;
+  iflag = plaus_iflag(iflag, -1, tjd, serr);
+  if (iflag & (SEFLG_HELCTR | SEFLG_BARYCTR | SEFLG_SIDEREAL | SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX))
+    return fixstar_all_each(tjd, iflgsave, lon, lat, ra, dec, nstars, serr);
+  epheflag = iflag & SEFLG_EPHMASK;
+  if (swed.last_epheflag != epheflag) {
+    free_planets();
+    /* close and free ephemeris files */
+    if (swed.jpl_file_is_open) {
+      swi_close_jpl_file();
+      swed.jpl_file_is_open = FALSE;
+    }
+    for (i = 0; i < SEI_NEPHFILES; i ++) {
+      close_ephe_file(&swed.fidat[i]);
+      memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
+    }
+    swed.last_epheflag = epheflag;
+  }
+  swi_check_ecliptic(tjd, iflag);
+  swi_check_nutation(tjd, iflag);
+  /* earth, for parallax, light deflection and aberration */
+  if ((retc = main_planet(tjd, SEI_EARTH, epheflag, iflag, serr)) != OK)
+    return ERR;
+  iflag = swed.pldat[SEI_EARTH].xflgs;
+  if (iflag & SEFLG_TOPOCTR) {
+    if (swi_get_observer(pedp->teval, iflag | SEFLG_NONUT, NO_SAVE, xobs, serr) != OK)
+      return ERR;
+    for (i = 0; i <= 5; i++)
+      xobs[i] = xobs[i] + pedp->x[i];
+  } else {
+    for (i = 0; i <= 5; i++)
+      xobs[i] = pedp->x[i];
+  }
+  if ((wbuf = (double *) malloc(nstars * 4 * sizeof(double))) == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_fixstar_all(): not enough memory");
+    return ERR;
+  }
+  X = wbuf;
+  Y = wbuf + nstars;
+  Z = wbuf + 2 * nstars;
+  G = wbuf + 3 * nstars;
+  for (j = 0; j < 6; j++)
+    sx[j] = cat->sx[j];
+  /******************************************
+   * FK5 -> ICRF (-> J2000) of the catalogue,
+   * and proper motion
+   ******************************************/
+  denum = get_denum(SEI_SUN, iflag);
+  for (j = 0; j < 3; j++) {
+    for (i = 0; i <= 5; i++)
+      xx[i] = (i == j) ? 1 : 0;
+    swi_icrs2fk5(xx, iflag, TRUE);
+    if (denum >= 403)
+      swi_bias(xx, J2000, SEFLG_SPEED, FALSE);
+    for (i = 0; i <= 2; i++)
+      mcat[j][i] = xx[i];
+  }
+  for (i = 0; i < nstars; i++) {
+    double t = tjd - J2000;
+    double x0 = sx[0][i], y0 = sx[1][i], z0 = sx[2][i];
+    double vx = sx[3][i], vy = sx[4][i], vz = sx[5][i];
+    double p = cat->parall[i];
+    if (cat->epoch[i] != 0) {
+      x0 = mcat[0][0] * sx[0][i] + mcat[1][0] * sx[1][i] + mcat[2][0] * sx[2][i];
+      y0 = mcat[0][1] * sx[0][i] + mcat[1][1] * sx[1][i] + mcat[2][1] * sx[2][i];
+      z0 = mcat[0][2] * sx[0][i] + mcat[1][2] * sx[1][i] + mcat[2][2] * sx[2][i];
+      vx = mcat[0][0] * sx[3][i] + mcat[1][0] * sx[4][i] + mcat[2][0] * sx[5][i];
+      vy = mcat[0][1] * sx[3][i] + mcat[1][1] * sx[4][i] + mcat[2][1] * sx[5][i];
+      vz = mcat[0][2] * sx[3][i] + mcat[1][2] * sx[4][i] + mcat[2][2] * sx[5][i];
+    }
+    X[i] = (x0 + t * vx - p * xobs[0]) * 10000;
+    Y[i] = (y0 + t * vy - p * xobs[1]) * 10000;
+    Z[i] = (z0 + t * vz - p * xobs[2]) * 10000;
+  }
+  /* stars of epoch 1950 need FK4 -> FK5 first; they are rare */
+  for (i = 0; i < nstars; i++) {
+    if (cat->epoch[i] != 1950)
+      continue;
+    for (j = 0; j <= 5; j++)
+      xx[j] = sx[j][i];
+    swi_FK4_FK5(xx, B1950);
+    swi_precess(xx, B1950, 0, J_TO_J2000);
+    swi_precess(xx+3, B1950, 0, J_TO_J2000);
+    swi_icrs2fk5(xx, iflag, TRUE);
+    if (denum >= 403)
+      swi_bias(xx, J2000, SEFLG_SPEED, FALSE);
+    X[i] = (xx[0] + (tjd - B1950) * xx[3] - cat->parall[i] * xobs[0]) * 10000;
+    Y[i] = (xx[1] + (tjd - B1950) * xx[4] - cat->parall[i] * xobs[1]) * 10000;
+    Z[i] = (xx[2] + (tjd - B1950) * xx[5] - cat->parall[i] * xobs[2]) * 10000;
+  }
+  /************************************
+   * relativistic deflection of light *
+   ************************************/
+  if ((iflag & SEFLG_TRUEPOS) == 0 && (iflag & SEFLG_NOGDEFL) == 0) {
+    /* seen from the geocenter even for topocentric positions, as
+     * swe_fixstar() passes only SEFLG_SPEED to swi_deflect_light() */
+    for (i = 0; i <= 5; i++)
+      xearth[i] = pedp->x[i];
+    if (pedp->iephe == SEFLG_JPLEPH || pedp->iephe == SEFLG_SWIEPH) {
+      for (i = 0; i <= 2; i++) {
+	e[i] = xearth[i] - psdp->x[i];
+	xx[i] = xearth[i] - psdp->x[i];
+      }
+    } else {
+      for (i = 0; i <= 2; i++) {
+	e[i] = xearth[i];
+	xx[i] = xearth[i] - psdp->x[i];
+      }
+    }
+    re = sqrt(square_sum(e));
+    for (i = 0; i <= 2; i++)
+      e[i] /= re;
+    sin_sunr = SUN_RADIUS / re;
+    g0 = 2.0 * HELGRAVCONST / CLIGHT / CLIGHT / AUNIT / re;
+    /* angular distance from the sun, in sun radii */
+    for (i = 0; i < nstars; i++) {
+      double ue = (X[i] * e[0] + Y[i] * e[1] + Z[i] * e[2])
+		  / sqrt(X[i] * X[i] + Y[i] * Y[i] + Z[i] * Z[i]);
+      G[i] = sqrt(1 - ue * ue) / sin_sunr;
+    }
+    /* stars behind the solar disc, s. swi_deflect_light() */
+    for (i = 0; i < nstars; i++)
+      G[i] = (G[i] < 1) ? g0 * meff(G[i]) : g0;
+    for (i = 0; i < nstars; i++) {
+      double ux = X[i], uy = Y[i], uz = Z[i];
+      double qx = ux + xx[0], qy = uy + xx[1], qz = uz + xx[2];
+      double ru = sqrt(ux * ux + uy * uy + uz * uz);
+      double rq = sqrt(qx * qx + qy * qy + qz * qz);
+      double uq, ue, qe, g1;
+      ux /= ru; uy /= ru; uz /= ru;
+      qx /= rq; qy /= rq; qz /= rq;
+      uq = ux * qx + uy * qy + uz * qz;
+      ue = ux * e[0] + uy * e[1] + uz * e[2];
+      qe = qx * e[0] + qy * e[1] + qz * e[2];
+      g1 = G[i] / (1.0 + qe);
+      X[i] = ru * (ux + g1 * (uq * e[0] - ue * qx));
+      Y[i] = ru * (uy + g1 * (uq * e[1] - ue * qy));
+      Z[i] = ru * (uz + g1 * (uq * e[2] - ue * qz));
+    }
+  }
+  /**********************************
+   * 'annual' aberration of light   *
+   **********************************/
+  if ((iflag & SEFLG_TRUEPOS) == 0 && (iflag & SEFLG_NOABERR) == 0) {
+    for (i = 0; i <= 2; i++) 
+      v[i] = xobs[i+3] / 24.0 / 3600.0 / CLIGHT * AUNIT;
+    v2 = square_sum(v);
+    b_1 = sqrt(1 - v2);
+    for (i = 0; i < nstars; i++) {
+      double ru = sqrt(X[i] * X[i] + Y[i] * Y[i] + Z[i] * Z[i]);
+      double f1 = (X[i] * v[0] + Y[i] * v[1] + Z[i] * v[2]) / ru;
+      double f2 = 1.0 + f1 / (1.0 + b_1);
+      X[i] = (b_1 * X[i] + f2 * ru * v[0]) / (1.0 + f1);
+      Y[i] = (b_1 * Y[i] + f2 * ru * v[1]) / (1.0 + f1);
+      Z[i] = (b_1 * Z[i] + f2 * ru * v[2]) / (1.0 + f1);
+    }
+  }
+  /************************************************
+   * ICRS -> J2000, precession and nutation are   *
+   * rotations; they are combined into one matrix *
+   ************************************************/
+  for (j = 0; j < 3; j++) {
+    for (i = 0; i <= 5; i++)
+      xx[i] = (i == j) ? 1 : 0;
+    if (!(iflag & SEFLG_ICRS) && denum >= 403)
+      swi_bias(xx, tjd, iflag & ~SEFLG_SPEED, FALSE);
+    if ((iflag & SEFLG_J2000) == 0)
+      swi_precess(xx, tjd, iflag, J2000_TO_J);
+    if (!(iflag & SEFLG_NONUT))
+      swi_nutate(xx, 0, FALSE);
+    for (i = 0; i <= 2; i++)
+      m[j][i] = xx[i];
+  }
+  if ((iflag & SEFLG_J2000) == 0)
+    oe = &swed.oec;
+  else
+    oe = &swed.oec2000;
+  for (j = 0; j < 3; j++) {
+    for (i = 0; i <= 2; i++)
+      xx[i] = (i == j) ? 1 : 0;
+    swi_coortrf2(xx, xx, oe->seps, oe->ceps);
+    if (!(iflag & SEFLG_NONUT))
+      swi_coortrf2(xx, xx, swed.nut.snut, swed.nut.cnut);
+    for (i = 0; i <= 2; i++)
+      mecl[j][i] = xx[i];
+  }
+  fixstar_rotate(m, X, Y, Z, X, Y, Z, nstars);
+  if (ra != NULL || dec != NULL)
+    fixstar_polar(X, Y, Z, ra, dec, nstars, iflag);
+  if (lon != NULL || lat != NULL) {
+    fixstar_rotate(mecl, X, Y, Z, X, Y, Z, nstars);
+    fixstar_polar(X, Y, Z, lon, lat, nstars, iflag);
+  }
+  for (i = 0; i < nstars; i++) {
+    if (cat->valid[i])
+      continue;
+    if (lon != NULL) lon[i] = 0;
+    if (lat != NULL) lat[i] = 0;
+    if (ra != NULL) ra[i] = 0;
+    if (dec != NULL) dec[i] = 0;
+  }
+  free(wbuf);
+  /* if no ephemeris has been specified, do not return chosen ephemeris */
+  if ((iflgsave & SEFLG_EPHMASK) == 0)
+    iflag = iflag & ~SEFLG_DEFAULTEPH;
+  iflag = iflag & ~SEFLG_SPEED;
+  return iflag;
+}
+
+int32 CALL_CONV swe_fixstar_all_ut(double tjd_ut, int32 iflag, double *lon, double *lat, double *ra, double *dec, char *serr)
+{
+  double deltat;
+  int32 retflag;
+  int32 epheflag = 0;
+  iflag = plaus_iflag(iflag, -1, tjd_ut, serr);
+  epheflag = iflag & SEFLG_EPHMASK;
+  if (epheflag == 0) {
+    epheflag = SEFLG_SWIEPH;
+    iflag |= SEFLG_SWIEPH;
+  }
+  deltat = swe_deltat_ex(tjd_ut, iflag, serr);
+  /* if ephe required is not ephe returned, adjust delta t: */
+  retflag = swe_fixstar_all(tjd_ut + deltat, iflag, lon, lat, ra, dec, serr);
+  if (retflag != ERR && (retflag & SEFLG_EPHMASK) != epheflag) {
+    deltat = swe_deltat_ex(tjd_ut, retflag, NULL);
+    retflag = swe_fixstar_all(tjd_ut + deltat, iflag, lon, lat, ra, dec, NULL);
+  }
+  return retflag;
+}
+
 /**********************************************************
  * get fixstar magnitude
  * parameters:
@@ -6175,12 +8704,9 @@ int32 CALL_CONV swe_fixstar_mag(char *star, double *mag, char *serr)
    * Comment lines start with # and are ignored.
    ******************************************************/
   if (swed.fixfp == NULL) {
-    if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE, swed.ephepath, serr)) == NULL) {
-      swed.is_old_starfile = TRUE;
-      if ((swed.fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE_OLD, swed.ephepath, NULL)) == NULL) {
-	retc = ERR;
-	goto return_err;
-      }
+    if (open_fixstar_file(serr) == ERR) {
+      retc = ERR;
+      goto return_err;
     }
   }
   rewind(swed.fixfp);
@@ -6205,6 +8731,16 @@ int32 CALL_CONV swe_fixstar_mag(char *star, double *mag, char *serr)
     retc = ERR;
     goto return_err;
   }
+  if (swed.fixcat != NULL) {
+    if ((i = fixstar_cat_find(swed.fixcat, sstar, star_nr, isnomclat, serr)) >= 0) {
+      strcpy(s, fixstar_cat_data(swed.fixcat, i));
+      goto found;
+    }
+    if (i == -1)
+      goto not_found;
+    retc = ERR;
+    goto return_err;
+  }
   while (fgets(s, AS_MAXCH, swed.fixfp) != NULL) {
     fline++;	
     if (*s == '#') continue;
@@ -6240,6 +8776,7 @@ int32 CALL_CONV swe_fixstar_mag(char *star, double *mag, char *serr)
     if (strncmp(fstar, sstar, cmplen) == 0) 
       goto found;
   }
+  not_found:
   if (serr != NULL) {
     strcpy(serr, "star  not found");
     if (strlen(serr) + strlen(star) < AS_MAXCH) {
@@ -6614,10 +9151,22 @@ static void trace_swe_get_planet_name(int swtch, int ipl, char *s)
 
 #endif
 
+/* number of times swe_set_topo() invalidated the saved positions in this
+ * thread */
+static TLS int32 topo_reset_count = 0;
+
 /* set geographic position and altitude of observer */
 void CALL_CONV swe_set_topo(double geolon, double geolat, double geoalt)
 {
   swi_init_swed_if_start();
+  /* same observer as before: the observer position vector and the saved
+   * planet positions are still valid */
+  if (swed.geopos_is_set
+      && swed.topd.geolon == geolon
+      && swed.topd.geolat == geolat
+      && swed.topd.geoalt == geoalt)
+    return;
+  topo_reset_count++;
   swed.topd.geolon = geolon;
   swed.topd.geolat = geolat;
   swed.topd.geoalt = geoalt;
@@ -6629,6 +9178,12 @@ void CALL_CONV swe_set_topo(double geolon, double geolat, double geoalt)
   swi_force_app_pos_etc();
 }
 
+/* get the number of times the observer position actually changed */
+int32 CALL_CONV swe_get_topo_reset_count(void)
+{
+  return topo_reset_count;
+}
+
 void swi_force_app_pos_etc()
 {
   int i;
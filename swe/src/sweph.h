@@ -486,11 +486,20 @@ struct plantbl {
 
 struct file_data {
   char fnam[AS_MAXCH];	/* ephemeris file name */
+  char gnam[AS_MAXCH];	/* name the file was looked for, as made by
+			 * swi_gen_filename(); identifies it in the
+			 * pool of open files */
   int fversion;		/* version number of file */
   char astnam[50];	/* asteroid name, if asteroid file */ 
   int32 sweph_denum;     /* DE number of JPL ephemeris, which this file
 			 * is derived from. */
   FILE *fptr;		/* ephemeris file pointer */
+  unsigned char *mdata;	/* memory mapped file contents, or NULL if the
+			 * file is read through fptr */
+  int32 mlen;		/* length of mdata */
+  int32 mpos;		/* current read position in mdata */
+  struct seg_cache_file *sfile;	/* identifies the file in the segment
+			 * cache (s. sweph.c), or NULL */
   double tfstart;       /* file may be used from this date */
   double tfend;         /*      through this date          */
   int32 iflg; 		/* byte reorder flag and little/bigendian flag */
@@ -547,6 +556,120 @@ struct sid_data {
   double t0;
 };
 
+/* cache of decoded (and rotated) chebyshew segments, so that going back
+ * and forth between dates does not read and unpack the same segments
+ * again and again. there is one cache for all threads (s. sweph.c); 
+ * a thread copies the segments it needs into its own swed.pldat[] */
+#define SEI_SEGCACHE_NHASH	256
+#define SEI_SEGCACHE_DEFAULT_SIZE	(1024L * 1024L)	/* bytes */
+
+struct seg_cache_entry {
+  struct seg_cache_file *sfile;	/* the file the segment was read from */
+  int ipli;		/* internal planet number */
+  int ibdy;		/* internal body number (asteroid number) */
+  int32 iseg;		/* segment number in the file */
+  double tseg0, tseg1;	/* start and end jd of the segment */
+  int ncoe;		/* # of coefficients per coordinate */
+  int neval;		/* how many coefficients to evaluate */
+  double *segp;		/* 3 x ncoe coefficients */
+  struct seg_cache_entry *prev, *next;	/* LRU list, most recent first */
+  struct seg_cache_entry *hnext;	/* hash chain */
+};
+
+struct seg_cache {
+  struct seg_cache_entry *head, *tail;
+  struct seg_cache_entry *hash[SEI_SEGCACHE_NHASH];
+  AS_BOOL size_is_set;	/* if not, SEI_SEGCACHE_DEFAULT_SIZE is used */
+  int32 size;		/* memory budget, bytes */
+  int32 used;		/* memory used by the entries, bytes */
+};
+
+/* ephemeris files that sweph() stops using, because another asteroid
+ * or another time range is needed, are kept open in a pool of the
+ * calling thread, most recently used first, so that going back to them
+ * costs nothing; s. swe_set_ephe_file_pool_size() */
+#define SEI_FILEPOOL_DEFAULT_SIZE	16	/* files */
+
+struct pooled_file {
+  int ifno;		/* SEI_FILE_PLANET etc. */
+  struct file_data fd;
+  struct pooled_file *next;
+};
+
+/* ephemeris bundle: ephemeris files packed into one file or block of
+ * memory, s. swe_set_ephe_bundle(). all numbers are 32 bit little endian
+ * integers:
+ *   0	SEI_BUNDLE_MAGIC
+ *   8	number of files n
+ *  12	0 (reserved)
+ *  16	n directory entries of SEI_BUNDLE_DIRENT bytes each: the name of
+ *	the file, relative to the ephemeris path, with '/' between 
+ *	directories, 0-terminated, in SEI_BUNDLE_NAMELEN bytes; the offset
+ *	of the contents of the file from the start of the bundle; and the
+ *	length of the file
+ * the contents of the files follow, each one aligned to 8 bytes.
+ * the files of the bundle get names that start with SEI_BUNDLE_DIR. */
+#define SEI_BUNDLE_MAGIC	"SWEBNDL1"
+#define SEI_BUNDLE_NAMELEN	56
+#define SEI_BUNDLE_DIRENT	(SEI_BUNDLE_NAMELEN + 8)
+#define SEI_BUNDLE_DIR		"<bundle>/"
+
+/* files that swi_fopen() has not found in the ephemeris path of the
+ * calling thread. they are not looked for again, until the path is set
+ * again or swe_close() is called. */
+#define SEI_FILEMISS_MAX	64
+
+struct file_miss {
+  uint32 key;		/* hash of fname */
+  char *fname;
+  char *msg;		/* the error message of swi_fopen() */
+  struct file_miss *next;
+};
+
+struct fixstar_cat;
+
+/* the delta t table, s. init_dt() in swephlib.c */
+struct deltat_tab;
+
+/* values of nutation and obliquity at fixed steps, from which they are
+ * interpolated for any date, instead of summing the series every time;
+ * s. swe_set_interpolate_nut(). cubic interpolation between nodes
+ * SEI_NUTTAB_STEP days apart keeps the error of the IAU 2000A/B
+ * nutation below 0.00005" over +-8000 years (the terms with the
+ * shortest periods, 5.6 and 9.1 days, dominate it). every node that
+ * is not cached yet costs a full series evaluation, so the table only
+ * pays off for dates close to each other, as in a sweep. */
+#define SEI_NUTTAB_SIZE		64	/* cached nodes, a power of 2 */
+#define SEI_NUTTAB_STEP		0.5	/* days */
+#define SEI_EPSTAB_STEP		16.0	/* days; the shortest period of the
+					 * obliquity is 400 years */
+struct interp_tab {
+  int32 model;		/* model the values have been computed with */
+  AS_BOOL is_set[SEI_NUTTAB_SIZE];
+  int32 node[SEI_NUTTAB_SIZE];	/* number of steps from J2000 */
+  double val[SEI_NUTTAB_SIZE][2];
+};
+
+/* state of swe_calc_series(): for each body, the positions at a block
+ * of the dates of the series that fall into the current ephemeris segment
+ * are evaluated together, s. swi_echeb_many() */
+#define SEI_CHEBSER_BLOCK	128
+struct cheb_block {
+  int ibdy;		/* body and segment the block has been */
+  double tseg0;		/* evaluated for */
+  int32 k0;		/* index of the first date of the block */
+  int32 nk;		/* number of dates in the block */
+  double x[6][SEI_CHEBSER_BLOCK];	/* positions and speeds */
+};
+
+struct cheb_series {
+  double tstart, tstep;	/* dates of the series */
+  int32 nsteps;		/* 0, if no series is being computed */
+  int32 kcur;		/* index and date of the date */
+  double tjdcur;	/* swe_calc() is computing */
+  struct cheb_block *blk[SEI_NPLANETS];
+};
+
 /* dpsi and deps loaded for 100 years after 1962 */
 #define SWE_DATA_DPSI_DEPS  36525   
 
@@ -598,6 +721,39 @@ struct swe_data {
   double *deps;
   int32 astro_models[SEI_NMODELS];
   int32 timeout;
+  int32 segcache_hits;	/* lookups of the calling thread in the */
+  int32 segcache_misses;	/* shared segment cache */
+  struct fixstar_cat *fixcat;	/* in-memory fixed star catalogue, shared
+				 * by all threads using the same star file */
+  AS_BOOL interpolate_nut;	/* interpolate nutation and obliquity,
+				 * instead of summing the series for
+				 * every date */
+  struct interp_tab nuttab;
+  struct interp_tab epstab;
+  struct cheb_series chebser;
+  int32 nutflag;	/* iflag of the last nutation computed */
+  struct pooled_file *filepool;	/* files kept open, s. above */
+  int32 filepool_n;
+  AS_BOOL filepool_size_is_set;	/* if not, SEI_FILEPOOL_DEFAULT_SIZE */
+  int32 filepool_size;
+  struct file_miss *filemiss;	/* s. above */
+  int32 nfilemiss;
+  struct deltat_tab *dttab;	/* delta t table, shared by all threads 
+				 * using the same ephemeris path */
 };
 
-extern TLS struct swe_data swed;
+/* the state of the calling thread is in swi_swed_own, unless a 
+ * calculation context is active (s. swe_context_switch()); all code
+ * goes through swed */
+extern TLS struct swe_data swi_swed_own;
+extern TLS struct swe_data *swi_swed_ctx;
+#define swed (*(swi_swed_ctx != NULL ? swi_swed_ctx : &swi_swed_own))
+
+struct jpl_save;
+
+/* a calculation context, s. swe_context_new() */
+struct swe_context {
+  struct swe_data data;
+  struct jpl_save *jpl;	/* state of the JPL reader, s. swejpl.c */
+  AS_BOOL is_active;
+};
@@ -627,6 +627,9 @@ ext_def( int32 ) swe_calc(
 ext_def(int32) swe_calc_ut(double tjd_ut, int32 ipl, int32 iflag, 
 	double *xx, char *serr);
 
+ext_def(int32) swe_calc_series(double tjd_start, double tjd_step,
+	int32 nsteps, int ipl, int32 iflag, double *xx, char *serr);
+
 /* fixed stars */
 ext_def( int32 ) swe_fixstar(
         char *star, double tjd, int32 iflag, 
@@ -638,9 +641,57 @@ ext_def(int32) swe_fixstar_ut(char *star, double tjd_ut, int32 iflag,
 
 ext_def(int32) swe_fixstar_mag(char *star, double *mag, char *serr);
 
+ext_def(int32) swe_fixstar_load(char *serr);
+
+ext_def(int32) swe_fixstar_index(char *star, char *serr);
+
+ext_def(int32) swe_fixstar_all(double tjd, int32 iflag,
+	double *lon, double *lat, double *ra, double *dec, char *serr);
+
+ext_def(int32) swe_fixstar_all_ut(double tjd_ut, int32 iflag,
+	double *lon, double *lat, double *ra, double *dec, char *serr);
+
 /* close Swiss Ephemeris */
 ext_def( void ) swe_close(void);
 
+/* calculation contexts: independent sets of the state of the 
+ * Swiss Ephemeris (ephemeris path, open files, observer position, 
+ * sidereal mode, saved positions) that a thread can switch between */
+struct swe_context;
+
+ext_def(struct swe_context *) swe_context_new(void);
+
+ext_def(int32) swe_context_switch(struct swe_context *ctx, char *serr);
+
+ext_def(struct swe_context *) swe_context_get_current(void);
+
+ext_def(void) swe_context_free(struct swe_context *ctx);
+
+/* set the memory budget of the decoded ephemeris segment cache, which is
+ * shared by all threads, in bytes; 0 disables the cache */
+ext_def( void ) swe_set_segment_cache_size(int32 nbytes);
+
+/* get the hit and miss counts of the calling thread in the decoded
+ * ephemeris segment cache, and the memory used by the cache */
+ext_def( void ) swe_get_segment_cache_stats(int32 *hits, int32 *misses, int32 *used);
+
+/* set how many ephemeris files the calling thread keeps open while it
+ * does not use them (e.g. the files of asteroids computed before);
+ * 0 closes them at once */
+ext_def( void ) swe_set_ephe_file_pool_size(int32 nfiles);
+
+/* use the ephemeris files packed into a bundle in memory, of len bytes,
+ * before the files of the ephemeris path; NULL stops using it */
+ext_def( int32 ) swe_set_ephe_bundle(unsigned char *data, int32 len, char *serr);
+
+/* use the ephemeris files packed into the bundle file fname */
+ext_def( int32 ) swe_open_ephe_bundle(char *fname, char *serr);
+
+/* write a copy of the ephemeris file fin to fout, with only the bodies
+ * ipl[0..nipl-1] (all with ipl == NULL) between tjd_start and tjd_end;
+ * returns -2 if nothing of fin is in the range */
+ext_def( int32 ) swe_compact_ephe_file(char *fin, char *fout, double tjd_start, double tjd_end, int32 *ipl, int32 nipl, char *serr);
+
 /* set directory path of ephemeris files */
 ext_def( void ) swe_set_ephe_path(char *path);
 
@@ -653,6 +704,10 @@ ext_def( char *) swe_get_planet_name(int ipl, char *spname);
 /* set geographic position of observer */
 ext_def (void) swe_set_topo(double geolon, double geolat, double geoalt);
 
+/* get the number of times swe_set_topo() changed the observer position in
+ * the calling thread */
+ext_def (int32) swe_get_topo_reset_count(void);
+
 /* set sidereal mode */
 ext_def(void) swe_set_sid_mode(int32 sid_mode, double t0, double ayan_t0);
 
@@ -708,6 +763,8 @@ ext_def(void) swe_utc_time_zone(
 	int32 *iyear_out, int32 *imonth_out, int32 *iday_out,
 	int32 *ihour_out, int32 *imin_out, double *dsec_out);
 
+ext_def(int32) swe_get_leap_seconds(const int32 **dates);
+
 /**************************** 
  * exports from swehouse.c 
  ****************************/
@@ -856,6 +913,11 @@ ext_def( void ) swe_cotrans_sp(double *xpo, double *xpn, double eps);
 ext_def( double ) swe_get_tid_acc(void);
 ext_def( void ) swe_set_tid_acc(double t_acc);
 
+/* interpolate nutation and obliquity from a table, for sweeps over
+ * close dates (error below 0.00005"), or sum the series for every
+ * date (default) */
+ext_def( void ) swe_set_interpolate_nut(AS_BOOL do_interpolate);
+
 ext_def( double ) swe_degnorm(double x);
 ext_def( double ) swe_radnorm(double x);
 ext_def( double ) swe_rad_midp(double x1, double x0);
@@ -81,6 +81,17 @@
 #if MSDOS
 # include <process.h>
 #endif
+/* SIMD kernels for the evaluation of chebyshew series, selected at
+ * runtime according to the cpu; s. swi_echeb_many() */
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# define SWI_USE_PTHREAD
+# include <pthread.h>
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__)) && !defined(SWI_NO_SIMD)
+# define SWI_USE_X86_SIMD
+# include <immintrin.h>
+#endif
 
 #ifdef TRACE
 void swi_open_trace(char *serr);
@@ -90,12 +101,14 @@ TLS int32 swi_trace_count = 0;
 #endif
 
 static void init_crc32(void);
-static int init_dt(void);
+static struct deltat_tab *init_dt(void);
 static double adjust_for_tidacc(double ans, double Y, double tid_acc);
 static double deltat_espenak_meeus_1620(double tjd, double tid_acc);
 static double deltat_longterm_morrison_stephenson(double tjd);
 static double deltat_stephenson_morrison_1600(double tjd, double tid_acc);
 static double deltat_aa(double tjd, double tid_acc);
+static void interp_tab_get(struct interp_tab *tab, int32 model, double tjd, double step, int nval, void (*calc)(double, double *), double *res);
+static void eps_node(double tjd, double *res);
 
 #define SEFLG_EPHMASK   (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH)
 
@@ -210,6 +223,229 @@ double swi_edcheb(double x, double *coef, int ncf)
   return (bj - bf) * .5;
 }
 
+/*
+ * evaluates the chebyshew series of the three coordinates of an
+ * ephemeris segment, coef[0..ncf-1], coef[stride..stride+ncf-1] and
+ * coef[2*stride..2*stride+ncf-1], at x in [-1,1], together with their derivatives
+ * (if dxp != NULL), in one pass through the coefficients. every
+ * coordinate goes through exactly the operations of swi_echeb() and
+ * swi_edcheb(), so that the results are the same.
+ */
+void swi_echeb_xyz(double x, double *coef, int stride, int ncf, double *xp, double *dxp)
+{
+  int i, j;
+  double x2, dj;
+  double br[3], brpp[3], brp2[3];
+  double bj[3], bf[3], bjpl[3], bjp2[3], xj, xjpl[3], xjp2[3];
+  x2 = x * 2.;
+  for (i = 0; i <= 2; i++) {
+    br[i] = brpp[i] = brp2[i] = 0.;
+    bj[i] = bf[i] = bjpl[i] = bjp2[i] = xjpl[i] = xjp2[i] = 0.;
+  }
+  for (j = ncf - 1; j >= 0; j--) {
+    for (i = 0; i <= 2; i++) {
+      brp2[i] = brpp[i];
+      brpp[i] = br[i];
+      br[i] = x2 * brpp[i] - brp2[i] + coef[i * stride + j];
+    }
+    if (dxp == NULL || j == 0)
+      continue;
+    dj = (double) (j + j);
+    for (i = 0; i <= 2; i++) {
+      xj = coef[i * stride + j] * dj + xjp2[i];
+      bj[i] = x2 * bjpl[i] - bjp2[i] + xj;
+      bf[i] = bjp2[i];
+      bjp2[i] = bjpl[i];
+      bjpl[i] = bj[i];
+      xjp2[i] = xjpl[i];
+      xjpl[i] = xj;
+    }
+  }
+  for (i = 0; i <= 2; i++) {
+    xp[i] = (br[i] - brp2[i]) * .5;
+    if (dxp != NULL)
+      dxp[i] = (bj[i] - bf[i]) * .5;
+  }
+}
+
+/*
+ * kernels of swi_echeb_many(); the SIMD versions evaluate the series at
+ * 2 or 4 points at a time, each lane doing exactly the operations of
+ * swi_echeb_xyz(), so that all of them give the same results.
+ */
+static void echeb_many_scalar(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df)
+{
+  int i, k;
+  double xp[3], dxp[3];
+  for (k = 0; k < nx; k++) {
+    swi_echeb_xyz(x[k], coef, stride, ncf, xp, (df != NULL) ? dxp : NULL);
+    for (i = 0; i <= 2; i++) {
+      f[i][k] = xp[i];
+      if (df != NULL)
+	df[i][k] = dxp[i];
+    }
+  }
+}
+
+/* the rest of the points of a SIMD kernel, from point k on */
+static void echeb_many_tail(double *x, int nx, int k, double *coef, int stride, int ncf, double **f, double **df)
+{
+  double *ft[3], *dft[3];
+  int i;
+  for (i = 0; i <= 2; i++) {
+    ft[i] = f[i] + k;
+    if (df != NULL)
+      dft[i] = df[i] + k;
+  }
+  echeb_many_scalar(x + k, nx - k, coef, stride, ncf, ft, (df != NULL) ? dft : NULL);
+}
+
+#ifdef SWI_USE_X86_SIMD
+__attribute__((target("sse2")))
+static void echeb_many_sse2(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df)
+{
+  int i, j, k;
+  __m128d two = _mm_set1_pd(2.), half = _mm_set1_pd(.5);
+  __m128d x2, dj, xj;
+  __m128d br[3], brpp[3], brp2[3];
+  __m128d bj[3], bf[3], bjpl[3], bjp2[3], xjpl[3], xjp2[3];
+  for (k = 0; k + 2 <= nx; k += 2) {
+    x2 = _mm_mul_pd(_mm_loadu_pd(x + k), two);
+    for (i = 0; i <= 2; i++) {
+      br[i] = brpp[i] = brp2[i] = _mm_setzero_pd();
+      bj[i] = bf[i] = bjpl[i] = bjp2[i] = xjpl[i] = xjp2[i] = _mm_setzero_pd();
+    }
+    for (j = ncf - 1; j >= 0; j--) {
+      for (i = 0; i <= 2; i++) {
+	brp2[i] = brpp[i];
+	brpp[i] = br[i];
+	br[i] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(x2, brpp[i]), brp2[i]), _mm_set1_pd(coef[i * stride + j]));
+      }
+      if (df == NULL || j == 0)
+	continue;
+      dj = _mm_set1_pd((double) (j + j));
+      for (i = 0; i <= 2; i++) {
+	xj = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(coef[i * stride + j]), dj), xjp2[i]);
+	bj[i] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(x2, bjpl[i]), bjp2[i]), xj);
+	bf[i] = bjp2[i];
+	bjp2[i] = bjpl[i];
+	bjpl[i] = bj[i];
+	xjp2[i] = xjpl[i];
+	xjpl[i] = xj;
+      }
+    }
+    for (i = 0; i <= 2; i++) {
+      _mm_storeu_pd(f[i] + k, _mm_mul_pd(_mm_sub_pd(br[i], brp2[i]), half));
+      if (df != NULL)
+	_mm_storeu_pd(df[i] + k, _mm_mul_pd(_mm_sub_pd(bj[i], bf[i]), half));
+    }
+  }
+  if (k < nx)
+    echeb_many_tail(x, nx, k, coef, stride, ncf, f, df);
+}
+
+/* 256 bit double arithmetic needs AVX only, not AVX2 */
+__attribute__((target("avx")))
+static void echeb_many_avx(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df)
+{
+  int i, j, k;
+  __m256d two = _mm256_set1_pd(2.), half = _mm256_set1_pd(.5);
+  __m256d x2, dj, xj;
+  __m256d br[3], brpp[3], brp2[3];
+  __m256d bj[3], bf[3], bjpl[3], bjp2[3], xjpl[3], xjp2[3];
+  for (k = 0; k + 4 <= nx; k += 4) {
+    x2 = _mm256_mul_pd(_mm256_loadu_pd(x + k), two);
+    for (i = 0; i <= 2; i++) {
+      br[i] = brpp[i] = brp2[i] = _mm256_setzero_pd();
+      bj[i] = bf[i] = bjpl[i] = bjp2[i] = xjpl[i] = xjp2[i] = _mm256_setzero_pd();
+    }
+    for (j = ncf - 1; j >= 0; j--) {
+      for (i = 0; i <= 2; i++) {
+	brp2[i] = brpp[i];
+	brpp[i] = br[i];
+	br[i] = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(x2, brpp[i]), brp2[i]), _mm256_broadcast_sd(coef + i * stride + j));
+      }
+      if (df == NULL || j == 0)
+	continue;
+      dj = _mm256_set1_pd((double) (j + j));
+      for (i = 0; i <= 2; i++) {
+	xj = _mm256_add_pd(_mm256_mul_pd(_mm256_broadcast_sd(coef + i * stride + j), dj), xjp2[i]);
+	bj[i] = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(x2, bjpl[i]), bjp2[i]), xj);
+	bf[i] = bjp2[i];
+	bjp2[i] = bjpl[i];
+	bjpl[i] = bj[i];
+	xjp2[i] = xjpl[i];
+	xjpl[i] = xj;
+      }
+    }
+    for (i = 0; i <= 2; i++) {
+      _mm256_storeu_pd(f[i] + k, _mm256_mul_pd(_mm256_sub_pd(br[i], brp2[i]), half));
+      if (df != NULL)
+	_mm256_storeu_pd(df[i] + k, _mm256_mul_pd(_mm256_sub_pd(bj[i], bf[i]), half));
+    }
+  }
+  /* the compiler does not always clear the upper halves of the registers
+   * before the call below; left dirty, they slow down all the SSE code
+   * that follows, not only the call */
+  _mm256_zeroupper();
+  if (k < nx)
+    echeb_many_tail(x, nx, k, coef, stride, ncf, f, df);
+}
+#endif
+
+typedef void (*echeb_many_fn)(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df);
+
+/* kernel of swi_echeb_many() in the calling thread */
+static TLS echeb_many_fn echeb_many = NULL;
+
+/* the fastest kernel the cpu supports, or the one asked for, if it is
+ * supported, s. swi_set_echeb_kernel() */
+static echeb_many_fn echeb_many_select(int kernel)
+{
+  if (kernel == SWI_ECHEB_SCALAR)
+    return echeb_many_scalar;
+#ifdef SWI_USE_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx") && kernel != SWI_ECHEB_SSE2)
+    return echeb_many_avx;
+  if (__builtin_cpu_supports("sse2"))
+    return echeb_many_sse2;
+#endif
+  return echeb_many_scalar;
+}
+
+/*
+ * for testing: chooses the kernel of swi_echeb_many() in the calling
+ * thread, SWI_ECHEB_AUTO for the fastest one. a kernel the cpu does
+ * not support is never chosen; returns the kernel chosen.
+ */
+int swi_set_echeb_kernel(int kernel)
+{
+  echeb_many = echeb_many_select(kernel);
+#ifdef SWI_USE_X86_SIMD
+  if (echeb_many == echeb_many_avx)
+    return SWI_ECHEB_AVX;
+  if (echeb_many == echeb_many_sse2)
+    return SWI_ECHEB_SSE2;
+#endif
+  return SWI_ECHEB_SCALAR;
+}
+
+/*
+ * evaluates the chebyshew series of the three coordinates of an
+ * ephemeris segment, as swi_echeb_xyz(), at the nx points x[0..nx-1] in
+ * [-1,1], e.g. at many dates. the values of coordinate i go to
+ * f[i][0..nx-1], the derivatives to df[i][0..nx-1], if df != NULL.
+ * they are the same as those of swi_echeb_xyz(), unless the compiler
+ * contracts the operations of this into fused multiply-adds.
+ */
+void swi_echeb_many(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df)
+{
+  if (echeb_many == NULL)
+    echeb_many = echeb_many_select(SWI_ECHEB_AUTO);
+  echeb_many(x, nx, coef, stride, ncf, f, df);
+}
+
 /*
  * conversion between ecliptical and equatorial polar coordinates.
  * for users of SWISSEPH, not used by our routines.
@@ -746,7 +982,10 @@ double swi_epsiln(double J, int32 iflag)
     + 84381.448;
     eps *= DEGTORAD/3600.0;
   } else { /* SEMOD_PREC_VONDRAK_2011 */
-    swi_ldp_peps(J, NULL, &eps);
+    if (swed.interpolate_nut)
+      interp_tab_get(&swed.epstab, prec_model, J, SEI_EPSTAB_STEP, 1, eps_node, &eps);
+    else
+      swi_ldp_peps(J, NULL, &eps);
     /*if ((iflag & SEFLG_JPLHOR_APPROX) && APPROXIMATE_HORIZONS_ASTRODIENST) {*/
     if ((iflag & SEFLG_JPLHOR_APPROX) && jplhora_model == SEMOD_JPLHORA_1) {
       tofs = (J - DCOR_EPS_JPL_TJD0) / 365.25;
@@ -1703,6 +1942,71 @@ done:
   return ans;
 }
 
+/* interpolates nval values, which calc() computes for a date, for tjd.
+ * the values are computed at nodes step days apart, and kept in the
+ * table tab, as long as the model remains the same. */
+static void interp_tab_get(struct interp_tab *tab, int32 model, double tjd, double step, int nval, void (*calc)(double, double *), double *res)
+{
+  int i, j;
+  int32 n, k;
+  double t, p, w[4], *v[4];
+  if (tab->model != model) {
+    memset((void *) tab->is_set, 0, sizeof(tab->is_set));
+    tab->model = model;
+  }
+  t = (tjd - J2000) / step;
+  n = (int32) floor(t);
+  p = t - n;
+  for (i = 0; i < 4; i++) {
+    k = n - 1 + i;
+    j = (int) (k & (SEI_NUTTAB_SIZE - 1));
+    if (!tab->is_set[j] || tab->node[j] != k) {
+      calc(J2000 + k * step, tab->val[j]);
+      tab->node[j] = k;
+      tab->is_set[j] = TRUE;
+    }
+    v[i] = tab->val[j];
+  }
+  /* cubic Lagrange interpolation, between the nodes n and n + 1 */
+  w[0] = -p * (p - 1) * (p - 2) / 6.0;
+  w[1] = (p + 1) * (p - 1) * (p - 2) / 2.0;
+  w[2] = -(p + 1) * p * (p - 2) / 2.0;
+  w[3] = (p + 1) * p * (p - 1) / 6.0;
+  for (i = 0; i < nval; i++)
+    res[i] = w[0] * v[0][i] + w[1] * v[1][i] + w[2] * v[2][i] + w[3] * v[3][i];
+}
+
+static void nut_node(double tjd, double *res)
+{
+  swi_nutation_iau2000ab(tjd, res);
+}
+
+static void eps_node(double tjd, double *res)
+{
+  swi_ldp_peps(tjd, NULL, &res[0]);
+}
+
+/* with do_interpolate = TRUE, nutation and obliquity are interpolated
+ * from values at fixed steps (s. sweph.h), which is faster for a sweep
+ * over close dates; by default, the series are summed for every date.
+ * applies to the calling thread. */
+void CALL_CONV swe_set_interpolate_nut(AS_BOOL do_interpolate)
+{
+  swi_init_swed_if_start();
+  do_interpolate = (do_interpolate != FALSE);
+  if (swed.interpolate_nut == do_interpolate)
+    return;
+  swed.interpolate_nut = do_interpolate;
+  swed.nuttab.model = swed.epstab.model = 0;
+  memset((void *) swed.nuttab.is_set, 0, sizeof(swed.nuttab.is_set));
+  memset((void *) swed.epstab.is_set, 0, sizeof(swed.epstab.is_set));
+  /* force nutation and obliquity to be computed again */
+  swed.nut.tnut = swed.nutv.tnut = 0;
+  swed.oec.teps = swed.oec2000.teps = 0;
+  /* and the apparent positions saved with the old values */
+  swi_force_app_pos_etc();
+}
+
 int swi_nutation(double J, int32 iflag, double *nutlo)
 {
   int n;
@@ -1719,7 +2023,10 @@ int swi_nutation(double J, int32 iflag, double *nutlo)
   } else if (nut_model == SEMOD_NUT_IAU_1980 || nut_model == SEMOD_NUT_IAU_CORR_1987) {
     swi_nutation_iau1980(J, nutlo);
   } else if (nut_model == SEMOD_NUT_IAU_2000A || nut_model == SEMOD_NUT_IAU_2000B) {
-    swi_nutation_iau2000ab(J, nutlo);
+    if (swed.interpolate_nut)
+      interp_tab_get(&swed.nuttab, nut_model, J, SEI_NUTTAB_STEP, 2, nut_node, nutlo);
+    else
+      swi_nutation_iau2000ab(J, nutlo);
     /*if ((iflag & SEFLG_JPLHOR_APPROX) && FRAME_BIAS_APPROX_HORIZONS) {*/
     /*if ((iflag & SEFLG_JPLHOR_APPROX) && !APPROXIMATE_HORIZONS_ASTRODIENST) {*/
     if ((iflag & SEFLG_JPLHOR_APPROX) && jplhora_model != SEMOD_JPLHORA_1) {
@@ -2024,7 +2331,7 @@ void swi_icrs2fk5(double *x, int32 iflag, AS_BOOL backward)
 #define TABSIZ 		(TABEND-TABSTART+1) 
 /* we make the table greater for additional values read from external file */
 #define TABSIZ_SPACE 	(TABSIZ+100)
-static TLS double dt[TABSIZ_SPACE] = {
+static const double dt_builtin[TABSIZ_SPACE] = {
 /* 1620.0 thru 1659.0 */
 124.00, 119.00, 115.00, 110.00, 106.00, 102.00, 98.00, 95.00, 91.00, 88.00,
 85.00, 82.00, 79.00, 77.00, 74.00, 72.00, 70.00, 67.00, 65.00, 63.00,
@@ -2081,6 +2388,28 @@ static TLS double dt[TABSIZ_SPACE] = {
 /* Extrapolated values, 2016 - 2019 */
 					 68.01, 68.50, 69.00, 69.50,
 };
+
+/* the table dt, with the values from swe_deltat.txt or sedeltat.txt 
+ * (s. init_dt()). it does not change, and is shared by all threads
+ * that use the same ephemeris path */
+struct deltat_tab {
+  char ephepath[AS_MAXCH];
+  int tabsiz;
+  double dt[TABSIZ_SPACE];
+  /* the interpolation of deltat_aa() in year TABSTART + i, as a 
+   * polynomial of the fraction of the year: 
+   * coef[i][0] + coef[i][1] * p + ... + coef[i][4] * p^4 */
+  double coef[TABSIZ_SPACE][5];
+  struct deltat_tab *next;
+};
+#ifdef SWI_USE_PTHREAD
+static struct deltat_tab *deltat_tabs = NULL;
+static struct deltat_tab deltat_tab_builtin;
+static pthread_mutex_t deltat_tabs_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+static TLS struct deltat_tab *deltat_tabs = NULL;
+static TLS struct deltat_tab deltat_tab_builtin;
+#endif
 /*#define DELTAT_ESPENAK_MEEUS_2006 TRUE*/
 #define TAB2_SIZ	27
 #define TAB2_START	(-1000)
@@ -2167,7 +2496,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
 	iy = (TAB2_END - TAB2_START) / TAB2_STEP;
 	dd = (Y - TAB2_END) / B;
 	/*ans = dt2[iy] + dd * (dt[0] / 100.0 - dt2[iy]);*/
-	ans = dt2[iy] + dd * (dt[0] - dt2[iy]);
+	ans = dt2[iy] + dd * (init_dt()->dt[0] - dt2[iy]);
 	ans = adjust_for_tidacc(ans, Ygreg, tid_acc);
 	*deltat = ans / 86400.0;
 	return iflag;
@@ -2221,10 +2550,11 @@ static double deltat_aa(double tjd, double tid_acc)
 {
   double ans = 0, ans2, ans3;
   double p, B, B2, Y, dd;
-  double d[6];
-  int i, iy, k;
+  double *c;
+  int iy;
   /* read additional values from swedelta.txt */
-  int tabsiz = init_dt();
+  struct deltat_tab *tab = init_dt();
+  int tabsiz = tab->tabsiz;
   int tabend = TABSTART + tabsiz - 1;
   /*Y = 2000.0 + (tjd - J2000)/365.25;*/
   Y = 2000.0 + (tjd - J2000)/365.2425;
@@ -2233,55 +2563,11 @@ static double deltat_aa(double tjd, double tid_acc)
      */
     p = floor(Y);
     iy = (int) (p - TABSTART);
-    /* Zeroth order estimate is value at start of year */
-    ans = dt[iy];
-    k = iy + 1;
-    if( k >= tabsiz )
-      goto done; /* No data, can't go on. */
     /* The fraction of tabulation interval */
     p = Y - p;
-    /* First order interpolated value */
-    ans += p*(dt[k] - dt[iy]);
-    if( (iy-1 < 0) || (iy+2 >= tabsiz) )
-      goto done; /* can't do second differences */
-    /* Make table of first differences */
-    k = iy - 2;
-    for( i=0; i<5; i++ ) {
-      if( (k < 0) || (k+1 >= tabsiz) ) 
-	d[i] = 0;
-      else
-	d[i] = dt[k+1] - dt[k];
-      k += 1;
-    }
-    /* Compute second differences */
-    for( i=0; i<4; i++ )
-      d[i] = d[i+1] - d[i];
-    B = 0.25*p*(p-1.0);
-    ans += B*(d[1] + d[2]);
-#if DEMO
-    printf( "B %.4lf, ans %.4lf\n", B, ans );
-#endif
-    if( iy+2 >= tabsiz )
-      goto done;
-    /* Compute third differences */
-    for( i=0; i<3; i++ )
-      d[i] = d[i+1] - d[i];
-    B = 2.0*B/3.0;
-    ans += (p-0.5)*B*d[1];
-#if DEMO
-    printf( "B %.4lf, ans %.4lf\n", B*(p-0.5), ans );
-#endif
-    if( (iy-2 < 0) || (iy+3 > tabsiz) )
-      goto done;
-    /* Compute fourth differences */
-    for( i=0; i<2; i++ )
-      d[i] = d[i+1] - d[i];
-    B = 0.125*B*(p+1.0)*(p-2.0);
-    ans += B*(d[0] + d[1]);
-#if DEMO
-    printf( "B %.4lf, ans %.4lf\n", B, ans );
-#endif
-    done:
+    /* Besselian interpolation, precomputed by deltat_tab_init_coef() */
+    c = tab->coef[iy];
+    ans = c[0] + p * (c[1] + p * (c[2] + p * (c[3] + p * c[4])));
     ans = adjust_for_tidacc(ans, Y, tid_acc);
     return ans / 86400.0;
   }
@@ -2297,7 +2583,7 @@ static double deltat_aa(double tjd, double tid_acc)
   if (Y <= tabend+100) {
     B2 = 0.01 * (tabend - 1820);
     ans2 = -20 + 31 * B2 * B2;
-    ans3 = dt[tabsiz-1];
+    ans3 = tab->dt[tabsiz-1];
     dd = (ans2 - ans3);
     ans += dd * (Y - (tabend + 100)) * 0.01;
   }
@@ -2407,10 +2693,72 @@ static double deltat_espenak_meeus_1620(double tjd, double tid_acc)
   return ans;
 }
 
+/* Computes the coefficients of the Besselian interpolation of the
+ * delta t table (s. AA page K11) for each year of the table. Up to
+ * fourth differences are used, as far as the table reaches.
+ */
+static void deltat_tab_init_coef(struct deltat_tab *tab)
+{
+  double *dt = tab->dt, *c;
+  double d[6];
+  int tabsiz = tab->tabsiz;
+  int i, iy, k;
+  for (iy = 0; iy < tabsiz; iy++) {
+    c = tab->coef[iy];
+    memset((void *) c, 0, 5 * sizeof(double));
+    /* Zeroth order estimate is value at start of year */
+    c[0] = dt[iy];
+    k = iy + 1;
+    if( k >= tabsiz )
+      continue; /* No data, can't go on. */
+    /* First order: p * (dt[k] - dt[iy]) */
+    c[1] = dt[k] - dt[iy];
+    if( (iy-1 < 0) || (iy+2 >= tabsiz) )
+      continue; /* can't do second differences */
+    /* Make table of first differences */
+    k = iy - 2;
+    for( i=0; i<5; i++ ) {
+      if( (k < 0) || (k+1 >= tabsiz) ) 
+	d[i] = 0;
+      else
+	d[i] = dt[k+1] - dt[k];
+      k += 1;
+    }
+    /* Compute second differences; 
+     * B = p(p-1)/4, term B*(d[1] + d[2]) */
+    for( i=0; i<4; i++ )
+      d[i] = d[i+1] - d[i];
+    c[1] -= 0.25 * (d[1] + d[2]);
+    c[2] += 0.25 * (d[1] + d[2]);
+    if( iy+2 >= tabsiz )
+      continue;
+    /* Compute third differences; 
+     * (p-0.5)*B*2/3 = (p^3 - 1.5p^2 + 0.5p)/6, term times d[1] */
+    for( i=0; i<3; i++ )
+      d[i] = d[i+1] - d[i];
+    c[1] += d[1] / 12.0;
+    c[2] -= d[1] / 4.0;
+    c[3] += d[1] / 6.0;
+    if( (iy-2 < 0) || (iy+3 > tabsiz) )
+      continue;
+    /* Compute fourth differences; 
+     * B*2/3*(p+1)(p-2)/8 = (p^4 - 2p^3 - p^2 + 2p)/48, 
+     * term times (d[0] + d[1]) */
+    for( i=0; i<2; i++ )
+      d[i] = d[i+1] - d[i];
+    c[1] += (d[0] + d[1]) / 24.0;
+    c[2] -= (d[0] + d[1]) / 48.0;
+    c[3] -= (d[0] + d[1]) / 24.0;
+    c[4] += (d[0] + d[1]) / 48.0;
+  }
+}
+
 /* Read delta t values from external file.
 * record structure: year(whitespace)delta_t in 0.01 sec.
+* the file is read only once for each ephemeris path; the table is 
+* kept for all threads.
 */
-static int init_dt(void)
+static struct deltat_tab *read_dt(void)
 {
 FILE *fp;
 int year;
@@ -2419,12 +2767,14 @@ int tabsiz;
 int i;
 char s[AS_MAXCH];
 char *sp;
-if (!swed.init_dt_done) {
-  swed.init_dt_done = TRUE;
-  /* no error message if file is missing */
-  if ((fp = swi_fopen(-1, "swe_deltat.txt", swed.ephepath, NULL)) == NULL
-    && (fp = swi_fopen(-1, "sedeltat.txt", swed.ephepath, NULL)) == NULL)
-    return TABSIZ; 
+struct deltat_tab *tab;
+if ((tab = (struct deltat_tab *) calloc(1, sizeof(struct deltat_tab))) == NULL)
+  return NULL;
+strcpy(tab->ephepath, swed.ephepath);
+memcpy((void *) tab->dt, (void *) dt_builtin, sizeof(dt_builtin));
+/* no error message if file is missing */
+if ((fp = swi_fopen(-1, "swe_deltat.txt", swed.ephepath, NULL)) != NULL
+  || (fp = swi_fopen(-1, "sedeltat.txt", swed.ephepath, NULL)) != NULL) {
   while(fgets(s, AS_MAXCH, fp) != NULL) {
     sp = s;
     while (strchr(" \t", *sp) != NULL && *sp != '\0') 
@@ -2440,20 +2790,62 @@ if (!swed.init_dt_done) {
     while (strchr(" \t", *sp) != NULL && *sp != '\0')
       sp++;	/* was *sp++  fixed by Alois 2-jul-2003 */
     /*dt[tab_index] = (short) (atof(sp) * 100 + 0.5);*/
-    dt[tab_index] = atof(sp);
+    tab->dt[tab_index] = atof(sp);
   }
   fclose(fp);
+  /* find table size */
+  tabsiz = 2001 - TABSTART + 1;
+  for (i = tabsiz - 1; i < TABSIZ_SPACE; i++) {
+    if (tab->dt[i] == 0) 
+      break;
+    else
+      tabsiz++;
+  }
+  tabsiz--;
+} else {
+  tabsiz = TABSIZ;
 }
-/* find table size */
-tabsiz = 2001 - TABSTART + 1;
-for (i = tabsiz - 1; i < TABSIZ_SPACE; i++) {
-  if (dt[i] == 0) 
+tab->tabsiz = tabsiz;
+deltat_tab_init_coef(tab);
+return tab;
+}
+
+/* returns the delta t table of the ephemeris path */
+static struct deltat_tab *init_dt(void)
+{
+struct deltat_tab *tab;
+if (swed.init_dt_done && swed.dttab != NULL)
+  return swed.dttab;
+#ifdef SWI_USE_PTHREAD
+pthread_mutex_lock(&deltat_tabs_lock);
+#endif
+for (tab = deltat_tabs; tab != NULL; tab = tab->next) {
+  if (strcmp(tab->ephepath, swed.ephepath) == 0)
     break;
-  else
-    tabsiz++;
 }
-tabsiz--;
-return tabsiz;
+if (tab == NULL && (tab = read_dt()) != NULL) {
+  tab->next = deltat_tabs;
+  deltat_tabs = tab;
+}
+if (tab == NULL) {
+  /* out of memory: the built-in table, tried again next time */
+  tab = &deltat_tab_builtin;
+  if (tab->tabsiz == 0) {
+    memcpy((void *) tab->dt, (void *) dt_builtin, sizeof(dt_builtin));
+    tab->tabsiz = TABSIZ;
+    deltat_tab_init_coef(tab);
+  }
+#ifdef SWI_USE_PTHREAD
+  pthread_mutex_unlock(&deltat_tabs_lock);
+#endif
+  return tab;
+}
+#ifdef SWI_USE_PTHREAD
+pthread_mutex_unlock(&deltat_tabs_lock);
+#endif
+swed.init_dt_done = TRUE;
+swed.dttab = tab;
+return tab;
 }
 
 /* Astronomical Almanac table is corrected by adding the expression
@@ -182,6 +182,15 @@ extern double swi_mod2PI(double x);
 /* evaluation of chebyshew series and derivative */
 extern double swi_echeb(double x, double *coef, int ncf);
 extern double swi_edcheb(double x, double *coef, int ncf);
+extern void swi_echeb_xyz(double x, double *coef, int stride, int ncf, double *xp, double *dxp);
+extern void swi_echeb_many(double *x, int nx, double *coef, int stride, int ncf, double **f, double **df);
+
+/* kernels of swi_echeb_many(), for testing */
+#define SWI_ECHEB_AUTO		0
+#define SWI_ECHEB_SCALAR	1
+#define SWI_ECHEB_SSE2		2
+#define SWI_ECHEB_AVX		3
+extern int swi_set_echeb_kernel(int kernel);
 
 /* cross product of vectors */
 extern void swi_cross_prod(double *a, double *b, double *x);
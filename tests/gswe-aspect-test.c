@@ -0,0 +1,172 @@
+#undef G_DISABLE_ASSERT
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <swe-glib.h>
+
+#include "test-asserts.h"
+
+// The distances every check is done with: a dense grid over the whole
+// circle, plus the orb boundaries of every aspect
+#define GRID_COUNT (3600 * 4 + 1)
+#define MAX_DISTANCES (GRID_COUNT + GSWE_ASPECT_QUINCUNX * 4)
+
+// The aspect of @distance by the definition: the first aspect, in the order
+// of their IDs, whose orb contains it
+static GsweAspect
+exact_aspect(gdouble distance, gdouble planet_orb)
+{
+    GsweAspect aspect;
+
+    distance = fmod(fabs(distance), 360.0);
+
+    if (distance > 180.0) {
+        distance = 360.0 - distance;
+    }
+
+    for (aspect = GSWE_ASPECT_CONJUCTION;
+         aspect <= GSWE_ASPECT_QUINCUNX;
+         aspect++) {
+        GsweAspectInfo *aspect_info = gswe_find_aspect_info_by_id(
+                aspect,
+                NULL
+            );
+        gdouble orb = fmax(
+                1.0,
+                planet_orb - gswe_aspect_info_get_orb_modifier(aspect_info)
+            );
+
+        if (fabs(gswe_aspect_info_get_size(aspect_info) - distance) < orb) {
+            return aspect;
+        }
+    }
+
+    return GSWE_ASPECT_NONE;
+}
+
+static void
+check_classifier(gdouble planet_orb)
+{
+    gdouble distances[MAX_DISTANCES];
+    GsweAspect aspects[MAX_DISTANCES],
+               aspect;
+    guint count = 0,
+          i;
+
+    for (i = 0; i < GRID_COUNT; i++) {
+        distances[count++] = i * 0.025;
+    }
+
+    for (aspect = GSWE_ASPECT_CONJUCTION;
+         aspect <= GSWE_ASPECT_QUINCUNX;
+         aspect++) {
+        GsweAspectInfo *aspect_info = gswe_find_aspect_info_by_id(
+                aspect,
+                NULL
+            );
+        gdouble size = gswe_aspect_info_get_size(aspect_info),
+                orb = fmax(
+                        1.0,
+                        planet_orb
+                            - gswe_aspect_info_get_orb_modifier(aspect_info)
+                    );
+
+        distances[count++] = size - orb;
+        distances[count++] = nextafter(size - orb, 360.0);
+        distances[count++] = size + orb;
+        distances[count++] = nextafter(size + orb, 0.0);
+    }
+
+    gswe_classify_aspects(distances, count, planet_orb, aspects, NULL);
+
+    for (i = 0; i < count; i++) {
+        if (aspects[i] != exact_aspect(distances[i], planet_orb)) {
+            g_error(
+                    "Distance %.17g with orb %g is classified as %d "
+                    "instead of %d",
+                    distances[i], planet_orb,
+                    aspects[i], exact_aspect(distances[i], planet_orb)
+                );
+        }
+    }
+}
+
+static void
+test_aspect_classify(void)
+{
+    gdouble distances[3] = { NAN, INFINITY, -INFINITY },
+            differences[3];
+    GsweAspect aspects[3];
+    GswePlanet planet;
+
+    // Orbs with a classifier table of their own…
+    for (planet = GSWE_PLANET_SUN; planet <= GSWE_PLANET_PLUTO; planet++) {
+        GswePlanetInfo *planet_info;
+
+        if ((planet_info = gswe_find_planet_info_by_id(planet, NULL)) != NULL) {
+            check_classifier(gswe_planet_info_get_orb(planet_info));
+        }
+    }
+
+    // …and orbs without one
+    check_classifier(7.3);
+    check_classifier(0.5);
+
+    gswe_classify_aspects(distances, 3, 13.0, aspects, differences);
+    g_assert_cmpint(aspects[0], ==, GSWE_ASPECT_NONE);
+    g_assert_cmpint(aspects[1], ==, GSWE_ASPECT_NONE);
+    g_assert_cmpint(aspects[2], ==, GSWE_ASPECT_NONE);
+}
+
+static void
+test_aspect_classify_changed(void)
+{
+    GsweAspectInfo *square = gswe_find_aspect_info_by_id(
+                GSWE_ASPECT_SQUARE,
+                NULL
+            ),
+                   *quintile = gswe_find_aspect_info_by_id(
+                GSWE_ASPECT_QUINTILE,
+                NULL
+            );
+    gdouble square_orb_modifier = gswe_aspect_info_get_orb_modifier(square),
+            quintile_size = gswe_aspect_info_get_size(quintile),
+            sun_orb = gswe_planet_info_get_orb(
+                    gswe_find_planet_info_by_id(GSWE_PLANET_SUN, NULL)
+                );
+    gdouble distance = 90.0 + sun_orb - square_orb_modifier - 0.5;
+    GsweAspect aspect;
+
+    // Make sure the classifier tables are built before changing anything
+    gswe_classify_aspects(&distance, 1, sun_orb, &aspect, NULL);
+    g_assert_cmpint(aspect, ==, GSWE_ASPECT_SQUARE);
+
+    gswe_aspect_info_set_orb_modifier(square, square_orb_modifier + 1.0);
+    gswe_classify_aspects(&distance, 1, sun_orb, &aspect, NULL);
+    g_assert_cmpint(aspect, ==, GSWE_ASPECT_NONE);
+    check_classifier(sun_orb);
+
+    gswe_aspect_info_set_size(quintile, 75.0);
+    check_classifier(sun_orb);
+
+    gswe_aspect_info_set_orb_modifier(square, square_orb_modifier);
+    gswe_aspect_info_set_size(quintile, quintile_size);
+    gswe_classify_aspects(&distance, 1, sun_orb, &aspect, NULL);
+    g_assert_cmpint(aspect, ==, GSWE_ASPECT_SQUARE);
+    check_classifier(sun_orb);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/gswe/aspect/classify", test_aspect_classify);
+    g_test_add_func(
+            "/gswe/aspect/classify_changed",
+            test_aspect_classify_changed
+        );
+
+    return g_test_run();
+}
@@ -0,0 +1,694 @@
+#undef G_DISABLE_ASSERT
+
+#include <math.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <swe-glib.h>
+#include "../swe/src/swephexp.h"
+#include "../swe/src/swephlib.h"
+
+#include "test-asserts.h"
+
+// The error bound of the interpolated nutation and obliquity, in degrees
+// (0.00005")
+#define NUTATION_BOUND (0.00005 / 3600.0)
+
+// The number of astronomical models swe_set_astro_models() expects
+// (SEI_NMODELS in sweph.h)
+#define MODEL_COUNT 20
+
+static void
+check_interpolated_nutation(gint32 nut_model, gint count)
+{
+    gint32 models[MODEL_COUNT] = { 0 };
+    gchar serr[AS_MAXCH];
+    gint i;
+
+    models[SE_MODEL_NUT] = nut_model;
+    swe_set_astro_models(models);
+
+    for (i = 0; i < count; i++) {
+        gdouble jd = g_test_rand_double_range(
+                    2451545.0 - 8000 * 365.25,
+                    2451545.0 + 8000 * 365.25
+                ),
+                interpolated[6],
+                exact[6];
+
+        swe_set_interpolate_nut(TRUE);
+        g_assert_cmpint(swe_calc(jd, SE_ECL_NUT, 0, interpolated, serr), >=, 0);
+        swe_set_interpolate_nut(FALSE);
+        g_assert_cmpint(swe_calc(jd, SE_ECL_NUT, 0, exact, serr), >=, 0);
+
+        // true and mean obliquity, nutation in longitude and in obliquity
+        gswe_assert_fuzzy_equals(interpolated[0], exact[0], NUTATION_BOUND);
+        gswe_assert_fuzzy_equals(interpolated[1], exact[1], NUTATION_BOUND);
+        gswe_assert_fuzzy_equals(interpolated[2], exact[2], NUTATION_BOUND);
+        gswe_assert_fuzzy_equals(interpolated[3], exact[3], NUTATION_BOUND);
+    }
+
+    models[SE_MODEL_NUT] = 0;
+    swe_set_astro_models(models);
+}
+
+static void
+test_ephemeris_nutation_2000b(void)
+{
+    check_interpolated_nutation(SEMOD_NUT_IAU_2000B, 20000);
+}
+
+static void
+test_ephemeris_nutation_2000a(void)
+{
+    // IAU 2000A is much slower to sum, so it gets fewer samples
+    check_interpolated_nutation(SEMOD_NUT_IAU_2000A, 1000);
+}
+
+// The number of dates of every series; several blocks of dates, with
+// segment boundaries inside them
+#define SERIES_STEPS 1000
+
+static const gint32 series_bodies[] = {
+    SE_SUN, SE_MOON, SE_MARS, SE_JUPITER, SE_PLUTO, SE_CHIRON, SE_OSCU_APOG
+};
+
+static const gint32 series_flags[] = {
+    SEFLG_SPEED,
+    SEFLG_SPEED | SEFLG_EQUATORIAL | SEFLG_J2000 | SEFLG_NONUT,
+    SEFLG_SPEED | SEFLG_HELCTR | SEFLG_XYZ,
+    SEFLG_SPEED | SEFLG_TRUEPOS | SEFLG_NOABERR,
+};
+
+// Compares swe_calc_series() with a swe_calc() loop
+static void
+check_series(void)
+{
+    gdouble *series = g_new(gdouble, 6 * SERIES_STEPS),
+            *loop = g_new(gdouble, 6 * SERIES_STEPS),
+            start = 2458849.5,
+            step = 1.0 / 24.0;
+    gchar serr[AS_MAXCH];
+    guint b,
+          f;
+    gint i;
+
+    for (b = 0; b < G_N_ELEMENTS(series_bodies); b++) {
+        for (f = 0; f < G_N_ELEMENTS(series_flags); f++) {
+            gint32 series_ret,
+                   loop_ret = 0;
+
+            series_ret = swe_calc_series(
+                    start, step, SERIES_STEPS,
+                    series_bodies[b], series_flags[f],
+                    series,
+                    serr
+                );
+
+            for (i = 0; i < SERIES_STEPS; i++) {
+                loop_ret = swe_calc(
+                        start + i * step,
+                        series_bodies[b], series_flags[f],
+                        loop + 6 * i,
+                        serr
+                    );
+            }
+
+            g_assert_cmpint(series_ret, ==, loop_ret);
+
+            // The kernels do the same operations as swe_calc(); only fused
+            // multiply-adds the compiler makes in the scalar code may
+            // change the last bits
+            for (i = 0; i < 6 * SERIES_STEPS; i++) {
+                gswe_assert_fuzzy_equals(
+                        series[i],
+                        loop[i],
+                        1e-13 * (fabs(loop[i]) + 1.0)
+                    );
+            }
+        }
+    }
+
+    g_free(series);
+    g_free(loop);
+}
+
+static void
+test_ephemeris_series(gconstpointer data)
+{
+    gint kernel = GPOINTER_TO_INT(data);
+
+    // The kernel is chosen for the calling thread only
+    if (swi_set_echeb_kernel(kernel) != kernel) {
+        g_test_message("The CPU does not support this kernel");
+    } else {
+        check_series();
+    }
+
+    swi_set_echeb_kernel(SWI_ECHEB_AUTO);
+}
+
+// The number of coefficients per coordinate of the test segments, and the
+// number of points they are evaluated at; not a multiple of any SIMD width
+#define CHEB_STRIDE 30
+#define CHEB_POINTS 37
+
+static const gint cheb_kernels[] = {
+    SWI_ECHEB_SCALAR, SWI_ECHEB_SSE2, SWI_ECHEB_AVX
+};
+
+// swi_echeb_xyz() and every kernel of swi_echeb_many() must give the very
+// same bits as swi_echeb() and swi_edcheb()
+static void
+test_ephemeris_chebyshev(void)
+{
+    gdouble coef[3 * CHEB_STRIDE],
+            x[CHEB_POINTS],
+            f[3][CHEB_POINTS],
+            df[3][CHEB_POINTS];
+    gdouble *fp[3] = { f[0], f[1], f[2] },
+            *dfp[3] = { df[0], df[1], df[2] };
+    gint ncf,
+         i,
+         k;
+    guint kernel;
+
+    for (i = 0; i < 3 * CHEB_STRIDE; i++) {
+        coef[i] = g_test_rand_double_range(-1.0, 1.0)
+            * pow(10.0, 2 - i % CHEB_STRIDE);
+    }
+
+    for (k = 0; k < CHEB_POINTS; k++) {
+        x[k] = (k == 0) ? -1.0 : g_test_rand_double_range(-1.0, 1.0);
+    }
+
+    for (ncf = 1; ncf <= CHEB_STRIDE; ncf++) {
+        for (k = 0; k < CHEB_POINTS; k++) {
+            gdouble xp[3],
+                    dxp[3];
+
+            swi_echeb_xyz(x[k], coef, CHEB_STRIDE, ncf, xp, dxp);
+
+            for (i = 0; i <= 2; i++) {
+                g_assert_cmpfloat(
+                        xp[i],
+                        ==,
+                        swi_echeb(x[k], coef + i * CHEB_STRIDE, ncf)
+                    );
+                g_assert_cmpfloat(
+                        dxp[i],
+                        ==,
+                        swi_edcheb(x[k], coef + i * CHEB_STRIDE, ncf)
+                    );
+            }
+
+            swi_echeb_xyz(x[k], coef, CHEB_STRIDE, ncf, xp, NULL);
+
+            for (i = 0; i <= 2; i++) {
+                g_assert_cmpfloat(
+                        xp[i],
+                        ==,
+                        swi_echeb(x[k], coef + i * CHEB_STRIDE, ncf)
+                    );
+            }
+        }
+
+        for (kernel = 0; kernel < G_N_ELEMENTS(cheb_kernels); kernel++) {
+            if (swi_set_echeb_kernel(cheb_kernels[kernel])
+                    != cheb_kernels[kernel]) {
+                continue;
+            }
+
+            swi_echeb_many(x, CHEB_POINTS, coef, CHEB_STRIDE, ncf, fp, dfp);
+
+            for (k = 0; k < CHEB_POINTS; k++) {
+                for (i = 0; i <= 2; i++) {
+                    g_assert_cmpfloat(
+                            f[i][k],
+                            ==,
+                            swi_echeb(x[k], coef + i * CHEB_STRIDE, ncf)
+                        );
+                    g_assert_cmpfloat(
+                            df[i][k],
+                            ==,
+                            swi_edcheb(x[k], coef + i * CHEB_STRIDE, ncf)
+                        );
+                }
+            }
+        }
+    }
+
+    swi_set_echeb_kernel(SWI_ECHEB_AUTO);
+}
+
+// The range of Julian days (ET) swe_compact_ephe_file() keeps in the test
+#define COMPACT_START 2451545.0
+#define COMPACT_END (2451545.0 + 3652.5)
+#define COMPACT_DATES 50
+
+// Calculates @body with the ephemeris files of @context
+static gint32
+calc_in_context(
+        struct swe_context *context,
+        gdouble jd,
+        gint32 body,
+        gint32 flags,
+        gdouble *xx)
+{
+    struct swe_context *previous = swe_context_get_current();
+    gchar serr[AS_MAXCH];
+    gint32 ret;
+
+    g_assert_cmpint(swe_context_switch(context, serr), ==, OK);
+    ret = swe_calc(jd, body, flags | SEFLG_SPEED, xx, serr);
+    swe_context_switch(previous, NULL);
+
+    return ret;
+}
+
+
+// Checks a compacted file against the original, at @jd; @kept tells if
+// the compacted file should have @body at that date
+static void
+check_compacted(
+        struct swe_context *original,
+        struct swe_context *compacted,
+        gdouble jd,
+        gint32 body,
+        gboolean kept)
+{
+    gdouble xx[6],
+            expected[6];
+    gint32 ret,
+           expected_ret;
+
+    gint i;
+
+    ret = calc_in_context(compacted, jd, body, SEFLG_SWIEPH, xx);
+
+    if (kept) {
+        expected_ret = calc_in_context(
+                original,
+                jd, body, SEFLG_SWIEPH,
+                expected
+            );
+        g_assert_cmpint(ret, ==, expected_ret);
+
+        for (i = 0; i < 6; i++) {
+            g_assert_cmpfloat(xx[i], ==, expected[i]);
+        }
+    } else {
+        // Without data, the Swiss Ephemeris falls back to the Moshier
+        // ephemeris, just like without the file. The switch happens in the
+        // middle of the Swiss Ephemeris calculation, so the result may
+        // differ from a plain Moshier calculation by a tiny amount (about
+        // 0.00005")
+        expected_ret = calc_in_context(
+                compacted,
+                jd, body, SEFLG_MOSEPH,
+                expected
+            );
+        g_assert_cmpint(ret, ==, expected_ret);
+        g_assert_cmpint(ret & SEFLG_MOSEPH, ==, SEFLG_MOSEPH);
+
+        for (i = 0; i < 6; i++) {
+            gswe_assert_fuzzy_equals(
+                    xx[i],
+                    expected[i],
+                    1e-7 * (fabs(expected[i]) + 1.0)
+                );
+        }
+    }
+}
+
+static void
+test_ephemeris_compact(void)
+{
+    struct swe_context *original = swe_context_new(),
+                       *compacted = swe_context_new(),
+                       *previous = swe_context_get_current();
+    gint32 body = SE_MARS;
+    gchar serr[AS_MAXCH],
+          *dir = g_dir_make_tmp("gswe-compact-XXXXXX", NULL),
+          *path,
+          *in,
+          *out;
+    gint i;
+
+    g_assert(dir != NULL);
+
+    path = g_strconcat(dir, G_SEARCHPATH_SEPARATOR_S, SWEPH_DATA_DIR, NULL);
+    in = g_build_filename(SWEPH_DATA_DIR, "sepl_18.se1", NULL);
+    out = g_build_filename(dir, "sepl_18.se1", NULL);
+
+    // Keep only Mars (and the Sun and the Earth-Moon barycenter, which
+    // every position needs) for ten years
+    g_assert_cmpint(
+            swe_compact_ephe_file(
+                in, out,
+                COMPACT_START, COMPACT_END,
+                &body, 1,
+                serr
+            ),
+            ==,
+            OK
+        );
+
+    // The compacted file comes first in the path; the others (like the
+    // Moon's) are read from the original directory
+    swe_context_switch(original, NULL);
+    swe_set_ephe_path(SWEPH_DATA_DIR);
+    swe_context_switch(compacted, NULL);
+    swe_set_ephe_path(path);
+    swe_context_switch(previous, NULL);
+
+    for (i = 0; i <= COMPACT_DATES; i++) {
+        gdouble jd = COMPACT_START
+                + (COMPACT_END - COMPACT_START) * i / COMPACT_DATES;
+
+        // Inside the range, the kept bodies are read from the very same
+        // coefficients
+        check_compacted(original, compacted, jd, SE_MARS, TRUE);
+        check_compacted(original, compacted, jd, SE_SUN, TRUE);
+
+        // Jupiter was dropped
+        check_compacted(original, compacted, jd, SE_JUPITER, FALSE);
+
+        // Outside the range, even Mars falls back
+        check_compacted(
+                original, compacted,
+                COMPACT_START - 100.0 - 20.0 * i,
+                SE_MARS,
+                FALSE
+            );
+        check_compacted(
+                original, compacted,
+                COMPACT_END + 100.0 + 20.0 * i,
+                SE_MARS,
+                FALSE
+            );
+    }
+
+    swe_context_free(original);
+    swe_context_free(compacted);
+    g_remove(out);
+    g_rmdir(dir);
+
+    g_free(dir);
+    g_free(path);
+    g_free(in);
+    g_free(out);
+}
+
+// The bodies the bundle test calculates; the Sun, the Moon and Mars come
+// from the bundle, Chiron from the directory
+static const gint32 bundle_bodies[] = {
+    SE_SUN, SE_MOON, SE_MARS, SE_CHIRON
+};
+
+#define BUNDLE_DATES 20
+#define BUNDLE_POSITIONS (BUNDLE_DATES * G_N_ELEMENTS(bundle_bodies))
+
+// Calculates the bundle test positions with the files of @path and of the
+// bundle in use. A new context is used, so no file opened before is reused
+static void
+calc_bundle_positions(gchar *path, gint32 *ret, gdouble *xx)
+{
+    struct swe_context *context = swe_context_new(),
+                       *previous = swe_context_get_current();
+    gchar serr[AS_MAXCH];
+    guint i;
+
+    swe_context_switch(context, NULL);
+    swe_set_ephe_path(path);
+
+    for (i = 0; i < BUNDLE_POSITIONS; i++) {
+        ret[i] = swe_calc(
+                2415020.5 + 1000.0 * (i / G_N_ELEMENTS(bundle_bodies)),
+                bundle_bodies[i % G_N_ELEMENTS(bundle_bodies)],
+                SEFLG_SWIEPH | SEFLG_SPEED,
+                xx + 6 * i,
+                serr
+            );
+    }
+
+    swe_context_switch(previous, NULL);
+    swe_context_free(context);
+}
+
+static void
+test_ephemeris_bundle(void)
+{
+    gint32 expected_ret[BUNDLE_POSITIONS],
+           ret[BUNDLE_POSITIONS];
+    gdouble expected[6 * BUNDLE_POSITIONS],
+            xx[6 * BUNDLE_POSITIONS];
+    gchar serr[AS_MAXCH],
+          *dir = g_dir_make_tmp("gswe-bundle-XXXXXX", NULL),
+          *argv[] = {
+              SWEBUNDLE, "-o", NULL, "-d", SWEPH_DATA_DIR,
+              "sepl_18.se1", "semo_18.se1",
+              NULL
+          },
+          *bundle,
+          *in,
+          *asteroids,
+          *contents;
+    gsize length;
+    gint status,
+         mode;
+    guint i;
+    GError *err = NULL;
+
+    g_assert(dir != NULL);
+
+    bundle = g_build_filename(dir, "sweph.bundle", NULL);
+    in = g_build_filename(SWEPH_DATA_DIR, "seas_18.se1", NULL);
+    asteroids = g_build_filename(dir, "seas_18.se1", NULL);
+
+    calc_bundle_positions(SWEPH_DATA_DIR, expected_ret, expected);
+
+    for (i = 0; i < BUNDLE_POSITIONS; i++) {
+        g_assert_cmpint(expected_ret[i] & SEFLG_SWIEPH, ==, SEFLG_SWIEPH);
+    }
+
+    // Pack the files of the planets and the Moon with swebundle, and put
+    // the one of the asteroids in the directory
+    argv[2] = bundle;
+    g_assert_true(g_spawn_sync(
+            NULL, argv, NULL, 0, NULL, NULL,
+            NULL, NULL,
+            &status,
+            &err
+        ));
+    g_assert_no_error(err);
+    g_assert_cmpint(status, ==, 0);
+
+    g_assert_true(g_file_get_contents(in, &contents, &length, NULL));
+    g_assert_true(g_file_set_contents(asteroids, contents, length, NULL));
+    g_free(contents);
+
+    // Without the bundle, the directory has no planets and no Moon
+    calc_bundle_positions(dir, ret, xx);
+
+    for (i = 0; i < BUNDLE_POSITIONS; i++) {
+        if (bundle_bodies[i % G_N_ELEMENTS(bundle_bodies)] != SE_CHIRON) {
+            g_assert_cmpint(ret[i] & SEFLG_MOSEPH, ==, SEFLG_MOSEPH);
+        }
+    }
+
+    // With the bundle mapped from its file, then given in memory, every
+    // position is the same as with the plain directory
+    contents = NULL;
+
+    for (mode = 0; mode < 2; mode++) {
+        if (mode == 0) {
+            g_assert_cmpint(swe_open_ephe_bundle(bundle, serr), ==, OK);
+        } else {
+            g_assert_true(
+                    g_file_get_contents(bundle, &contents, &length, NULL)
+                );
+            g_assert_cmpint(
+                    swe_set_ephe_bundle(
+                        (unsigned char *)contents, length,
+                        serr
+                    ),
+                    ==,
+                    OK
+                );
+        }
+
+        calc_bundle_positions(dir, ret, xx);
+
+        for (i = 0; i < BUNDLE_POSITIONS; i++) {
+            g_assert_cmpint(ret[i], ==, expected_ret[i]);
+        }
+
+        for (i = 0; i < 6 * BUNDLE_POSITIONS; i++) {
+            g_assert_cmpfloat(xx[i], ==, expected[i]);
+        }
+    }
+
+    swe_set_ephe_bundle(NULL, 0, NULL);
+    g_free(contents);
+
+    g_remove(bundle);
+    g_remove(asteroids);
+    g_rmdir(dir);
+
+    g_free(dir);
+    g_free(bundle);
+    g_free(in);
+    g_free(asteroids);
+}
+
+// Two dates in different segments of every body, and how many times the
+// segment cache test goes back and forth between them
+static const gdouble cache_dates[] = { 2451545.0, 2452545.0 };
+
+#define CACHE_ROUNDS 10
+
+// Calculates Mars at the cache test dates, alternating between them
+static void
+calc_cache_round(gdouble *xx)
+{
+    gchar serr[AS_MAXCH];
+    guint d;
+
+    for (d = 0; d < G_N_ELEMENTS(cache_dates); d++) {
+        g_assert_cmpint(
+                swe_calc(
+                    cache_dates[d], SE_MARS, SEFLG_SWIEPH | SEFLG_SPEED,
+                    xx + 6 * d,
+                    serr
+                ),
+                >=,
+                0
+            );
+    }
+}
+
+static void
+test_ephemeris_segment_cache(void)
+{
+    struct swe_context *context = swe_context_new(),
+                       *previous = swe_context_get_current();
+    gdouble uncached[CACHE_ROUNDS][6 * G_N_ELEMENTS(cache_dates)],
+            cached[CACHE_ROUNDS][6 * G_N_ELEMENTS(cache_dates)];
+    gint32 hits,
+           misses,
+           used,
+           first_hits,
+           first_misses,
+           round_hits = 0,
+           last_hits;
+    guint i;
+    gint r;
+
+    // The counters belong to the context; the cache to all of them
+    swe_context_switch(context, NULL);
+    swe_set_ephe_path(SWEPH_DATA_DIR);
+
+    // Without the cache, nothing is looked up, and nothing is stored
+    swe_set_segment_cache_size(0);
+    swe_get_segment_cache_stats(&first_hits, &first_misses, &used);
+    g_assert_cmpint(used, ==, 0);
+
+    for (r = 0; r < CACHE_ROUNDS; r++) {
+        calc_cache_round(uncached[r]);
+    }
+
+    swe_get_segment_cache_stats(&hits, &misses, &used);
+    g_assert_cmpint(hits, ==, first_hits);
+    g_assert_cmpint(misses, ==, first_misses);
+    g_assert_cmpint(used, ==, 0);
+
+    // With the default size, the first round reads the segments of both
+    // dates, and every round after it finds all of them in the cache
+    swe_set_segment_cache_size(1024 * 1024);
+    calc_cache_round(cached[0]);
+
+    swe_get_segment_cache_stats(&first_hits, &first_misses, &used);
+    g_assert_cmpint(first_misses, >, misses);
+    g_assert_cmpint(used, >, 0);
+    last_hits = first_hits;
+
+    for (r = 1; r < CACHE_ROUNDS; r++) {
+        calc_cache_round(cached[r]);
+        swe_get_segment_cache_stats(&hits, &misses, NULL);
+
+        g_assert_cmpint(misses, ==, first_misses);
+
+        if (r == 1) {
+            round_hits = hits - last_hits;
+            g_assert_cmpint(round_hits, >, 0);
+        } else {
+            g_assert_cmpint(hits - last_hits, ==, round_hits);
+        }
+
+        last_hits = hits;
+    }
+
+    // The cached segments give the very same positions
+    for (r = 0; r < CACHE_ROUNDS; r++) {
+        for (i = 0; i < 6 * G_N_ELEMENTS(cache_dates); i++) {
+            g_assert_cmpfloat(cached[r][i], ==, uncached[r][i]);
+        }
+    }
+
+    swe_context_switch(previous, NULL);
+    swe_context_free(context);
+}
+
+int
+main(int argc, char **argv)
+{
+    gboolean bundles_supported;
+
+    g_test_init(&argc, &argv, NULL);
+    gswe_init();
+
+    // The tests read the files of SWEPH_DATA_DIR; a bundle gswe_init()
+    // found would take their place. Without bundle support, the bundle test
+    // is skipped
+    bundles_supported = (swe_set_ephe_bundle(NULL, 0, NULL) == OK);
+
+    g_test_add_func(
+            "/gswe/ephemeris/nutation/iau2000b",
+            test_ephemeris_nutation_2000b
+        );
+    g_test_add_func(
+            "/gswe/ephemeris/nutation/iau2000a",
+            test_ephemeris_nutation_2000a
+        );
+    g_test_add_data_func(
+            "/gswe/ephemeris/series/scalar",
+            GINT_TO_POINTER(SWI_ECHEB_SCALAR),
+            test_ephemeris_series
+        );
+    g_test_add_data_func(
+            "/gswe/ephemeris/series/sse2",
+            GINT_TO_POINTER(SWI_ECHEB_SSE2),
+            test_ephemeris_series
+        );
+    g_test_add_data_func(
+            "/gswe/ephemeris/series/avx",
+            GINT_TO_POINTER(SWI_ECHEB_AVX),
+            test_ephemeris_series
+        );
+    g_test_add_func(
+            "/gswe/ephemeris/chebyshev",
+            test_ephemeris_chebyshev
+        );
+    g_test_add_func("/gswe/ephemeris/compact", test_ephemeris_compact);
+
+    g_test_add_func(
+            "/gswe/ephemeris/segment_cache",
+            test_ephemeris_segment_cache
+        );
+
+    if (bundles_supported) {
+        g_test_add_func("/gswe/ephemeris/bundle", test_ephemeris_bundle);
+    }
+
+    return g_test_run();
+}
@@ -0,0 +1,264 @@
+#undef G_DISABLE_ASSERT
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <swe-glib.h>
+#include "../swe/src/swephexp.h"
+
+#include "test-asserts.h"
+
+static void
+test_fixed_star_lookup_name(void)
+{
+    GsweFixedStar *star,
+                  *other_star;
+    GError *err = NULL;
+    guint count;
+
+    // The first lookup loads the catalogue
+    star = gswe_fixed_star_lookup("aldeb", &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(star);
+
+    count = gswe_fixed_star_catalogue_get_count();
+    g_assert_cmpuint(count, >, 0);
+    g_assert_cmpuint(gswe_fixed_star_get_number(star), >=, 1);
+    g_assert_cmpuint(gswe_fixed_star_get_number(star), <=, count);
+    g_assert_cmpstr(gswe_fixed_star_get_name(star), ==, "Aldebaran");
+    g_assert_cmpstr(gswe_fixed_star_get_nomenclature(star), ==, "alTau");
+    gswe_assert_fuzzy_equals(gswe_fixed_star_get_magnitude(star), 0.985, 0.001);
+
+    // The nomenclature name finds the same star
+    other_star = gswe_fixed_star_lookup(",alTau", &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(other_star);
+    g_assert_cmpuint(
+            gswe_fixed_star_get_number(other_star),
+            ==,
+            gswe_fixed_star_get_number(star)
+        );
+    gswe_fixed_star_unref(other_star);
+
+    // Loading the catalogue again keeps it as it is
+    g_assert_true(gswe_fixed_star_catalogue_load(&err));
+    g_assert_no_error(err);
+    g_assert_cmpuint(gswe_fixed_star_catalogue_get_count(), ==, count);
+
+    gswe_fixed_star_unref(star);
+}
+
+static void
+test_fixed_star_lookup_number(void)
+{
+    GsweFixedStar *star,
+                  *by_name;
+    GError *err = NULL;
+    guint count;
+
+    g_assert_true(gswe_fixed_star_catalogue_load(&err));
+    g_assert_no_error(err);
+    count = gswe_fixed_star_catalogue_get_count();
+
+    by_name = gswe_fixed_star_lookup("Regulus", &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(by_name);
+
+    star = gswe_fixed_star_lookup_by_number(
+            gswe_fixed_star_get_number(by_name),
+            &err
+        );
+    g_assert_no_error(err);
+    g_assert_nonnull(star);
+    g_assert_cmpuint(
+            gswe_fixed_star_get_number(star),
+            ==,
+            gswe_fixed_star_get_number(by_name)
+        );
+    g_assert_cmpstr(
+            gswe_fixed_star_get_name(star),
+            ==,
+            gswe_fixed_star_get_name(by_name)
+        );
+    g_assert_cmpstr(gswe_fixed_star_get_nomenclature(star), ==, "alLeo");
+    gswe_fixed_star_unref(star);
+    gswe_fixed_star_unref(by_name);
+
+    // The first and the last star of the catalogue
+    star = gswe_fixed_star_lookup_by_number(1, &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(star);
+    g_assert_cmpuint(gswe_fixed_star_get_number(star), ==, 1);
+    gswe_fixed_star_unref(star);
+
+    star = gswe_fixed_star_lookup_by_number(count, &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(star);
+    g_assert_cmpuint(gswe_fixed_star_get_number(star), ==, count);
+    gswe_fixed_star_unref(star);
+}
+
+static void
+test_fixed_star_lookup_missing(void)
+{
+    GsweFixedStar *star;
+    GError *err = NULL;
+
+    star = gswe_fixed_star_lookup("Nosuchstar", &err);
+    g_assert_null(star);
+    g_assert_error(err, GSWE_ERROR, GSWE_ERROR_UNKNOWN_STAR);
+    g_clear_error(&err);
+
+    star = gswe_fixed_star_lookup_by_number(0, &err);
+    g_assert_null(star);
+    g_assert_error(err, GSWE_ERROR, GSWE_ERROR_UNKNOWN_STAR);
+    g_clear_error(&err);
+
+    star = gswe_fixed_star_lookup_by_number(
+            gswe_fixed_star_catalogue_get_count() + 1,
+            &err
+        );
+    g_assert_null(star);
+    g_assert_error(err, GSWE_ERROR, GSWE_ERROR_UNKNOWN_STAR);
+    g_clear_error(&err);
+}
+
+// The largest difference swe_fixstar_all() may have from swe_fixstar(), in
+// degrees (0.000002")
+#define STAR_BOUND (0.000002 / 3600.0)
+
+static const gdouble star_dates[] = {
+    2451545.0, 2456536.9946, 2415020.5, 2488069.5, 2305447.5
+};
+
+// The flag sets of the vectorized code, and some that fall back to
+// swe_fixstar() for every star
+static const gint32 star_flags[] = {
+    SEFLG_SWIEPH,
+    SEFLG_SWIEPH | SEFLG_TOPOCTR,
+    SEFLG_SWIEPH | SEFLG_J2000 | SEFLG_NONUT,
+    SEFLG_SWIEPH | SEFLG_ICRS,
+    SEFLG_SWIEPH | SEFLG_TRUEPOS | SEFLG_NOABERR | SEFLG_NOGDEFL,
+    SEFLG_MOSEPH,
+    SEFLG_MOSEPH | SEFLG_TOPOCTR | SEFLG_J2000,
+    SEFLG_SWIEPH | SEFLG_HELCTR,
+    SEFLG_SWIEPH | SEFLG_BARYCTR,
+    SEFLG_SWIEPH | SEFLG_SIDEREAL,
+};
+
+static void
+assert_star_angle(gdouble all, gdouble single, gint32 number, gint32 flags)
+{
+    gdouble difference = fmod(fabs(all - single), 360.0);
+
+    if (difference > 180.0) {
+        difference = 360.0 - difference;
+    }
+
+    if (difference > STAR_BOUND) {
+        g_error(
+                "Star %d with flags %x is at %.12f instead of %.12f",
+                number, flags,
+                all, single
+            );
+    }
+}
+
+static void
+test_fixed_star_all(void)
+{
+    GError *err = NULL;
+    gint32 count,
+           number;
+    gdouble *lon,
+            *lat,
+            *ra,
+            *dec;
+    gchar serr[AS_MAXCH];
+    guint d,
+          f;
+
+    g_assert_true(gswe_fixed_star_catalogue_load(&err));
+    g_assert_no_error(err);
+    count = gswe_fixed_star_catalogue_get_count();
+
+    lon = g_new(gdouble, count);
+    lat = g_new(gdouble, count);
+    ra = g_new(gdouble, count);
+    dec = g_new(gdouble, count);
+
+    swe_set_topo(19.8166667, 47.5, 100.0);
+    swe_set_sid_mode(SE_SIDM_LAHIRI, 0.0, 0.0);
+
+    for (d = 0; d < G_N_ELEMENTS(star_dates); d++) {
+        for (f = 0; f < G_N_ELEMENTS(star_flags); f++) {
+            gint32 flags = star_flags[f];
+
+            g_assert_cmpint(swe_fixstar_all(
+                    star_dates[d], flags,
+                    lon, lat, ra, dec,
+                    serr
+                ), !=, ERR);
+
+            for (number = 1; number <= count; number++) {
+                gchar star[SE_MAX_STNAME * 2];
+                gdouble xx[6];
+                gint32 i = number - 1;
+
+                // swe_fixstar() changes the name it gets
+                g_snprintf(star, sizeof(star), "%d", number);
+                g_assert_cmpint(
+                        swe_fixstar(star, star_dates[d], flags, xx, serr),
+                        !=,
+                        ERR
+                    );
+                assert_star_angle(lon[i], xx[0], number, flags);
+                assert_star_angle(lat[i], xx[1], number, flags);
+
+                g_snprintf(star, sizeof(star), "%d", number);
+                g_assert_cmpint(swe_fixstar(
+                        star,
+                        star_dates[d], flags | SEFLG_EQUATORIAL,
+                        xx,
+                        serr
+                    ), !=, ERR);
+                assert_star_angle(ra[i], xx[0], number, flags);
+                assert_star_angle(dec[i], xx[1], number, flags);
+            }
+        }
+    }
+
+    swe_set_sid_mode(SE_SIDM_FAGAN_BRADLEY, 0.0, 0.0);
+
+    g_free(lon);
+    g_free(lat);
+    g_free(ra);
+    g_free(dec);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    // The star catalogue is not installed with the ephemeris files, so it is
+    // read from the Swiss Ephemeris sources. The tests all run in this thread
+    gswe_init();
+    swe_set_ephe_path(STAR_CATALOGUE_DIR);
+
+    g_test_add_func(
+            "/gswe/fixed_star/lookup_name",
+            test_fixed_star_lookup_name
+        );
+    g_test_add_func(
+            "/gswe/fixed_star/lookup_number",
+            test_fixed_star_lookup_number
+        );
+    g_test_add_func(
+            "/gswe/fixed_star/lookup_missing",
+            test_fixed_star_lookup_missing
+        );
+    g_test_add_func("/gswe/fixed_star/all", test_fixed_star_all);
+
+    return g_test_run();
+}
@@ -0,0 +1,1206 @@
+#undef G_DISABLE_ASSERT
+
+#include <float.h>
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <swe-glib.h>
+#include "../swe/src/swephexp.h"
+
+#include "test-asserts.h"
+
+static GsweMoment *
+create_moment(void)
+{
+    GsweTimestamp *timestamp;
+    GsweMoment *moment;
+
+    timestamp = gswe_timestamp_new_from_gregorian_full(
+            1983, 3, 7,
+            11, 54, 45, 0,
+            1.0
+        );
+    moment = gswe_moment_new_full(
+            timestamp,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS
+        );
+    g_object_unref(timestamp);
+
+    return moment;
+}
+
+static void
+test_moment_topo_reuse(void)
+{
+    GsweMoment *moment = create_moment(),
+               *other_moment = create_moment();
+    gint32 resets;
+
+    gswe_moment_add_all_planets(moment);
+    gswe_moment_add_all_planets(other_moment);
+
+    /* Calculating all the planets sets the observer at most once */
+    resets = swe_get_topo_reset_count();
+    gswe_moment_get_all_planets(moment);
+    g_assert_cmpint(swe_get_topo_reset_count() - resets, <=, 1);
+
+    /* Another moment at the same place doesn't need a new observer */
+    resets = swe_get_topo_reset_count();
+    gswe_moment_get_all_planets(other_moment);
+    g_assert_cmpint(swe_get_topo_reset_count(), ==, resets);
+
+    /* Neither does a new time at the same place */
+    gswe_timestamp_set_gregorian_year(
+            gswe_moment_get_timestamp(moment),
+            2013,
+            NULL
+        );
+    gswe_moment_get_all_planets(moment);
+    g_assert_cmpint(swe_get_topo_reset_count(), ==, resets);
+
+    /* Moving the observer sets it exactly once */
+    gswe_moment_set_coordinates(moment, 19.0, 47.0, 100.0);
+    gswe_moment_get_all_planets(moment);
+    g_assert_cmpint(swe_get_topo_reset_count(), ==, resets + 1);
+
+    g_object_unref(moment);
+    g_object_unref(other_moment);
+}
+
+static void
+assert_same_planets(GsweMoment *moment, GsweMoment *reference)
+{
+    GList *planets = gswe_moment_get_all_planets(moment),
+          *references = gswe_moment_get_all_planets(reference);
+
+    g_assert_cmpuint(g_list_length(planets), ==, g_list_length(references));
+
+    for (; planets; planets = planets->next, references = references->next) {
+        gswe_assert_fuzzy_equals(
+                gswe_planet_data_get_position(planets->data),
+                gswe_planet_data_get_position(references->data),
+                0.0000001
+            );
+    }
+}
+
+static void
+test_moment_context_alternate(void)
+{
+    GsweContext *context = gswe_context_new(),
+                *other_context = gswe_context_new();
+    GsweMoment *moment = create_moment(),
+               *other_moment = create_moment(),
+               *reference = create_moment(),
+               *other_reference = create_moment();
+    gdouble jd;
+    gint32 resets;
+    guint i;
+
+    gswe_moment_set_context(moment, context);
+    gswe_moment_set_context(other_moment, other_context);
+    gswe_moment_set_coordinates(other_moment, -0.1275, 51.5072, 35.0);
+    gswe_moment_set_coordinates(other_reference, -0.1275, 51.5072, 35.0);
+
+    gswe_moment_add_all_planets(moment);
+    gswe_moment_add_all_planets(other_moment);
+    gswe_moment_add_all_planets(reference);
+    gswe_moment_add_all_planets(other_reference);
+
+    // Each context gets its observer once
+    gswe_moment_get_all_planets(moment);
+    gswe_moment_get_all_planets(other_moment);
+
+    jd = gswe_timestamp_get_julian_day_et(
+            gswe_moment_get_timestamp(moment),
+            NULL
+        );
+
+    for (i = 0; i < 10; i++) {
+        jd += 3.7;
+
+        // Switching between the two moments keeps both observers
+        resets = swe_get_topo_reset_count();
+        gswe_timestamp_set_julian_day_et(
+                gswe_moment_get_timestamp(moment),
+                jd,
+                NULL
+            );
+        gswe_timestamp_set_julian_day_et(
+                gswe_moment_get_timestamp(other_moment),
+                jd,
+                NULL
+            );
+        gswe_moment_get_all_planets(moment);
+        gswe_moment_get_all_planets(other_moment);
+        g_assert_cmpint(swe_get_topo_reset_count(), ==, resets);
+
+        // The positions are the same as without a context
+        gswe_timestamp_set_julian_day_et(
+                gswe_moment_get_timestamp(reference),
+                jd,
+                NULL
+            );
+        gswe_timestamp_set_julian_day_et(
+                gswe_moment_get_timestamp(other_reference),
+                jd,
+                NULL
+            );
+        assert_same_planets(moment, reference);
+        assert_same_planets(other_moment, other_reference);
+    }
+
+    g_object_unref(moment);
+    g_object_unref(other_moment);
+    g_object_unref(reference);
+    g_object_unref(other_reference);
+    g_object_unref(context);
+    g_object_unref(other_context);
+}
+
+static void
+test_moment_series(void)
+{
+    GsweMoment *moment = create_moment();
+    GswePlanet planets[] = { GSWE_PLANET_SUN, GSWE_PLANET_ASCENDANT };
+    gdouble jd[2],
+            longitude[4];
+    gint house[4];
+    GsweMomentSeries series = { longitude, NULL, NULL, NULL, house };
+    GswePlanetData *planet_data;
+    guint p;
+
+    jd[0] = gswe_timestamp_get_julian_day_et(
+            gswe_moment_get_timestamp(moment),
+            NULL
+        );
+    jd[1] = jd[0] + 1.0;
+
+    g_assert_true(gswe_moment_calculate_series(
+            jd, 2, FALSE,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS,
+            planets, 2,
+            &series,
+            NULL
+        ));
+
+    /* The first instant must match the moment itself */
+    for (p = 0; p < 2; p++) {
+        gswe_moment_add_planet(moment, planets[p], NULL);
+        planet_data = gswe_moment_get_planet(moment, planets[p], NULL);
+
+        gswe_assert_fuzzy_equals(
+                longitude[p * 2],
+                gswe_planet_data_get_position(planet_data),
+                0.000001
+            );
+    }
+
+    /* The Ascendant is always on the cusp of the first house */
+    g_assert_cmpint(house[2], ==, 1);
+
+    /* The Sun moves about a degree a day */
+    gswe_assert_fuzzy_equals(longitude[1] - longitude[0], 1.0, 0.05);
+
+    g_object_unref(moment);
+}
+
+static void
+test_moment_series_parallel(void)
+{
+    GswePlanet planets[] = {
+        GSWE_PLANET_SUN,
+        GSWE_PLANET_MOON,
+        GSWE_PLANET_MARS,
+        GSWE_PLANET_MC
+    };
+    const guint count = 1000,
+                planet_count = G_N_ELEMENTS(planets);
+    gdouble *jd = g_new(gdouble, count),
+            *serial = g_new(gdouble, count * planet_count),
+            *parallel = g_new(gdouble, count * planet_count);
+    GsweMomentSeries serial_series = { serial, NULL, NULL, NULL, NULL },
+                     parallel_series = { parallel, NULL, NULL, NULL, NULL };
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        jd[i] = 2445400.5 + i * 0.25;
+    }
+
+    g_assert_true(gswe_moment_calculate_series(
+            jd, count, TRUE,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS,
+            planets, planet_count,
+            &serial_series,
+            NULL
+        ));
+    g_assert_true(gswe_moment_calculate_series_parallel(
+            jd, count, TRUE,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS,
+            planets, planet_count,
+            4,
+            &parallel_series,
+            NULL
+        ));
+
+    for (i = 0; i < count * planet_count; i++) {
+        gswe_assert_fuzzy_equals(parallel[i], serial[i], 0.0000001);
+    }
+
+    g_free(jd);
+    g_free(serial);
+    g_free(parallel);
+}
+
+static gdouble
+get_position(GsweMoment *moment, GswePlanet planet)
+{
+    GswePlanetData *planet_data = gswe_moment_get_planet(moment, planet, NULL);
+    gdouble position = gswe_planet_data_get_position(planet_data);
+
+    gswe_planet_data_unref(planet_data);
+
+    return position;
+}
+
+// The error bound of the positions with interpolated nutation, in degrees
+// (0.0001")
+#define NUTATION_BOUND (0.0001 / 3600.0)
+
+static const GswePlanet nutation_planets[] = {
+    GSWE_PLANET_SUN,
+    GSWE_PLANET_MOON,
+    GSWE_PLANET_MARS,
+    GSWE_PLANET_JUPITER,
+};
+
+static void
+get_nutation_positions(GsweMoment *moment, gdouble *positions)
+{
+    guint p;
+
+    for (p = 0; p < G_N_ELEMENTS(nutation_planets); p++) {
+        gswe_moment_add_planet(moment, nutation_planets[p], NULL);
+        positions[p] = get_position(moment, nutation_planets[p]);
+    }
+}
+
+static void
+get_nutation_series(const gdouble *jd, guint count, gdouble *positions)
+{
+    GsweMomentSeries series = { positions, NULL, NULL, NULL, NULL };
+
+    g_assert_true(gswe_moment_calculate_series_parallel(
+            jd, count, FALSE,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS,
+            nutation_planets, G_N_ELEMENTS(nutation_planets),
+            4,
+            &series,
+            NULL
+        ));
+}
+
+// Checks that @interpolated is within the bound of @exact, but is not the
+// same, so the nutation table was actually used
+static void
+assert_interpolated(const gdouble *interpolated, const gdouble *exact, guint n)
+{
+    gboolean differs = FALSE;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        gswe_assert_fuzzy_equals(interpolated[i], exact[i], NUTATION_BOUND);
+        differs |= (interpolated[i] != exact[i]);
+    }
+
+    g_assert_true(differs);
+}
+
+static void
+test_moment_interpolate_nutation(void)
+{
+    const guint planet_count = G_N_ELEMENTS(nutation_planets),
+                count = 100;
+    GsweContext *context = gswe_context_new();
+    GsweMoment *moment;
+    gdouble exact[G_N_ELEMENTS(nutation_planets)],
+            interpolated[G_N_ELEMENTS(nutation_planets)],
+            jd[100],
+            exact_series[100 * G_N_ELEMENTS(nutation_planets)],
+            interpolated_series[100 * G_N_ELEMENTS(nutation_planets)];
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        jd[i] = 2445400.5 + i * 0.37;
+    }
+
+    g_assert_false(gswe_get_interpolate_nutation());
+
+    moment = create_moment();
+    get_nutation_positions(moment, exact);
+    g_object_unref(moment);
+    get_nutation_series(jd, count, exact_series);
+
+    gswe_set_interpolate_nutation(TRUE);
+    g_assert_true(gswe_get_interpolate_nutation());
+
+    // The setting reaches the thread's own state, ...
+    moment = create_moment();
+    get_nutation_positions(moment, interpolated);
+    g_object_unref(moment);
+    assert_interpolated(interpolated, exact, planet_count);
+
+    // ... the contexts, ...
+    moment = create_moment();
+    gswe_moment_set_context(moment, context);
+    get_nutation_positions(moment, interpolated);
+    g_object_unref(moment);
+    assert_interpolated(interpolated, exact, planet_count);
+
+    // ... and the worker threads of the series
+    get_nutation_series(jd, count, interpolated_series);
+    assert_interpolated(
+            interpolated_series,
+            exact_series,
+            count * planet_count
+        );
+
+    // Switching it off gives back the summed series everywhere
+    gswe_set_interpolate_nutation(FALSE);
+
+    moment = create_moment();
+    gswe_moment_set_context(moment, context);
+    get_nutation_positions(moment, interpolated);
+    g_object_unref(moment);
+
+    for (i = 0; i < planet_count; i++) {
+        g_assert_cmpfloat(interpolated[i], ==, exact[i]);
+    }
+
+    get_nutation_series(jd, count, interpolated_series);
+
+    for (i = 0; i < count * planet_count; i++) {
+        g_assert_cmpfloat(interpolated_series[i], ==, exact_series[i]);
+    }
+
+    g_object_unref(context);
+}
+
+static void
+test_moment_opposite_points(void)
+{
+    GsweMoment *moment = create_moment();
+    GswePlanet planets[] = {
+        GSWE_PLANET_ASCENDANT, GSWE_PLANET_DESCENDANT,
+        GSWE_PLANET_MC, GSWE_PLANET_IC,
+        GSWE_PLANET_VERTEX, GSWE_PLANET_ANTIVERTEX,
+        GSWE_PLANET_MOON_NODE, GSWE_PLANET_MOON_SOUTH_NODE,
+    };
+    gdouble jd,
+            cusps[13],
+            ascmc[10],
+            longitude[G_N_ELEMENTS(planets)],
+            latitude[G_N_ELEMENTS(planets)];
+    GsweMomentSeries series = { longitude, latitude, NULL, NULL, NULL };
+    guint p;
+
+    for (p = 0; p < G_N_ELEMENTS(planets); p++) {
+        gswe_moment_add_planet(moment, planets[p], NULL);
+    }
+
+    jd = gswe_timestamp_get_julian_day_et(
+            gswe_moment_get_timestamp(moment),
+            NULL
+        );
+    swe_houses(jd, 47.5, 19.8166667, 'P', cusps, ascmc);
+
+    // The Ascendant of this moment is at 104°, so folding the opposite
+    // points into [0; 180) would put them on top of it
+    gswe_assert_fuzzy_equals(
+            get_position(moment, GSWE_PLANET_ASCENDANT),
+            ascmc[0],
+            0.000001
+        );
+    gswe_assert_fuzzy_equals(
+            get_position(moment, GSWE_PLANET_DESCENDANT),
+            ascmc[0] + 180.0,
+            0.000001
+        );
+
+    // The IC is opposite to the MC, not to the ARMC
+    gswe_assert_fuzzy_equals(
+            fmod(get_position(moment, GSWE_PLANET_IC) + 180.0, 360.0),
+            ascmc[1],
+            0.000001
+        );
+
+    gswe_assert_fuzzy_equals(
+            fmod(get_position(moment, GSWE_PLANET_ANTIVERTEX) + 180.0, 360.0),
+            ascmc[3],
+            0.000001
+        );
+    gswe_assert_fuzzy_equals(
+            fmod(
+                get_position(moment, GSWE_PLANET_MOON_SOUTH_NODE) + 180.0,
+                360.0
+            ),
+            get_position(moment, GSWE_PLANET_MOON_NODE),
+            0.000001
+        );
+
+    // The series gives the same points, and mirrors the latitude of the
+    // south node
+    g_assert_true(gswe_moment_calculate_series(
+            &jd, 1, FALSE,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS,
+            planets, G_N_ELEMENTS(planets),
+            &series,
+            NULL
+        ));
+
+    for (p = 0; p < G_N_ELEMENTS(planets); p++) {
+        gswe_assert_fuzzy_equals(
+                longitude[p],
+                get_position(moment, planets[p]),
+                0.000001
+            );
+    }
+
+    gswe_assert_fuzzy_equals(latitude[7], -latitude[6], 0.000001);
+
+    g_object_unref(moment);
+}
+
+static const GswePlanet pair_planets[] = {
+    GSWE_PLANET_SUN, GSWE_PLANET_MOON, GSWE_PLANET_MERCURY,
+    GSWE_PLANET_VENUS, GSWE_PLANET_MARS, GSWE_PLANET_JUPITER,
+    GSWE_PLANET_SATURN, GSWE_PLANET_ASCENDANT, GSWE_PLANET_MC,
+    GSWE_PLANET_MOON_NODE,
+};
+
+static GsweMoment *
+create_pair_moment(gdouble jd)
+{
+    GsweTimestamp *timestamp = gswe_timestamp_new_from_julian_day(jd);
+    GsweMoment *moment = gswe_moment_new_full(
+            timestamp,
+            19.8166667, 47.5, 100.0,
+            GSWE_HOUSE_SYSTEM_PLACIDUS
+        );
+    guint p;
+
+    g_object_unref(timestamp);
+
+    for (p = 0; p < G_N_ELEMENTS(pair_planets); p++) {
+        gswe_moment_add_planet(moment, pair_planets[p], NULL);
+    }
+
+    return moment;
+}
+
+// Checks the aspects and antiscia of @moment against those calculated for
+// every planet pair on its own, and returns the number of pairs in a
+// quincunx or in antiscion on the mid Leo/Aquarius axis, which the orb edge
+// tests move around
+static guint
+check_all_pairs(GsweMoment *moment)
+{
+    GList *l;
+    guint found = 0;
+
+    for (l = gswe_moment_get_all_aspects(moment); l; l = g_list_next(l)) {
+        GsweAspectData *aspect_data = l->data,
+                       *expected = gswe_aspect_data_new_with_planets(
+                               gswe_aspect_data_get_planet1(aspect_data),
+                               gswe_aspect_data_get_planet2(aspect_data)
+                           );
+
+        g_assert_cmpint(
+                gswe_aspect_data_get_aspect(aspect_data),
+                ==,
+                gswe_aspect_data_get_aspect(expected)
+            );
+
+        if (gswe_aspect_data_get_aspect(expected) == GSWE_ASPECT_QUINCUNX) {
+            found++;
+        }
+
+        gswe_aspect_data_unref(expected);
+    }
+
+    for (l = gswe_moment_get_all_antiscia(moment); l; l = g_list_next(l)) {
+        GsweAntiscionData *antiscion_data = l->data,
+                          *expected = gswe_antiscion_data_new_with_planets(
+                               gswe_antiscion_data_get_planet1(antiscion_data),
+                               gswe_antiscion_data_get_planet2(antiscion_data)
+                           );
+
+        g_assert_cmpint(
+                gswe_antiscion_data_get_axis(antiscion_data),
+                ==,
+                gswe_antiscion_data_get_axis(expected)
+            );
+
+        if (
+                    gswe_antiscion_data_get_axis(expected)
+                    == GSWE_ANTISCION_AXIS_MID_LEO
+                ) {
+            found++;
+        }
+
+        gswe_antiscion_data_unref(expected);
+    }
+
+    return found;
+}
+
+static void
+test_moment_aspects_all_pairs(void)
+{
+    guint straddling = 0,
+          i;
+
+    // A moment every 7.3 days for two years, so that every planet crosses
+    // 0° while others are on the other side of it
+    for (i = 0; i < 100; i++) {
+        GsweMoment *moment = create_pair_moment(2456000.5 + i * 7.3);
+        GList *l,
+              *k;
+
+        check_all_pairs(moment);
+
+        for (
+                    l = gswe_moment_get_all_planets(moment);
+                    l;
+                    l = g_list_next(l)
+                ) {
+            for (k = g_list_next(l); k; k = g_list_next(k)) {
+                gdouble distance = fabs(
+                        gswe_planet_data_get_position(l->data)
+                        - gswe_planet_data_get_position(k->data)
+                    );
+
+                if ((distance > 180.0) && (360.0 - distance < 13.0)) {
+                    straddling++;
+                }
+            }
+        }
+
+        g_object_unref(moment);
+    }
+
+    g_assert_cmpuint(straddling, >, 0);
+}
+
+// Calls check_all_pairs() for moments at @jd after @edge has put each
+// ordered planet pair on the edge of an aspect or antiscion orb, and returns
+// the number of pairs found in that aspect or antiscion
+static guint
+check_edges(
+        gdouble jd,
+        void (*edge)(gdouble position1, gdouble position2, gdouble offset))
+{
+    GsweMoment *moment = create_pair_moment(jd);
+    gdouble positions[G_N_ELEMENTS(pair_planets)];
+    guint found = 0,
+          i,
+          j;
+    gint offset;
+
+    for (i = 0; i < G_N_ELEMENTS(pair_planets); i++) {
+        positions[i] = get_position(moment, pair_planets[i]);
+    }
+
+    g_object_unref(moment);
+
+    for (i = 0; i < G_N_ELEMENTS(pair_planets); i++) {
+        for (j = 0; j < G_N_ELEMENTS(pair_planets); j++) {
+            if (i == j) {
+                continue;
+            }
+
+            // Both sides of the edge, a few ULPs apart
+            for (offset = -2; offset <= 2; offset++) {
+                edge(positions[i], positions[j], offset * DBL_EPSILON);
+
+                moment = create_pair_moment(jd);
+                found += check_all_pairs(moment);
+                g_object_unref(moment);
+            }
+        }
+    }
+
+    return found;
+}
+
+static GsweAspectInfo *edge_aspect_info;
+
+// Sets the orb of the edge aspect so that the pair is exactly at its end.
+// Every planet has a 170° orb here, so the orb of a pair is the same as the
+// largest orb the moment looks for pairs with
+static void
+aspect_edge(gdouble position1, gdouble position2, gdouble offset)
+{
+    gdouble distance = fabs(position1 - position2);
+
+    if (distance > 180.0) {
+        distance = 360.0 - distance;
+    }
+
+    gswe_aspect_info_set_orb_modifier(
+            edge_aspect_info,
+            (170.0 - fabs(
+                    distance - gswe_aspect_info_get_size(edge_aspect_info)
+                )) * (1.0 + offset)
+        );
+}
+
+static GsweAntiscionAxisInfo *edge_axis_info;
+
+// Puts the edge axis where the mirror of the first planet is exactly one orb
+// away from the second one, before or after it depending on the order of the
+// two planets. Every orb is 5° here
+static void
+antiscion_edge(gdouble position1, gdouble position2, gdouble offset)
+{
+    gdouble start_point = (
+                position1 + position2 + (position1 < position2 ? 5.0 : -5.0)
+            ) / 2.0;
+
+    gswe_antiscion_axis_info_set_sign_offset(
+            edge_axis_info,
+            (start_point - 120.0) * (1.0 + offset)
+        );
+}
+
+static void
+set_pair_planet_orbs(gdouble *orbs, gdouble orb)
+{
+    guint p;
+
+    for (p = 0; p < G_N_ELEMENTS(pair_planets); p++) {
+        GswePlanetInfo *planet_info = gswe_find_planet_info_by_id(
+                pair_planets[p],
+                NULL
+            );
+
+        orbs[p] = gswe_planet_info_get_orb(planet_info);
+        gswe_planet_info_set_orb(planet_info, orb);
+    }
+}
+
+static void
+restore_pair_planet_orbs(gdouble *orbs)
+{
+    guint p;
+
+    for (p = 0; p < G_N_ELEMENTS(pair_planets); p++) {
+        gswe_planet_info_set_orb(
+                gswe_find_planet_info_by_id(pair_planets[p], NULL),
+                orbs[p]
+            );
+    }
+}
+
+static void
+test_moment_aspects_orb_edges(void)
+{
+    gdouble orb_modifiers[GSWE_ASPECT_QUINCUNX + 1],
+            orbs[G_N_ELEMENTS(pair_planets)],
+            sign_offset;
+    GsweAspect aspect;
+
+    set_pair_planet_orbs(orbs, 170.0);
+
+    // Every aspect but the edge aspect gets a 1° orb, so that they rarely
+    // get in the way
+    for (aspect = GSWE_ASPECT_CONJUCTION;
+         aspect <= GSWE_ASPECT_QUINCUNX;
+         aspect++) {
+        GsweAspectInfo *aspect_info = gswe_find_aspect_info_by_id(
+                aspect,
+                NULL
+            );
+
+        orb_modifiers[aspect] = gswe_aspect_info_get_orb_modifier(
+                aspect_info
+            );
+        gswe_aspect_info_set_orb_modifier(aspect_info, 1000.0);
+    }
+
+    edge_aspect_info = gswe_find_aspect_info_by_id(GSWE_ASPECT_QUINCUNX, NULL);
+    g_assert_cmpuint(check_edges(2456000.5, aspect_edge), >, 0);
+
+    for (aspect = GSWE_ASPECT_CONJUCTION;
+         aspect <= GSWE_ASPECT_QUINCUNX;
+         aspect++) {
+        gswe_aspect_info_set_orb_modifier(
+                gswe_find_aspect_info_by_id(aspect, NULL),
+                orb_modifiers[aspect]
+            );
+    }
+
+    restore_pair_planet_orbs(orbs);
+
+    // The same for the antiscia, with a 5° orb for every planet
+    set_pair_planet_orbs(orbs, 5.0);
+
+    edge_axis_info = gswe_find_antiscion_axis_info_by_id(
+            GSWE_ANTISCION_AXIS_MID_LEO,
+            NULL
+        );
+    sign_offset = gswe_antiscion_axis_info_get_sign_offset(edge_axis_info);
+    g_assert_cmpuint(check_edges(2456000.5, antiscion_edge), >, 0);
+    gswe_antiscion_axis_info_set_sign_offset(edge_axis_info, sign_offset);
+
+    restore_pair_planet_orbs(orbs);
+}
+
+// The ::changed and notify emissions of an object
+struct emissions {
+    guint changed;
+    guint notify;
+    GHashTable *properties;
+};
+
+static void
+count_changed(gpointer object, struct emissions *emissions)
+{
+    emissions->changed++;
+}
+
+static guint
+notify_count(struct emissions *emissions, const gchar *property)
+{
+    return GPOINTER_TO_UINT(
+            g_hash_table_lookup(emissions->properties, property)
+        );
+}
+
+static void
+count_notify(GObject *object, GParamSpec *pspec, struct emissions *emissions)
+{
+    const gchar *name = g_param_spec_get_name(pspec);
+
+    emissions->notify++;
+    g_hash_table_insert(
+            emissions->properties,
+            (gpointer)name,
+            GUINT_TO_POINTER(notify_count(emissions, name) + 1)
+        );
+}
+
+static void
+reset_emissions(struct emissions *emissions)
+{
+    emissions->changed = 0;
+    emissions->notify = 0;
+    g_hash_table_remove_all(emissions->properties);
+}
+
+static void
+connect_emissions(gpointer object, struct emissions *emissions)
+{
+    emissions->properties = g_hash_table_new(g_str_hash, g_str_equal);
+    reset_emissions(emissions);
+    g_signal_connect(object, "changed", G_CALLBACK(count_changed), emissions);
+    g_signal_connect(object, "notify", G_CALLBACK(count_notify), emissions);
+}
+
+static gdouble
+ascendant(GsweMoment *moment)
+{
+    GList *cusps = gswe_moment_get_house_cusps(moment, NULL);
+
+    g_assert_nonnull(cusps);
+
+    return gswe_house_data_get_cusp_position(cusps->data);
+}
+
+static void
+test_moment_update(void)
+{
+    GsweMoment *moment = create_moment(),
+               *other_moment;
+    GsweTimestamp *timestamp = gswe_moment_get_timestamp(moment);
+    struct emissions emissions;
+    gdouble first,
+            second;
+
+    connect_emissions(moment, &emissions);
+
+    // An update without changes emits nothing
+    gswe_moment_update_begin(moment);
+    gswe_moment_set_coordinates(moment, 19.8166667, 47.5, 100.0);
+    gswe_moment_set_house_system(moment, GSWE_HOUSE_SYSTEM_PLACIDUS);
+    gswe_moment_update_commit(moment);
+    g_assert_cmpuint(emissions.changed, ==, 0);
+    g_assert_cmpuint(emissions.notify, ==, 0);
+
+    // Nested updates emit everything once, on the outermost commit,
+    // including the changes of the timestamp
+    gswe_moment_update_begin(moment);
+    gswe_moment_set_coordinates(moment, 19.0, 47.0, 100.0);
+    gswe_moment_update_begin(moment);
+    gswe_moment_set_coordinates(moment, 20.0, 48.0, 100.0);
+    gswe_moment_set_house_system(moment, GSWE_HOUSE_SYSTEM_KOCH);
+    gswe_timestamp_set_gregorian_year(timestamp, 2013, NULL);
+    gswe_moment_update_commit(moment);
+    g_assert_cmpuint(emissions.changed, ==, 0);
+    g_assert_cmpuint(emissions.notify, ==, 0);
+    gswe_moment_update_commit(moment);
+    g_assert_cmpuint(emissions.changed, ==, 1);
+    g_assert_cmpuint(emissions.notify, ==, 2);
+    g_assert_cmpuint(notify_count(&emissions, "coordinates"), ==, 1);
+    g_assert_cmpuint(notify_count(&emissions, "house-system"), ==, 1);
+
+    // Every change inside an update bumps the revision, so values fetched in
+    // between are calculated again
+    reset_emissions(&emissions);
+    gswe_moment_update_begin(moment);
+    gswe_moment_set_coordinates(moment, 19.0, 47.0, 100.0);
+    first = ascendant(moment);
+    gswe_moment_set_coordinates(moment, 20.0, 48.0, 100.0);
+    second = ascendant(moment);
+    gswe_moment_update_commit(moment);
+    g_assert_cmpfloat(first, !=, second);
+    g_assert_cmpfloat(ascendant(moment), ==, second);
+    g_assert_cmpuint(emissions.changed, ==, 1);
+    g_assert_cmpuint(emissions.notify, ==, 1);
+
+    other_moment = create_moment();
+    gswe_moment_set_coordinates(other_moment, 20.0, 48.0, 100.0);
+    gswe_moment_set_house_system(other_moment, GSWE_HOUSE_SYSTEM_KOCH);
+    gswe_timestamp_set_gregorian_year(
+            gswe_moment_get_timestamp(other_moment),
+            2013,
+            NULL
+        );
+    g_assert_cmpfloat(ascendant(other_moment), ==, second);
+    g_object_unref(other_moment);
+
+    g_object_unref(moment);
+    g_hash_table_unref(emissions.properties);
+}
+
+static void
+test_moment_set_all(void)
+{
+    GsweMoment *moment = create_moment();
+    struct emissions emissions,
+                     timestamp_emissions;
+    GsweTime instant;
+
+    connect_emissions(moment, &emissions);
+    connect_emissions(gswe_moment_get_timestamp(moment), &timestamp_emissions);
+
+    g_assert_true(gswe_time_set_gregorian(
+            &instant,
+            2013, 9, 1, 13, 52, 18.419,
+            2.0,
+            NULL
+        ));
+
+    // The time changes the existing timestamp, which notifies the moment
+    // only through its ::changed signal
+    gswe_moment_set_all(
+            moment,
+            &instant,
+            20.0, 48.0, 200.0,
+            GSWE_HOUSE_SYSTEM_KOCH,
+            NULL
+        );
+    g_assert_cmpuint(emissions.changed, ==, 1);
+    g_assert_cmpuint(emissions.notify, ==, 2);
+    g_assert_cmpuint(notify_count(&emissions, "coordinates"), ==, 1);
+    g_assert_cmpuint(notify_count(&emissions, "house-system"), ==, 1);
+    g_assert_cmpuint(timestamp_emissions.changed, ==, 1);
+
+    // Only one of them changes
+    reset_emissions(&emissions);
+    gswe_moment_set_all(
+            moment,
+            NULL,
+            20.0, 48.0, 200.0,
+            GSWE_HOUSE_SYSTEM_EQUAL,
+            NULL
+        );
+    g_assert_cmpuint(emissions.changed, ==, 1);
+    g_assert_cmpuint(emissions.notify, ==, 1);
+    g_assert_cmpuint(notify_count(&emissions, "house-system"), ==, 1);
+
+    // Nothing changes
+    reset_emissions(&emissions);
+    gswe_moment_set_all(
+            moment,
+            NULL,
+            20.0, 48.0, 200.0,
+            GSWE_HOUSE_SYSTEM_EQUAL,
+            NULL
+        );
+    g_assert_cmpuint(emissions.changed, ==, 0);
+    g_assert_cmpuint(emissions.notify, ==, 0);
+
+    // Inside an update of its own, set_all() emits nothing until the commit
+    reset_emissions(&emissions);
+    gswe_moment_update_begin(moment);
+    gswe_moment_set_all(
+            moment,
+            NULL,
+            19.0, 47.0, 100.0,
+            GSWE_HOUSE_SYSTEM_KOCH,
+            NULL
+        );
+    g_assert_cmpuint(emissions.changed, ==, 0);
+    g_assert_cmpuint(emissions.notify, ==, 0);
+    gswe_moment_set_coordinates(moment, 20.0, 48.0, 100.0);
+    gswe_moment_update_commit(moment);
+    g_assert_cmpuint(emissions.changed, ==, 1);
+    g_assert_cmpuint(emissions.notify, ==, 2);
+    g_assert_cmpuint(notify_count(&emissions, "coordinates"), ==, 1);
+    g_assert_cmpuint(notify_count(&emissions, "house-system"), ==, 1);
+
+    g_object_unref(moment);
+    g_hash_table_unref(emissions.properties);
+    g_hash_table_unref(timestamp_emissions.properties);
+}
+
+// The number of random positions every house placement is checked with
+#define HOUSE_POSITION_COUNT 1000
+
+static const GsweHouseSystem placement_house_systems[] = {
+    GSWE_HOUSE_SYSTEM_PLACIDUS,
+    GSWE_HOUSE_SYSTEM_KOCH,
+    GSWE_HOUSE_SYSTEM_EQUAL,
+    GSWE_HOUSE_SYSTEM_GAUQUELIN,
+};
+
+// The house of @position by the definition: the one that starts at its own
+// cusp and ends at the next one. The Gauquelin sectors are numbered
+// clockwise, the other houses counterclockwise
+static gint
+exact_house(const gdouble *cusps, guint count, gdouble position)
+{
+    gboolean clockwise = (count == 36);
+    guint house;
+
+    for (house = 1; house <= count; house++) {
+        gdouble start = cusps[house],
+                end = cusps[house % count + 1],
+                width = (clockwise) ? start - end : end - start,
+                distance = (clockwise) ? start - position : position - start;
+
+        if ((width = fmod(width, 360.0)) < 0.0) {
+            width += 360.0;
+        }
+
+        if ((distance = fmod(distance, 360.0)) < 0.0) {
+            distance += 360.0;
+        }
+
+        if (distance < width) {
+            return house;
+        }
+    }
+
+    g_assert_not_reached();
+
+    return 0;
+}
+
+static void
+check_house_placement(GsweMoment *moment)
+{
+    GList *house_list = gswe_moment_get_house_cusps(moment, NULL),
+          *l;
+    gdouble cusps[37],
+            positions[HOUSE_POSITION_COUNT + 2 * 36 + 5];
+    gint houses[G_N_ELEMENTS(positions)];
+    guint count = 0,
+          position_count = 0,
+          house,
+          i;
+    gint zero_house;
+    gboolean clockwise;
+
+    for (l = house_list; l; l = g_list_next(l)) {
+        GsweHouseData *house_data = l->data;
+
+        g_assert_cmpuint(gswe_house_data_get_house(house_data), ==, ++count);
+        cusps[count] = gswe_house_data_get_cusp_position(house_data);
+    }
+
+    clockwise = (
+            gswe_moment_get_house_system(moment) == GSWE_HOUSE_SYSTEM_GAUQUELIN
+        );
+    g_assert_cmpuint(count, ==, (clockwise) ? 36 : 12);
+
+    for (house = 1; house <= count; house++) {
+        gdouble before = cusps[house] + ((clockwise) ? 1e-9 : -1e-9);
+        guint previous = (house == 1) ? count : house - 1;
+
+        // A position exactly on a cusp is in the house the cusp starts, a
+        // position just before it is still in the previous one
+        g_assert_cmpint(
+                gswe_moment_get_house(moment, cusps[house], NULL),
+                ==,
+                house
+            );
+        g_assert_cmpint(
+                gswe_moment_get_house(moment, before, NULL),
+                ==,
+                previous
+            );
+
+        positions[position_count++] = cusps[house];
+        positions[position_count++] = before;
+    }
+
+    // The house around 0° starts before 360° and ends after it (or the other
+    // way round for the Gauquelin sectors); positions on both sides of 0°,
+    // and positions outside of [0, 360) belong to it the same way
+    zero_house = exact_house(cusps, count, 0.0);
+    g_assert_cmpint(gswe_moment_get_house(moment, 0.0, NULL), ==, zero_house);
+    g_assert_cmpint(gswe_moment_get_house(moment, 360.0, NULL), ==, zero_house);
+    g_assert_cmpint(
+            gswe_moment_get_house(moment, -360.0, NULL),
+            ==,
+            zero_house
+        );
+    g_assert_cmpint(
+            gswe_moment_get_house(
+                    moment,
+                    (clockwise)
+                        ? cusps[zero_house] / 2.0
+                        : (cusps[zero_house] + 360.0) / 2.0,
+                    NULL
+                ),
+            ==,
+            zero_house
+        );
+    g_assert_cmpint(
+            gswe_moment_get_house(
+                    moment,
+                    (clockwise)
+                        ? (cusps[zero_house % count + 1] + 360.0) / 2.0
+                        : cusps[zero_house % count + 1] / 2.0,
+                    NULL
+                ),
+            ==,
+            zero_house
+        );
+
+    positions[position_count++] = 0.0;
+    positions[position_count++] = 360.0;
+    positions[position_count++] = -360.0;
+    positions[position_count++] = 1e-9;
+    positions[position_count++] = 360.0 - 1e-9;
+
+    for (i = 0; i < HOUSE_POSITION_COUNT; i++) {
+        positions[position_count++] = g_test_rand_double_range(-720.0, 720.0);
+    }
+
+    // The batch call gives the same houses as one call per position, and the
+    // houses by the definition
+    gswe_moment_get_houses(moment, positions, houses, position_count, NULL);
+
+    for (i = 0; i < position_count; i++) {
+        g_assert_cmpint(
+                houses[i],
+                ==,
+                gswe_moment_get_house(moment, positions[i], NULL)
+            );
+        g_assert_cmpint(
+                houses[i],
+                ==,
+                exact_house(cusps, count, positions[i])
+            );
+    }
+}
+
+static void
+test_moment_house_placement(void)
+{
+    GsweMoment *moment = create_moment();
+    GsweTimestamp *timestamp = gswe_moment_get_timestamp(moment);
+    gdouble positions[3] = { 0.0, 123.4, 359.9 };
+    gint houses[3];
+    guint i,
+          j;
+
+    for (i = 0; i < 20; i++) {
+        gswe_timestamp_set_julian_day_et(
+                timestamp,
+                g_test_rand_double_range(2415020.5, 2488069.5),
+                NULL
+            );
+        gswe_moment_set_coordinates(
+                moment,
+                g_test_rand_double_range(-180.0, 180.0),
+                g_test_rand_double_range(-60.0, 60.0),
+                100.0
+            );
+
+        for (j = 0; j < G_N_ELEMENTS(placement_house_systems); j++) {
+            gswe_moment_set_house_system(moment, placement_house_systems[j]);
+            check_house_placement(moment);
+        }
+    }
+
+    // Without a house system, every position is in house 0
+    gswe_moment_set_house_system(moment, GSWE_HOUSE_SYSTEM_NONE);
+    g_assert_cmpint(gswe_moment_get_house(moment, 123.4, NULL), ==, 0);
+    gswe_moment_get_houses(moment, positions, houses, 3, NULL);
+    g_assert_cmpint(houses[0], ==, 0);
+    g_assert_cmpint(houses[1], ==, 0);
+    g_assert_cmpint(houses[2], ==, 0);
+
+    g_object_unref(moment);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/gswe/moment/topo_reuse", test_moment_topo_reuse);
+    g_test_add_func(
+            "/gswe/moment/context_alternate",
+            test_moment_context_alternate
+        );
+    g_test_add_func("/gswe/moment/series", test_moment_series);
+    g_test_add_func(
+            "/gswe/moment/series_parallel",
+            test_moment_series_parallel
+        );
+    g_test_add_func(
+            "/gswe/moment/opposite_points",
+            test_moment_opposite_points
+        );
+    g_test_add_func(
+            "/gswe/moment/aspects_all_pairs",
+            test_moment_aspects_all_pairs
+        );
+    g_test_add_func(
+            "/gswe/moment/aspects_orb_edges",
+            test_moment_aspects_orb_edges
+        );
+    g_test_add_func("/gswe/moment/update", test_moment_update);
+    g_test_add_func("/gswe/moment/set_all", test_moment_set_all);
+    g_test_add_func(
+            "/gswe/moment/house_placement",
+            test_moment_house_placement
+        );
+    g_test_add_func(
+            "/gswe/moment/interpolate_nutation",
+            test_moment_interpolate_nutation
+        );
+
+    return g_test_run();
+}
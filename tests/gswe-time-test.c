@@ -0,0 +1,597 @@
+#undef G_DISABLE_ASSERT
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <swe-glib.h>
+#include "../swe/src/swephexp.h"
+
+#include "test-asserts.h"
+
+// The precision of a Julian day around the current era is about 40
+// microseconds; these are a bit looser than that
+#define JD_EPSILON (0.001 / 86400.0)
+#define SECOND_EPSILON 0.001
+
+struct gregorian_date {
+    gint year;
+    gint month;
+    gint day;
+    gint hour;
+    gint minute;
+    gdouble second;
+    gdouble timezone_offset;
+};
+
+static const struct gregorian_date dates[] = {
+    { 1983, 3, 7, 11, 54, 45.948, 1.0 },
+    { 2013, 9, 1, 13, 52, 18.419, 2.0 },
+    { 2000, 1, 1, 12, 0, 0.0, 0.0 },
+    { 1850, 6, 15, 3, 30, 10.5, -5.5 },
+    { 1600, 2, 29, 23, 59, 59.75, 0.0 },
+    // The leap second at the end of 2016, in UTC and in local time
+    { 2016, 12, 31, 23, 59, 60.5, 0.0 },
+    { 2017, 1, 1, 0, 59, 60.25, 1.0 },
+};
+
+static void
+assert_gregorian(const GsweTime *instant, const struct gregorian_date *date)
+{
+    gint year,
+         month,
+         day,
+         hour,
+         minute;
+    gdouble second;
+
+    gswe_time_get_gregorian(
+            instant,
+            &year, &month, &day,
+            &hour, &minute, &second
+        );
+
+    g_assert_cmpint(year, ==, date->year);
+    g_assert_cmpint(month, ==, date->month);
+    g_assert_cmpint(day, ==, date->day);
+    g_assert_cmpint(hour, ==, date->hour);
+    g_assert_cmpint(minute, ==, date->minute);
+    gswe_assert_fuzzy_equals(second, date->second, SECOND_EPSILON);
+}
+
+static void
+test_time_gregorian(void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(dates); i++) {
+        const struct gregorian_date *date = &dates[i];
+        GsweTime instant = { 0 };
+        GError *err = NULL;
+        gdouble dret[2];
+        gchar serr[AS_MAXCH];
+        gint utc_year,
+             utc_month,
+             utc_day,
+             utc_hour,
+             utc_minute;
+        gdouble utc_second;
+
+        g_assert_true(gswe_time_set_gregorian(
+                &instant,
+                date->year, date->month, date->day,
+                date->hour, date->minute, date->second,
+                date->timezone_offset,
+                &err
+            ));
+        g_assert_no_error(err);
+        gswe_assert_fuzzy_equals(
+                instant.timezone_offset,
+                date->timezone_offset,
+                0.0
+            );
+
+        // The same Julian days as the Swiss Ephemeris gives
+        swe_utc_time_zone(
+                date->year, date->month, date->day,
+                date->hour, date->minute, date->second,
+                date->timezone_offset,
+                &utc_year, &utc_month, &utc_day,
+                &utc_hour, &utc_minute, &utc_second
+            );
+        g_assert_cmpint(swe_utc_to_jd(
+                utc_year, utc_month, utc_day,
+                utc_hour, utc_minute, utc_second,
+                SE_GREG_CAL, dret, serr
+            ), ==, OK);
+        gswe_assert_fuzzy_equals(instant.julian_day_et, dret[0], 0.0);
+        gswe_assert_fuzzy_equals(instant.julian_day_ut, dret[1], 0.0);
+
+        // Back to the same date
+        assert_gregorian(&instant, date);
+    }
+}
+
+static void
+test_time_leap_second(void)
+{
+    GsweTime leap_second = { 0 },
+             new_year = { 0 };
+
+    g_assert_true(gswe_time_set_gregorian(
+            &leap_second,
+            2016, 12, 31, 23, 59, 60.5,
+            0.0,
+            NULL
+        ));
+    g_assert_true(gswe_time_set_gregorian(
+            &new_year,
+            2017, 1, 1, 0, 0, 0.5,
+            0.0,
+            NULL
+        ));
+
+    // The last minute of 2016 is 61 seconds long
+    gswe_assert_fuzzy_equals(
+            new_year.julian_day_et - leap_second.julian_day_et,
+            1.0 / 86400.0,
+            JD_EPSILON
+        );
+    gswe_assert_fuzzy_equals(
+            new_year.julian_day_ut - leap_second.julian_day_ut,
+            1.0 / 86400.0,
+            JD_EPSILON
+        );
+}
+
+static void
+test_time_julian_day(void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(dates); i++) {
+        const struct gregorian_date *date = &dates[i];
+        GsweTime instant = { 0 },
+                 from_et = { 0 },
+                 from_ut = { 0 };
+
+        g_assert_true(gswe_time_set_gregorian(
+                &instant,
+                date->year, date->month, date->day,
+                date->hour, date->minute, date->second,
+                date->timezone_offset,
+                NULL
+            ));
+
+        // Setting either Julian day gets the other one, and the date, back
+        from_et.timezone_offset = date->timezone_offset;
+        gswe_time_set_julian_day_et(&from_et, instant.julian_day_et);
+        gswe_assert_fuzzy_equals(
+                from_et.julian_day_et,
+                instant.julian_day_et,
+                0.0
+            );
+        gswe_assert_fuzzy_equals(
+                from_et.julian_day_ut,
+                instant.julian_day_ut,
+                JD_EPSILON
+            );
+        assert_gregorian(&from_et, date);
+
+        from_ut.timezone_offset = date->timezone_offset;
+        gswe_time_set_julian_day_ut(&from_ut, instant.julian_day_ut);
+        gswe_assert_fuzzy_equals(
+                from_ut.julian_day_ut,
+                instant.julian_day_ut,
+                0.0
+            );
+        gswe_assert_fuzzy_equals(
+                from_ut.julian_day_et,
+                instant.julian_day_et,
+                JD_EPSILON
+            );
+        assert_gregorian(&from_ut, date);
+
+        // Stepping away and back again
+        gswe_time_add_days(&from_et, 1000.25);
+        gswe_time_add_days(&from_et, -1000.25);
+        gswe_assert_fuzzy_equals(
+                from_et.julian_day_et,
+                instant.julian_day_et,
+                JD_EPSILON
+            );
+        assert_gregorian(&from_et, date);
+    }
+}
+
+static void
+test_time_timestamp(void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(dates); i++) {
+        const struct gregorian_date *date = &dates[i];
+        GsweTimestamp *timestamp;
+        GsweTime instant = { 0 },
+                 back = { 0 };
+        GError *err = NULL;
+
+        g_assert_true(gswe_time_set_gregorian(
+                &instant,
+                date->year, date->month, date->day,
+                date->hour, date->minute, date->second,
+                date->timezone_offset,
+                NULL
+            ));
+
+        // GsweTime → GsweTimestamp → GsweTime keeps every value
+        timestamp = gswe_timestamp_new_from_time(&instant);
+        g_assert_true(gswe_timestamp_get_time(timestamp, &back, &err));
+        g_assert_no_error(err);
+        gswe_assert_fuzzy_equals(
+                back.julian_day_et,
+                instant.julian_day_et,
+                0.0
+            );
+        gswe_assert_fuzzy_equals(
+                back.julian_day_ut,
+                instant.julian_day_ut,
+                0.0
+            );
+        gswe_assert_fuzzy_equals(
+                back.timezone_offset,
+                instant.timezone_offset,
+                0.0
+            );
+
+        // The timestamp has the same Gregorian date, in the same time zone
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_year(timestamp, NULL),
+                ==,
+                date->year
+            );
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_month(timestamp, NULL),
+                ==,
+                date->month
+            );
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_day(timestamp, NULL),
+                ==,
+                date->day
+            );
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_hour(timestamp, NULL),
+                ==,
+                date->hour
+            );
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_minute(timestamp, NULL),
+                ==,
+                date->minute
+            );
+        g_assert_cmpint(
+                gswe_timestamp_get_gregorian_second(timestamp, NULL),
+                ==,
+                (gint)date->second
+            );
+        gswe_assert_fuzzy_equals(
+                gswe_timestamp_get_julian_day_et(timestamp, NULL),
+                instant.julian_day_et,
+                0.0
+            );
+        gswe_assert_fuzzy_equals(
+                gswe_timestamp_get_julian_day_ut(timestamp, NULL),
+                instant.julian_day_ut,
+                0.0
+            );
+
+        g_object_unref(timestamp);
+
+        // A timestamp made from the Julian day alone gives the same date in
+        // UTC
+        timestamp = gswe_timestamp_new_from_julian_day(instant.julian_day_et);
+        g_assert_true(gswe_timestamp_get_time(timestamp, &back, &err));
+        g_assert_no_error(err);
+        gswe_assert_fuzzy_equals(
+                back.julian_day_et,
+                instant.julian_day_et,
+                0.0
+            );
+        back.timezone_offset = date->timezone_offset;
+        assert_gregorian(&back, date);
+
+        g_object_unref(timestamp);
+    }
+}
+
+// The number of random dates the array conversions are checked with
+#define ARRAY_COUNT 2000
+
+static void
+test_time_calendar_arrays(void)
+{
+    gint *year = g_new(gint, ARRAY_COUNT),
+         *month = g_new(gint, ARRAY_COUNT),
+         *day = g_new(gint, ARRAY_COUNT);
+    gdouble *hour = g_new(gdouble, ARRAY_COUNT),
+            *julian_days = g_new(gdouble, ARRAY_COUNT);
+    guint i;
+
+    for (i = 0; i < ARRAY_COUNT; i++) {
+        year[i] = g_test_rand_int_range(-5000, 5000);
+        month[i] = g_test_rand_int_range(1, 13);
+        day[i] = g_test_rand_int_range(1, 29);
+        // Every tenth date is at midnight
+        hour[i] = (i % 10 == 0) ? 0.0 : g_test_rand_double_range(0.0, 24.0);
+    }
+
+    gswe_time_julday_array(year, month, day, hour, ARRAY_COUNT, julian_days);
+
+    for (i = 0; i < ARRAY_COUNT; i++) {
+        gswe_assert_fuzzy_equals(
+                julian_days[i],
+                swe_julday(year[i], month[i], day[i], hour[i], SE_GREG_CAL),
+                1e-9
+            );
+    }
+
+    gswe_time_revjul_array(julian_days, ARRAY_COUNT, year, month, day, hour);
+
+    for (i = 0; i < ARRAY_COUNT; i++) {
+        gint scalar_year,
+             scalar_month,
+             scalar_day;
+        gdouble scalar_hour;
+
+        swe_revjul(
+                julian_days[i],
+                SE_GREG_CAL,
+                &scalar_year, &scalar_month, &scalar_day,
+                &scalar_hour
+            );
+
+        g_assert_cmpint(year[i], ==, scalar_year);
+        g_assert_cmpint(month[i], ==, scalar_month);
+        g_assert_cmpint(day[i], ==, scalar_day);
+        gswe_assert_fuzzy_equals(hour[i], scalar_hour, 1e-8);
+    }
+
+    g_free(year);
+    g_free(month);
+    g_free(day);
+    g_free(hour);
+    g_free(julian_days);
+}
+
+// Dates gswe_time_utc_to_jd_array() must find invalid. The first ones are
+// invalid for gswe_time_set_gregorian(), too; the others would be carried
+// over to the next unit by it
+static const struct gregorian_date invalid_dates[] = {
+    // No leap second at the end of this day, and no UTC before 1972
+    { 2016, 12, 30, 23, 59, 60.5, 0.0 },
+    { 1970, 12, 31, 23, 59, 60.0, 0.0 },
+    { 2017, 1, 1, 0, 59, 60.5, 0.0 },
+#define SCALAR_INVALID_COUNT 3
+    { 2015, 2, 29, 12, 0, 0.0, 0.0 },
+    { 2015, 13, 1, 12, 0, 0.0, 0.0 },
+    { 2015, 6, 0, 12, 0, 0.0, 0.0 },
+    { 2015, 6, 15, 24, 0, 0.0, 0.0 },
+    { 2015, 6, 15, 12, 60, 0.0, 0.0 },
+    { 2015, 6, 15, 12, 0, -1.0, 0.0 },
+};
+
+static void
+test_time_utc_arrays(void)
+{
+    guint date_count = G_N_ELEMENTS(dates),
+          invalid_count = G_N_ELEMENTS(invalid_dates),
+          count = ARRAY_COUNT + date_count + invalid_count,
+          i;
+    GsweDateArrays in = {
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gdouble, count)
+    },
+                   out = {
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gint, count),
+        g_new(gdouble, count)
+    };
+    gdouble *timezone_offsets = g_new(gdouble, count),
+            *julian_days_et = g_new(gdouble, count),
+            *julian_days_ut = g_new(gdouble, count);
+    GError *err = NULL;
+
+    // Random dates around the start of UTC, the fixed dates with the leap
+    // seconds, and the invalid dates, mixed up with the valid ones
+    for (i = 0; i < count; i++) {
+        const struct gregorian_date *date = NULL;
+
+        if ((i % 100 == 50) && (i / 100 < invalid_count)) {
+            date = &invalid_dates[i / 100];
+        } else if ((i % 100 == 75) && (i / 100 < date_count)) {
+            date = &dates[i / 100];
+        }
+
+        if (date) {
+            in.year[i] = date->year;
+            in.month[i] = date->month;
+            in.day[i] = date->day;
+            in.hour[i] = date->hour;
+            in.minute[i] = date->minute;
+            in.second[i] = date->second;
+            timezone_offsets[i] = date->timezone_offset;
+
+            continue;
+        }
+
+        in.year[i] = g_test_rand_int_range(1900, 2030);
+        in.month[i] = g_test_rand_int_range(1, 13);
+        in.day[i] = g_test_rand_int_range(1, 29);
+        in.hour[i] = g_test_rand_int_range(0, 24);
+        in.minute[i] = g_test_rand_int_range(0, 60);
+        // Not too close to a whole minute, so converting back can not round
+        // differently
+        in.second[i] = g_test_rand_double_range(0.01, 59.99);
+        timezone_offsets[i] = g_test_rand_int_range(-24, 29) / 2.0;
+    }
+
+    g_assert_false(gswe_time_utc_to_jd_array(
+            &in,
+            timezone_offsets,
+            count,
+            julian_days_et,
+            julian_days_ut,
+            &err
+        ));
+    g_assert_error(err, GSWE_ERROR, GSWE_ERROR_INVALID_DATE);
+    g_clear_error(&err);
+
+    // Every date gives the same Julian days as gswe_time_set_gregorian(),
+    // or NaN if it is invalid
+    for (i = 0; i < count; i++) {
+        GsweTime instant = { 0 };
+        gboolean invalid = FALSE,
+                 scalar_invalid = FALSE;
+        guint j;
+
+        for (j = 0; j < invalid_count; j++) {
+            if (
+                        (in.year[i] == invalid_dates[j].year)
+                        && (in.month[i] == invalid_dates[j].month)
+                        && (in.day[i] == invalid_dates[j].day)
+                        && (in.hour[i] == invalid_dates[j].hour)
+                        && (in.minute[i] == invalid_dates[j].minute)
+                        && (in.second[i] == invalid_dates[j].second)
+                    ) {
+                invalid = TRUE;
+                scalar_invalid = (j < SCALAR_INVALID_COUNT);
+            }
+        }
+
+        if (invalid) {
+            g_assert_true(isnan(julian_days_et[i]));
+            g_assert_true(isnan(julian_days_ut[i]));
+        }
+
+        if (!invalid || scalar_invalid) {
+            g_assert_cmpint(gswe_time_set_gregorian(
+                    &instant,
+                    in.year[i], in.month[i], in.day[i],
+                    in.hour[i], in.minute[i], in.second[i],
+                    timezone_offsets[i],
+                    NULL
+                ), ==, !invalid);
+        }
+
+        if (!invalid) {
+            gswe_assert_fuzzy_equals(
+                    julian_days_et[i],
+                    instant.julian_day_et,
+                    JD_EPSILON
+                );
+            gswe_assert_fuzzy_equals(
+                    julian_days_ut[i],
+                    instant.julian_day_ut,
+                    JD_EPSILON
+                );
+        }
+    }
+
+    // Without the invalid dates, the conversion succeeds, and the dates
+    // convert back to themselves, like with gswe_time_get_gregorian()
+    for (i = 0; i < count; i++) {
+        if (isnan(julian_days_et[i])) {
+            julian_days_et[i] = 2451545.0;
+        }
+    }
+
+    gswe_time_jdet_to_utc_array(
+            julian_days_et,
+            timezone_offsets,
+            count,
+            &out
+        );
+
+    for (i = 0; i < count; i++) {
+        GsweTime instant = {
+            julian_days_et[i],
+            julian_days_ut[i],
+            timezone_offsets[i]
+        };
+        gint year,
+             month,
+             day,
+             hour,
+             minute;
+        gdouble second;
+
+        gswe_time_get_gregorian(
+                &instant,
+                &year, &month, &day,
+                &hour, &minute, &second
+            );
+
+        g_assert_cmpint(out.year[i], ==, year);
+        g_assert_cmpint(out.month[i], ==, month);
+        g_assert_cmpint(out.day[i], ==, day);
+        g_assert_cmpint(out.hour[i], ==, hour);
+        g_assert_cmpint(out.minute[i], ==, minute);
+        gswe_assert_fuzzy_equals(out.second[i], second, SECOND_EPSILON);
+
+        if (!isnan(julian_days_ut[i])) {
+            g_assert_cmpint(out.year[i], ==, in.year[i]);
+            g_assert_cmpint(out.month[i], ==, in.month[i]);
+            g_assert_cmpint(out.day[i], ==, in.day[i]);
+            g_assert_cmpint(out.hour[i], ==, in.hour[i]);
+            g_assert_cmpint(out.minute[i], ==, in.minute[i]);
+            gswe_assert_fuzzy_equals(
+                    out.second[i],
+                    in.second[i],
+                    SECOND_EPSILON
+                );
+        }
+    }
+
+    g_free(in.year);
+    g_free(in.month);
+    g_free(in.day);
+    g_free(in.hour);
+    g_free(in.minute);
+    g_free(in.second);
+    g_free(out.year);
+    g_free(out.month);
+    g_free(out.day);
+    g_free(out.hour);
+    g_free(out.minute);
+    g_free(out.second);
+    g_free(timezone_offsets);
+    g_free(julian_days_et);
+    g_free(julian_days_ut);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    gswe_init();
+
+    g_test_add_func("/gswe/time/gregorian", test_time_gregorian);
+    g_test_add_func("/gswe/time/leap_second", test_time_leap_second);
+    g_test_add_func("/gswe/time/julian_day", test_time_julian_day);
+    g_test_add_func("/gswe/time/timestamp", test_time_timestamp);
+    g_test_add_func(
+            "/gswe/time/calendar_arrays",
+            test_time_calendar_arrays
+        );
+    g_test_add_func("/gswe/time/utc_arrays", test_time_utc_arrays);
+
+    return g_test_run();
+}
@@ -308,6 +308,123 @@ static void
 test_timestamp_now(void)
 {}
 
+static void
+count_changed(GsweTimestamp *timestamp, guint *changed)
+{
+    (*changed)++;
+}
+
+static void
+count_notify(GObject *object, GParamSpec *pspec, GHashTable *properties)
+{
+    const gchar *name = g_param_spec_get_name(pspec);
+
+    g_hash_table_insert(
+            properties,
+            (gpointer)name,
+            GUINT_TO_POINTER(
+                    GPOINTER_TO_UINT(g_hash_table_lookup(properties, name)) + 1
+                )
+        );
+}
+
+static void
+assert_notified_once(gpointer name, gpointer count, gpointer user_data)
+{
+    g_assert_cmpuint(GPOINTER_TO_UINT(count), ==, 1);
+}
+
+// Asserts that every property was notified at most once, and returns the
+// number of notified properties
+static guint
+notified_once(GHashTable *properties)
+{
+    g_hash_table_foreach(properties, assert_notified_once, NULL);
+
+    return g_hash_table_size(properties);
+}
+
+static void
+test_timestamp_update(void)
+{
+    GsweTimestamp *timestamp = gswe_timestamp_new_from_gregorian_full(
+            1983, 3, 7,
+            11, 54, 45, 0,
+            1.0
+        );
+    GHashTable *properties = g_hash_table_new(g_str_hash, g_str_equal);
+    guint changed = 0;
+
+    g_signal_connect(
+            timestamp,
+            "changed",
+            G_CALLBACK(count_changed),
+            &changed
+        );
+    g_signal_connect(
+            timestamp,
+            "notify",
+            G_CALLBACK(count_notify),
+            properties
+        );
+
+    // An update without changes emits nothing
+    gswe_timestamp_update_begin(timestamp);
+    gswe_timestamp_set_gregorian_year(timestamp, 1983, NULL);
+    gswe_timestamp_update_commit(timestamp);
+    g_assert_cmpuint(changed, ==, 0);
+    g_assert_cmpuint(g_hash_table_size(properties), ==, 0);
+
+    // Nested updates emit everything once, on the outermost commit
+    gswe_timestamp_update_begin(timestamp);
+    gswe_timestamp_set_gregorian_year(timestamp, 2013, NULL);
+    gswe_timestamp_update_begin(timestamp);
+    gswe_timestamp_set_gregorian_month(timestamp, 9, NULL);
+    gswe_timestamp_set_gregorian_day(timestamp, 1, NULL);
+    gswe_timestamp_set_gregorian_full(
+            timestamp,
+            2013, 9, 1,
+            13, 52, 18, 0,
+            2.0,
+            NULL
+        );
+    gswe_timestamp_update_commit(timestamp);
+    g_assert_cmpuint(changed, ==, 0);
+    g_assert_cmpuint(g_hash_table_size(properties), ==, 0);
+    gswe_timestamp_update_commit(timestamp);
+    g_assert_cmpuint(changed, ==, 1);
+    g_assert_cmpuint(notified_once(properties), ==, 9);
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-year"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-month"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-day"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-hour"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-minute"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-second"));
+    g_assert_nonnull(g_hash_table_lookup(
+            properties,
+            "gregorian-timezone-offset"
+        ));
+    g_assert_nonnull(g_hash_table_lookup(properties, "gregorian-valid"));
+    g_assert_nonnull(g_hash_table_lookup(properties, "julian-day-valid"));
+
+    // Without an update, gswe_timestamp_set_gregorian_full() batches its own
+    // changes
+    changed = 0;
+    g_hash_table_remove_all(properties);
+    gswe_timestamp_set_gregorian_full(
+            timestamp,
+            2014, 10, 2,
+            14, 53, 19, 1,
+            3.0,
+            NULL
+        );
+    g_assert_cmpuint(changed, ==, 1);
+    g_assert_cmpuint(notified_once(properties), ==, 10);
+
+    g_object_unref(timestamp);
+    g_hash_table_unref(properties);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -322,6 +439,7 @@ main(int argc, char **argv)
     g_test_add_func("/gswe/timestamp/conv/jd_greg", test_timestamp_conv_jdgreg);
     g_test_add_func("/gswe/timestamp/sidereal", test_timestamp_sidereal);
     g_test_add_func("/gswe/timestamp/now", test_timestamp_now);
+    g_test_add_func("/gswe/timestamp/update", test_timestamp_update);
 
     return g_test_run();
 }